@@ -1,13 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB017
-#define ITERS 4
+#define BENCH_DEFAULT_N 16
+#define BENCH_DEFAULT_ITERS 4
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_accum\n");
 
-    size_t n = 16;
+    size_t n = BENCH_N;
     float *a = (float *)fb_malloc(sizeof(float) * n);
     float *b = (float *)fb_malloc(sizeof(float) * n);
     if (!a || !b) {
@@ -17,10 +18,10 @@ int main(void) {
     bench_fill_f32(a, n, 1.0f);
     bench_fill_f32(b, n, 0.5f);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_accum(a, b, n);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -1,13 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB032
-#define ITERS 8
+#define BENCH_DEFAULT_N 32
+#define BENCH_DEFAULT_ITERS 8
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_activation\n");
 
-    size_t n = 32;
+    size_t n = BENCH_N;
     int8_t *data = (int8_t *)fb_malloc(sizeof(int8_t) * n);
     if (!data) {
         fb_print("alloc failed\n");
@@ -15,10 +16,10 @@ int main(void) {
     }
     bench_fill_i8(data, n, -8);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_activation(data, n, FB_ACT_RELU);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
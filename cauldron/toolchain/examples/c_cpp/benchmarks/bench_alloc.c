@@ -0,0 +1,27 @@
+#include "bench_common.h"
+
+#define TAG 0xB061
+#define BENCH_DEFAULT_ITERS 16
+
+#ifndef BENCH_ALLOC_BYTES
+#define BENCH_ALLOC_BYTES 256
+#endif
+
+/* Build with FB_FLAGS+=-DFB_ALLOC_FREELIST=1 to measure the size-class
+ * allocator; the default build measures the bump allocator. */
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_alloc\n");
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        void *p = fb_malloc(BENCH_ALLOC_BYTES);
+        if (!p) {
+            fb_print("alloc failed\n");
+            return 1;
+        }
+        fb_free(p);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
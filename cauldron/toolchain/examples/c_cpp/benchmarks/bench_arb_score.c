@@ -1,6 +1,7 @@
 #include "bench_common.h"
 
 #define TAG 0xB043
+#define BENCH_DEFAULT_ITERS 1
 
 int main(void) {
     bench_heap_setup();
@@ -16,8 +17,10 @@ int main(void) {
     uint8_t mask = 0;
     uint64_t graph_idx = (uint64_t)(FB_ARB_SEGMENT - 1u);
 
-    bench_log(TAG, 0, 1);
-    (void)fb_arb_score(graph_idx, NULL, 0, &mask);
-    bench_log(TAG, 1, 1);
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        (void)fb_arb_score(graph_idx, NULL, 0, &mask);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,37 @@
+#include "bench_common.h"
+
+#define TAG 0xB062
+#define BENCH_DEFAULT_ITERS 8
+
+#ifndef BENCH_ARENA_BYTES
+#define BENCH_ARENA_BYTES (64u * 1024u)
+#endif
+
+/* Simulates per-inference scratch: four buffers allocated, then dropped with
+ * a single reset, repeated BENCH_ITERS times over a fixed RAM region. */
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_arena\n");
+
+    fb_arena_t arena;
+    if (fb_arena_init_heap(&arena, BENCH_ARENA_BYTES) != 0) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        fb_arena_mark_t mark = fb_arena_mark(&arena);
+        int8_t *x = (int8_t *)fb_arena_alloc(&arena, 256);
+        int32_t *h = (int32_t *)fb_arena_alloc(&arena, sizeof(int32_t) * 128);
+        int32_t *out = (int32_t *)fb_arena_alloc(&arena, sizeof(int32_t) * 16);
+        fb_row_state_t *state = (fb_row_state_t *)fb_arena_alloc(&arena, sizeof(fb_row_state_t));
+        if (!x || !h || !out || !state) {
+            fb_print("arena exhausted\n");
+            return 1;
+        }
+        fb_arena_reset(&arena, mark);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
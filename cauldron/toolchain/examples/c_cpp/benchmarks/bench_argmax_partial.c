@@ -1,12 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB01B
+#define BENCH_DEFAULT_N 16
+#define BENCH_DEFAULT_ITERS 1
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_argmax_partial\n");
 
-    size_t n = 16;
+    size_t n = BENCH_N;
     float *data = (float *)fb_malloc(sizeof(float) * n);
     fb_argmax_state_t *state = (fb_argmax_state_t *)fb_malloc(sizeof(fb_argmax_state_t));
     if (!data || !state) {
@@ -14,13 +16,15 @@ int main(void) {
         return 1;
     }
     bench_fill_f32(data, n, 0.1f);
-    state->cursor = 0;
-    state->max_idx = 0;
-    state->max_bits = 0;
     state->max_per_call = (uint32_t)n;
 
-    bench_log(TAG, 0, 1);
-    (void)fb_argmax_partial(data, n, state);
-    bench_log(TAG, 1, 1);
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        state->cursor = 0;
+        state->max_idx = 0;
+        state->max_bits = 0;
+        (void)fb_argmax_partial(data, n, state);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,27 @@
+#include "bench_common.h"
+#include "frostbite_log.h"
+
+#define TAG 0xB076
+#define BENCH_DEFAULT_ITERS 8
+
+/* 0 = FB_BLOG record, 1 = the same four values via fb_printf, 2 = fb_debug_log */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_blog\n");
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 2
+        fb_debug_log(0xB100, (uint64_t)i, 4096, 123456, 0);
+#elif BENCH_OP == 1
+        fb_printf("kernel=0xb100 iter=%d rows=4096 instret=123456 status=0\n", i);
+#else
+        FB_BLOG(0xB100, 1, i, 4096, 123456, 0);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "bench_common.h"
+
+#define TAG 0xB06C
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 1
+
+/* 0 = max_rows from fb_budgeted_rows, 1 = fixed max_rows = d (no query) */
+#ifndef BENCH_BUDGET_FIXED
+#define BENCH_BUDGET_FIXED 0
+#endif
+
+/* Rough MATMUL_I8_I8 cost of one row, in instructions */
+#define ROW_COST(n) (2u * (n) + 16u)
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_budgeted_rows\n");
+
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    if (!x || !w || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+    bench_fill_i8(w, n * d, 1);
+
+    fb_budget_t budget;
+    fb_budget_init(&budget, FB_TX_BUDGET, FB_TX_RESERVE);
+    fb_row_state_t state = {0, d};
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        state.cursor = 0;
+        while (state.cursor < d) {
+#if !BENCH_BUDGET_FIXED
+            state.max_rows = fb_budgeted_rows(&budget, ROW_COST(n));
+#endif
+            fb_matmul_i8_i8_partial(out, x, w, 1 << 16, n, d, &state);
+            if (state.cursor < d) {
+                fb_budget_mark_tx(&budget);
+            }
+        }
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
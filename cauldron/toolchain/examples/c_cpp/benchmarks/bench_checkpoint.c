@@ -0,0 +1,31 @@
+#include "bench_common.h"
+
+#define TAG 0xB085
+#define BENCH_DEFAULT_N 1024
+#define BENCH_DEFAULT_ITERS 1
+
+/* Checkpoint from under an n-byte frame, so fb_checkpoint copies and
+ * checksums about n bytes of stack (FB_WARM_STACK bounds it) */
+static __attribute__((noinline)) int checkpoint_under(uint32_t *sum) {
+    volatile uint8_t frame[BENCH_N];
+    frame[0] = (uint8_t)*sum;
+    int rc = 0;
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        rc |= fb_checkpoint(NULL, 0);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    *sum += frame[0];
+    return rc;
+}
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_checkpoint\n");
+
+    uint32_t sum = 0;
+    int rc = checkpoint_under(&sum);
+    /* a fresh restart of the bench should time the checkpoint again */
+    fb_checkpoint_clear();
+    return rc != 0 || sum == 0xFFFFFFFFu;
+}
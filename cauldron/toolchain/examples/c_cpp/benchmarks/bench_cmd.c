@@ -0,0 +1,58 @@
+#include "bench_common.h"
+
+#define TAG 0xB066
+#define BENCH_DEFAULT_N 16
+#define BENCH_DEFAULT_D 8
+#define BENCH_DEFAULT_ITERS 4
+
+/* 0 = fb_cmd_run over a prebuilt list, 1 = direct wrapper calls */
+#ifndef BENCH_CMD_DIRECT
+#define BENCH_CMD_DIRECT 0
+#endif
+
+/* Small-model inference step (matmul, argmax, activation, bias add) issued
+ * either as one command list or as four direct calls. */
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_cmd\n");
+
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
+    int8_t *bias = (int8_t *)fb_malloc(sizeof(int8_t) * n);
+    int32_t *h = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    fb_argmax_i32_state_t *state = (fb_argmax_i32_state_t *)fb_malloc(sizeof(fb_argmax_i32_state_t));
+    if (!x || !w || !bias || !h || !state) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+    bench_fill_i8(w, n * d, 1);
+    bench_fill_i8(bias, n, -4);
+    fb_memset(state, 0, sizeof(*state));
+
+    fb_cmd_t cmds[] = {
+        FB_CMD_MATMUL_I8_I8(h, x, w, 1 << 16, n, d),
+        FB_CMD_ARGMAX_I32_PARTIAL(h, d, state),
+        FB_CMD_ACTIVATION(x, n, FB_ACT_RELU),
+        FB_CMD_VEC_ADD_I8(x, bias, n),
+    };
+    (void)cmds;
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        state->cursor = 0;
+#if BENCH_CMD_DIRECT
+        fb_matmul_i8_i8(h, x, w, 1 << 16, n, d);
+        (void)fb_argmax_i32_partial(h, d, state);
+        fb_activation(x, n, FB_ACT_RELU);
+        fb_vec_add_i8(x, bias, n);
+#else
+        (void)fb_cmd_run(cmds, sizeof(cmds) / sizeof(cmds[0]));
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
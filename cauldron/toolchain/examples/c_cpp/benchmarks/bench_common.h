@@ -30,6 +30,29 @@
 #define FB_ARB_SEGMENT 3
 #endif
 
+/*
+ * Bench shape knobs. A bench defines BENCH_DEFAULT_N / _D / _ITERS (after
+ * including this header) for the knobs it uses; any of them can be overridden
+ * per build, e.g. FB_FLAGS="... -DBENCH_N=256 -DBENCH_D=64 -DBENCH_ITERS=4".
+ * N is the input/vector length, D the output rows. bench_report.py sweeps
+ * these and diffs BENCH_ITERS=1/2 builds to split fixed per-call overhead from
+ * per-element cost.
+ */
+#ifndef BENCH_N
+#define BENCH_N BENCH_DEFAULT_N
+#endif
+
+#ifndef BENCH_D
+#define BENCH_D BENCH_DEFAULT_D
+#endif
+
+#ifndef BENCH_ITERS
+#define BENCH_ITERS BENCH_DEFAULT_ITERS
+#endif
+
+/* Repeat the timed body BENCH_ITERS times: BENCH_LOOP(i) { kernel(); } */
+#define BENCH_LOOP(i) for (int i = 0; i < (int)(BENCH_ITERS); i++)
+
 static inline void bench_heap_setup(void) {
     fb_heap_init_segments(FB_HEAP_SEGMENT, FB_HEAP_SEGMENT_COUNT,
                           FB_HEAP_OFFSET, FB_RAM_BYTES);
@@ -0,0 +1,92 @@
+#include "bench_common.h"
+
+#define TAG 0xB07D
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 16
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * Conv1d over BENCH_N positions x BENCH_CIN channels, BENCH_D filters of
+ * BENCH_K taps, stride 1, pad (k - 1) / 2, ReLU.
+ * 0 = im2col into a full buffer, then one fb_matmul_i8_i8 per position
+ * 1 = fb_conv1d_i8 (one staged window, no im2col buffer)
+ * 2 = fb_conv1d_i8 resumable, max_rows = out_len / 2
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+#ifndef BENCH_CIN
+#define BENCH_CIN 4
+#endif
+#ifndef BENCH_K
+#define BENCH_K 3
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_conv1d\n");
+
+    uint32_t len = BENCH_N;
+    uint32_t c_out = BENCH_D;
+    uint32_t n = BENCH_K * BENCH_CIN;
+    int8_t *x = (int8_t *)fb_malloc((size_t)len * BENCH_CIN);
+    int8_t *w = (int8_t *)fb_malloc((size_t)c_out * n);
+    int32_t *bias = (int32_t *)fb_malloc(sizeof(int32_t) * c_out);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * len * c_out);
+    void *win = fb_malloc(FB_CONV1D_WINDOW_BYTES(BENCH_K, BENCH_CIN));
+    if (!x || !w || !bias || !out || !win) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(x, (size_t)len * BENCH_CIN, 1);
+    bench_fill_i8(w, (size_t)c_out * n, 1);
+    bench_fill_i32(bias, c_out, -(int32_t)c_out);
+
+    fb_conv1d_cfg_t cfg = {(uint64_t)(uintptr_t)out, (uint64_t)(uintptr_t)x, (uint64_t)(uintptr_t)w,
+                           (uint64_t)(uintptr_t)bias, (uint64_t)(uintptr_t)win, FB_Q16_ONE,
+                           FB_Q16_ONE, len, BENCH_CIN, c_out, BENCH_K, 1, 1, (BENCH_K - 1) / 2,
+                           FB_ACT_RELU, 0};
+    uint32_t out_len = fb_conv1d_out_len(&cfg);
+    fb_print("%u positions x %u filters, window %u bytes\n", out_len, c_out, n);
+#if BENCH_OP == 0
+    uint8_t *cols = (uint8_t *)fb_malloc(FB_PREQUANT_BYTES(n) * out_len);
+    if (!cols) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+#endif
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 0
+        for (uint32_t p = 0; p < out_len; p++) {
+            int8_t *col = (int8_t *)(cols + (size_t)p * FB_PREQUANT_BYTES(n));
+            for (uint32_t j = 0; j < BENCH_K; j++) {
+                int32_t t = (int32_t)p - (BENCH_K - 1) / 2 + (int32_t)j;
+                for (uint32_t c = 0; c < BENCH_CIN; c++) {
+                    col[j * BENCH_CIN + c] = t >= 0 && t < (int32_t)len ? x[t * BENCH_CIN + c] : 0;
+                }
+            }
+            *fb_prequant_scale(col, n) = FB_Q16_ONE;
+        }
+        for (uint32_t p = 0; p < out_len; p++) {
+            int32_t *row = out + (size_t)p * c_out;
+            fb_matmul_i8_i8(row, cols + (size_t)p * FB_PREQUANT_BYTES(n), w, FB_Q16_ONE, n, c_out);
+            for (uint32_t o = 0; o < c_out; o++) {
+                int32_t v = row[o] + bias[o];
+                row[o] = v < 0 ? 0 : v;
+            }
+        }
+#elif BENCH_OP == 1
+        fb_conv1d_i8(&cfg);
+#else
+        fb_row_state_t st = {0, out_len > 1 ? out_len / 2 : 1};
+        cfg.state_ptr = (uint64_t)(uintptr_t)&st;
+        while (fb_conv1d_i8(&cfg) == 0) {
+        }
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
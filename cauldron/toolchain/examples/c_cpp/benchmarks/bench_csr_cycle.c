@@ -0,0 +1,71 @@
+#include "bench_common.h"
+#include "frostbite_graph.h"
+
+#define TAG 0xB073
+#define BENCH_DEFAULT_N 64 /* nodes */
+#define BENCH_DEFAULT_D 8  /* out-degree per node */
+#define BENCH_DEFAULT_ITERS 1
+
+#define BENCH_CYCLE_DIM 16
+#define BENCH_CYCLE_CAP 256
+
+/* Cycle length searched: 0 = 2 hops, 1 = 3 hops, 2 = 4 hops */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+/* Edges examined per call (0 = whole search in one call; needs --max-tx 0) */
+#ifndef BENCH_CYCLE_STEPS
+#define BENCH_CYCLE_STEPS 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_csr_cycle\n");
+
+    uint32_t nodes = BENCH_N;
+    uint32_t deg = BENCH_D < BENCH_N ? BENCH_D : BENCH_N;
+    uint32_t edges_n = nodes * deg;
+    FB_PREQUANT_T(BENCH_CYCLE_DIM) xq;
+    bench_fill_i8(xq.x, BENCH_CYCLE_DIM, 1);
+    xq.x_scale_q16 = FB_Q16_ONE;
+    int8_t *w = (int8_t *)fb_malloc((size_t)edges_n * BENCH_CYCLE_DIM);
+    fb_csr_edge_t *edges = (fb_csr_edge_t *)fb_malloc(sizeof(fb_csr_edge_t) * edges_n);
+    size_t bytes = fb_csr_bytes(nodes, edges_n, BENCH_CYCLE_DIM);
+    uint8_t *seg = (uint8_t *)fb_malloc(bytes);
+    int32_t *scores = (int32_t *)fb_malloc(sizeof(int32_t) * edges_n);
+    uint8_t *mask = (uint8_t *)fb_malloc(edges_n);
+    size_t state_bytes = fb_csr_cycle_state_bytes(nodes);
+    fb_csr_cycle_state_t *st = (fb_csr_cycle_state_t *)fb_malloc(state_bytes);
+    fb_csr_cycle_t *out = (fb_csr_cycle_t *)fb_malloc(sizeof(fb_csr_cycle_t) * BENCH_CYCLE_CAP);
+    if (!w || !edges || !seg || !scores || !mask || !st || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(w, (size_t)edges_n * BENCH_CYCLE_DIM, 1);
+    for (uint32_t e = 0; e < edges_n; e++) {
+        edges[e].src = e / deg;
+        edges[e].dst = (e / deg + 1u + (e % deg) * 7u) % nodes;
+        edges[e].weights = w + (size_t)e * BENCH_CYCLE_DIM;
+    }
+    fb_csr_t g;
+    if (fb_csr_build(seg, bytes, nodes, BENCH_CYCLE_DIM, edges, edges_n) != 0 ||
+        fb_csr_open(&g, seg, bytes) != 0) {
+        fb_print("csr build failed\n");
+        return 1;
+    }
+    (void)fb_csr_arb_score(&g, &xq, 0, scores, mask);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        if (fb_csr_cycle_init(st, state_bytes, &g, (uint32_t)i % nodes, 2u + BENCH_OP,
+                              BENCH_CYCLE_STEPS) != 0) {
+            fb_print("cycle init failed\n");
+            return 1;
+        }
+        while (!fb_csr_cycle_search(&g, scores, mask, 0, out, BENCH_CYCLE_CAP, st)) {
+        }
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
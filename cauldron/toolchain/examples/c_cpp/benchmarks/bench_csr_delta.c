@@ -0,0 +1,72 @@
+#include "bench_common.h"
+#include "frostbite_graph.h"
+
+#define TAG 0xB071
+#define BENCH_DEFAULT_N 256 /* nodes, out-degree BENCH_CSR_DEG */
+#define BENCH_DEFAULT_D 16  /* delta records per update */
+#define BENCH_DEFAULT_ITERS 1
+
+#define BENCH_CSR_DIM 16
+#define BENCH_CSR_DEG 8
+
+/* 0 = fb_csr_compact of a D-record log, 1 = full fb_csr_build of the edge list */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_csr_delta\n");
+
+    if (FB_GRAPH_SEGMENT == 0) {
+        fb_print("graph segment disabled\n");
+        return 0;
+    }
+
+    uint32_t nodes = BENCH_N;
+    uint32_t deg = BENCH_CSR_DEG < BENCH_N ? BENCH_CSR_DEG : BENCH_N;
+    uint32_t edges_n = nodes * deg;
+    uint32_t records = BENCH_D;
+    size_t csr_bytes = fb_csr_bytes(nodes, edges_n + records, BENCH_CSR_DIM);
+    size_t log_bytes = fb_csr_delta_bytes(records, BENCH_CSR_DIM);
+    uint8_t *base = (uint8_t *)(uintptr_t)FB_SEGMENT_ADDR(FB_GRAPH_SEGMENT, 0);
+    uint8_t *next = base + FB_ALIGN4(csr_bytes);
+    fb_csr_delta_header_t *log = (fb_csr_delta_header_t *)(next + FB_ALIGN4(csr_bytes));
+    fb_csr_edge_t *edges = (fb_csr_edge_t *)fb_malloc(sizeof(fb_csr_edge_t) * edges_n);
+    int8_t *w = (int8_t *)fb_malloc((size_t)edges_n * BENCH_CSR_DIM);
+    uint32_t *order = (uint32_t *)fb_malloc(sizeof(uint32_t) * (records + 1u));
+    if (!edges || !w || !order) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(w, (size_t)edges_n * BENCH_CSR_DIM, 1);
+    for (uint32_t e = 0; e < edges_n; e++) {
+        edges[e].src = e / deg;
+        edges[e].dst = (e / deg + 1u + e % deg) % nodes;
+        edges[e].weights = w + (size_t)e * BENCH_CSR_DIM;
+    }
+    fb_csr_t g;
+    if (fb_csr_build(base, csr_bytes, nodes, BENCH_CSR_DIM, edges, edges_n) != 0 ||
+        fb_csr_open(&g, base, csr_bytes) != 0) {
+        fb_print("csr build failed\n");
+        return 1;
+    }
+    /* half the records re-weight existing edges, half delete them */
+    fb_csr_delta_reset(log, g.generation, BENCH_CSR_DIM);
+    for (uint32_t r = 0; r < records; r++) {
+        const fb_csr_edge_t *e = &edges[(r * 7919u) % edges_n];
+        (void)fb_csr_delta_append(log, log_bytes, e->src, e->dst,
+                                  (r & 1u) ? FB_CSR_DELTA_DELETE : FB_CSR_DELTA_UPSERT, w);
+    }
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 1
+        (void)fb_csr_build(next, csr_bytes, nodes, BENCH_CSR_DIM, edges, edges_n);
+#else
+        (void)fb_csr_compact(next, csr_bytes, &g, log, log_bytes, order);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "bench_common.h"
+#include "frostbite_graph.h"
+
+#define TAG 0xB074
+#define BENCH_DEFAULT_N 256 /* nodes */
+#define BENCH_DEFAULT_D 8   /* out-degree per node */
+#define BENCH_DEFAULT_ITERS 1
+
+#define BENCH_GNN_DIM 16
+
+/* 0 = two layers in fb_csr_gnn, 1 = two fb_csr_aggregate passes + matmul per node */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+/* Nodes per fb_csr_gnn call (0 = all layers in one call; needs --max-tx 0) */
+#ifndef BENCH_GNN_ROWS
+#define BENCH_GNN_ROWS 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_csr_gnn\n");
+
+    uint32_t nodes = BENCH_N;
+    uint32_t deg = BENCH_D < BENCH_N ? BENCH_D : BENCH_N;
+    uint32_t edges_n = nodes * deg;
+    static const int8_t no_weights[4] = {0};
+    fb_csr_edge_t *edges = (fb_csr_edge_t *)fb_malloc(sizeof(fb_csr_edge_t) * edges_n);
+    size_t bytes = fb_csr_bytes(nodes, edges_n, 4);
+    uint8_t *seg = (uint8_t *)fb_malloc(bytes);
+    int8_t *feat = (int8_t *)fb_malloc((size_t)nodes * BENCH_GNN_DIM);
+    int8_t *w = (int8_t *)fb_malloc(BENCH_GNN_DIM * BENCH_GNN_DIM);
+    int32_t *buf0 = (int32_t *)fb_malloc(sizeof(int32_t) * nodes * BENCH_GNN_DIM);
+    int32_t *buf1 = (int32_t *)fb_malloc(sizeof(int32_t) * nodes * BENCH_GNN_DIM);
+    if (!edges || !seg || !feat || !w || !buf0 || !buf1) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(feat, (size_t)nodes * BENCH_GNN_DIM, 1);
+    bench_fill_i8(w, BENCH_GNN_DIM * BENCH_GNN_DIM, 3);
+    for (uint32_t e = 0; e < edges_n; e++) {
+        edges[e].src = e / deg;
+        edges[e].dst = (e / deg + 1u + (e % deg) * 5u) % nodes;
+        edges[e].weights = no_weights;
+    }
+    fb_csr_t g;
+    if (fb_csr_build(seg, bytes, nodes, 4, edges, edges_n) != 0 ||
+        fb_csr_open(&g, seg, bytes) != 0) {
+        fb_print("csr build failed\n");
+        return 1;
+    }
+
+#if BENCH_OP == 1
+    FB_PREQUANT_T(BENCH_GNN_DIM) xq;
+    int32_t sum[BENCH_GNN_DIM];
+    int8_t *mid = (int8_t *)fb_malloc((size_t)nodes * BENCH_GNN_DIM);
+    if (!mid) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+#else
+    fb_csr_gnn_state_t st;
+    fb_csr_gnn_cfg_t cfg = {0};
+    cfg.graph_ptr = (uint64_t)(uintptr_t)&g;
+    cfg.feat_ptr = (uint64_t)(uintptr_t)feat;
+    cfg.buf_ptr[0] = (uint64_t)(uintptr_t)buf0;
+    cfg.buf_ptr[1] = (uint64_t)(uintptr_t)buf1;
+    cfg.state_ptr = (uint64_t)(uintptr_t)&st;
+    cfg.feat_type = FB_CSR_FEAT_I8;
+    cfg.in_dim = BENCH_GNN_DIM;
+    cfg.num_layers = 2;
+    for (uint32_t l = 0; l < 2; l++) {
+        cfg.layers[l] = (fb_csr_gnn_layer_t){(uint64_t)(uintptr_t)w, FB_Q16_ONE, BENCH_GNN_DIM,
+                                             FB_ACT_RELU, FB_CSR_GNN_SELF};
+    }
+    void *scratch = fb_malloc(fb_csr_gnn_scratch_bytes(&cfg));
+    if (!scratch) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    cfg.scratch_ptr = (uint64_t)(uintptr_t)scratch;
+#endif
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 1
+        /* The old two-call shape: aggregate, matmul, requant to i8 features, repeat */
+        for (uint32_t l = 0; l < 2; l++) {
+            const int8_t *in = l ? mid : feat;
+            int32_t *out = l ? buf1 : buf0;
+            for (uint32_t v = 0; v < nodes; v++) {
+                (void)fb_csr_aggregate(&g, v, in, BENCH_GNN_DIM, sum);
+                for (uint32_t k = 0; k < BENCH_GNN_DIM; k++) {
+                    sum[k] += in[(size_t)v * BENCH_GNN_DIM + k];
+                }
+                (void)fb_quantize_i32_to_prequant(&xq, sum, BENCH_GNN_DIM, 0, 0);
+                fb_matmul_i8_i8(out + (size_t)v * BENCH_GNN_DIM, &xq, w, FB_Q16_ONE,
+                                BENCH_GNN_DIM, BENCH_GNN_DIM);
+            }
+            if (l == 0) {
+                for (size_t k = 0; k < (size_t)nodes * BENCH_GNN_DIM; k++) {
+                    int32_t v = buf0[k] < 0 ? 0 : buf0[k];
+                    mid[k] = (int8_t)(v > 127 ? 127 : v);
+                }
+            }
+        }
+#else
+        st = (fb_csr_gnn_state_t){0, BENCH_GNN_ROWS, 0};
+        while (fb_csr_gnn(&cfg) == 0) {
+        }
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
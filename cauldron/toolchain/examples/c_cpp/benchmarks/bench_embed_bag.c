@@ -0,0 +1,67 @@
+#include "bench_common.h"
+
+#define TAG 0xB07E
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 32
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * Pool BENCH_D rows of a BENCH_ROWS x BENCH_N int8 table into i32.
+ * 0 = per-ID guest loop (widening add, byte at a time)
+ * 1 = fb_embed_bag_i8, FB_EMBED_SUM
+ * 2 = fb_embed_bag_i8, FB_EMBED_MEAN
+ * 3 = fb_embed_bag_i8_partial, max_rows = count / 2
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+#ifndef BENCH_ROWS
+#define BENCH_ROWS 256
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_embed_bag\n");
+
+    uint32_t dim = BENCH_N;
+    uint32_t count = BENCH_D;
+    int8_t *table = (int8_t *)fb_malloc((size_t)BENCH_ROWS * dim);
+    uint32_t *ids = (uint32_t *)fb_malloc(sizeof(uint32_t) * count);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * dim);
+    void *acc = fb_malloc(FB_EMBED_ACC_BYTES(dim));
+    if (!table || !ids || !out || !acc) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(table, (size_t)BENCH_ROWS * dim, 1);
+    for (uint32_t i = 0; i < count; i++) {
+        ids[i] = (i * 97u + 13u) % BENCH_ROWS;
+    }
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(iter) {
+#if BENCH_OP == 0
+        for (uint32_t c = 0; c < dim; c++) {
+            out[c] = 0;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            const int8_t *row = table + (size_t)ids[i] * dim;
+            for (uint32_t c = 0; c < dim; c++) {
+                out[c] += row[c];
+            }
+        }
+#elif BENCH_OP == 1
+        fb_embed_bag_i8(out, table, dim, BENCH_ROWS, ids, count, FB_EMBED_SUM, acc);
+#elif BENCH_OP == 2
+        fb_embed_bag_i8(out, table, dim, BENCH_ROWS, ids, count, FB_EMBED_MEAN, acc);
+#else
+        fb_row_state_t st = {0, count > 1 ? count / 2 : 1};
+        while (fb_embed_bag_i8_partial(out, table, dim, BENCH_ROWS, ids, count, FB_EMBED_SUM, acc,
+                                       &st) == 0) {
+        }
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
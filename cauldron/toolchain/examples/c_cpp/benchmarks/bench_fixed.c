@@ -0,0 +1,117 @@
+#include "bench_common.h"
+
+#define TAG 0xB069
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_ITERS 1
+
+/* 0 mul, 1 div, 2 sqrt, 3 exp, 4 log, 5 sigmoid, 6 tanh */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+/* 0 = frostbite_fixed.h Q16, 1 = the same op through the soft-float builtins */
+#ifndef BENCH_FIXED_FLOAT
+#define BENCH_FIXED_FLOAT 0
+#endif
+
+#if BENCH_FIXED_FLOAT
+/* Called directly so fb-cc's native F instructions do not hide the soft path. */
+float __addsf3(float a, float b);
+float __subsf3(float a, float b);
+float __mulsf3(float a, float b);
+float __divsf3(float a, float b);
+
+static float soft_sigmoid(float x) {
+    return __divsf3(1.0f, __addsf3(1.0f, fb_expf(-x)));
+}
+
+/* ln(x) = 2 atanh((x - 1) / (x + 1)), four series terms */
+static float soft_log(float x) {
+    float t = __divsf3(__subsf3(x, 1.0f), __addsf3(x, 1.0f));
+    float t2 = __mulsf3(t, t);
+    float p = __addsf3(__mulsf3(t2, 0.142857f), 0.2f);
+    p = __addsf3(__mulsf3(p, t2), 0.333333f);
+    p = __addsf3(__mulsf3(p, t2), 1.0f);
+    return __mulsf3(__mulsf3(p, t), 2.0f);
+}
+
+static float bench_op(float a, float b) {
+    (void)a;
+    (void)b;
+#if BENCH_OP == 0
+    return __mulsf3(a, b);
+#elif BENCH_OP == 1
+    return __divsf3(a, b);
+#elif BENCH_OP == 2
+    return fb_sqrtf(a);
+#elif BENCH_OP == 3
+    return fb_expf(b);
+#elif BENCH_OP == 4
+    return soft_log(a);
+#elif BENCH_OP == 5
+    return soft_sigmoid(b);
+#else
+    return __subsf3(__mulsf3(soft_sigmoid(__mulsf3(b, 2.0f)), 2.0f), 1.0f);
+#endif
+}
+#else
+static fb_q16_t bench_op(fb_q16_t a, fb_q16_t b) {
+    (void)a;
+    (void)b;
+#if BENCH_OP == 0
+    return fb_q16_mul(a, b);
+#elif BENCH_OP == 1
+    return fb_q16_div(a, b);
+#elif BENCH_OP == 2
+    return fb_q16_sqrt(a);
+#elif BENCH_OP == 3
+    return fb_q16_exp(b);
+#elif BENCH_OP == 4
+    return fb_q16_log(a);
+#elif BENCH_OP == 5
+    return fb_q16_sigmoid(b);
+#else
+    return fb_q16_tanh(b);
+#endif
+}
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_fixed\n");
+
+#if BENCH_FIXED_FLOAT
+    typedef float elem_t;
+#else
+    typedef fb_q16_t elem_t;
+#endif
+    size_t n = BENCH_N;
+    elem_t *a = (elem_t *)fb_malloc(sizeof(elem_t) * n);
+    elem_t *b = (elem_t *)fb_malloc(sizeof(elem_t) * n);
+    elem_t *out = (elem_t *)fb_malloc(sizeof(elem_t) * n);
+    if (!a || !b || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    /* a in [1, 1 + n/16), b in [-2, 2) */
+    for (size_t i = 0; i < n; i++) {
+        int32_t ai = FB_Q16_ONE + (int32_t)i * 4096;
+        int32_t bi = (int32_t)((i * 2654435761u) & 0x3FFFF) - 2 * FB_Q16_ONE;
+#if BENCH_FIXED_FLOAT
+        a[i] = (float)ai / 65536.0f;
+        b[i] = (float)bi / 65536.0f;
+#else
+        a[i] = ai;
+        b[i] = bi;
+#endif
+    }
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(it) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = bench_op(a[i], b[i]);
+        }
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "bench_common.h"
 
 #define TAG 0xB040
+#define BENCH_DEFAULT_ITERS 1
 
 int main(void) {
     bench_heap_setup();
@@ -21,8 +22,10 @@ int main(void) {
     }
     uint64_t graph_idx = (uint64_t)(FB_GRAPH_SEGMENT - 1u);
 
-    bench_log(TAG, 0, 1);
-    (void)fb_graph_search(input, graph_idx, output, 0, 0);
-    bench_log(TAG, 1, 1);
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        (void)fb_graph_search(input, graph_idx, output, 0, 0);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
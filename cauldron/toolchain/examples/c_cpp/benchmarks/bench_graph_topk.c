@@ -0,0 +1,98 @@
+#include "bench_common.h"
+#include "frostbite_graph.h"
+
+#define TAG 0xB072
+#define BENCH_DEFAULT_N 64  /* nodes */
+#define BENCH_DEFAULT_D 256 /* out-degree per node */
+#define BENCH_DEFAULT_ITERS 1
+
+#define BENCH_TOPK_DIM 16
+#define BENCH_TOPK_K 8
+
+/* 0 = fb_csr_graph_search (every hit), 1 = fb_csr_graph_search_topk,
+ * 2 = fb_graph_search_topk over the flat GRPH list */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_graph_topk\n");
+
+    if (FB_GRAPH_SEGMENT == 0) {
+        fb_print("graph segment disabled\n");
+        return 0;
+    }
+
+    uint32_t nodes = BENCH_N;
+    uint32_t deg = BENCH_D;
+    uint32_t edges_n = nodes * deg;
+    uint8_t *base = (uint8_t *)(uintptr_t)FB_SEGMENT_ADDR(FB_GRAPH_SEGMENT, 0);
+    FB_PREQUANT_T(BENCH_TOPK_DIM) xq;
+    bench_fill_i8(xq.x, BENCH_TOPK_DIM, 1);
+    xq.x_scale_q16 = FB_Q16_ONE;
+    fb_graph_hit_t top[BENCH_TOPK_K];
+    int8_t *w = (int8_t *)fb_malloc((size_t)edges_n * BENCH_TOPK_DIM);
+    if (!w) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(w, (size_t)edges_n * BENCH_TOPK_DIM, 1);
+
+#if BENCH_OP == 2
+    fb_graph_hit_t *hits = (fb_graph_hit_t *)fb_malloc(sizeof(fb_graph_hit_t) * edges_n);
+    if (!hits) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    uint32_t *hdr = (uint32_t *)base;
+    hdr[0] = 0x48505247; /* GRPH */
+    hdr[1] = edges_n;
+    hdr[2] = BENCH_TOPK_DIM;
+    hdr[3] = 0;
+    uint8_t *rec = base + 16;
+    for (uint32_t e = 0; e < edges_n; e++) {
+        uint32_t target = e % deg;
+        fb_memcpy(rec, &target, sizeof(target));
+        fb_memcpy(rec + 4, w + (size_t)e * BENCH_TOPK_DIM, BENCH_TOPK_DIM);
+        rec += 4 + BENCH_TOPK_DIM;
+    }
+    uint64_t graph_idx = (uint64_t)(FB_GRAPH_SEGMENT - 1u);
+#else
+    fb_graph_hit_t *hits = (fb_graph_hit_t *)fb_malloc(sizeof(fb_graph_hit_t) * deg);
+    fb_csr_edge_t *edges = (fb_csr_edge_t *)fb_malloc(sizeof(fb_csr_edge_t) * edges_n);
+    if (!hits || !edges) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    /* Targets may exceed `nodes`, so size the node table by degree too. */
+    uint32_t node_count = nodes > deg ? nodes : deg;
+    for (uint32_t e = 0; e < edges_n; e++) {
+        edges[e].src = e / deg;
+        edges[e].dst = e % deg;
+        edges[e].weights = w + (size_t)e * BENCH_TOPK_DIM;
+    }
+    size_t bytes = fb_csr_bytes(node_count, edges_n, BENCH_TOPK_DIM);
+    fb_csr_t g;
+    if (fb_csr_build(base, bytes, node_count, BENCH_TOPK_DIM, edges, edges_n) != 0 ||
+        fb_csr_open(&g, base, bytes) != 0) {
+        fb_print("csr build failed\n");
+        return 1;
+    }
+#endif
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 2
+        (void)fb_graph_search_topk(xq.x, graph_idx, hits, top, BENCH_TOPK_K, 0, 0);
+#elif BENCH_OP == 1
+        (void)hits;
+        (void)fb_csr_graph_search_topk(&g, (uint32_t)i % nodes, &xq, top, BENCH_TOPK_K, 0, NULL);
+#else
+        (void)top;
+        (void)fb_csr_graph_search(&g, (uint32_t)i % nodes, &xq, hits, 0, NULL);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "bench_common.h"
+#include "frostbite.hpp"
+
+#define TAG 0xB077
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 16
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * One quantize -> MATMUL_I8_I8 -> ReLU layer.
+ * 0 = C wrappers, shape read from a layer descriptor at run time
+ * 1 = frostbite.hpp, shape in the types (n / d fold into the ecall setup)
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+struct layer_desc_t {
+    uint32_t n;
+    uint32_t d;
+};
+
+static fb::Tensor<int32_t, BENCH_N> in;
+static fb::Prequant<BENCH_N> xq;
+static fb::Matrix<int8_t, BENCH_D, BENCH_N> w;
+static fb::Tensor<int32_t, BENCH_D> out;
+static volatile layer_desc_t desc = {BENCH_N, BENCH_D};
+
+int main() {
+    fb_print("bench_hpp_matmul\n");
+    bench_fill_i32(in.ptr(), BENCH_N, -(int32_t)BENCH_N);
+    bench_fill_i8(w.ptr(), sizeof(w.data), 1);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 1
+        fb::quantize(xq, in);
+        fb::matmul_i8_i8(out, xq, w, 1 << 16);
+        fb::relu(out);
+#else
+        size_t n = desc.n;
+        size_t d = desc.d;
+        fb_quantize_i32_to_prequant(&xq, in.ptr(), n, 0, 0);
+        fb_matmul_i8_i8(out.ptr(), &xq, w.ptr(), 1 << 16, n, d);
+        for (size_t r = 0; r < d; r++) {
+            out[r] = out[r] < 0 ? 0 : out[r];
+        }
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,453 @@
+#include "bench_common.h"
+
+#define TAG 0xB084
+#define BENCH_DEFAULT_N 256
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 1
+
+/*
+ * Differential test for the integer kernels: each op fills deterministic
+ * inputs (xorshift, seeded by op/n/d), runs the syscall once, runs a
+ * portable C reference and compares, then times BENCH_ITERS syscalls.
+ * Exact ops must match bit for bit. SOFTMAX_I32 (f32 math in the VM) may be
+ * 2 LSB off the fb_q16_exp reference, SILU_MUL_I32 (the VM's own sigmoid)
+ * within |a * b| / 2^22 + 2. A mismatch prints FAIL and exits 1 before the
+ * timed loop; every op prints one line with an FNV-1a checksum of the
+ * kernel output, which bench_report.py compares against --baseline.
+ *
+ * 0 = MATMUL_I8_I8          5 = MATMUL_I8_I32       10 = WEIGHTED_SUM_I32
+ * 1 = MATMUL_I8_I8_PARTIAL  6 = RMSNORM_I32         11 = ARGMAX_I32_PARTIAL
+ * 2 = MATMUL_I8_I8_QKV      7 = SOFTMAX_I32         12 = DOT_I8
+ * 3 = MATMUL_I8_I8_W1W3     8 = SILU_MUL_I32        13 = VEC_ADD_I8
+ * 4 = MATMUL_I8_I8_W1W3_SILU 9 = DOT_I32            14 = ACTIVATION (ReLU)
+ * -1 = check every op, untimed (the default build)
+ */
+#ifndef BENCH_OP
+#define BENCH_OP -1
+#endif
+
+#define DIFF_OPS 15u
+#define DIFF_SOFTMAX_TOL 2u
+
+typedef struct {
+    uint32_t n, d, d_kv;
+    int8_t *x;       /* prequant buffer, n activations */
+    int8_t *w[3];    /* d x n, d x n, d_kv x n (Q/W1, K/W3, V) */
+    uint32_t w_scale[3];
+    int32_t *a, *b;  /* i32 inputs, n each (a is the in-place operand) */
+    int8_t *a8, *b8; /* i8 inputs, n each */
+    int16_t *norm;   /* RMSNORM_I32 weights: gain, w[n] */
+    int32_t *got[3];
+    int32_t *want[3];
+    int8_t *got8, *want8;
+    fb_row_state_t *rows;
+    fb_matmul_qkv_cfg_t qkv;
+    fb_matmul_w1w3_cfg_t w1w3;
+    fb_matmul_w1w3_silu_cfg_t silu;
+} diff_ctx_t;
+
+static uint32_t diff_rng;
+
+static uint32_t diff_next(void) {
+    diff_rng ^= diff_rng << 13;
+    diff_rng ^= diff_rng >> 17;
+    diff_rng ^= diff_rng << 5;
+    return diff_rng;
+}
+
+/* uniform in [lo, hi], hi - lo < UINT32_MAX */
+static int32_t diff_range(int32_t lo, int32_t hi) {
+    uint32_t span = (uint32_t)hi - (uint32_t)lo + 1u;
+    return (int32_t)((uint32_t)lo + diff_next() % span);
+}
+
+static void diff_fill_i8(int8_t *buf, uint32_t len, int32_t lo, int32_t hi) {
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = (int8_t)diff_range(lo, hi);
+    }
+}
+
+static void diff_fill_i32(int32_t *buf, uint32_t len, int32_t lo, int32_t hi) {
+    for (uint32_t i = 0; i < len; i++) {
+        buf[i] = diff_range(lo, hi);
+    }
+}
+
+/* ── Portable references ───────────────────────────────────────── */
+
+static int32_t ref_dot_i8(const int8_t *a, const int8_t *b, uint32_t n) {
+    int32_t s = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        s += (int32_t)a[i] * b[i];
+    }
+    return s;
+}
+
+/* out[r] = (dot(x, w[r]) * w_scale * x_scale) >> 32 */
+static void ref_matmul_i8_i8(int32_t *out, const int8_t *x, const int8_t *w,
+                             uint32_t w_scale, uint32_t n, uint32_t d) {
+    int64_t x_scale = *fb_prequant_scale((void *)(uintptr_t)x, n);
+    for (uint32_t r = 0; r < d; r++) {
+        int64_t dot = ref_dot_i8(x, w + (size_t)r * n, n);
+        out[r] = (int32_t)((dot * w_scale * x_scale) >> 32);
+    }
+}
+
+/* MATMUL_I8_I8_W1W3_SILU gates with a hard SiLU: a * clamp((a + 4) / 8, 0, 1) */
+static int32_t ref_hard_silu_mul(int32_t a, int32_t b) {
+    int64_t gate = ((int64_t)a + 4 * FB_Q16_ONE) >> 3;
+    gate = gate < 0 ? 0 : gate > FB_Q16_ONE ? FB_Q16_ONE : gate;
+    return (int32_t)((((a * gate) >> 16) * b) >> 16);
+}
+
+static int32_t ref_silu_mul(int32_t a, int32_t b) {
+    return (int32_t)(((((int64_t)a * fb_q16_sigmoid(a)) >> 16) * b) >> 16);
+}
+
+static void ref_rmsnorm_i32(int32_t *out, const int32_t *x, const int16_t *w, uint32_t n) {
+    uint64_t sumsq = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        sumsq += (uint64_t)((int64_t)x[i] * x[i]);
+    }
+    int32_t rms = (int32_t)fb_isqrt64(sumsq / n);
+    uint64_t kmax = fb_isqrt64(n);
+    for (uint32_t i = 0; i < n; i++) {
+        int64_t k = fb_rmsnorm_i32_k(x[i], sumsq, rms, kmax, n);
+        out[i] = (int32_t)((k * w[0] * w[1 + i]) >> 24);
+    }
+}
+
+static void ref_softmax_i32(int32_t *out, const int32_t *x, uint32_t n) {
+    int32_t max = INT32_MIN;
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        max = x[i] > max ? x[i] : max;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = fb_q16_exp(fb_q16_sub_sat(x[i], max));
+        sum += out[i];
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        out[i] = (int32_t)(((int64_t)out[i] << 16) / sum);
+    }
+}
+
+/* ── Cases ─────────────────────────────────────────────────────── */
+
+static void diff_prepare(diff_ctx_t *c, uint32_t op) {
+    uint32_t n = c->n;
+    diff_rng = 0x9E3779B9u ^ (op * 0x85EBCA6Bu) ^ (n << 16) ^ c->d;
+    diff_fill_i8(c->x, n, -127, 127);
+    *fb_prequant_scale(c->x, n) = diff_range(1 << 10, 1 << 17);
+    for (uint32_t k = 0; k < 3; k++) {
+        diff_fill_i8(c->w[k], (k == 2 ? c->d_kv : c->d) * n, -127, 127);
+        c->w_scale[k] = (uint32_t)diff_range(1 << 10, 1 << 17);
+    }
+    c->qkv.wq_scale = c->w1w3.w1_scale = c->silu.w1_scale = c->w_scale[0];
+    c->qkv.wk_scale = c->w1w3.w3_scale = c->silu.w3_scale = c->w_scale[1];
+    c->qkv.wv_scale = c->w_scale[2];
+    diff_fill_i8(c->a8, n, -128, 127);
+    diff_fill_i8(c->b8, n, -128, 127);
+    fb_memcpy(c->got8, c->a8, n);
+    c->norm[0] = (int16_t)diff_range(1 << 12, INT16_MAX);
+    for (uint32_t i = 0; i < n; i++) {
+        c->norm[1 + i] = (int16_t)diff_range(INT16_MIN, INT16_MAX);
+    }
+
+    int32_t lim = 1 << 20;
+    if (op == 5) {
+        lim = 1 << 12;
+    } else if (op == 7 || op == 8) {
+        lim = 8 * FB_Q16_ONE; /* logits / gate pre-activations in [-8, 8] */
+    } else if (op == 11) {
+        lim = INT32_MAX;
+    }
+    diff_fill_i32(c->a, n, -lim, lim);
+    diff_fill_i32(c->b, n, -(1 << 18), 1 << 18);
+    fb_memcpy(c->got[0], c->a, sizeof(int32_t) * n);
+}
+
+static void diff_kernel(diff_ctx_t *c, uint32_t op) {
+    uint32_t n = c->n;
+    uint32_t d = c->d;
+    switch (op) {
+    case 0:
+        fb_matmul_i8_i8(c->got[0], c->x, c->w[0], (int32_t)c->w_scale[0], n, d);
+        break;
+    case 1:
+        c->rows->cursor = 0;
+        c->rows->max_rows = d;
+        fb_matmul_i8_i8_partial(c->got[0], c->x, c->w[0], (int32_t)c->w_scale[0], n, d, c->rows);
+        break;
+    case 2:
+        c->rows->cursor = 0;
+        c->rows->max_rows = 0;
+        fb_matmul_i8_i8_qkv(&c->qkv);
+        break;
+    case 3:
+        c->rows->cursor = 0;
+        c->rows->max_rows = 0;
+        fb_matmul_i8_i8_w1w3(&c->w1w3);
+        break;
+    case 4:
+        c->rows->cursor = 0;
+        c->rows->max_rows = 0;
+        fb_matmul_i8_i8_w1w3_silu(&c->silu);
+        break;
+    case 5:
+        fb_matmul_i8_i32(c->got[0], c->a, c->w[0], (int32_t)c->w_scale[0], n, d);
+        break;
+    case 6:
+        fb_rmsnorm_i32(c->got[0], c->a, (uint64_t)(uintptr_t)c->norm, n);
+        break;
+    case 7:
+        fb_softmax_i32(c->got[0], n);
+        break;
+    case 8:
+        fb_silu_mul_i32(c->got[0], c->b, n);
+        break;
+    case 9:
+        c->got[0][0] = (int32_t)fb_dot_i32(c->a, c->b, n, 20);
+        break;
+    case 10:
+        fb_weighted_sum_i32(c->got[0], c->b, -12345, n, 12);
+        break;
+    case 11: {
+        fb_argmax_i32_state_t st = {0, 0, INT32_MIN, 0};
+        c->got[0][0] = (int32_t)fb_argmax_i32_partial(c->a, n, &st);
+        break;
+    }
+    case 12:
+        c->got[0][0] = fb_dot_i8(c->a8, c->b8, n);
+        break;
+    case 13:
+        fb_vec_add_i8(c->got8, c->b8, n);
+        break;
+    default:
+        fb_activation(c->got8, n, FB_ACT_RELU);
+        break;
+    }
+}
+
+static void diff_reference(diff_ctx_t *c, uint32_t op) {
+    uint32_t n = c->n;
+    uint32_t d = c->d;
+    int32_t *out = c->want[0];
+    switch (op) {
+    case 0:
+    case 1:
+        ref_matmul_i8_i8(out, c->x, c->w[0], c->w_scale[0], n, d);
+        break;
+    case 2:
+        for (uint32_t k = 0; k < 3; k++) {
+            ref_matmul_i8_i8(c->want[k], c->x, c->w[k], c->w_scale[k], n, k ? c->d_kv : d);
+        }
+        break;
+    case 3:
+    case 4:
+        ref_matmul_i8_i8(c->want[0], c->x, c->w[0], c->w_scale[0], n, d);
+        ref_matmul_i8_i8(c->want[1], c->x, c->w[1], c->w_scale[1], n, d);
+        if (op == 4) {
+            for (uint32_t r = 0; r < d; r++) {
+                out[r] = ref_hard_silu_mul(c->want[0][r], c->want[1][r]);
+            }
+        }
+        break;
+    case 5:
+        for (uint32_t r = 0; r < d; r++) {
+            int64_t dot = 0;
+            for (uint32_t i = 0; i < n; i++) {
+                dot += (int64_t)c->a[i] * c->w[0][(size_t)r * n + i];
+            }
+            out[r] = (int32_t)((dot * c->w_scale[0]) >> 16);
+        }
+        break;
+    case 6:
+        ref_rmsnorm_i32(out, c->a, c->norm, n);
+        break;
+    case 7:
+        ref_softmax_i32(out, c->a, n);
+        break;
+    case 8:
+        for (uint32_t i = 0; i < n; i++) {
+            out[i] = ref_silu_mul(c->a[i], c->b[i]);
+        }
+        break;
+    case 9: {
+        int64_t s = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            s += (int64_t)c->a[i] * c->b[i];
+        }
+        out[0] = (int32_t)(s >> 20);
+        break;
+    }
+    case 10:
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t v = (uint32_t)(((int64_t)-12345 * c->b[i]) >> 12);
+            out[i] = (int32_t)((uint32_t)c->a[i] + v);
+        }
+        break;
+    case 11:
+        out[0] = 0;
+        for (uint32_t i = 1; i < n; i++) {
+            out[0] = c->a[i] > c->a[out[0]] ? (int32_t)i : out[0];
+        }
+        break;
+    case 12:
+        out[0] = ref_dot_i8(c->a8, c->b8, n);
+        break;
+    case 13:
+        for (uint32_t i = 0; i < n; i++) {
+            c->want8[i] = (int8_t)(uint8_t)((uint8_t)c->a8[i] + (uint8_t)c->b8[i]);
+        }
+        break;
+    default:
+        for (uint32_t i = 0; i < n; i++) {
+            c->want8[i] = c->a8[i] < 0 ? 0 : c->a8[i];
+        }
+        break;
+    }
+}
+
+/* Output vectors of `op` and the length of vector k */
+static uint32_t diff_outputs(const diff_ctx_t *c, uint32_t op, uint32_t k, uint32_t *len) {
+    *len = c->n;
+    if (op <= 5) {
+        *len = op == 2 && k ? c->d_kv : c->d;
+    } else if (op == 9 || op == 11 || op == 12) {
+        *len = 1;
+    }
+    return op == 2 ? 3u : op == 3 ? 2u : 1u;
+}
+
+static uint32_t diff_tolerance(const diff_ctx_t *c, uint32_t op, uint32_t i) {
+    if (op == 7) {
+        return DIFF_SOFTMAX_TOL;
+    }
+    if (op == 8) {
+        uint64_t ab = (uint64_t)fb_abs_u32(c->a[i]) * fb_abs_u32(c->b[i]);
+        return (uint32_t)(ab >> 22) + 2u;
+    }
+    return 0;
+}
+
+static uint32_t diff_fnv(uint32_t h, const void *p, size_t len) {
+    const uint8_t *s = (const uint8_t *)p;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ s[i]) * 16777619u;
+    }
+    return h;
+}
+
+/* Run op once against its reference and print its checksum; 0 if it matches */
+static int diff_check(diff_ctx_t *c, uint32_t op) {
+    int byte = op >= 13;
+    uint32_t len = 0;
+    uint32_t vecs = diff_outputs(c, op, 0, &len);
+    uint32_t bad = 0;
+    uint32_t max_err = 0;
+    uint32_t sum = 2166136261u;
+
+    diff_prepare(c, op);
+    diff_reference(c, op);
+    diff_kernel(c, op);
+    for (uint32_t k = 0; k < vecs; k++) {
+        (void)diff_outputs(c, op, k, &len);
+        sum = byte ? diff_fnv(sum, c->got8, len) : diff_fnv(sum, c->got[k], 4u * len);
+        for (uint32_t i = 0; i < len; i++) {
+            int32_t got = byte ? c->got8[i] : c->got[k][i];
+            int32_t want = byte ? c->want8[i] : c->want[k][i];
+            uint32_t err = fb_abs_u32((int32_t)((uint32_t)got - (uint32_t)want));
+            max_err = err > max_err ? err : max_err;
+            if (err > diff_tolerance(c, op, i) && bad++ == 0) {
+                fb_print("FAIL: op %u out %u [%u] got %d want %d\n", op, k, i, got, want);
+            }
+        }
+    }
+    fb_print("kernel_diff op=%u n=%u d=%u checksum=%x max_err=%u mismatches=%u\n", op,
+             c->n, c->d, sum, max_err, bad);
+    return bad != 0;
+}
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_kernel_diff\n");
+
+    diff_ctx_t c;
+    fb_memset(&c, 0, sizeof(c));
+    c.n = BENCH_N;
+    c.d = BENCH_D;
+    c.d_kv = c.d >= 4 ? c.d / 4 : 1; /* grouped K/V heads */
+    uint32_t vec = c.n > c.d ? c.n : c.d;
+    c.x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(c.n));
+    c.a = (int32_t *)fb_malloc(sizeof(int32_t) * c.n);
+    c.b = (int32_t *)fb_malloc(sizeof(int32_t) * c.n);
+    c.a8 = (int8_t *)fb_malloc(c.n);
+    c.b8 = (int8_t *)fb_malloc(c.n);
+    c.got8 = (int8_t *)fb_malloc(c.n);
+    c.want8 = (int8_t *)fb_malloc(c.n);
+    c.norm = (int16_t *)fb_malloc(sizeof(int16_t) * (c.n + 1u));
+    c.rows = (fb_row_state_t *)fb_malloc(sizeof(fb_row_state_t));
+    int ok = c.x && c.a && c.b && c.a8 && c.b8 && c.got8 && c.want8 && c.norm && c.rows;
+    for (uint32_t k = 0; k < 3; k++) {
+        c.w[k] = (int8_t *)fb_malloc((size_t)c.n * (k == 2 ? c.d_kv : c.d));
+        c.got[k] = (int32_t *)fb_malloc(sizeof(int32_t) * vec);
+        c.want[k] = (int32_t *)fb_malloc(sizeof(int32_t) * vec);
+        ok = ok && c.w[k] && c.got[k] && c.want[k];
+    }
+    if (!ok) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+
+    /* QKV: Q = w[0], K = the first d_kv rows of w[1], V = w[2]; W1/W3 = w[0] / w[1] */
+    c.qkv.out_q = (uint64_t)(uintptr_t)c.got[0];
+    c.qkv.out_k = (uint64_t)(uintptr_t)c.got[1];
+    c.qkv.out_v = (uint64_t)(uintptr_t)c.got[2];
+    c.qkv.x_ptr = (uint64_t)(uintptr_t)c.x;
+    c.qkv.wq_ptr = (uint64_t)(uintptr_t)c.w[0];
+    c.qkv.wk_ptr = (uint64_t)(uintptr_t)c.w[1];
+    c.qkv.wv_ptr = (uint64_t)(uintptr_t)c.w[2];
+    c.qkv.n = c.n;
+    c.qkv.d_q = c.d;
+    c.qkv.d_k = c.d_kv;
+    c.qkv.d_v = c.d_kv;
+    c.qkv.state_ptr = (uint64_t)(uintptr_t)c.rows;
+    c.w1w3.out_a = c.qkv.out_q;
+    c.w1w3.out_b = c.qkv.out_k;
+    c.w1w3.x_ptr = c.qkv.x_ptr;
+    c.w1w3.w1_ptr = c.qkv.wq_ptr;
+    c.w1w3.w3_ptr = c.qkv.wk_ptr;
+    c.w1w3.n = c.n;
+    c.w1w3.d = c.d;
+    c.w1w3.state_ptr = c.qkv.state_ptr;
+    c.silu.out_ptr = c.qkv.out_q;
+    c.silu.x_ptr = c.qkv.x_ptr;
+    c.silu.w1_ptr = c.qkv.wq_ptr;
+    c.silu.w3_ptr = c.qkv.wk_ptr;
+    c.silu.n = c.n;
+    c.silu.d = c.d;
+    c.silu.state_ptr = c.qkv.state_ptr;
+
+#if BENCH_OP < 0
+    int failed = 0;
+    for (uint32_t op = 0; op < DIFF_OPS; op++) {
+        failed += diff_check(&c, op);
+    }
+    if (failed) {
+        fb_print("FAILURES: %d\n", failed);
+        return 1;
+    }
+    fb_print("OK\n");
+#else
+    if (diff_check(&c, (uint32_t)(BENCH_OP))) {
+        return 1;
+    }
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(iter) {
+        diff_kernel(&c, (uint32_t)(BENCH_OP));
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+#endif
+    return 0;
+}
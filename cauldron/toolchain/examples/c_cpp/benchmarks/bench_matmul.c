@@ -1,14 +1,16 @@
 #include "bench_common.h"
 
 #define TAG 0xB010
-#define ITERS 2
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 2
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_matmul\n");
 
-    size_t n = 4;
-    size_t d = 4;
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
     float *x = (float *)fb_malloc(sizeof(float) * n);
     float *w = (float *)fb_malloc(sizeof(float) * n * d);
     float *out = (float *)fb_malloc(sizeof(float) * d);
@@ -19,10 +21,10 @@ int main(void) {
     bench_fill_f32(x, n, 0.1f);
     bench_fill_f32(w, n * d, 0.2f);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_matmul(out, x, w, n, d);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,48 @@
+#include "bench_common.h"
+
+#define TAG 0xB063
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 16
+#define BENCH_DEFAULT_ITERS 2
+
+#ifndef BENCH_ALIGN
+#define BENCH_ALIGN 64
+#endif
+
+/* Same int8 matmul on 64-byte aligned buffers (phases 0/1) and on buffers
+ * offset by one byte (phases 2/3) to expose host-side alignment fast paths. */
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_matmul_aligned\n");
+
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_aligned_alloc(BENCH_ALIGN, n + 4 + BENCH_ALIGN);
+    int8_t *w = (int8_t *)fb_aligned_alloc(BENCH_ALIGN, n * d + BENCH_ALIGN);
+    int32_t *out = (int32_t *)fb_aligned_alloc(BENCH_ALIGN, sizeof(int32_t) * d);
+    if (!x || !w || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    int8_t *x_u = x + 1;
+    int8_t *w_u = w + 1;
+    int32_t x_scale = 1 << 16;
+    bench_fill_i8(x, n + 1, 1);
+    bench_fill_i8(w, n * d + 1, 1);
+    fb_memcpy(x + n, &x_scale, sizeof(x_scale));
+    fb_memmove(x_u + 1, x_u, n - 1);
+    fb_memcpy(x_u + n, &x_scale, sizeof(x_scale));
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        fb_matmul_i8_i8(out, x, w, (1 << 16), n, d);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+
+    bench_log(TAG, 2, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        fb_matmul_i8_i8(out, x_u, w_u, (1 << 16), n, d);
+    }
+    bench_log(TAG, 3, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "bench_common.h"
+
+#define TAG 0xB07B
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 32
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * BENCH_M inputs against one d x n int8 matrix, m x d outputs per iteration.
+ * 0 = one fb_matmul_i8_i8 per input (m kernel calls)
+ * 1 = fb_matmul_i8_i8_batch (min(m, d) kernel calls)
+ * 2 = fb_matmul_i8_i32_batch (m kernel calls)
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+#ifndef BENCH_M
+#define BENCH_M 16
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_matmul_batch\n");
+
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    uint32_t m = BENCH_M;
+    int32_t *src = (int32_t *)fb_malloc(sizeof(int32_t) * n * m);
+    int8_t *w = (int8_t *)fb_malloc((size_t)n * d);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d * m);
+    uint8_t *batch = (uint8_t *)fb_malloc(FB_BATCH_BYTES(n, m));
+    uint8_t *per_input = (uint8_t *)fb_malloc(FB_PREQUANT_BYTES(n) * m);
+    void *scratch = fb_malloc(FB_MATMUL_BATCH_SCRATCH_BYTES(n, m));
+    if (!src || !w || !out || !batch || !per_input || !scratch) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i32(src, (size_t)n * m, -(int32_t)n);
+    bench_fill_i8(w, (size_t)n * d, 1);
+    fb_quantize_i32_to_batch(batch, src, n, m, 0, 0);
+    for (uint32_t i = 0; i < m; i++) {
+        fb_quantize_i32_to_prequant(per_input + i * FB_PREQUANT_BYTES(n), src + i * n, n, 0, 0);
+    }
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 0
+        for (uint32_t b = 0; b < m; b++) {
+            fb_matmul_i8_i8(out + b * d, per_input + b * FB_PREQUANT_BYTES(n), w, 1 << 16, n, d);
+        }
+#elif BENCH_OP == 1
+        fb_matmul_i8_i8_batch(out, batch, w, 1 << 16, n, d, m, scratch);
+#else
+        fb_matmul_i8_i32_batch(out, src, w, 1 << 16, n, d, m);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "bench_common.h"
+
+#define TAG 0xB067
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 1
+
+/* 0 = fb_matmul_i8_i8_bias_act, 1 = matmul + guest bias/ReLU + requant passes */
+#ifndef BENCH_BIAS_ACT_SEPARATE
+#define BENCH_BIAS_ACT_SEPARATE 0
+#endif
+
+#define OUT_SCALE (1 << 20)
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_matmul_bias_act\n");
+
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
+    int32_t *bias = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    int8_t *out_q = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(d));
+    fb_row_state_t *state = (fb_row_state_t *)fb_malloc(sizeof(fb_row_state_t));
+    if (!x || !w || !bias || !out || !out_q || !state) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+    bench_fill_i8(w, n * d, 3);
+    bench_fill_i32(bias, d, -(int32_t)d);
+    state->cursor = 0;
+    state->max_rows = 0;
+
+    fb_matmul_bias_act_cfg_t cfg;
+    fb_memset(&cfg, 0, sizeof(cfg));
+    cfg.out_ptr = (uint64_t)(uintptr_t)out;
+    cfg.x_ptr = (uint64_t)(uintptr_t)x;
+    cfg.w_ptr = (uint64_t)(uintptr_t)w;
+    cfg.bias_ptr = (uint64_t)(uintptr_t)bias;
+    cfg.out_q_ptr = (uint64_t)(uintptr_t)out_q;
+    cfg.w_scale = 1 << 16;
+    cfg.n = n;
+    cfg.d = d;
+    cfg.act = FB_ACT_RELU;
+    cfg.out_scale = OUT_SCALE;
+    cfg.state_ptr = (uint64_t)(uintptr_t)state;
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_BIAS_ACT_SEPARATE
+        fb_matmul_i8_i8(out, x, w, 1 << 16, n, d);
+        for (uint32_t r = 0; r < d; r++) {
+            int32_t v = out[r] + bias[r];
+            out[r] = v < 0 ? 0 : v;
+        }
+        (void)fb_quantize_i32_to_prequant(out_q, out, d, OUT_SCALE, 0);
+#else
+        state->cursor = 0;
+        (void)fb_matmul_i8_i8_bias_act(&cfg);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
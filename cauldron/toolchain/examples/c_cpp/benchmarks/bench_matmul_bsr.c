@@ -0,0 +1,86 @@
+#include "bench_common.h"
+#include "frostbite_sparse.h"
+
+#define TAG 0xB07A
+#define BENCH_DEFAULT_N 256
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * d x n matmul of a block-pruned matrix, dense vs block-sparse.
+ * 0 = MATMUL_I8_I8 on the dense matrix (zeros included)
+ * 1 = fb_bsr_matmul_i8_i8, one MATMUL_I8_I8 per stored block
+ * 2 = fb_bsr_matmul_i8_i8_partial, max_rows = d / 2
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+/* Block shape and the percentage of blocks left nonzero */
+#ifndef BENCH_BR
+#define BENCH_BR 8
+#endif
+#ifndef BENCH_BC
+#define BENCH_BC 32
+#endif
+#ifndef BENCH_DENSITY
+#define BENCH_DENSITY 20
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_matmul_bsr\n");
+
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int8_t *w = (int8_t *)fb_malloc((size_t)n * d);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    if (!x || !w || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+    bench_fill_i8(w, (size_t)n * d, 1);
+    /* zero all but every (100 / BENCH_DENSITY)-th block, staggered per block row */
+    uint32_t keep = 100u / (BENCH_DENSITY ? BENCH_DENSITY : 1);
+    for (uint32_t r = 0; r < d; r++) {
+        for (uint32_t c = 0; c < n; c++) {
+            uint32_t blk = (r / BENCH_BR) + (c / BENCH_BC);
+            if (blk % keep != 0) {
+                w[(size_t)r * n + c] = 0;
+            }
+        }
+    }
+
+    size_t bytes = fb_bsr_bytes(w, n, d, BENCH_BR, BENCH_BC);
+    void *seg = fb_malloc(bytes);
+    fb_bsr_t m;
+    if (!seg || fb_bsr_build(seg, bytes, w, n, d, BENCH_BR, BENCH_BC) < 0 ||
+        fb_bsr_open(&m, seg, bytes) != 0) {
+        fb_print("bsr build failed\n");
+        return 1;
+    }
+    void *scratch = fb_malloc(fb_bsr_scratch_bytes(&m));
+    if (!scratch) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    fb_print("dense %u bytes, bsr %u bytes, %u blocks\n", n * d, (uint32_t)bytes, m.num_blocks);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 0
+        fb_matmul_i8_i8(out, x, w, 1 << 16, n, d);
+#elif BENCH_OP == 1
+        fb_bsr_matmul_i8_i8(out, x, &m, 1 << 16, scratch);
+#else
+        fb_row_state_t st = {0, d > 1 ? d / 2 : 1};
+        while (!fb_bsr_matmul_i8_i8_partial(out, x, &m, 1 << 16, scratch, &st)) {
+        }
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "bench_common.h"
+
+#define TAG 0xB079
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 16
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * d x n matmul from int8 vs packed int4 weights (half the weight bytes).
+ * 0 = MATMUL_I8_I8 on int8 weights (baseline)
+ * 1 = fb_matmul_i4_i8 (per-row unpack + MATMUL_I8_I8)
+ * 2 = fb_matmul_i4_i8_partial, max_rows = d / 2 (one yield per matmul)
+ * 3 = fb_matmul_i4_i8_argmax_partial, all rows per call
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_matmul_i4_i8\n");
+
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int8_t *w = (int8_t *)fb_aligned_alloc(8, n * d);
+    uint8_t *w4 = (uint8_t *)fb_aligned_alloc(8, FB_I4_BYTES(n, d));
+    int8_t *row = (int8_t *)fb_aligned_alloc(8, FB_I4_ROW_BUF_BYTES(n));
+    int32_t *scales = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    if (!x || !w || !w4 || !row || !scales || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+    bench_fill_i8(w, n * d, 1);
+    fb_i4_pack(w4, w, n, d);
+    for (size_t r = 0; r < d; r++) {
+        scales[r] = 1 << 16;
+    }
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 0
+        fb_matmul_i8_i8(out, x, w, 1 << 16, n, d);
+#elif BENCH_OP == 1
+        fb_matmul_i4_i8(out, x, w4, scales, n, d, row);
+#elif BENCH_OP == 2
+        fb_row_state_t st = {0, (uint32_t)(d > 1 ? d / 2 : 1)};
+        while (!fb_matmul_i4_i8_partial(out, x, w4, scales, n, d, row, &st)) {
+        }
+#else
+        fb_argmax_i32_state_t st = {0, 0, INT32_MIN, 0};
+        (void)fb_matmul_i4_i8_argmax_partial(x, w4, scales, n, d, row, &st);
+        out[0] = (int32_t)st.max_idx;
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
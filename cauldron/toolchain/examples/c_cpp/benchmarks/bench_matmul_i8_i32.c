@@ -1,14 +1,16 @@
 #include "bench_common.h"
 
 #define TAG 0xB020
-#define ITERS 2
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 2
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_matmul_i8_i32\n");
 
-    size_t n = 4;
-    size_t d = 4;
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
     int32_t *x = (int32_t *)fb_malloc(sizeof(int32_t) * n);
     int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
@@ -19,10 +21,10 @@ int main(void) {
     bench_fill_i32(x, n, 1);
     bench_fill_i8(w, n * d, 1);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_matmul_i8_i32(out, x, w, (1 << 16), n, d);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
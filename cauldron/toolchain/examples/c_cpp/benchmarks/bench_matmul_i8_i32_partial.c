@@ -1,13 +1,16 @@
 #include "bench_common.h"
 
 #define TAG 0xB021
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 1
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_matmul_i8_i32_partial\n");
 
-    size_t n = 4;
-    size_t d = 4;
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
     int32_t *x = (int32_t *)fb_malloc(sizeof(int32_t) * n);
     int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
@@ -18,11 +21,13 @@ int main(void) {
     }
     bench_fill_i32(x, n, 1);
     bench_fill_i8(w, n * d, 1);
-    state->cursor = 0;
     state->max_rows = (uint32_t)d;
 
-    bench_log(TAG, 0, 1);
-    fb_matmul_i8_i32_partial(out, x, w, (1 << 16), n, d, state);
-    bench_log(TAG, 1, 1);
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        state->cursor = 0;
+        fb_matmul_i8_i32_partial(out, x, w, (1 << 16), n, d, state);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -1,14 +1,17 @@
 #include "bench_common.h"
 
 #define TAG 0xB02D
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 1
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_matmul_i8_i8_w1w3\n");
 
-    uint32_t n = 4;
-    uint32_t d = 4;
-    int8_t *x = (int8_t *)fb_malloc(sizeof(int8_t) * n);
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
     int8_t *w1 = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     int8_t *w3 = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     int32_t *out_a = (int32_t *)fb_malloc(sizeof(int32_t) * d);
@@ -19,6 +22,7 @@ int main(void) {
         return 1;
     }
     bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
     bench_fill_i8(w1, n * d, 1);
     bench_fill_i8(w3, n * d, 1);
 
@@ -35,8 +39,11 @@ int main(void) {
     cfg.d = d;
     cfg.state_ptr = (uint64_t)(uintptr_t)state;
 
-    bench_log(TAG, 0, 1);
-    fb_matmul_i8_i8_w1w3(&cfg);
-    bench_log(TAG, 1, 1);
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        state->cursor = 0;
+        fb_matmul_i8_i8_w1w3(&cfg);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -1,25 +1,52 @@
 #include "bench_common.h"
+#include "frostbite_task.h"
 
 #define TAG 0xB02E
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 1
+
+/* Rows per chunk (0 = all rows, no yields) */
+#ifndef BENCH_ROWS_PER_CALL
+#define BENCH_ROWS_PER_CALL 0
+#endif
+
+/* Task state in the RAM segment; a restart resumes at the saved iteration/row. */
+typedef struct {
+    fb_task_t task;
+    uint32_t iter;
+} silu_task_t;
+
+static int silu_run(silu_task_t *s, const fb_matmul_w1w3_silu_cfg_t *cfg) {
+    FB_TASK_BEGIN(&s->task);
+    for (s->iter = 0; s->iter < (uint32_t)BENCH_ITERS; s->iter++) {
+        FB_AWAIT_ROWS(&s->task, cfg->d, fb_matmul_i8_i8_w1w3_silu(cfg));
+    }
+    FB_TASK_END(&s->task);
+}
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_matmul_i8_i8_w1w3_silu\n");
 
-    uint32_t n = 4;
-    uint32_t d = 4;
-    int8_t *x = (int8_t *)fb_malloc(sizeof(int8_t) * n);
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
     int8_t *w1 = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     int8_t *w3 = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
-    fb_row_state_t *state = (fb_row_state_t *)fb_malloc(sizeof(fb_row_state_t));
-    if (!x || !w1 || !w3 || !out || !state) {
+    void *task_mem = fb_malloc(sizeof(silu_task_t));
+    if (!x || !w1 || !w3 || !out || !task_mem) {
         fb_print("alloc failed\n");
         return 1;
     }
     bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
     bench_fill_i8(w1, n * d, 1);
     bench_fill_i8(w3, n * d, 1);
+    silu_task_t *task = (silu_task_t *)fb_task_attach((uint64_t)(uintptr_t)task_mem,
+                                                      sizeof(silu_task_t),
+                                                      BENCH_ROWS_PER_CALL);
 
     fb_matmul_w1w3_silu_cfg_t cfg;
     fb_memset(&cfg, 0, sizeof(cfg));
@@ -31,10 +58,14 @@ int main(void) {
     cfg.w3_scale = 1 << 16;
     cfg.n = n;
     cfg.d = d;
-    cfg.state_ptr = (uint64_t)(uintptr_t)state;
+    cfg.state_ptr = (uint64_t)(uintptr_t)&task->task.rows;
 
-    bench_log(TAG, 0, 1);
-    fb_matmul_i8_i8_w1w3_silu(&cfg);
-    bench_log(TAG, 1, 1);
+    bench_log(TAG, 0, BENCH_ITERS);
+    /* fb_task_attach zeroed an invalid header; only a finished run starts over */
+    if (fb_task_done(&task->task)) {
+        fb_task_restart(&task->task);
+    }
+    (void)silu_run(task, &cfg);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
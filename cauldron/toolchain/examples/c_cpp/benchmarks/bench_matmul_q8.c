@@ -1,14 +1,16 @@
 #include "bench_common.h"
 
 #define TAG 0xB015
-#define ITERS 2
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 2
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_matmul_q8\n");
 
-    size_t n = 4;
-    size_t d = 4;
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
     float *x = (float *)fb_malloc(sizeof(float) * n);
     int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     float *scale = (float *)fb_malloc(sizeof(float) * d);
@@ -21,10 +23,10 @@ int main(void) {
     bench_fill_f32(scale, d, 1.0f);
     bench_fill_i8(w, n * d, 1);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_matmul_q8(out, x, w, scale, n, d);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -1,13 +1,16 @@
 #include "bench_common.h"
 
 #define TAG 0xB016
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 1
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_matmul_q8_partial\n");
 
-    size_t n = 4;
-    size_t d = 4;
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
     float *x = (float *)fb_malloc(sizeof(float) * n);
     int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
     float *scale = (float *)fb_malloc(sizeof(float) * d);
@@ -20,11 +23,13 @@ int main(void) {
     bench_fill_f32(x, n, 0.1f);
     bench_fill_f32(scale, d, 1.0f);
     bench_fill_i8(w, n * d, 1);
-    state->cursor = 0;
     state->max_rows = (uint32_t)d;
 
-    bench_log(TAG, 0, 1);
-    fb_matmul_q8_partial(out, x, w, scale, n, d, state);
-    bench_log(TAG, 1, 1);
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        state->cursor = 0;
+        fb_matmul_q8_partial(out, x, w, scale, n, d, state);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,70 @@
+#!/bin/bash
+# Sweep bench_memcpy.c over ops, sizes, and alignments and report retired
+# instructions per byte.
+#
+# Each point is built with fb-cc and its exact instruction count is found by
+# bisecting frostbite-run --max-instructions. The same build with
+# BENCH_MEM_BYTES=0 is subtracted, so the reported figure only covers the
+# memory op itself (4 iterations per run).
+#
+# Usage: ./bench_mem_sweep.sh [OUT_DIR]
+# Environment: FB_CC, MEM_OPS, MEM_SIZES, MEM_ALIGNS (src:dst pairs)
+
+set -e
+
+FB_CC=${FB_CC:-fb-cc}
+OUT_DIR=${1:-out}/mem_sweep
+MEM_OPS=${MEM_OPS:-"0 1 2 3"}
+MEM_SIZES=${MEM_SIZES:-"16 64 256 1024 4096"}
+MEM_ALIGNS=${MEM_ALIGNS:-"0:0 1:0 0:3 4:4"}
+ITERS=4
+OP_NAMES=(memcpy memset memmove memcmp)
+
+mkdir -p "$OUT_DIR"
+
+count_instructions() {
+    local elf="$1" lo=1 hi=1 mid
+    while ! frostbite-run "$elf" --max-instructions "$hi" 2>&1 | grep -q "exited"; do
+        lo=$((hi + 1))
+        hi=$((hi * 2))
+        if [ "$hi" -gt 1073741824 ]; then
+            echo "error: $elf did not halt" >&2
+            return 1
+        fi
+    done
+    while [ "$lo" -lt "$hi" ]; do
+        mid=$(((lo + hi) / 2))
+        if frostbite-run "$elf" --max-instructions "$mid" 2>&1 | grep -q "exited"; then
+            hi=$mid
+        else
+            lo=$((mid + 1))
+        fi
+    done
+    echo "$lo"
+}
+
+build_point() {
+    local op="$1" bytes="$2" src="$3" dst="$4"
+    local elf="$OUT_DIR/bench_memcpy_${op}_${bytes}_${src}_${dst}.elf"
+    "$FB_CC" -DBENCH_ITERS="$ITERS" -DBENCH_MEM_OP="$op" -DBENCH_MEM_BYTES="$bytes" \
+        -DBENCH_MEM_SRC_ALIGN="$src" -DBENCH_MEM_DST_ALIGN="$dst" \
+        bench_memcpy.c -o "$elf" > /dev/null
+    echo "$elf"
+}
+
+printf "%-8s %8s %4s %4s %12s %10s\n" op bytes src dst instructions instr/byte
+for op in $MEM_OPS; do
+    for pair in $MEM_ALIGNS; do
+        src=${pair%%:*}
+        dst=${pair##*:}
+        base=$(count_instructions "$(build_point "$op" 0 "$src" "$dst")")
+        for bytes in $MEM_SIZES; do
+            total=$(count_instructions "$(build_point "$op" "$bytes" "$src" "$dst")")
+            delta=$((total - base))
+            per_byte=$(awk -v d="$delta" -v b="$bytes" -v i="$ITERS" \
+                'BEGIN { printf "%.3f", d / (b * i) }')
+            printf "%-8s %8d %4d %4d %12d %10s\n" \
+                "${OP_NAMES[$op]}" "$bytes" "$src" "$dst" "$delta" "$per_byte"
+        done
+    done
+done
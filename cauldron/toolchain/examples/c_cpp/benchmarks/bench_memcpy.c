@@ -0,0 +1,55 @@
+#include "bench_common.h"
+
+#define TAG 0xB060
+#define BENCH_DEFAULT_ITERS 4
+
+/* 0 = memcpy, 1 = memset, 2 = memmove (overlapping, backward), 3 = memcmp */
+#ifndef BENCH_MEM_OP
+#define BENCH_MEM_OP 0
+#endif
+
+#ifndef BENCH_MEM_BYTES
+#define BENCH_MEM_BYTES 1024
+#endif
+
+/* Byte offsets from an 8-byte aligned base. */
+#ifndef BENCH_MEM_DST_ALIGN
+#define BENCH_MEM_DST_ALIGN 0
+#endif
+
+#ifndef BENCH_MEM_SRC_ALIGN
+#define BENCH_MEM_SRC_ALIGN 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_memcpy\n");
+
+    /* Buffers are left as mapped (zeroed) RAM so only the op itself scales
+     * with BENCH_MEM_BYTES; see bench_mem_sweep.sh. */
+    size_t n = BENCH_MEM_BYTES;
+    uint8_t *src = (uint8_t *)fb_malloc(n + 16);
+    uint8_t *dst = (uint8_t *)fb_malloc(n + 16);
+    if (!src || !dst) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    uint8_t *s = src + BENCH_MEM_SRC_ALIGN;
+    uint8_t *d = dst + BENCH_MEM_DST_ALIGN;
+    int acc = 0;
+
+    bench_log(TAG, 0, n);
+    BENCH_LOOP(i) {
+#if BENCH_MEM_OP == 0
+        fb_memcpy(d, s, n);
+#elif BENCH_MEM_OP == 1
+        fb_memset(d, 0x5a, n);
+#elif BENCH_MEM_OP == 2
+        fb_memmove(s + 8, s, n);
+#else
+        acc |= fb_memcmp(d, s, n);
+#endif
+    }
+    bench_log(TAG, 1, n);
+    return acc;
+}
@@ -0,0 +1,94 @@
+#include "bench_common.h"
+
+#define TAG 0xB065
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 1
+
+#define MLP_OUT 16
+#define MLP_W_SCALE (1 << 8)
+
+/* 0 = fb_quantize_i32_to_prequant between layers, 1 = scalar guest loops */
+#ifndef BENCH_MLP_NAIVE
+#define BENCH_MLP_NAIVE 0
+#endif
+
+/* Layer-to-layer requantization as a template would write it by hand:
+ * separate ReLU, max, and divide/clamp passes. */
+static void naive_requant(int8_t *x, int32_t *h, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (h[i] < 0) {
+            h[i] = 0;
+        }
+    }
+    int32_t max_abs = 0;
+    for (size_t i = 0; i < n; i++) {
+        int32_t a = h[i] < 0 ? -h[i] : h[i];
+        if (a > max_abs) {
+            max_abs = a;
+        }
+    }
+    int32_t scale = max_abs / 127 + 1;
+    for (size_t i = 0; i < n; i++) {
+        int32_t q = h[i] / scale;
+        if (q > 127) {
+            q = 127;
+        }
+        if (q < -127) {
+            q = -127;
+        }
+        x[i] = (int8_t)q;
+    }
+    for (size_t i = n; i < FB_ALIGN4(n); i++) {
+        x[i] = 0;
+    }
+    scale <<= 16;
+    fb_memcpy(x + FB_ALIGN4(n), &scale, sizeof(scale));
+}
+
+static void requant(int8_t *x, int32_t *h, size_t n) {
+#if BENCH_MLP_NAIVE
+    naive_requant(x, h, n);
+#else
+    (void)fb_quantize_i32_to_prequant(x, h, n, 0, FB_PREQUANT_RELU);
+#endif
+}
+
+/* 3-layer int8 MLP (n -> d -> d -> 16). Build with -DBENCH_MLP_NAIVE=1 and
+ * diff instruction counts to see the requantization savings. */
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_mlp_prequant\n");
+
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
+    int32_t *input = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int8_t *x0 = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int8_t *x1 = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(d));
+    int8_t *x2 = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(d));
+    int8_t *w1 = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
+    int8_t *w2 = (int8_t *)fb_malloc(sizeof(int8_t) * d * d);
+    int8_t *w3 = (int8_t *)fb_malloc(sizeof(int8_t) * d * MLP_OUT);
+    int32_t *h = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * MLP_OUT);
+    if (!input || !x0 || !x1 || !x2 || !w1 || !w2 || !w3 || !h || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i32(input, n, -(int32_t)n * 256);
+    bench_fill_i8(w1, n * d, 1);
+    bench_fill_i8(w2, d * d, 3);
+    bench_fill_i8(w3, d * MLP_OUT, 5);
+    (void)fb_quantize_i32_to_prequant(x0, input, n, 0, 0);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        fb_matmul_i8_i8(h, x0, w1, MLP_W_SCALE, n, d);
+        requant(x1, h, d);
+        fb_matmul_i8_i8(h, x1, w2, MLP_W_SCALE, d, d);
+        requant(x2, h, d);
+        fb_matmul_i8_i8(out, x2, w3, MLP_W_SCALE, d, MLP_OUT);
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "bench_common.h"
+#include "frostbite_model.h"
+
+#define TAG 0xB06E
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 16
+#define BENCH_DEFAULT_ITERS 1
+
+/* 0 = matmul writes output_ptr in place, 1 = stage in heap and copy out */
+#ifndef BENCH_MODEL_STAGED
+#define BENCH_MODEL_STAGED 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_model_control\n");
+
+    static uint64_t ctrl_words[7];
+    fb_model_control_v1_t *ctrl = (fb_model_control_v1_t *)ctrl_words;
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    int32_t *input = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int32_t *output = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    int8_t *w = (int8_t *)fb_malloc(n * d);
+    int32_t *staged = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    if (!input || !output || !w || !staged) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i32(input, n, 1);
+    bench_fill_i8(w, n * d, 1);
+    fb_memset(ctrl, 0, sizeof(*ctrl));
+    ctrl->magic = FB_MODEL_CTRL_MAGIC;
+    ctrl->abi_version = FB_MODEL_ABI_VERSION;
+    ctrl->input_ptr = (uint32_t)(uintptr_t)input;
+    ctrl->input_len = sizeof(int32_t) * n;
+    ctrl->output_ptr = (uint32_t)(uintptr_t)output;
+
+    fb_model_t m;
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        uint32_t rc = fb_model_open(&m, (uint64_t)(uintptr_t)ctrl, sizeof(int32_t) * d,
+                                    FB_MODEL_SCHEMA_ANY, 0);
+        const int32_t *x = rc ? NULL : fb_model_input_i32(&m, 0, n);
+        int32_t *y = x ? fb_model_output_i32(&m, 0, d) : NULL;
+        if (!y) {
+            fb_print("bad control block\n");
+            return 1;
+        }
+#if BENCH_MODEL_STAGED
+        fb_matmul_i8_i32(staged, x, w, 1 << 16, n, d);
+        fb_memcpy(y, staged, sizeof(int32_t) * d);
+#else
+        (void)staged;
+        fb_matmul_i8_i32(y, x, w, 1 << 16, n, d);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include "bench_common.h"
+
+#define TAG 0xB06F
+#define BENCH_DEFAULT_N 1024
+#define BENCH_DEFAULT_ITERS 1
+
+/* 0 = table in .bss (cleared by crt0 on every start), 1 = FB_NOINIT */
+#ifndef BENCH_NOINIT
+#define BENCH_NOINIT 0
+#endif
+
+#if BENCH_NOINIT
+#define BENCH_TABLE_ATTR FB_NOINIT
+#else
+#define BENCH_TABLE_ATTR
+#endif
+
+/* 16 * n byte static table; crt0's clear of it shows up in bench setup */
+static BENCH_TABLE_ATTR uint8_t table[BENCH_N * 16];
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_noinit\n");
+
+    uint32_t bytes = (uint32_t)sizeof(table);
+    uint32_t sum = 0;
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        table[(uint32_t)i % bytes] = (uint8_t)i;
+        sum += table[bytes - 1u];
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return sum == 0xFFFFFFFFu;
+}
@@ -0,0 +1,16 @@
+#include "bench_common.h"
+
+#define TAG 0xB075
+#define BENCH_DEFAULT_ITERS 8
+
+/* Build with -DFB_LOG_LEVEL=FB_LOG_INFO to measure the stripped debug line. */
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_printf\n");
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        fb_log_debug("iter=%d mask=%x tag=%s\n", i, (unsigned)i * 0x11u, "bench");
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#define FB_PROFILE 1
+#include "bench_common.h"
+
+#define TAG 0xB064
+#define BENCH_DEFAULT_N 4
+#define BENCH_DEFAULT_D 4
+#define BENCH_DEFAULT_ITERS 4
+
+/* Brackets an int8 matmul with FB_PROFILE_BEGIN/END and logs the raw counter
+ * reads, so the in-guest delta can be checked against frostbite-run. */
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_profile\n");
+
+    size_t n = BENCH_N;
+    size_t d = BENCH_D;
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int8_t *w = (int8_t *)fb_malloc(sizeof(int8_t) * n * d);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    if (!x || !w || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+    bench_fill_i8(w, n * d, 1);
+
+    bench_log(TAG, 0, fb_instret());
+    FB_PROFILE_BEGIN(TAG);
+    BENCH_LOOP(i) {
+        fb_matmul_i8_i8(out, x, w, (1 << 16), n, d);
+    }
+    FB_PROFILE_END(TAG);
+    bench_log(TAG, 1, fb_instret());
+    return 0;
+}
@@ -1,15 +1,15 @@
 #include "bench_common.h"
 
 #define TAG 0xB001
-#define ITERS 32
+#define BENCH_DEFAULT_ITERS 32
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_putchar\n");
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_putchar('A');
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
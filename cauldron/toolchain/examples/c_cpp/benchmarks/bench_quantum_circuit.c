@@ -0,0 +1,56 @@
+#include "bench_common.h"
+
+#define TAG 0xB083
+#define BENCH_DEFAULT_N 32
+#define BENCH_DEFAULT_ITERS 1
+
+/*
+ * A BENCH_N-gate circuit over the 7-qubit state: per qubit, H, a CNOT pair
+ * that cancels, and an RZ.
+ * 0 = one fb_quantum_op call site per gate (the circuit as written)
+ * 1 = fb_quantum_run on the circuit as written
+ * 2 = fb_quantum_run on the fb_quantum_circuit_simplify result
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 2
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_quantum_circuit\n");
+
+    uint32_t n = BENCH_N;
+    fb_q16_complex_t *state = (fb_q16_complex_t *)fb_malloc(
+        sizeof(fb_q16_complex_t) * FB_QUANTUM_STATE_LEN);
+    fb_qgate_t *gates = (fb_qgate_t *)fb_malloc(sizeof(fb_qgate_t) * n);
+    if (!state || !gates) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t q = (i / 4) % FB_QUANTUM_NUM_QUBITS;
+        uint32_t c = (q + 1) % FB_QUANTUM_NUM_QUBITS;
+        static const uint8_t ops[4] = {FB_QOP_H, FB_QOP_CNOT, FB_QOP_CNOT, FB_QOP_RZ};
+        uint8_t op = ops[i % 4];
+        fb_qgate_t g = FB_QGATE(op, q, op == FB_QOP_CNOT ? c : i & 7);
+        gates[i] = g;
+    }
+    size_t count = n;
+#if BENCH_OP == 2
+    count = fb_quantum_circuit_simplify(gates, count);
+#endif
+    fb_quantum_op(FB_QOP_INIT, 0, 0, state);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(iter) {
+#if BENCH_OP == 0
+        for (size_t i = 0; i < count; i++) {
+            (void)fb_quantum_op(gates[i].op, gates[i].target, gates[i].control, state);
+        }
+#else
+        (void)fb_quantum_run(gates, count, state, NULL);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -1,7 +1,7 @@
 #include "bench_common.h"
 
 #define TAG 0xB018
-#define ITERS 8
+#define BENCH_DEFAULT_ITERS 8
 
 int main(void) {
     bench_heap_setup();
@@ -14,10 +14,10 @@ int main(void) {
     }
     *value = 3.5f;
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         (void)fb_read_f32((uint64_t)(uintptr_t)value);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,470 @@
+#!/usr/bin/env python3
+"""Run the syscall benchmarks over a size sweep and tabulate cost per call.
+
+Every bench_*.c is rebuilt per sweep point with -DBENCH_N/-DBENCH_D (see
+bench_common.h) and twice per point with -DBENCH_ITERS=1 and -DBENCH_ITERS=2. The difference
+between the two builds is the cost of one timed call; what remains of the
+single-iteration build is the fixed setup overhead (heap init, buffer fill).
+
+Local mode counts retired instructions with frostbite-run by bisecting
+--max-instructions (the local runner prints no per-tag output). On-chain mode
+runs frostbite-run-onchain once per build and records total instructions,
+transactions, and compute units, plus any DEBUG_LOG markers the program logs
+(sol_log_64 format) and FB_BLOG records (decoded by toolchain/scripts/fb_log.py)
+so the timed tags can be checked.
+
+Every build's exit code is recorded, and a nonzero one fails the run.
+Benches that print a `checksum=` line of their output (bench_kernel_diff.c,
+the differential test of the kernels against portable C references) get it
+recorded too.
+
+Results are written as CSV or JSON. Pass --baseline with an earlier report to
+flag points whose per-call cost grew by more than --threshold percent, or
+whose output checksum changed; the script exits 1 when any regression or
+failed build is found.
+
+Usage:
+  ./bench_report.py [--sweep sweep.json] [--bench NAME ...]
+                    [--format csv|json] [-o report.csv]
+                    [--baseline old.json] [--threshold 5]
+                    [--onchain --program-id <pubkey>]
+"""
+
+from __future__ import annotations
+
+import argparse
+import csv
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+from pathlib import Path
+from typing import Any
+
+HERE = Path(__file__).resolve().parent
+sys.path.insert(0, str(HERE.parents[2] / "scripts"))
+
+import fb_log  # noqa: E402  (toolchain/scripts/fb_log.py)
+
+DEFAULT_FLAGS = (
+    "-DFB_HEAP_SEGMENT=1 -DFB_HEAP_SEGMENT_COUNT=1 "
+    "-DFB_GRAPH_SEGMENT=2 -DFB_ARB_SEGMENT=3"
+)
+
+# ── Default sweep ──────────────────────────────────────────────────
+
+# Production shapes: n = 64..512 inputs, d = 16..256 outputs.
+ND_POINTS: list[dict[str, int]] = [
+    {"n": 64, "d": 16},
+    {"n": 128, "d": 64},
+    {"n": 256, "d": 128},
+    {"n": 512, "d": 256},
+]
+N_POINTS: list[dict[str, int]] = [{"n": v} for v in (64, 256, 1024, 4096)]
+
+# Benches whose wrappers take (n, d) shapes or a flat length n. Anything not
+# listed runs once at its built-in size.
+ND_BENCHES = {
+    "bench_matmul",
+    "bench_matmul_q8",
+    "bench_matmul_q8_partial",
+    "bench_matmul_i8_i32",
+    "bench_matmul_i8_i32_partial",
+    "bench_matmul_i8_i8",
+    "bench_matmul_i8_i8_partial",
+    "bench_matmul_i8_i8_argmax",
+    "bench_matmul_i8_i8_qkv",
+    "bench_matmul_i8_i8_w1w3",
+    "bench_matmul_i8_i8_w1w3_silu",
+    "bench_matmul_aligned",
+    "bench_mlp_prequant",
+    "bench_cmd",
+    "bench_matmul_bias_act",
+    "bench_budgeted_rows",
+    "bench_segment_view",
+    "bench_model_control",
+}
+N_BENCHES = {
+    "bench_rmsnorm",
+    "bench_softmax",
+    "bench_silu",
+    "bench_rope",
+    "bench_accum",
+    "bench_memcpy_f32",
+    "bench_argmax_partial",
+    "bench_softmax_i32",
+    "bench_dot_i32",
+    "bench_weighted_sum_i32",
+    "bench_argmax_i32_partial",
+    "bench_softmax_i32_f32",
+    "bench_silu_mul_i32",
+    "bench_rmsnorm_i32",
+    "bench_dot_i8",
+    "bench_vec_add_i8",
+    "bench_activation",
+    "bench_noinit",
+}
+
+# Benches with a per-operation BENCH_OP switch, swept over every op
+OP_POINTS: dict[str, list[dict[str, int]]] = {
+    "bench_softfloat": [{"n": 64, "op": op} for op in range(9)],
+    "bench_fixed": [{"n": 64, "op": op} for op in range(7)],
+    "bench_vec_op_i32": [{"n": n, "op": op} for n in (256, 4096) for op in range(7)],
+    "bench_resumable": [{"n": n, "op": op} for n in (256, 4096) for op in range(3)],
+    "bench_csr_graph": [
+        {"n": n, "d": d, "op": op} for n, d in ((64, 8), (512, 16), (1024, 32)) for op in range(2)
+    ],
+    "bench_csr_delta": [
+        {"n": n, "d": d, "op": op} for n, d in ((256, 16), (1024, 16), (1024, 256)) for op in range(2)
+    ],
+    "bench_graph_topk": [
+        {"n": n, "d": d, "op": op} for n, d in ((64, 64), (64, 256), (32, 1024)) for op in range(3)
+    ],
+    "bench_csr_cycle": [
+        {"n": n, "d": d, "op": op} for n, d in ((32, 4), (64, 8)) for op in range(3)
+    ],
+    "bench_csr_gnn": [
+        {"n": n, "d": d, "op": op} for n, d in ((256, 8), (1024, 8), (1024, 32)) for op in range(2)
+    ],
+    "bench_blog": [{"op": op} for op in range(3)],
+    "bench_hpp_matmul": [{"n": n, "d": d, "op": op} for n, d in ((64, 16), (256, 64)) for op in range(2)],
+    "bench_weights_layout": [{"n": n, "d": d, "op": op} for n, d in ((64, 32), (256, 64)) for op in range(2)],
+    "bench_matmul_i4_i8": [{"n": n, "d": d, "op": op} for n, d in ((64, 16), (256, 64)) for op in range(4)],
+    "bench_matmul_bsr": [{"n": n, "d": d, "op": op} for n, d in ((256, 64), (1024, 64)) for op in range(3)],
+    "bench_matmul_batch": [
+        {"n": 64, "d": d, "m": m, "op": op} for d in (1, 32) for m in (1, 4, 16, 64) for op in range(3)
+    ],
+    "bench_tree_ensemble": [{"n": 64, "d": d, "op": op} for d in (16, 64, 128) for op in range(3)],
+    "bench_conv1d": [{"n": n, "d": d, "op": op} for n, d in ((32, 8), (128, 16)) for op in range(3)],
+    "bench_embed_bag": [{"n": n, "d": d, "op": op} for n, d in ((32, 8), (64, 64), (256, 32)) for op in range(4)],
+    "bench_stream_window": [{"n": n, "d": d, "op": op} for n, d in ((32, 4), (128, 8), (512, 16)) for op in range(2)],
+    "bench_topk_i32": [{"n": n, "d": d, "op": op} for n, d in ((64, 1), (256, 3), (1024, 5)) for op in range(4)],
+    "bench_rmsnorm_prequant": [{"n": n, "op": op} for n in (64, 256, 1024) for op in range(3)],
+    "bench_seg_tensor": [{"n": n, "d": d, "op": op} for n, d in ((64, 64), (256, 64)) for op in range(3)],
+    "bench_quantum_circuit": [{"n": n, "op": op} for n in (8, 32, 128) for op in range(3)],
+    "bench_kernel_diff": [
+        {"n": n, "d": d, "op": op} for n, d in ((64, 16), (256, 64), (512, 256)) for op in range(15)
+    ],
+}
+
+PARAM_MACROS = {"n": "BENCH_N", "d": "BENCH_D", "m": "BENCH_M", "op": "BENCH_OP"}
+
+FIELDS = [
+    "bench", "n", "d", "m", "op", "elements",
+    "total_1", "total_2", "per_call", "per_element", "setup",
+    "transactions", "cu_1", "cu_2", "cu_per_call", "tags",
+    "exit_code", "checksum", "max_err",
+]
+
+# ── Regex ──────────────────────────────────────────────────────────
+
+EXITED_RE = re.compile(r"exited", re.IGNORECASE)
+EXIT_CODE_RE = re.compile(r"(?:exited with code|Exit code):\s*(-?\d+)", re.IGNORECASE)
+CHECKSUM_RE = re.compile(r"checksum=([0-9a-fA-F]+) max_err=(\d+)")
+TOTAL_INSTR_RE = re.compile(r"Total instructions:\s*(\d+)")
+TRANSACTIONS_RE = re.compile(r"Transactions:\s*(\d+)")
+CU_RE = re.compile(r"consumed\s+(\d+)\s+of\s+\d+\s+compute units")
+DEBUG_LOG_RE = re.compile(
+    r"Program log: (0x[0-9a-fA-F]+), (0x[0-9a-fA-F]+), (0x[0-9a-fA-F]+), "
+    r"(0x[0-9a-fA-F]+), (0x[0-9a-fA-F]+)"
+)
+
+# ── Sweep ──────────────────────────────────────────────────────────
+
+
+def default_sweep(benches: list[str]) -> dict[str, list[dict[str, int]]]:
+    sweep: dict[str, list[dict[str, int]]] = {}
+    for bench in benches:
+        if bench in OP_POINTS:
+            sweep[bench] = OP_POINTS[bench]
+        elif bench in ND_BENCHES:
+            sweep[bench] = ND_POINTS
+        elif bench in N_BENCHES:
+            sweep[bench] = N_POINTS
+        else:
+            sweep[bench] = [{}]
+    return sweep
+
+
+def load_sweep(path: Path, benches: list[str]) -> dict[str, list[dict[str, int]]]:
+    """Load {"bench_x": [{"n": 64, "d": 16}, ...], "*": [...]} overrides."""
+    raw = json.loads(path.read_text())
+    sweep = default_sweep(benches)
+    fallback = raw.get("*")
+    for bench in benches:
+        if bench in raw:
+            sweep[bench] = raw[bench]
+        elif fallback is not None:
+            sweep[bench] = fallback
+    return sweep
+
+
+def list_benches() -> list[str]:
+    return sorted(p.stem for p in [*HERE.glob("bench_*.c"), *HERE.glob("bench_*.cpp")])
+
+
+def bench_source(bench: str) -> Path:
+    cpp = HERE / f"{bench}.cpp"
+    return cpp if cpp.is_file() else HERE / f"{bench}.c"
+
+
+def point_elements(point: dict[str, int]) -> int:
+    if "n" in point and "d" in point:
+        return point["n"] * point["d"] * point.get("m", 1)
+    return point.get("n", 0)
+
+
+def point_key(bench: str, point: dict[str, Any]) -> tuple[str, ...]:
+    return (bench, *(str(point.get(k, "")) for k in PARAM_MACROS))
+
+# ── Build + run ────────────────────────────────────────────────────
+
+
+def build(args: argparse.Namespace, bench: str, point: dict[str, int],
+          iters: int) -> Path:
+    suffix = "_".join(f"{k}{v}" for k, v in sorted(point.items()))
+    name = f"{bench}_{suffix}_i{iters}" if suffix else f"{bench}_i{iters}"
+    out = Path(args.out_dir) / "report" / f"{name}.elf"
+    out.parent.mkdir(parents=True, exist_ok=True)
+    cmd = [args.fb_cc, *shlex.split(args.flags), f"-DBENCH_ITERS={iters}"]
+    for key, value in sorted(point.items()):
+        cmd.append(f"-D{PARAM_MACROS[key]}={value}")
+    source = bench_source(bench)
+    if source.suffix == ".cpp":
+        cmd.append("-std=c++17")
+    cmd += [str(source), "-o", str(out)]
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    return out
+
+
+def parse_output(text: str) -> dict[str, Any]:
+    """Exit code and output checksum, where the runner output has them."""
+    result: dict[str, Any] = {}
+    match = EXIT_CODE_RE.search(text)
+    if match:
+        result["exit_code"] = int(match.group(1))
+    sums = CHECKSUM_RE.findall(text)
+    if sums:
+        result["checksum"] = " ".join(c.lower() for c, _ in sums)
+        result["max_err"] = max(int(e) for _, e in sums)
+    return result
+
+
+def run_local(args: argparse.Namespace, elf: Path, limit: int) -> str | None:
+    """Runner output if the program halted within `limit` instructions."""
+    proc = subprocess.run(
+        [args.runner, str(elf), "--ram-count", str(args.ram_count),
+         "--max-instructions", str(limit)],
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True,
+    )
+    return proc.stdout if EXITED_RE.search(proc.stdout) else None
+
+
+def count_local(args: argparse.Namespace, elf: Path) -> dict[str, Any]:
+    lo, hi = 1, 1
+    out = run_local(args, elf, hi)
+    while out is None:
+        lo = hi + 1
+        hi *= 2
+        if hi > args.max_instructions:
+            raise RuntimeError(f"{elf} did not halt within {args.max_instructions}")
+        out = run_local(args, elf, hi)
+    while lo < hi:
+        mid = (lo + hi) // 2
+        if run_local(args, elf, mid) is not None:
+            hi = mid
+        else:
+            lo = mid + 1
+    return {"instructions": lo, **parse_output(out)}
+
+
+def parse_onchain(text: str) -> dict[str, Any]:
+    result: dict[str, Any] = {}
+    match = TOTAL_INSTR_RE.search(text)
+    if match:
+        result["instructions"] = int(match.group(1))
+    match = TRANSACTIONS_RE.search(text)
+    if match:
+        result["transactions"] = int(match.group(1))
+    cu = [int(v) for v in CU_RE.findall(text)]
+    if cu:
+        result["cu"] = sum(cu)
+    tags = [
+        f"{int(m[0], 16):#x}:{int(m[1], 16)}"
+        for m in DEBUG_LOG_RE.findall(text)
+        if int(m[0], 16) >= 0xB000
+    ]
+    tags += [
+        f"{r['tag']:#x}:{'/'.join(str(v) for v in r['fields'])}"
+        for r in fb_log.scan(text)
+        if r["tag"] >= 0xB000
+    ]
+    result["tags"] = " ".join(tags)
+    result.update(parse_output(text))
+    return result
+
+
+def count_onchain(args: argparse.Namespace, elf: Path) -> dict[str, Any]:
+    cmd = [args.onchain_runner, str(elf), "--ram-count", str(args.ram_count), "-v"]
+    if args.program_id:
+        cmd += ["--program-id", args.program_id]
+    if args.rpc:
+        cmd += ["--rpc", args.rpc]
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          text=True)
+    result = parse_onchain(proc.stdout)
+    if proc.returncode != 0 or "instructions" not in result:
+        raise RuntimeError(f"{elf}: on-chain run failed\n{proc.stdout[-2000:]}")
+    return result
+
+
+def measure(args: argparse.Namespace, bench: str,
+            point: dict[str, int]) -> dict[str, Any]:
+    count = count_onchain if args.onchain else count_local
+    one = count(args, build(args, bench, point, 1))
+    two = count(args, build(args, bench, point, 2))
+    per_call = two["instructions"] - one["instructions"]
+    elements = point_elements(point)
+    row: dict[str, Any] = {
+        "bench": bench,
+        "n": point.get("n", ""),
+        "d": point.get("d", ""),
+        "m": point.get("m", ""),
+        "op": point.get("op", ""),
+        "elements": elements or "",
+        "total_1": one["instructions"],
+        "total_2": two["instructions"],
+        "per_call": per_call,
+        "per_element": round(per_call / elements, 4) if elements else "",
+        "setup": one["instructions"] - per_call,
+        "transactions": two.get("transactions", ""),
+        "cu_1": one.get("cu", ""),
+        "cu_2": two.get("cu", ""),
+        "cu_per_call": (two["cu"] - one["cu"]) if "cu" in one and "cu" in two else "",
+        "tags": two.get("tags", ""),
+        "exit_code": two.get("exit_code", one.get("exit_code", "")),
+        "checksum": two.get("checksum", ""),
+        "max_err": two.get("max_err", ""),
+    }
+    if one.get("exit_code"):
+        row["exit_code"] = one["exit_code"]
+    return row
+
+# ── Output + baseline ──────────────────────────────────────────────
+
+
+def write_rows(rows: list[dict[str, Any]], fmt: str, path: str | None) -> None:
+    out = open(path, "w", newline="") if path else sys.stdout
+    try:
+        if fmt == "json":
+            json.dump(rows, out, indent=2)
+            out.write("\n")
+        else:
+            writer = csv.DictWriter(out, fieldnames=FIELDS)
+            writer.writeheader()
+            writer.writerows(rows)
+    finally:
+        if path:
+            out.close()
+
+
+def load_rows(path: Path) -> list[dict[str, Any]]:
+    if path.suffix == ".json":
+        return json.loads(path.read_text())
+    with path.open(newline="") as f:
+        return list(csv.DictReader(f))
+
+
+def point_label(row: dict[str, Any]) -> str:
+    return " ".join([row["bench"]] + [f"{k}={row[k]}" for k in PARAM_MACROS if row.get(k, "") != ""])
+
+
+def compare(rows: list[dict[str, Any]], baseline: list[dict[str, Any]],
+            metric: str, threshold: float) -> list[str]:
+    """Return one line per row whose metric exceeds baseline by > threshold%,
+    or whose output checksum differs from the baseline's."""
+    base = {point_key(r["bench"], r): r for r in baseline}
+    regressions = []
+    for row in rows:
+        old = base.get(point_key(row["bench"], row))
+        if old is not None and old.get("checksum") and row.get("checksum") \
+                and old["checksum"] != row["checksum"]:
+            regressions.append(
+                f"{point_label(row)}: checksum {old['checksum']} -> {row['checksum']} "
+                "(output changed)"
+            )
+        if old is None or old.get(metric) in ("", None) or row.get(metric) in ("", None):
+            continue
+        old_v = float(old[metric])
+        new_v = float(row[metric])
+        delta = new_v - old_v
+        pct = (delta / old_v * 100.0) if old_v else (100.0 if delta > 0 else 0.0)
+        row[f"{metric}_baseline"] = old_v
+        row[f"{metric}_delta_pct"] = round(pct, 2)
+        if pct > threshold:
+            regressions.append(
+                f"{point_label(row)}: {metric} {old_v:g} -> {new_v:g} ({pct:+.1f}%)"
+            )
+    return regressions
+
+# ── Main ───────────────────────────────────────────────────────────
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--fb-cc", default=os.environ.get("FB_CC", "fb-cc"))
+    parser.add_argument("--flags", default=os.environ.get("FB_FLAGS", DEFAULT_FLAGS))
+    parser.add_argument("--out-dir", default="out")
+    parser.add_argument("--ram-count", type=int, default=3)
+    parser.add_argument("--bench", action="append", default=[],
+                        help="Bench name (bench_x); repeatable, default all")
+    parser.add_argument("--sweep", type=Path, help="JSON sweep overrides")
+    parser.add_argument("--format", choices=("csv", "json"), default="csv")
+    parser.add_argument("-o", "--output", help="Write the report here (default stdout)")
+    parser.add_argument("--baseline", type=Path, help="Earlier CSV/JSON report")
+    parser.add_argument("--metric", default=None,
+                        help="Baseline metric (default per_call, or cu_per_call on-chain)")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="Regression threshold in percent")
+    parser.add_argument("--max-instructions", type=int, default=1 << 30)
+    parser.add_argument("--runner", default="frostbite-run")
+    parser.add_argument("--onchain", action="store_true")
+    parser.add_argument("--onchain-runner", default="frostbite-run-onchain")
+    parser.add_argument("--program-id", default=os.environ.get("FROSTBITE_PROGRAM_ID"))
+    parser.add_argument("--rpc", default=None)
+    args = parser.parse_args()
+
+    benches = list_benches()
+    if args.bench:
+        unknown = sorted(set(args.bench) - set(benches))
+        if unknown:
+            parser.error(f"unknown bench: {', '.join(unknown)}")
+        benches = [b for b in benches if b in args.bench]
+    sweep = load_sweep(args.sweep, benches) if args.sweep else default_sweep(benches)
+
+    rows = []
+    for bench in benches:
+        for point in sweep[bench]:
+            print(f"==> {bench} {point}", file=sys.stderr)
+            rows.append(measure(args, bench, point))
+
+    regressions: list[str] = []
+    if args.baseline:
+        metric = args.metric or ("cu_per_call" if args.onchain else "per_call")
+        regressions = compare(rows, load_rows(args.baseline), metric, args.threshold)
+        FIELDS.extend([f"{metric}_baseline", f"{metric}_delta_pct"])
+
+    write_rows(rows, args.format, args.output)
+    failures = [f"{point_label(r)}: exit code {r['exit_code']}" for r in rows
+                if r.get("exit_code") not in ("", None, 0)]
+    for line in failures:
+        print(f"failed: {line}", file=sys.stderr)
+    for line in regressions:
+        print(f"regression: {line}", file=sys.stderr)
+    return 1 if regressions or failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
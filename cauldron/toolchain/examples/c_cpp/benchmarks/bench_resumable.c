@@ -0,0 +1,62 @@
+#include "bench_common.h"
+
+#define TAG 0xB06B
+#define BENCH_DEFAULT_N 256
+#define BENCH_DEFAULT_D 0 /* max_per_call; 0 runs each pass in one call */
+#define BENCH_DEFAULT_ITERS 1
+
+/* 0 = fb_dot_i32, 1 = fb_rmsnorm_i32, 2 = fb_softmax_i32 */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+/* 0 = *_resumable helper, 1 = the one-shot kernel */
+#ifndef BENCH_RESUMABLE_ONESHOT
+#define BENCH_RESUMABLE_ONESHOT 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_resumable\n");
+
+    size_t n = BENCH_N;
+    int32_t *x = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int32_t *y = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int16_t *w = (int16_t *)fb_malloc(sizeof(int16_t) * (n + 1));
+    if (!x || !y || !w) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i32(x, n, -(int32_t)n / 2);
+    bench_fill_i32(y, n, 1 << 16);
+    for (size_t i = 0; i <= n; i++) {
+        w[i] = 4096;
+    }
+    fb_reduce_i32_state_t st;
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+        fb_memset(&st, 0, sizeof(st));
+        st.max_per_call = BENCH_D;
+#if BENCH_RESUMABLE_ONESHOT
+#if BENCH_OP == 0
+        (void)fb_dot_i32(x, y, n, 16);
+#elif BENCH_OP == 1
+        fb_rmsnorm_i32(y, x, (uint64_t)(uintptr_t)w, n);
+#else
+        fb_softmax_i32(y, n);
+#endif
+#elif BENCH_OP == 0
+        while (!fb_dot_i32_resumable(x, y, n, 16, &st)) {
+        }
+#elif BENCH_OP == 1
+        while (!fb_rmsnorm_i32_resumable(y, x, (uint64_t)(uintptr_t)w, n, &st)) {
+        }
+#else
+        while (!fb_softmax_i32_resumable(y, n, &st)) {
+        }
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -1,13 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB011
-#define ITERS 4
+#define BENCH_DEFAULT_N 8
+#define BENCH_DEFAULT_ITERS 4
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_rmsnorm\n");
 
-    size_t n = 8;
+    size_t n = BENCH_N;
     float *x = (float *)fb_malloc(sizeof(float) * n);
     float *w = (float *)fb_malloc(sizeof(float) * n);
     float *out = (float *)fb_malloc(sizeof(float) * n);
@@ -18,10 +19,10 @@ int main(void) {
     bench_fill_f32(x, n, 0.2f);
     bench_fill_f32(w, n, 1.0f);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_rmsnorm(out, x, w, n);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
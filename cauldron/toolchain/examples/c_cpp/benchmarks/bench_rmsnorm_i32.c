@@ -1,13 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB028
-#define ITERS 4
+#define BENCH_DEFAULT_N 8
+#define BENCH_DEFAULT_ITERS 4
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_rmsnorm_i32\n");
 
-    size_t n = 8;
+    size_t n = BENCH_N;
     int32_t *x = (int32_t *)fb_malloc(sizeof(int32_t) * n);
     int32_t *w = (int32_t *)fb_malloc(sizeof(int32_t) * n);
     int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * n);
@@ -18,10 +19,10 @@ int main(void) {
     bench_fill_i32(x, n, 1);
     bench_fill_i32(w, n, 1);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_rmsnorm_i32(out, x, (uint64_t)(uintptr_t)w, n);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,54 @@
+#include "bench_common.h"
+
+#define TAG 0xB081
+#define BENCH_DEFAULT_N 256
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * RMSNorm a BENCH_N hidden vector into a prequant buffer for the next
+ * QKV / W1W3 matmul.
+ * 0 = RMSNORM_I32 into an i32 scratch, then fb_quantize_i32_to_prequant
+ * 1 = fb_rmsnorm_i32_to_prequant, dynamic scale
+ * 2 = fb_rmsnorm_i32_to_prequant, calibrated scale
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_rmsnorm_prequant\n");
+
+    size_t n = BENCH_N;
+    int32_t *x = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int16_t *w = (int16_t *)fb_malloc(sizeof(int16_t) * (n + 1));
+    void *xq = fb_malloc(FB_PREQUANT_BYTES(n));
+#if BENCH_OP == 0
+    int32_t *scratch = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+#else
+    int32_t *scratch = x;
+#endif
+    if (!x || !w || !xq || !scratch) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (int32_t)((i * 2654435761u) >> 14) - (1 << 17);
+        w[1 + i] = (int16_t)(4096 + (int32_t)(i & 255));
+    }
+    w[0] = 4096;
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 0
+        fb_rmsnorm_i32(scratch, x, (uint64_t)(uintptr_t)w, n);
+        (void)fb_quantize_i32_to_prequant(xq, scratch, n, 0, 0);
+#elif BENCH_OP == 1
+        (void)fb_rmsnorm_i32_to_prequant(xq, x, (uint64_t)(uintptr_t)w, n, 0, 0);
+#else
+        (void)fb_rmsnorm_i32_to_prequant(xq, x, (uint64_t)(uintptr_t)w, n, 1 << 12, 0);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
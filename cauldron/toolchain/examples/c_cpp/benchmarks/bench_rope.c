@@ -1,14 +1,16 @@
 #include "bench_common.h"
 
 #define TAG 0xB014
-#define ITERS 2
+#define BENCH_DEFAULT_N 8
+#define BENCH_DEFAULT_D 8
+#define BENCH_DEFAULT_ITERS 2
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_rope\n");
 
-    int dim = 8;
-    int head = 8;
+    int dim = BENCH_N;
+    int head = BENCH_D;
     float *q = (float *)fb_malloc(sizeof(float) * dim);
     float *k = (float *)fb_malloc(sizeof(float) * dim);
     if (!q || !k) {
@@ -18,10 +20,10 @@ int main(void) {
     bench_fill_f32(q, dim, 0.1f);
     bench_fill_f32(k, dim, 0.2f);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_rope(q, k, 0, dim, head);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,64 @@
+#include "bench_common.h"
+
+#define TAG 0xB082
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 1
+
+/*
+ * BENCH_D x BENCH_N int8 weights split over two RAM segments (the graph and
+ * arb accounts), one matmul per iteration.
+ * 0 = gather both parts into heap scratch, then MATMUL_I8_I8
+ * 1 = fb_matmul_i8_i8_seg_partial, split on a row boundary (zero copy)
+ * 2 = fb_matmul_i8_i8_seg_partial, split mid-row (one row via row_buf)
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_seg_tensor\n");
+
+    if (FB_GRAPH_SEGMENT == 0 || FB_ARB_SEGMENT == 0) {
+        fb_print("weight segments disabled\n");
+        return 0;
+    }
+
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    uint32_t split = d / 2 * n + (BENCH_OP == 2 ? n / 2 : 0);
+    fb_seg_tensor_t w;
+    fb_seg_tensor_init(&w, n);
+    if (fb_seg_tensor_add(&w, FB_GRAPH_SEGMENT, 0, split) != 0 ||
+        fb_seg_tensor_add(&w, FB_ARB_SEGMENT, 0, n * d - split) != 0) {
+        fb_print("bad segments\n");
+        return 1;
+    }
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    int8_t *row_buf = (int8_t *)fb_malloc(n);
+    int8_t *scratch = (int8_t *)fb_malloc(BENCH_OP == 0 ? n * d : 1);
+    if (!x || !out || !row_buf || !scratch) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8((int8_t *)w.parts[0].base, w.parts[0].len, 1);
+    bench_fill_i8((int8_t *)w.parts[1].base, w.parts[1].len, 3);
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 0
+        fb_memcpy(scratch, w.parts[0].base, w.parts[0].len);
+        fb_memcpy(scratch + w.parts[0].len, w.parts[1].base, w.parts[1].len);
+        fb_matmul_i8_i8(out, x, scratch, 1 << 16, n, d);
+#else
+        fb_row_state_t st = {0, 0};
+        (void)fb_matmul_i8_i8_seg_partial(out, x, &w, 1 << 16, n, d, row_buf, &st);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
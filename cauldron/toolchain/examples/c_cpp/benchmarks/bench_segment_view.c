@@ -0,0 +1,58 @@
+#include "bench_common.h"
+
+#define TAG 0xB06D
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 1
+
+/* Segment holding the weights (a RAM account, as a weights account would be) */
+#ifndef BENCH_VIEW_SEGMENT
+#define BENCH_VIEW_SEGMENT FB_GRAPH_SEGMENT
+#endif
+
+/* 0 = kernel reads the segment view directly, 1 = copy to heap scratch first */
+#ifndef BENCH_VIEW_COPY
+#define BENCH_VIEW_COPY 0
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_segment_view\n");
+
+    if (BENCH_VIEW_SEGMENT == 0) {
+        fb_print("view segment disabled\n");
+        return 0;
+    }
+
+    uint32_t n = BENCH_N;
+    uint32_t d = BENCH_D;
+    fb_segment_view_t weights;
+    if (fb_segment_view_init(&weights, BENCH_VIEW_SEGMENT, 0, n * d) != 0) {
+        fb_print("bad view\n");
+        return 1;
+    }
+    int8_t *w = fb_segment_view_i8(&weights, 0, n * d);
+    int8_t *x = (int8_t *)fb_malloc(FB_PREQUANT_BYTES(n));
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * d);
+    int8_t *scratch = (int8_t *)fb_malloc(n * d);
+    if (!w || !x || !out || !scratch) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i8(w, n * d, 1);
+    bench_fill_i8(x, n, 1);
+    *fb_prequant_scale(x, n) = 1 << 16;
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_VIEW_COPY
+        fb_memcpy(scratch, w, n * d);
+        fb_matmul_i8_i8(out, x, scratch, 1 << 16, n, d);
+#else
+        (void)scratch;
+        fb_matmul_i8_i8(out, x, w, 1 << 16, n, d);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -1,13 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB013
-#define ITERS 4
+#define BENCH_DEFAULT_N 8
+#define BENCH_DEFAULT_ITERS 4
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_silu\n");
 
-    size_t n = 8;
+    size_t n = BENCH_N;
     float *data = (float *)fb_malloc(sizeof(float) * n);
     if (!data) {
         fb_print("alloc failed\n");
@@ -15,10 +16,10 @@ int main(void) {
     }
     bench_fill_f32(data, n, -0.5f);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_silu(data, n);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,52 @@
+#!/bin/bash
+# Compare ELF sizes of every benchmark built uncompressed (fb-cc --no-rvc)
+# and with the default compressed target.
+#
+# Reports .text (llvm-size) and the loadable image (text + data, what the
+# upload pays for) per benchmark, then the totals. A zero saving on every
+# row means fb-cc fell back to rv64imfd because clang lacks Zca.
+#
+# Usage: ./bench_size_compare.sh [OUT_DIR] [bench.c ...]
+# Environment: FB_CC, FB_FLAGS, SIZE_FLAGS (extra fb-cc flags for both builds)
+
+set -e
+
+FB_CC=${FB_CC:-fb-cc}
+OUT_DIR=${1:-out}/size_compare
+shift || true
+SOURCES=("$@")
+if [ ${#SOURCES[@]} -eq 0 ]; then
+    SOURCES=(bench_*.c bench_*.cpp)
+fi
+
+mkdir -p "$OUT_DIR/norvc" "$OUT_DIR/rvc"
+
+# "<text> <image>" bytes of an ELF; image = every loaded section but .bss
+elf_sizes() {
+    llvm-size -A "$1" | awk '
+        $1 == ".text" || $1 == ".init" { text += $2 }
+        $1 ~ /^\.(text|init|rodata|srodata|data|sdata)/ { image += $2 }
+        END { printf "%d %d\n", text, image }'
+}
+
+printf "%-32s %9s %9s %7s %9s %9s %7s\n" \
+    bench text text_c saved image image_c saved
+tot_t0=0 tot_t1=0 tot_i0=0 tot_i1=0
+for src in "${SOURCES[@]}"; do
+    name=$(basename "$src")
+    name=${name%.*}
+    # shellcheck disable=SC2086
+    "$FB_CC" $FB_FLAGS $SIZE_FLAGS --no-rvc "$src" -o "$OUT_DIR/norvc/$name.elf" > /dev/null
+    # shellcheck disable=SC2086
+    "$FB_CC" $FB_FLAGS $SIZE_FLAGS "$src" -o "$OUT_DIR/rvc/$name.elf" > /dev/null
+    read -r t0 i0 < <(elf_sizes "$OUT_DIR/norvc/$name.elf")
+    read -r t1 i1 < <(elf_sizes "$OUT_DIR/rvc/$name.elf")
+    tot_t0=$((tot_t0 + t0)) tot_t1=$((tot_t1 + t1))
+    tot_i0=$((tot_i0 + i0)) tot_i1=$((tot_i1 + i1))
+    awk -v n="$name" -v t0="$t0" -v t1="$t1" -v i0="$i0" -v i1="$i1" 'BEGIN {
+        printf "%-32s %9d %9d %6.1f%% %9d %9d %6.1f%%\n", n, t0, t1,
+            t0 ? 100 * (t0 - t1) / t0 : 0, i0, i1, i0 ? 100 * (i0 - i1) / i0 : 0 }'
+done
+awk -v t0="$tot_t0" -v t1="$tot_t1" -v i0="$tot_i0" -v i1="$tot_i1" 'BEGIN {
+    printf "%-32s %9d %9d %6.1f%% %9d %9d %6.1f%%\n", "total", t0, t1,
+        t0 ? 100 * (t0 - t1) / t0 : 0, i0, i1, i0 ? 100 * (i0 - i1) / i0 : 0 }'
@@ -0,0 +1,64 @@
+#include "bench_common.h"
+
+#define TAG 0xB068
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_ITERS 1
+
+/* 0 __addsf3, 1 __subsf3, 2 __mulsf3, 3 __divsf3, 4 __floatsisf,
+ * 5 fb_fmaf, 6 fb_sqrtf, 7 fb_rsqrtf, 8 fb_expf */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+/* Call the builtins directly so the soft path is measured even when fb-cc
+ * compiles the bench itself with the F extension. */
+float __addsf3(float a, float b);
+float __subsf3(float a, float b);
+float __mulsf3(float a, float b);
+float __divsf3(float a, float b);
+float __floatsisf(int a);
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_softfloat\n");
+
+    size_t n = BENCH_N;
+    float *a = (float *)fb_malloc(sizeof(float) * n);
+    float *b = (float *)fb_malloc(sizeof(float) * n);
+    float *out = (float *)fb_malloc(sizeof(float) * n);
+    int32_t *ints = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    if (!a || !b || !out || !ints) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_f32(a, n, 1.5f);
+    bench_fill_f32(b, n, 1.25f);
+    bench_fill_i32(ints, n, -(int32_t)n * 1000);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(it) {
+        for (size_t i = 0; i < n; i++) {
+#if BENCH_OP == 0
+            out[i] = __addsf3(a[i], b[i]);
+#elif BENCH_OP == 1
+            out[i] = __subsf3(a[i], b[i]);
+#elif BENCH_OP == 2
+            out[i] = __mulsf3(a[i], b[i]);
+#elif BENCH_OP == 3
+            out[i] = __divsf3(a[i], b[i]);
+#elif BENCH_OP == 4
+            out[i] = __floatsisf(ints[i]);
+#elif BENCH_OP == 5
+            out[i] = fb_fmaf(a[i], b[i], out[i]);
+#elif BENCH_OP == 6
+            out[i] = fb_sqrtf(a[i]);
+#elif BENCH_OP == 7
+            out[i] = fb_rsqrtf(a[i]);
+#else
+            out[i] = fb_expf(b[i] * 0.0625f);
+#endif
+        }
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
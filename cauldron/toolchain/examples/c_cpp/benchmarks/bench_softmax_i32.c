@@ -1,13 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB022
-#define ITERS 4
+#define BENCH_DEFAULT_N 8
+#define BENCH_DEFAULT_ITERS 4
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_softmax_i32\n");
 
-    size_t n = 8;
+    size_t n = BENCH_N;
     int32_t *data = (int32_t *)fb_malloc(sizeof(int32_t) * n);
     if (!data) {
         fb_print("alloc failed\n");
@@ -15,10 +16,10 @@ int main(void) {
     }
     bench_fill_i32(data, n, 1);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_softmax_i32(data, n);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
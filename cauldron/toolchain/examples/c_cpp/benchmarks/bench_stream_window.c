@@ -0,0 +1,75 @@
+#include "bench_common.h"
+#include "frostbite_stream.h"
+
+#define TAG 0xB07F
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 8
+#define BENCH_DEFAULT_ITERS 4
+
+/*
+ * One new sample per iteration into a BENCH_N-sample window of BENCH_D
+ * Q16 features, then mean and variance of every feature.
+ * 0 = shift the window and recompute the stats from all samples (O(N * D))
+ * 1 = fb_ring_push + fb_ring_stats (O(D))
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_stream_window\n");
+
+    uint32_t window = BENCH_N;
+    uint32_t features = BENCH_D;
+    fb_q16_t *sample = (fb_q16_t *)fb_malloc(sizeof(fb_q16_t) * features);
+    fb_q16_t *mean = (fb_q16_t *)fb_malloc(sizeof(fb_q16_t) * features);
+    fb_q16_t *var = (fb_q16_t *)fb_malloc(sizeof(fb_q16_t) * features);
+#if BENCH_OP == 0
+    fb_q16_t *samples = (fb_q16_t *)fb_malloc(sizeof(fb_q16_t) * window * features);
+    if (!sample || !mean || !var || !samples) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i32(samples, (size_t)window * features, 1);
+#else
+    size_t bytes = FB_RING_BYTES(window, features);
+    void *mem = fb_malloc(bytes);
+    fb_ring_t ring;
+    if (!sample || !mean || !var || !mem || fb_ring_init(mem, bytes, window, features, FB_Q16_HALF) != 0 ||
+        fb_ring_open(&ring, mem, bytes) != 0) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < window; i++) {
+        bench_fill_i32(sample, features, (int32_t)i);
+        fb_ring_push(&ring, sample);
+    }
+#endif
+    bench_fill_i32(sample, features, 3);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(iter) {
+        sample[iter % features] += FB_Q16_ONE;
+#if BENCH_OP == 0
+        fb_memmove(samples, samples + features, sizeof(fb_q16_t) * (window - 1) * features);
+        fb_memcpy(samples + (size_t)(window - 1) * features, sample, sizeof(fb_q16_t) * features);
+        for (uint32_t f = 0; f < features; f++) {
+            int64_t sum = 0, sum_sq = 0;
+            for (uint32_t t = 0; t < window; t++) {
+                int64_t x = samples[(size_t)t * features + f];
+                sum += x;
+                sum_sq += (x * x) >> 16;
+            }
+            int64_t m = sum / window;
+            mean[f] = (fb_q16_t)m;
+            var[f] = (fb_q16_t)(sum_sq / window - ((m * m) >> 16));
+        }
+#else
+        fb_ring_push(&ring, sample);
+        fb_ring_stats(&ring, mean, var, NULL);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
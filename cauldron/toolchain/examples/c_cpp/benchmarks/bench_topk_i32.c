@@ -0,0 +1,63 @@
+#include "bench_common.h"
+
+#define TAG 0xB080
+#define BENCH_DEFAULT_N 256
+#define BENCH_DEFAULT_D 3
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * Top-BENCH_D classes of BENCH_N scrambled i32 logits.
+ * 0 = SOFTMAX_I32 over all logits, then a guest selection loop (K passes)
+ * 1 = fb_topk_i32
+ * 2 = fb_topk_i32 with FB_TOPK_SOFTMAX over the K kept values
+ * 3 = fb_topk_i32_partial, max_per_call = n / 2
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_topk_i32\n");
+
+    uint32_t n = BENCH_N;
+    uint32_t k = BENCH_D;
+    int32_t *logits = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int32_t *work = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    uint32_t *idx = (uint32_t *)fb_malloc(sizeof(uint32_t) * k);
+    int32_t *val = (int32_t *)fb_malloc(sizeof(int32_t) * k);
+    if (!logits || !work || !idx || !val) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        logits[i] = (int32_t)((i * 2654435761u) >> 12) - (1 << 19);
+    }
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(iter) {
+#if BENCH_OP == 0
+        fb_memcpy(work, logits, sizeof(int32_t) * n);
+        fb_softmax_i32(work, n);
+        for (uint32_t j = 0; j < k; j++) {
+            uint32_t best = 0;
+            for (uint32_t i = 1; i < n; i++) {
+                best = work[i] > work[best] ? i : best;
+            }
+            idx[j] = best;
+            val[j] = work[best];
+            work[best] = -1;
+        }
+#elif BENCH_OP == 1
+        (void)fb_topk_i32(logits, n, k, idx, val, 0);
+#elif BENCH_OP == 2
+        (void)fb_topk_i32(logits, n, k, idx, val, FB_TOPK_SOFTMAX);
+#else
+        fb_topk_i32_state_t st = {0, 0, 0, n > 1 ? n / 2 : 1};
+        while (!fb_topk_i32_partial(logits, n, k, idx, val, 0, &st)) {
+        }
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "bench_common.h"
+#include "frostbite_tree.h"
+
+#define TAG 0xB07C
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 64
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * Ensemble of BENCH_D complete trees of depth BENCH_DEPTH over BENCH_N
+ * features, one score per iteration.
+ * 0 = pointer walk over tree_q16_v1 nodes (the guest_tree template loop)
+ * 1 = fb_tree_eval_i32 over the flattened ensemble
+ * 2 = fb_tree_eval_i8 over the flattened ensemble
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 1
+#endif
+
+#ifndef BENCH_DEPTH
+#define BENCH_DEPTH 6
+#endif
+
+#define NODES ((2u << BENCH_DEPTH) - 1u)
+
+static volatile int64_t sink;
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_tree_ensemble\n");
+
+    uint32_t n = BENCH_N;
+    uint32_t trees = BENCH_D;
+    size_t stride = NODES * sizeof(fb_tree_src_node_t);
+    fb_tree_src_node_t *src = (fb_tree_src_node_t *)fb_malloc(stride * trees);
+    int32_t *x = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int8_t *x8 = (int8_t *)fb_malloc(n);
+    if (!src || !x || !x8) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    for (uint32_t t = 0; t < trees; t++) {
+        fb_tree_src_node_t *tree = src + (size_t)t * NODES;
+        for (uint32_t i = 0; i < NODES; i++) {
+            int leaf = i >= NODES / 2u;
+            tree[i].feature = leaf ? -1 : (int32_t)((t * 7u + i * 13u) % n);
+            tree[i].threshold = (int32_t)((i * 37u + t) % 101u) - 50;
+            tree[i].left = leaf ? -1 : (int32_t)(2u * i + 1u);
+            tree[i].right = leaf ? -1 : (int32_t)(2u * i + 2u);
+            tree[i].value = (int32_t)(i * 977u + t) % 4096 - 2048;
+        }
+    }
+    bench_fill_i32(x, n, -(int32_t)(n / 2));
+    bench_fill_i8(x8, n, (int8_t)-(int32_t)(n / 2));
+
+    size_t bytes = fb_tree_bytes(src, NODES, trees, stride, n);
+    void *seg = fb_malloc(bytes);
+    fb_tree_ensemble_t e;
+    if (!seg || fb_tree_build(seg, bytes, src, NODES, trees, stride, n, 0) < 0 ||
+        fb_tree_open(&e, seg, bytes) != 0) {
+        fb_print("tree build failed\n");
+        return 1;
+    }
+    fb_print("%u trees, depth %u: %u bytes\n", trees, e.depth, (uint32_t)bytes);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 0
+        int64_t total = 0;
+        for (uint32_t t = 0; t < trees; t++) {
+            const fb_tree_src_node_t *tree = src + (size_t)t * NODES;
+            int32_t idx = 0;
+            for (uint32_t depth = 0; depth <= FB_TREE_MAX_DEPTH; depth++) {
+                if (idx < 0 || (uint32_t)idx >= NODES) {
+                    return 2;
+                }
+                const fb_tree_src_node_t *nd = &tree[idx];
+                if (nd->feature < 0) {
+                    total += nd->value;
+                    break;
+                }
+                if ((uint32_t)nd->feature >= n) {
+                    return 2;
+                }
+                idx = x[nd->feature] <= nd->threshold ? nd->left : nd->right;
+            }
+        }
+        sink = total;
+#elif BENCH_OP == 1
+        sink = fb_tree_eval_i32(&e, x);
+#else
+        sink = fb_tree_eval_i8(&e, x8);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -1,13 +1,14 @@
 #include "bench_common.h"
 
 #define TAG 0xB031
-#define ITERS 8
+#define BENCH_DEFAULT_N 32
+#define BENCH_DEFAULT_ITERS 8
 
 int main(void) {
     bench_heap_setup();
     fb_print("bench_vec_add_i8\n");
 
-    size_t n = 32;
+    size_t n = BENCH_N;
     int8_t *a = (int8_t *)fb_malloc(sizeof(int8_t) * n);
     int8_t *b = (int8_t *)fb_malloc(sizeof(int8_t) * n);
     if (!a || !b) {
@@ -17,10 +18,10 @@ int main(void) {
     bench_fill_i8(a, n, 1);
     bench_fill_i8(b, n, 2);
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_vec_add_i8(a, b, n);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
@@ -0,0 +1,78 @@
+#include "bench_common.h"
+
+#define TAG 0xB06A
+#define BENCH_DEFAULT_N 256
+#define BENCH_DEFAULT_ITERS 1
+
+/* FB_VEC_OP_* code */
+#ifndef BENCH_OP
+#define BENCH_OP FB_VEC_OP_ADD
+#endif
+
+/* 0 = fb_vec_op_i32, 1 = the plain guest loop it replaces */
+#ifndef BENCH_VEC_OP_NAIVE
+#define BENCH_VEC_OP_NAIVE 0
+#endif
+
+#define VEC_SHIFT 16
+#define VEC_LO (-(1 << 20))
+#define VEC_HI (1 << 20)
+#define VEC_STEP (1 << 16)
+
+#if BENCH_VEC_OP_NAIVE
+static void naive_op(void *dst, const int32_t *a, const int32_t *b, size_t n) {
+    int32_t *out = (int32_t *)dst;
+    (void)out;
+    (void)b;
+    for (size_t i = 0; i < n; i++) {
+#if BENCH_OP == FB_VEC_OP_ADD
+        out[i] = a[i] + b[i];
+#elif BENCH_OP == FB_VEC_OP_SUB
+        out[i] = a[i] - b[i];
+#elif BENCH_OP == FB_VEC_OP_MUL_SHIFT
+        out[i] = (int32_t)(((int64_t)a[i] * b[i]) >> VEC_SHIFT);
+#elif BENCH_OP == FB_VEC_OP_MAX
+        out[i] = a[i] > b[i] ? a[i] : b[i];
+#elif BENCH_OP == FB_VEC_OP_MIN
+        out[i] = a[i] < b[i] ? a[i] : b[i];
+#elif BENCH_OP == FB_VEC_OP_CLAMP
+        out[i] = a[i] < VEC_LO ? VEC_LO : (a[i] > VEC_HI ? VEC_HI : a[i]);
+#else
+        int64_t q = ((int64_t)a[i] * 65536) / VEC_STEP;
+        q = q > 127 ? 127 : (q < -127 ? -127 : q);
+        ((int8_t *)dst)[i] = (int8_t)q;
+#endif
+    }
+}
+#endif
+
+int main(void) {
+    bench_heap_setup();
+    fb_print("bench_vec_op_i32\n");
+
+    size_t n = BENCH_N;
+    int32_t *a = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int32_t *b = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    int32_t *out = (int32_t *)fb_malloc(sizeof(int32_t) * n);
+    if (!a || !b || !out) {
+        fb_print("alloc failed\n");
+        return 1;
+    }
+    bench_fill_i32(a, n, -(int32_t)n / 2);
+    bench_fill_i32(b, n, 1 << 16);
+    int32_t p0 = BENCH_OP == FB_VEC_OP_MUL_SHIFT ? VEC_SHIFT
+               : BENCH_OP == FB_VEC_OP_CLAMP     ? VEC_LO
+                                                 : VEC_STEP;
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_VEC_OP_NAIVE
+        (void)p0;
+        naive_op(out, a, b, n);
+#else
+        (void)fb_vec_op_i32(out, a, b, n, BENCH_OP, p0, VEC_HI);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
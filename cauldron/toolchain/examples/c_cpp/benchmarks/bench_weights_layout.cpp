@@ -0,0 +1,80 @@
+#include "bench_common.h"
+#include "frostbite_layout.hpp"
+
+#define TAG 0xB078
+#define BENCH_DEFAULT_N 64
+#define BENCH_DEFAULT_D 32
+#define BENCH_DEFAULT_ITERS 2
+
+/*
+ * Two-layer MLP (W1 D x N, B1, W2 1 x D, B2) read from a weights segment
+ * with an rvcd-v1 header (blocks start at byte 12).
+ * 0 = block offsets summed from the manifest dims at run time (template guests)
+ * 1 = frostbite_layout.hpp constants (what fb_layout.py headers give C guests)
+ */
+#ifndef BENCH_OP
+#define BENCH_OP 0
+#endif
+
+struct weights_desc_t {
+    uint32_t data_offset;
+    uint32_t input_dim;
+    uint32_t hidden_dim;
+    uint32_t output_dim;
+};
+
+constexpr fb::WeightsLayout<4> kLayout = fb::weights_layout(FB_GRAPH_SEGMENT, 12, {
+    fb::i8_matrix(BENCH_D, BENCH_N), fb::i32_vector(BENCH_D),
+    fb::i8_matrix(1, BENCH_D), fb::i32_vector(1),
+});
+static_assert(kLayout.aligned(), "bench weights misaligned");
+
+static volatile weights_desc_t desc = {12, BENCH_N, BENCH_D, 1};
+static int32_t in[BENCH_N];
+static int32_t hidden[BENCH_D];
+static int32_t out[1];
+static FB_PREQUANT_T(BENCH_N) xq;
+static FB_PREQUANT_T(BENCH_D) hq;
+
+static void layer(int32_t *y, const void *x, uint64_t w, uint64_t b, size_t n, size_t d) {
+    const int32_t *bias = (const int32_t *)(uintptr_t)b;
+    fb_matmul_i8_i8(y, x, (const int8_t *)(uintptr_t)w, 1 << 16, n, d);
+    for (size_t r = 0; r < d; r++) {
+        int32_t v = y[r] + bias[r];
+        y[r] = v < 0 ? 0 : v;
+    }
+}
+
+int main() {
+    fb_print("bench_weights_layout\n");
+    if (FB_GRAPH_SEGMENT == 0) {
+        fb_print("weights segment disabled\n");
+        return 0;
+    }
+    bench_fill_i32(in, BENCH_N, -(int32_t)BENCH_N);
+    bench_fill_i8((int8_t *)(uintptr_t)kLayout.addr(0), kLayout.end() - kLayout.base, 1);
+
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
+#if BENCH_OP == 1
+        fb_quantize_i32_to_prequant(&xq, in, BENCH_N, 0, 0);
+        layer(hidden, &xq, kLayout.addr(0), kLayout.addr(1), BENCH_N, BENCH_D);
+        fb_quantize_i32_to_prequant(&hq, hidden, BENCH_D, 0, 0);
+        layer(out, &hq, kLayout.addr(2), kLayout.addr(3), BENCH_D, 1);
+#else
+        size_t n = desc.input_dim;
+        size_t h = desc.hidden_dim;
+        size_t o = desc.output_dim;
+        size_t w1 = desc.data_offset;
+        size_t b1 = w1 + h * n;
+        size_t w2 = b1 + h * 4;
+        size_t b2 = w2 + o * h;
+        fb_quantize_i32_to_prequant(&xq, in, n, 0, 0);
+        layer(hidden, &xq, FB_SEGMENT_ADDR(FB_GRAPH_SEGMENT, w1), FB_SEGMENT_ADDR(FB_GRAPH_SEGMENT, b1), n, h);
+        fb_quantize_i32_to_prequant(&hq, hidden, h, 0, 0);
+        layer(out, &hq, FB_SEGMENT_ADDR(FB_GRAPH_SEGMENT, w2), FB_SEGMENT_ADDR(FB_GRAPH_SEGMENT, b2), h, o);
+#endif
+    }
+    bench_log(TAG, 1, BENCH_ITERS);
+    return 0;
+}
@@ -1,7 +1,7 @@
 #include "bench_common.h"
 
 #define TAG 0xB019
-#define ITERS 8
+#define BENCH_DEFAULT_ITERS 8
 
 int main(void) {
     bench_heap_setup();
@@ -13,10 +13,10 @@ int main(void) {
         return 1;
     }
 
-    bench_log(TAG, 0, ITERS);
-    for (int i = 0; i < ITERS; i++) {
+    bench_log(TAG, 0, BENCH_ITERS);
+    BENCH_LOOP(i) {
         fb_write_f32((uint64_t)(uintptr_t)value, 2.5f + (float)i);
     }
-    bench_log(TAG, 1, ITERS);
+    bench_log(TAG, 1, BENCH_ITERS);
     return 0;
 }
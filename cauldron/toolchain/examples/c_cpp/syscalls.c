@@ -1,4 +1,11 @@
 #include "frostbite.h"
+#include "frostbite_cost.h"
+#include "frostbite_graph.h"
+#include "frostbite_log.h"
+#include "frostbite_model.h"
+#include "frostbite_sparse.h"
+#include "frostbite_stream.h"
+#include "frostbite_tree.h"
 
 #include <stdint.h>
 #include <stddef.h>
@@ -72,6 +79,35 @@ static void test_system(void) {
     fb_putchar('O');
     fb_putchar('K');
     fb_putchar('\n');
+
+    uint64_t t0 = fb_instret();
+    uint64_t t1 = fb_instret();
+    check(t1 >= t0, "fb_instret monotonic");
+
+    fb_budget_t budget;
+    fb_budget_init(&budget, 10000, 1000);
+    check(fb_budget_remaining(&budget) <= 9000, "budget remaining");
+    check(fb_budgeted_rows(&budget, 100) <= 90, "budgeted rows");
+    check(fb_budgeted_rows(&budget, 1000000) == 1, "budgeted rows min");
+
+    /* 100 fixed + 0.5 per element: 64-element rows cost 32 each */
+    fb_cost_t cost = {100, 0, 1u << 15};
+    check_u32("cost call", (uint32_t)fb_cost_call(&cost, 64, 1), 132);
+    check_u32("cost max rows", fb_cost_max_rows(&cost, 64, 1100), 31);
+    check_u32("cost max rows min", fb_cost_max_rows(&cost, 64, 50), 1);
+    fb_cost_t flat = {100, 0, 0};
+    check_u32("cost max rows flat", fb_cost_max_rows(&flat, 64, 1100), 1000);
+    check_u32("cost transactions", fb_cost_transactions(&cost, 64, 100, 1132, 32), 4);
+
+    static uint8_t bss_bytes[67];
+    static FB_NOINIT uint32_t noinit_word;
+    int bss_zero = 1;
+    for (size_t i = 0; i < sizeof(bss_bytes); i++) {
+        bss_zero &= bss_bytes[i] == 0;
+    }
+    check(bss_zero, "bss cleared");
+    noinit_word = 0x4E4F494Eu;
+    check_u32("noinit word", noinit_word, 0x4E4F494Eu);
 }
 
 static void test_memory(void) {
@@ -90,6 +126,18 @@ static void test_memory(void) {
         for (size_t i = 0; i < 16; i++) {
             check(buf2[i] == 0x5a, "fb_memcpy value");
         }
+
+        check(fb_memcmp(buf, buf2, 16) == 0, "fb_memcmp equal");
+        buf2[15] = 0x5b;
+        check(fb_memcmp(buf, buf2, 16) < 0, "fb_memcmp order");
+
+        for (size_t i = 0; i < 16; i++) {
+            buf[i] = (uint8_t)i;
+        }
+        fb_memmove(buf + 1, buf, 15);
+        for (size_t i = 1; i < 16; i++) {
+            check(buf[i] == (uint8_t)(i - 1), "fb_memmove overlap");
+        }
     }
 
     uint8_t *alias = (uint8_t *)malloc(8);
@@ -104,6 +152,38 @@ static void test_memory(void) {
         }
     }
 
+    fb_arena_t arena;
+    check(fb_arena_init_heap(&arena, 64) == 0, "fb_arena_init_heap");
+    fb_arena_mark_t mark = fb_arena_mark(&arena);
+    uint8_t *a1 = (uint8_t *)fb_arena_alloc(&arena, 3);
+    uint8_t *a2 = (uint8_t *)fb_arena_alloc(&arena, 8);
+    check(a1 != NULL && a2 == a1 + 8, "fb_arena_alloc rounding");
+    check(fb_arena_alloc(&arena, 64) == NULL, "fb_arena_alloc exhausted");
+    fb_arena_reset(&arena, mark);
+    check(fb_arena_alloc(&arena, 64) == a1, "fb_arena_reset");
+
+    fb_heap_mark_t heap_mark;
+    fb_heap_mark(&heap_mark);
+    uint8_t *h1 = (uint8_t *)fb_malloc(24);
+    fb_heap_rewind(&heap_mark);
+    check(h1 != NULL && fb_malloc(24) == h1, "fb_heap_rewind");
+    check(fb_checkpoint(&heap_mark, sizeof(heap_mark)) == (FB_WARM_START ? 0 : -1),
+          "fb_checkpoint");
+    fb_checkpoint_clear();
+
+    fb_segment_view_t view;
+    check(fb_segment_view_init(&view, 0, 0, 16) == -1, "segment view seg 0");
+    check(fb_segment_view_init(&view, FB_HEAP_SEGMENT, FB_SEGMENT_SPAN - 4, 8) == -1,
+          "segment view past span");
+    check(fb_segment_view_init(&view, FB_HEAP_SEGMENT, FB_SEGMENT_SPAN, 0) == -1,
+          "segment view offset at span");
+    check(fb_segment_view_init(&view, FB_HEAP_SEGMENT, 0, 64) == 0, "segment view init");
+    fb_segment_view_t sub = fb_segment_view_slice(&view, 16, 32);
+    check(sub.base == view.base + 16 && sub.len == 32, "segment view slice");
+    check(fb_segment_view_i32(&sub, 0, 8) == (int32_t *)sub.base, "segment view i32");
+    check(fb_segment_view_i32(&sub, 4, 8) == NULL, "segment view bounds");
+    check(fb_segment_view_i32(&sub, 2, 1) == NULL, "segment view align");
+
     float *f = (float *)fb_malloc(sizeof(float));
     if (f) {
         fb_write_f32((uint64_t)f, 3.5f);
@@ -143,6 +223,36 @@ static void test_memory(void) {
     } else {
         check(0, "fb_malloc accum");
     }
+
+    check_f32_bits("fmaf", fb_fmaf(2.0f, 3.0f, 4.0f), 10.0f);
+    check_f32_bits("sqrtf", fb_sqrtf(2.25f), 1.5f);
+    check_f32_bits("rsqrtf", fb_rsqrtf(4.0f), 0.5f);
+    check_f32_bits("expf(0)", fb_expf(0.0f), 1.0f);
+
+    check_i32("q16 mul", fb_q16_mul(FB_Q16(1.5), FB_Q16(-2.0)), FB_Q16(-3.0));
+    check_i32("q16 div", fb_q16_div(FB_Q16(3.0), FB_Q16(2.0)), FB_Q16(1.5));
+    check_i32("q16 sqrt", fb_q16_sqrt(FB_Q16(2.25)), FB_Q16(1.5));
+    check_i32("q16 exp(0)", fb_q16_exp(0), FB_Q16_ONE);
+    check_i32("q16 log(1)", fb_q16_log(FB_Q16_ONE), 0);
+
+    int32_t va[] = {1, -2, 300, 4};
+    int32_t vb[] = {10, 20, -30, 40};
+    int32_t vd[4];
+    fb_vec_add_i32(vd, va, vb, 4);
+    check_i32("vec_add_i32[2]", vd[2], 270);
+    fb_vec_sub_i32(vd, va, vb, 4);
+    check_i32("vec_sub_i32[1]", vd[1], -22);
+    fb_vec_clamp_i32(vd, va, 4, 0, 100);
+    check_i32("vec_clamp_i32[1]", vd[1], 0);
+    check_i32("vec_clamp_i32[2]", vd[2], 100);
+    check_i32("vec_op bad", fb_vec_op_i32(vd, va, vb, 4, 99, 0, 0), -1);
+    check_i32("vec_op shift range",
+              fb_vec_op_i32(vd, va, vb, 4, FB_VEC_OP_MUL_SHIFT, 64, 0), -1);
+    check_i32("vec_op negative shift",
+              fb_vec_op_i32(vd, va, vb, 4, FB_VEC_OP_MUL_SHIFT, -1, 0), -1);
+    int32_t vmin[1] = {INT32_MIN};
+    fb_vec_mul_shift_i32(vd, vmin, vmin, 1, 63);
+    check_i32("vec_mul_shift_i32 min^2 >> 63", vd[0], 1);
 }
 
 static void test_ai(void) {
@@ -164,6 +274,19 @@ static void test_ai(void) {
     check_i32("activation[1]", act[1], 2);
     check_i32("activation[2]", act[2], 0);
     check_i32("activation[3]", act[3], 4);
+
+    fb_cmd_t cmds[] = {
+        FB_CMD_DOT_I8(a, b, 4),
+        FB_CMD_VEC_ADD_I8(dst, a, 4),
+        FB_CMD(FB_SYS_EXIT, 7),
+    };
+    check(fb_cmd_run(cmds, 3) == 2, "fb_cmd_run rejects exit");
+    check_i32("cmd dot_i8", (int32_t)cmds[0].result, 20);
+    check_i32("cmd vec_add_i8[0]", dst[0], 6);
+    check_i32("cmd rejected", (int32_t)cmds[2].result, -1);
+    check_u32("cmd argc", cmds[0].argc, 3);
+    cmds[0].argc = 8;
+    check(fb_cmd_run(cmds, 1) == 0 && cmds[0].result == -1, "fb_cmd_run rejects argc");
 }
 
 static void test_llm(void) {
@@ -206,6 +329,63 @@ static void test_llm(void) {
     fb_silu_mul_i32(ai, bi, 0);
     fb_rmsnorm_i32(ai, ai, 0, 0);
 
+    /* max_per_call 0: every pass in one call, no yields */
+    fb_reduce_i32_state_t reduce = {0, 0, 0, 0, 0};
+    while (!fb_dot_i32_resumable(ai, bi, 4, 1, &reduce)) {
+    }
+    check_i32("dot_i32_resumable", (int32_t)reduce.acc, 5);
+
+    int32_t rx[] = {10, 0, 0, 0};
+    int16_t rw[] = {4096, 4096, 4096, 4096, 4096};
+    int32_t rout[4];
+    fb_reduce_i32_state_t rms = {0, 0, 0, 0, 0};
+    while (!fb_rmsnorm_i32_resumable(rout, rx, (uint64_t)(uintptr_t)rw, 4, &rms)) {
+    }
+    check_i32("rmsnorm_i32_resumable[0]", rout[0], 2);
+    check_i32("rmsnorm_i32_resumable[1]", rout[1], 0);
+
+    /* fused norm -> prequant: rmsnorm gives {2, 0, 0, 0}, dynamic step 1033 */
+    FB_PREQUANT_T(4) normq;
+    check_i32("rmsnorm_prequant scale",
+              fb_rmsnorm_i32_to_prequant(&normq, rx, (uint64_t)(uintptr_t)rw, 4, 0, 0), 1033);
+    check_i32("rmsnorm_prequant x[0]", normq.x[0], 127);
+    check_i32("rmsnorm_prequant x[1]", normq.x[1], 0);
+    (void)fb_rmsnorm_i32_to_prequant(&normq, rx, (uint64_t)(uintptr_t)rw, 4, 1 << 16, 0);
+    check_i32("rmsnorm_prequant static x[0]", normq.x[0], 2);
+
+    int32_t sm[] = {0, 0, 1 << 16, 1 << 16};
+    fb_reduce_i32_state_t soft = {0, 0, 0, 0, 0};
+    while (!fb_softmax_i32_resumable(sm, 4, &soft)) {
+    }
+    check_i32("softmax_i32_resumable[0]", sm[0], 8812);
+    check_i32("softmax_i32_resumable[2]", sm[2], 23955);
+
+    int32_t logits[] = {3 << 16, -65536, 5 << 16, 3 << 16, 0, 4 << 16};
+    uint32_t top_idx[3];
+    int32_t top_val[3];
+    check_u32("topk count", fb_topk_i32(logits, 6, 3, top_idx, top_val, 0), 3);
+    check_u32("topk idx[0]", top_idx[0], 2);
+    check_u32("topk idx[1]", top_idx[1], 5);
+    check_u32("topk idx[2] tie", top_idx[2], 0);
+    check_i32("topk val[2]", top_val[2], 3 << 16);
+    fb_topk_i32_state_t topk = {0, 0, 0, 4};
+    while (!fb_topk_i32_partial(logits, 6, 2, top_idx, top_val, FB_TOPK_SOFTMAX, &topk)) {
+    }
+    check_u32("topk partial idx[1]", top_idx[1], 5);
+    check(top_val[0] > top_val[1] && top_val[0] + top_val[1] > 65500, "topk softmax");
+
+    int32_t act[] = {-508, 254, 127, 0, 63};
+    FB_PREQUANT_T(5) pq;
+    int32_t pq_scale = fb_quantize_i32_to_prequant(&pq, act, 5, 0, 0);
+    check_i32("prequant scale", pq_scale, 4 << 16);
+    check_i32("prequant x[0]", pq.x[0], -127);
+    check_i32("prequant x[1]", pq.x[1], 64);
+    check_i32("prequant x[4]", pq.x[4], 16);
+    check_i32("prequant pad", pq.x[7], 0);
+    pq_scale = fb_quantize_i32_to_prequant(&pq, act, 5, 0, FB_PREQUANT_RELU);
+    check_i32("prequant relu x[0]", pq.x[0], 0);
+    check_i32("prequant relu scale", pq.x_scale_q16, pq_scale);
+
     fb_matmul_i8_i8(ai, &dummy, (const int8_t *)&dummy, 1 << 16, 0, 0);
     fb_matmul_i8_i8_partial(ai, &dummy, (const int8_t *)&dummy, 1 << 16, 0, 0, &row_state);
 
@@ -223,6 +403,116 @@ static void test_llm(void) {
     fb_matmul_w1w3_silu_cfg_t w1w3_silu_cfg = {0};
     w1w3_silu_cfg.state_ptr = (uint64_t)&row_state;
     fb_matmul_i8_i8_w1w3_silu(&w1w3_silu_cfg);
+
+    FB_PREQUANT_T(4) ba_x = {{2, 0, 0, 0}, 1 << 16};
+    int8_t ba_w[] = {1, 0, 0, 0, -3, 0, 0, 0};
+    int32_t ba_bias[] = {1, 2};
+    int32_t ba_out[2] = {0};
+    FB_PREQUANT_T(2) ba_q;
+    fb_row_state_t ba_state = {0, 0};
+    fb_matmul_bias_act_cfg_t ba_cfg = {0};
+    ba_cfg.out_ptr = (uint64_t)ba_out;
+    ba_cfg.x_ptr = (uint64_t)&ba_x;
+    ba_cfg.w_ptr = (uint64_t)ba_w;
+    ba_cfg.bias_ptr = (uint64_t)ba_bias;
+    ba_cfg.out_q_ptr = (uint64_t)&ba_q;
+    ba_cfg.w_scale = 1 << 16;
+    ba_cfg.n = 4;
+    ba_cfg.d = 2;
+    ba_cfg.act = FB_ACT_RELU;
+    ba_cfg.out_scale = 1 << 16;
+    ba_cfg.state_ptr = (uint64_t)&ba_state;
+    check_i32("bias_act done", fb_matmul_i8_i8_bias_act(&ba_cfg), 1);
+    check_i32("bias_act[0]", ba_out[0], 3);
+    check_i32("bias_act[1]", ba_out[1], 0);
+    check_i32("bias_act q[0]", ba_q.x[0], 3);
+    check_i32("bias_act scale", ba_q.x_scale_q16, 1 << 16);
+    check_i32("q16 sigmoid(0)", fb_q16_sigmoid(0), FB_Q16_HALF);
+
+    /* int4: 2 x 18 rows (two 16-weight groups, padded tail) vs the int8 kernel */
+    FB_PREQUANT_T(18) i4_x;
+    int8_t i4_w[36];
+    uint64_t i4_packed[FB_I4_BYTES(18, 2) / 8];
+    uint64_t i4_row[FB_I4_ROW_BUF_BYTES(18) / 8];
+    int32_t i4_scales[] = {1 << 16, 2 << 16};
+    int32_t i4_out[2], i8_out[2];
+    for (int i = 0; i < 18; i++) {
+        i4_x.x[i] = (int8_t)(i - 9);
+        i4_w[i] = (int8_t)((i % 16) - 8);
+        i4_w[18 + i] = (int8_t)(7 - (i % 16));
+    }
+    i4_x.x[18] = i4_x.x[19] = 0;
+    i4_x.x_scale_q16 = 1 << 16;
+    fb_i4_pack((uint8_t *)i4_packed, i4_w, 18, 2);
+    fb_matmul_i4_i8(i4_out, &i4_x, (const uint8_t *)i4_packed, i4_scales, 18, 2, (int8_t *)i4_row);
+    fb_matmul_i8_i8(&i8_out[0], &i4_x, i4_w, i4_scales[0], 18, 1);
+    fb_matmul_i8_i8(&i8_out[1], &i4_x, i4_w + 18, i4_scales[1], 18, 1);
+    check_i32("i4 row 0", i4_out[0], i8_out[0]);
+    check_i32("i4 row 1", i4_out[1], i8_out[1]);
+    fb_row_state_t i4_state = {0, 0};
+    i4_out[1] = 0;
+    check_i32("i4 partial done", fb_matmul_i4_i8_partial(i4_out, &i4_x, (const uint8_t *)i4_packed,
+                                                         i4_scales, 18, 2, (int8_t *)i4_row,
+                                                         &i4_state), 1);
+    check_i32("i4 partial row 1", i4_out[1], i8_out[1]);
+    fb_argmax_i32_state_t i4_arg = {0, 0, INT32_MIN, 0};
+    check_i32("i4 argmax done", fb_matmul_i4_i8_argmax_partial(&i4_x, (const uint8_t *)i4_packed,
+                                                               i4_scales, 18, 2, (int8_t *)i4_row,
+                                                               &i4_arg), 1);
+    check_u32("i4 argmax", i4_arg.max_idx, i8_out[1] > i8_out[0] ? 1u : 0u);
+
+    /* batch of 3 inputs vs the 2 x 18 int8 rows: one pass per weight row (m > d) */
+    int32_t bx[3 * 18];
+    uint32_t batch[FB_BATCH_BYTES(18, 3) / 4];
+    uint32_t batch_scratch[FB_MATMUL_BATCH_SCRATCH_BYTES(18, 3) / 4];
+    int32_t b_out[6];
+    FB_PREQUANT_T(18) bq;
+    for (int i = 0; i < 3 * 18; i++) {
+        bx[i] = (i * 37 % 29 - 14) * (i / 18 + 1) * 1000;
+    }
+    fb_quantize_i32_to_batch(batch, bx, 18, 3, 0, 0);
+    fb_matmul_i8_i8_batch(b_out, batch, i4_w, 3 << 15, 18, 2, 3, batch_scratch);
+    fb_quantize_i32_to_prequant(&bq, bx + 2 * 18, 18, 0, 0);
+    fb_matmul_i8_i8(i8_out, &bq, i4_w, 3 << 15, 18, 2);
+    check_i32("batch m>d row 0", b_out[4], i8_out[0]);
+    check_i32("batch m>d row 1", b_out[5], i8_out[1]);
+    /* first 2 inputs: one pass per input (m <= d), resumable */
+    fb_row_state_t b_state = {0, 1};
+    fb_quantize_i32_to_batch(batch, bx, 18, 2, 0, 0);
+    while (!fb_matmul_i8_i8_batch_partial(b_out, batch, i4_w, 3 << 15, 18, 2, 2,
+                                          batch_scratch, &b_state)) {
+    }
+    fb_quantize_i32_to_prequant(&bq, bx + 18, 18, 0, 0);
+    fb_matmul_i8_i8(i8_out, &bq, i4_w, 3 << 15, 18, 2);
+    check_i32("batch partial row 0", b_out[2], i8_out[0]);
+    check_i32("batch partial row 1", b_out[3], i8_out[1]);
+
+    /* 3 x 4 weights over two heap buffers; row 1 straddles them */
+    int8_t *part_a = (int8_t *)fb_malloc(8);
+    int8_t *part_b = (int8_t *)fb_malloc(8);
+    if (part_a && part_b) {
+        static const int8_t ws[12] = {1, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 1};
+        fb_memcpy(part_a, ws, 6);
+        fb_memcpy(part_b, ws + 6, 6);
+        fb_seg_tensor_t wt;
+        uint64_t pa = (uint64_t)(uintptr_t)part_a, pb = (uint64_t)(uintptr_t)part_b;
+        fb_seg_tensor_init(&wt, 4);
+        check(fb_seg_tensor_add(&wt, (uint32_t)(pa >> 28), (uint32_t)(pa & 0x0FFFFFFFu), 6) == 0 &&
+                  fb_seg_tensor_add(&wt, (uint32_t)(pb >> 28), (uint32_t)(pb & 0x0FFFFFFFu), 6) == 0,
+              "seg tensor add");
+        check_u32("seg tensor rows", fb_seg_tensor_rows(&wt), 3);
+        FB_PREQUANT_T(4) sx = {{1, 2, 3, 4}, 1 << 16};
+        int32_t s_out[3] = {0, 0, 0};
+        int8_t s_row[4];
+        fb_row_state_t s_state = {0, 2};
+        check_i32("seg matmul no row_buf",
+                  fb_matmul_i8_i8_seg_partial(s_out, &sx, &wt, 1 << 16, 4, 3, NULL, &s_state), -1);
+        while (!fb_matmul_i8_i8_seg_partial(s_out, &sx, &wt, 1 << 16, 4, 3, s_row, &s_state)) {
+        }
+        check_i32("seg matmul row 0", s_out[0], 1);
+        check_i32("seg matmul straddle", s_out[1], 2);
+        check_i32("seg matmul row 2", s_out[2], 10);
+    }
 }
 
 static void test_quantum(void) {
@@ -236,6 +526,326 @@ static void test_quantum(void) {
     fb_quantum_op(FB_QOP_INIT, 0, 0, state);
     int meas = fb_quantum_op(FB_QOP_MEASURE, 0, 0, state);
     check(meas == 0 || meas == 1, "quantum measure range");
+
+    /* H H and the mirrored CNOT pair cancel, leaving INIT + MEASURE */
+    fb_qgate_t circuit[] = {
+        FB_QGATE(FB_QOP_INIT, 0, 0),    FB_QGATE(FB_QOP_H, 0, 0),
+        FB_QGATE(FB_QOP_H, 0, 0),       FB_QGATE(FB_QOP_CNOT, 1, 0),
+        FB_QGATE(FB_QOP_H, 1, 0),       FB_QGATE(FB_QOP_H, 1, 0),
+        FB_QGATE(FB_QOP_CNOT, 1, 0),    FB_QGATE(FB_QOP_MEASURE, 0, 7),
+    };
+    size_t gates = fb_quantum_circuit_simplify(circuit, 8);
+    check_u32("quantum simplify", (uint32_t)gates, 2);
+    int outcome = -1;
+    check_i32("quantum run", fb_quantum_run(circuit, gates, state, &outcome), 1);
+    check_i32("quantum run measure", outcome, 0);
+    fb_qgate_t bad_gate[] = {FB_QGATE(FB_QOP_CNOT, 1, 1)};
+    check_i32("quantum run bad", fb_quantum_run(bad_gate, 1, state, NULL), -1);
+}
+
+static void test_model(void) {
+    static uint64_t ctrl_words[7];
+    static int32_t input[4] = {1, 2, 3, 4};
+    static int32_t output[4];
+    fb_model_control_v1_t *ctrl = (fb_model_control_v1_t *)ctrl_words;
+    fb_model_t m;
+
+    fb_memset(ctrl, 0, sizeof(*ctrl));
+    check_u32("model bad magic",
+              fb_model_open(&m, (uint64_t)(uintptr_t)ctrl, sizeof(output), FB_MODEL_SCHEMA_ANY, 0),
+              FB_MODEL_ERR_CTRL);
+
+    ctrl->magic = FB_MODEL_CTRL_MAGIC;
+    ctrl->abi_version = FB_MODEL_ABI_VERSION;
+    ctrl->input_ptr = (uint32_t)(uintptr_t)input;
+    ctrl->input_len = sizeof(input);
+    ctrl->output_ptr = (uint32_t)(uintptr_t)output;
+    check_u32("model open",
+              fb_model_open(&m, (uint64_t)(uintptr_t)ctrl, sizeof(output), FB_MODEL_SCHEMA_ANY, 0),
+              FB_MODEL_OK);
+    const int32_t *x = fb_model_input_i32(&m, 0, 4);
+    int32_t *y = fb_model_output_i32(&m, 0, 4);
+    check(x == input && y == output, "model spans in place");
+    check(fb_model_input_i32(&m, 0, 5) == NULL, "model input past end");
+    check(fb_model_output_i32(&m, 0, 5) == NULL, "model output past max");
+    check_u32("model output_len", m.output_len, sizeof(output));
+    check_u32("crc32", fb_crc32("123456789", 9), 0xCBF43926u);
+
+    ctrl->input_len = FB_SEGMENT_SPAN;
+    check_u32("model input bounds",
+              fb_model_open(&m, (uint64_t)(uintptr_t)ctrl, sizeof(output), FB_MODEL_SCHEMA_ANY, 0),
+              FB_MODEL_ERR_INPUT_BOUNDS);
+}
+
+static void test_blog(void) {
+    static const uint8_t expect[8] = {1, 0x80, 0xE2, 0x02, 7, 1, 0xD8, 0x04};
+    fb_blog_t b;
+    fb_blog_begin(&b, 0xB100, 7);
+    fb_blog_i64(&b, -1);
+    fb_blog_i64(&b, 300);
+    check_u32("blog len", b.len, 8);
+    check(fb_memcmp(b.buf, expect, sizeof(expect)) == 0, "blog bytes");
+    check_u32("blog dropped", b.dropped, 0);
+    check_u32("blog emit", (uint32_t)fb_blog_emit(&b), 17);
+
+    /* 10-byte fields: five fit, the rest are dropped and reported in a trailer */
+    fb_blog_begin(&b, 0xB100, 7);
+    for (int i = 0; i < 8; i++) {
+        fb_blog_i64(&b, INT64_MIN);
+    }
+    check_u32("blog overflow len", b.len, 55);
+    check_u32("blog overflow dropped", b.dropped, 3);
+    check_u32("blog overflow emit", (uint32_t)fb_blog_emit(&b), 81 + 17);
+}
+
+static void test_csr(void) {
+    static const int8_t w_a[4] = {1, 1, 1, 1};
+    static const int8_t w_b[4] = {-1, -1, -1, -1};
+    fb_csr_edge_t edges[3] = {
+        {1, 2, w_a},
+        {0, 1, w_b},
+        {1, 0, w_b},
+    };
+    size_t bytes = fb_csr_bytes(3, 3, 4);
+    uint8_t *seg = (uint8_t *)fb_malloc(bytes);
+    fb_graph_hit_t *hits = (fb_graph_hit_t *)fb_malloc(sizeof(fb_graph_hit_t) * 2);
+    if (!seg || !hits) {
+        check(0, "fb_malloc csr");
+        return;
+    }
+    fb_csr_t g;
+    check(fb_csr_build(seg, bytes, 3, 4, edges, 3) == 0, "csr build");
+    check(fb_csr_open(&g, seg, bytes) == 0, "csr open");
+
+    uint32_t deg = 0;
+    const uint32_t *nb = fb_csr_neighbors(&g, 1, &deg, NULL);
+    check_u32("csr deg", deg, 2);
+    check(nb && nb[0] == 0 && nb[1] == 2, "csr sorted adjacency");
+    uint32_t *nb_w = (uint32_t *)(uintptr_t)nb;
+    nb_w[1] = 3;
+    check(fb_csr_open(&g, seg, bytes) == -1, "csr open target range");
+    nb_w[1] = 0;
+    check(fb_csr_open(&g, seg, bytes) == -1, "csr open target order");
+    nb_w[1] = 2;
+    check(fb_csr_open(&g, seg, bytes) == 0, "csr reopen");
+    check_u32("csr find edge", fb_csr_find_edge(&g, 1, 2), 2);
+    check_u32("csr missing edge", fb_csr_find_edge(&g, 2, 1), FB_CSR_NONE);
+
+    FB_PREQUANT_T(4) xq = {{1, 2, 3, 4}, FB_Q16_ONE};
+    uint32_t n_hits = fb_csr_graph_search(&g, 1, &xq, hits, 0, NULL);
+    check_u32("csr search hits", n_hits, 1);
+    check_u32("csr search target", hits[0].target, 2);
+    check_i32("csr search score", hits[0].score, 10);
+    fb_graph_hit_t best;
+    check_u32("csr topk hits", fb_csr_graph_search_topk(&g, 1, &xq, &best, 1, INT32_MIN, NULL), 1);
+    check_u32("csr topk target", best.target, 2);
+
+    int32_t edge_scores[3];
+    uint8_t edge_mask[3];
+    check_u32("csr arb score", fb_csr_arb_score(&g, &xq, -10, edge_scores, edge_mask), 3);
+    fb_csr_cycle_state_t *cyc = (fb_csr_cycle_state_t *)fb_malloc(fb_csr_cycle_state_bytes(3));
+    fb_csr_cycle_t cycle;
+    if (!cyc) {
+        check(0, "fb_malloc csr cycle");
+        return;
+    }
+    check(fb_csr_cycle_init(cyc, fb_csr_cycle_state_bytes(3), &g, 0, 3, 0) == 0, "csr cycle init");
+    check(fb_csr_cycle_search(&g, edge_scores, edge_mask, INT32_MIN, &cycle, 1, cyc) == 1,
+          "csr cycle search");
+    check_u32("csr cycle found", cyc->found, 1);
+    check_u32("csr cycle hops", cycle.hops, 2);
+    check_i32("csr cycle score", (int32_t)cycle.score, -20);
+
+    static const int8_t node_feat[3] = {1, 2, 4};
+    int32_t gnn_buf[2][3];
+    fb_csr_gnn_state_t gnn_state = {0, 0, 0}; /* max_rows 0: no yields */
+    fb_csr_gnn_cfg_t gnn = {0};
+    gnn.graph_ptr = (uint64_t)(uintptr_t)&g;
+    gnn.feat_ptr = (uint64_t)(uintptr_t)node_feat;
+    gnn.buf_ptr[0] = (uint64_t)(uintptr_t)gnn_buf[0];
+    gnn.buf_ptr[1] = (uint64_t)(uintptr_t)gnn_buf[1];
+    gnn.state_ptr = (uint64_t)(uintptr_t)&gnn_state;
+    gnn.feat_type = FB_CSR_FEAT_I8;
+    gnn.in_dim = 1;
+    gnn.num_layers = 2;
+    gnn.layers[0] = (fb_csr_gnn_layer_t){0, 0, 1, FB_ACT_NONE, 0};
+    gnn.layers[1] = gnn.layers[0];
+    void *gnn_scratch = fb_malloc(fb_csr_gnn_scratch_bytes(&gnn));
+    if (!gnn_scratch) {
+        check(0, "fb_malloc csr gnn");
+        return;
+    }
+    gnn.scratch_ptr = (uint64_t)(uintptr_t)gnn_scratch;
+    int gnn_calls = 1;
+    while (fb_csr_gnn(&gnn) == 0) {
+        gnn_calls++;
+    }
+    check_u32("csr gnn calls", (uint32_t)gnn_calls, 1);
+    check_i32("csr gnn node 0", fb_csr_gnn_output(&gnn)[0], 5);
+    check_i32("csr gnn node 1", fb_csr_gnn_output(&gnn)[1], 2);
+
+    size_t log_bytes = fb_csr_delta_bytes(2, 4);
+    fb_csr_delta_header_t *log = (fb_csr_delta_header_t *)fb_malloc(log_bytes);
+    uint8_t *next = (uint8_t *)fb_malloc(fb_csr_bytes(3, 3, 4));
+    uint32_t order[2];
+    if (!log || !next) {
+        check(0, "fb_malloc csr delta");
+        return;
+    }
+    fb_csr_delta_reset(log, g.generation, 4);
+    check(fb_csr_delta_append(log, log_bytes, 1, 0, FB_CSR_DELTA_DELETE, NULL) == 0,
+          "csr delta delete");
+    check(fb_csr_delta_append(log, log_bytes, 2, 1, FB_CSR_DELTA_UPSERT, w_a) == 0,
+          "csr delta upsert");
+    check(fb_csr_delta_append(log, log_bytes, 0, 2, FB_CSR_DELTA_UPSERT, w_a) == -1,
+          "csr delta full");
+    check(fb_csr_compact(next, fb_csr_bytes(3, 3, 4), &g, log, log_bytes, order) == 3,
+          "csr compact edges");
+    check(fb_csr_open(&g, next, fb_csr_bytes(3, 3, 4)) == 0, "csr compact open");
+    check_u32("csr compact generation", g.generation, 1);
+    check_u32("csr compact deleted", fb_csr_find_edge(&g, 1, 0), FB_CSR_NONE);
+    check_u32("csr compact inserted", fb_csr_find_edge(&g, 2, 1), 2);
+}
+
+static void test_sparse(void) {
+    /* 3 x 8, 2 x 4 blocks: only blocks (0, 0) and (1, 1) are nonzero */
+    static const int8_t w[24] = {
+        1, 2, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 3, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, -1, 0, 2,
+    };
+    FB_PREQUANT_T(8) xq = {{1, 2, 3, 4, 5, 6, 7, 8}, FB_Q16_ONE};
+    size_t bytes = fb_bsr_bytes(w, 8, 3, 2, 4);
+    uint8_t *seg = (uint8_t *)fb_malloc(bytes);
+    int32_t dense[3], out[3];
+    fb_bsr_t m;
+    if (!seg) {
+        check(0, "fb_malloc bsr");
+        return;
+    }
+    check(fb_bsr_build(seg, bytes, w, 8, 3, 2, 4) == (long)bytes, "bsr build");
+    check(fb_bsr_open(&m, seg, bytes) == 0, "bsr open");
+    check_u32("bsr blocks", m.num_blocks, 2);
+    uint8_t *scratch = (uint8_t *)fb_malloc(fb_bsr_scratch_bytes(&m));
+    if (!scratch) {
+        check(0, "fb_malloc bsr scratch");
+        return;
+    }
+    fb_matmul_i8_i8(dense, &xq, w, 2 << 16, 8, 3);
+    fb_bsr_matmul_i8_i8(out, &xq, &m, 2 << 16, scratch);
+    check_i32("bsr row 0", out[0], dense[0]);
+    check_i32("bsr row 1", out[1], dense[1]);
+    check_i32("bsr row 2", out[2], dense[2]);
+    fb_row_state_t st = {0, 0};
+    out[2] = 0;
+    check_i32("bsr partial done", fb_bsr_matmul_i8_i8_partial(out, &xq, &m, 2 << 16, scratch, &st), 1);
+    check_i32("bsr partial row 2", out[2], dense[2]);
+    seg[0] ^= 1;
+    check(fb_bsr_open(&m, seg, bytes) != 0, "bsr bad magic");
+}
+
+static void test_tree(void) {
+    /* tree 0: x[0] <= 10 ? leaf 5 : (x[1] <= -3 ? leaf 7 : leaf 9); tree 1: leaf 100 */
+    static const fb_tree_src_node_t src[2][5] = {
+        {{0, 10, 1, 2, 0}, {-1, 0, -1, -1, 5}, {1, -3, 3, 4, 0}, {-1, 0, -1, -1, 7}, {-1, 0, -1, -1, 9}},
+        {{-1, 0, -1, -1, 100}, {-1, 0, -1, -1, 0}, {-1, 0, -1, -1, 0}, {-1, 0, -1, -1, 0},
+         {-1, 0, -1, -1, 0}},
+    };
+    size_t bytes = fb_tree_bytes(src, 5, 2, sizeof(src[0]), 2);
+    uint8_t *seg = (uint8_t *)fb_malloc(bytes);
+    fb_tree_ensemble_t e;
+    if (!seg) {
+        check(0, "fb_malloc tree");
+        return;
+    }
+    check(fb_tree_build(seg, bytes, src, 5, 2, sizeof(src[0]), 2, 1000) == (long)bytes, "tree build");
+    check(fb_tree_open(&e, seg, bytes) == 0, "tree open");
+    check_u32("tree depth", e.depth, 2);
+    int32_t a[2] = {10, 50}, b[2] = {11, -3}, c[2] = {11, -2};
+    int8_t c8[2] = {11, -2};
+    check_i32("tree left leaf", (int32_t)fb_tree_eval_i32(&e, a), 1105);
+    check_i32("tree right-left", (int32_t)fb_tree_eval_i32(&e, b), 1107);
+    check_i32("tree right-right", (int32_t)fb_tree_eval_i32(&e, c), 1109);
+    check_i32("tree i8", (int32_t)fb_tree_eval_i8(&e, c8), 1109);
+    int64_t sum = 0;
+    fb_row_state_t st = {0, 0};
+    check_i32("tree partial done", fb_tree_eval_i32_partial(&e, b, &sum, &st), 1);
+    check_i32("tree partial", (int32_t)sum, 1107);
+    check(fb_tree_open(&e, seg, bytes - 1) != 0, "tree short segment");
+}
+
+static void test_conv1d(void) {
+    /* 5 positions x 2 channels, 2 filters of 3 taps, pad 1: out[p] = conv of x[p-1..p+1] */
+    static const int8_t x[10] = {1, -1, 2, 0, 3, 1, -2, 4, 0, 5};
+    static const int8_t w_oik[12] = {1, 1, 1, 0, 0, 0, 1, 0, -1, 2, 2, 2};
+    static const int32_t bias[2] = {0, -8};
+    int8_t w[12];
+    uint32_t win[FB_CONV1D_WINDOW_BYTES(3, 2) / 4];
+    int32_t out[10];
+    fb_conv1d_pack_weights(w, w_oik, 2, 2, 3);
+    fb_conv1d_cfg_t cfg = {(uint64_t)(uintptr_t)out, (uint64_t)(uintptr_t)x, (uint64_t)(uintptr_t)w,
+                           (uint64_t)(uintptr_t)bias, (uint64_t)(uintptr_t)win, FB_Q16_ONE,
+                           FB_Q16_ONE, 5, 2, 2, 3, 1, 1, 1, FB_ACT_RELU, 0};
+    check_u32("conv1d out_len", fb_conv1d_out_len(&cfg), 5);
+    check_i32("conv1d done", fb_conv1d_i8(&cfg), 1);
+    /* filter 0 sums channel 0 over the taps; filter 1 is ch0[t-1] - ch0[t+1] + 2 * ch1 sums - 8 */
+    check_i32("conv1d p0 f0", out[0], 3);
+    check_i32("conv1d p1 f1 relu", out[3], 0);
+    check_i32("conv1d p2 f1", out[5], 6);
+    check_i32("conv1d p4 f1", out[9], 8);
+    cfg.stride = 0;
+    check_i32("conv1d bad stride", fb_conv1d_i8(&cfg), -1);
+}
+
+static void test_embed(void) {
+    /* 4 x 8 table, row r = r + c; bags {1, 3, 3} and {0, 2} */
+    static int8_t table[32] __attribute__((aligned(8)));
+    static const uint32_t user_ids[3] = {1, 3, 3};
+    static const uint32_t item_ids[2] = {0, 2};
+    uint64_t acc[FB_EMBED_ACC_BYTES(8) / 8];
+    int32_t user[8], item[8];
+    for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 8; c++) {
+            table[r * 8 + c] = (int8_t)(r + c - (c & 1) * 2 * c);
+        }
+    }
+    check_i32("embed sum", fb_embed_bag_i8(user, table, 8, 4, user_ids, 3, FB_EMBED_SUM, acc), 0);
+    check_i32("embed sum c0", user[0], 7);
+    check_i32("embed sum c1", user[1], 4);
+    check_i32("embed mean", fb_embed_bag_i8(item, table, 8, 4, item_ids, 2, FB_EMBED_MEAN, acc), 0);
+    check_i32("embed mean c3", item[3], -2);
+    check_i32("embed tower dot", (int32_t)fb_dot_i32(user, item, 8, 0), 436);
+    fb_row_state_t st = {0, 1};
+    int r;
+    while ((r = fb_embed_bag_i8_partial(item, table, 8, 4, user_ids, 3, FB_EMBED_SUM, acc, &st)) == 0) {
+    }
+    check_i32("embed partial done", r, 1);
+    check_i32("embed partial c1", item[1], 4);
+    check_i32("embed bad id", fb_embed_bag_i8(user, table, 8, 3, user_ids, 3, FB_EMBED_SUM, acc), -1);
+}
+
+static void test_stream(void) {
+    /* window 3, one feature: push 1..5, then the window holds 3, 4, 5 */
+    static uint64_t mem[FB_RING_BYTES(3, 1) / 8 + 1];
+    fb_ring_t r;
+    check(fb_ring_open(&r, mem, sizeof(mem)) != 0, "ring open before init");
+    check_i32("ring init", fb_ring_init(mem, sizeof(mem), 3, 1, FB_Q16_HALF), 0);
+    check_i32("ring open", fb_ring_open(&r, mem, sizeof(mem)), 0);
+    for (int i = 1; i <= 5; i++) {
+        fb_q16_t x = fb_q16_from_int(i);
+        fb_ring_push(&r, &x);
+    }
+    check_u32("ring count", r.hdr->count, 3);
+    check_i32("ring mean", fb_ring_mean(&r, 0), 4 * FB_Q16_ONE);
+    check_i32("ring var", fb_ring_var(&r, 0), 43690); /* 2/3 */
+    check_i32("ring newest", fb_ring_at(&r, 0, 0), 5 * FB_Q16_ONE);
+    check_i32("ring oldest", fb_ring_at(&r, 2, 0), 3 * FB_Q16_ONE);
+    /* ema: 1, 1.5, 2.25, 3.125, 4.0625 */
+    check_i32("ring ema", fb_ring_ema(&r, 0), 266240);
+    fb_q16_t window[3];
+    check_u32("ring copy", fb_ring_copy_window(&r, window), 3);
+    check_i32("ring copy oldest", window[0], 3 * FB_Q16_ONE);
+    check_i32("ring copy newest", window[2], 5 * FB_Q16_ONE);
 }
 
 #if FB_ONCHAIN
@@ -323,6 +933,22 @@ int main(void) {
     test_llm();
     fb_print("test_quantum\n");
     test_quantum();
+    fb_print("test_model\n");
+    test_model();
+    fb_print("test_csr\n");
+    test_csr();
+    fb_print("test_blog\n");
+    test_blog();
+    fb_print("test_sparse\n");
+    test_sparse();
+    fb_print("test_tree\n");
+    test_tree();
+    fb_print("test_conv1d\n");
+    test_conv1d();
+    fb_print("test_embed\n");
+    test_embed();
+    fb_print("test_stream\n");
+    test_stream();
 
 #if FB_ONCHAIN
     test_graph();
@@ -0,0 +1,104 @@
+#include "frostbite.hpp"
+#include "frostbite_layout.hpp"
+
+static int failures = 0;
+
+static void check_i32(const char *msg, int32_t got, int32_t expect) {
+    if (got != expect) {
+        fb_print("FAIL: %s (got %d, expected %d)\n", msg, got, expect);
+        failures++;
+    }
+}
+
+static fb::Tensor<int32_t, 5> in = {{1, 2, 3, 4, 5}};
+static fb::Matrix<int8_t, 3, 5> w = {{1, 1, 1, 1, 1, 1, 0, -1, 0, 1, 2, 2, 2, 2, 2}};
+static fb::Prequant<5> xq;
+static fb::Tensor<int32_t, 3> out;
+static fb::Tensor<int32_t, 3> out_raw;
+
+static void test_matmul() {
+    check_i32("quantize scale", fb::quantize(xq, in, 1 << 16), 1 << 16);
+    check_i32("quantize x[4]", xq.x[4], 5);
+    check_i32("quantize pad", xq.x[7], 0);
+
+    fb::matmul_i8_i8(out, xq, w, 1 << 16);
+    check_i32("matmul row 0", out[0], 15);
+    check_i32("matmul row 1", out[1], 3);
+    check_i32("matmul row 2", out[2], 30);
+
+    fb::matmul_i8_i8<5, 3>(out_raw.ptr(), &xq, w.ptr(), 1 << 16);
+    for (size_t r = 0; r < 3; r++) {
+        check_i32("matmul raw == typed", out_raw[r], out[r]);
+    }
+
+    /* max_rows 0: all rows in one call, no yield off-chain */
+    fb_row_state_t st = {0, 0};
+    out_raw[2] = 0;
+    check_i32("partial done", fb::matmul_i8_i8_partial(out_raw, xq, w, 1 << 16, st), 1);
+    check_i32("partial row 2", out_raw[2], 30);
+}
+
+static void test_vec() {
+    fb::Tensor<int8_t, 4> a = {{1, 2, 3, 4}};
+    fb::Tensor<int8_t, 4> b = {{1, 1, 1, 1}};
+    check_i32("dot_i8", fb::dot_i8(a, b), 10);
+    fb::vec_add_i8(a, b);
+    check_i32("vec_add_i8", a[3], 5);
+
+    fb::Tensor<int32_t, 3> t = {{-4, 0, 9}};
+    fb::relu(t);
+    check_i32("relu", t[0] + t[2], 9);
+}
+
+static void test_cfg() {
+    fb_row_state_t st = {0, 0};
+    fb_matmul_bias_act_cfg_t cfg = fb::bias_act_cfg(out, xq, w, 1 << 16, FB_ACT_RELU, st);
+    check_i32("bias_act n", (int32_t)cfg.n, 5);
+    check_i32("bias_act d", (int32_t)cfg.d, 3);
+    check_i32("bias_act run", fb_matmul_i8_i8_bias_act(&cfg), 1);
+    check_i32("bias_act row 1", out[1], 3);
+}
+
+/* W (3 x 5), B (3): 15 + 12 bytes after a 12-byte rvcd-v1 header; B padded to a word. */
+constexpr fb::WeightsLayout<2> kLayout = fb::weights_layout(1, 12, {
+    fb::i8_matrix(3, 5), fb::i32_vector(3, 4),
+});
+static_assert(kLayout.aligned(), "padded layout is aligned");
+static_assert(kLayout.offset(1) == 28 && kLayout.end() == 40, "layout offsets");
+static_assert(kLayout.addr(1) == FB_SEGMENT_ADDR(1, 28), "layout address");
+static_assert(!fb::weights_layout(1, 12, {fb::i8_matrix(3, 5), fb::i32_vector(3)}).aligned(),
+              "dense bias after an odd matrix is misaligned");
+
+static void test_layout() {
+    /* Blob image in scratch at the layout's offsets (relative to base). */
+    static int32_t blob_words[(40 - 12) / 4];
+    uint8_t *blob = (uint8_t *)blob_words;
+    fb_memcpy(blob + kLayout.offset(0) - kLayout.base, w.ptr(), kLayout.size(0));
+    int32_t *bias = (int32_t *)(blob + kLayout.offset(1) - kLayout.base);
+    for (size_t r = 0; r < 3; r++) {
+        bias[r] = (int32_t)r;
+    }
+    fb_matmul_i8_i8(out_raw.ptr(), &xq, (const int8_t *)blob, 1 << 16, 5, 3);
+    check_i32("layout row 0", out_raw[0] + bias[0], 15);
+    check_i32("layout row 2", out_raw[2] + bias[2], 32);
+}
+
+int main() {
+    fb_print("Frostbite syscall smoke (C++)\n");
+
+    fb_print("test_matmul\n");
+    test_matmul();
+    fb_print("test_vec\n");
+    test_vec();
+    fb_print("test_cfg\n");
+    test_cfg();
+    fb_print("test_layout\n");
+    test_layout();
+
+    if (failures != 0) {
+        fb_print("FAILURES: %d\n", failures);
+        return 1;
+    }
+    fb_print("OK\n");
+    return 0;
+}
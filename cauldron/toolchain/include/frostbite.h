@@ -12,6 +12,8 @@
 #include <stddef.h>
 #include <stdarg.h>
 
+#include "frostbite_fixed.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -78,9 +80,27 @@ extern "C" {
 #define FB_Q8_FLAG_TENSOR_SCALE (1ULL << 62)
 #define FB_Q8_FLAG_MASK         (FB_Q8_FLAG_PREQUANT | FB_Q8_FLAG_TENSOR_SCALE)
 
+/* fb_vec_op_i32 op codes */
+#define FB_VEC_OP_ADD        0 /* dst = a + b */
+#define FB_VEC_OP_SUB        1 /* dst = a - b */
+#define FB_VEC_OP_MUL_SHIFT  2 /* dst = (a * b) >> p0, rounded; p0 in 0..63 (16 for Q16) */
+#define FB_VEC_OP_MAX        3 /* dst = max(a, b) */
+#define FB_VEC_OP_MIN        4 /* dst = min(a, b) */
+#define FB_VEC_OP_CLAMP      5 /* dst = clamp(a, p0, p1) */
+#define FB_VEC_OP_REQUANT_I8 6 /* (int8_t *)dst = a quantized at step p0 (Q16) */
+
 /* Activation types */
 #define FB_ACT_RELU    0
 #define FB_ACT_SIGMOID 1
+#define FB_ACT_NONE    0xFF /* guest helpers only (fb_matmul_i8_i8_bias_act) */
+
+/*
+ * Place a static in .noinit: crt0 never clears it, so large tables cost no
+ * startup instructions and keep their contents across fresh restarts (scratch
+ * is not reset). Contents are unspecified until the guest writes them; guard
+ * with a magic word as fb_task_attach does.
+ */
+#define FB_NOINIT __attribute__((section(".noinit")))
 
 /* Virtual address helpers */
 #define FB_SCRATCH_ADDR(offset) ((uint64_t)(offset))
@@ -131,6 +151,31 @@ typedef struct {
     uint32_t max_per_call;
 } fb_argmax_i32_state_t;
 
+/*
+ * Resumable reduction state for the guest-side *_resumable helpers. Words 0-1
+ * match fb_row_state_t; start from {0, max_per_call} (the rest zeroed).
+ */
+typedef struct {
+    uint32_t cursor;
+    uint32_t max_per_call; /* elements per call, 0 = all */
+    uint32_t phase;
+    int32_t pivot;         /* softmax: running max; rmsnorm: floor(rms) */
+    int64_t acc;           /* dot sum, sum of squares, or sum of exps */
+} fb_reduce_i32_state_t;
+
+/*
+ * Resumable top-K state (guest-side fb_topk_i32_partial). Same shape as
+ * fb_argmax_i32_state_t; start from {0, 0, 0, max_per_call}.
+ */
+typedef struct {
+    uint32_t cursor;
+    uint32_t filled;       /* entries held in idx/val, <= k */
+    int32_t min_val;       /* val[k - 1] once filled == k */
+    uint32_t max_per_call; /* elements per call, 0 = all */
+} fb_topk_i32_state_t;
+
+#define FB_TOPK_SOFTMAX 1u /* replace the K values with their Q16 softmax */
+
 /* MATMUL_I8_I8_ARGMAX state word offsets */
 #define FB_I8_I8_ARGMAX_CURSOR_WORD     0u
 #define FB_I8_I8_ARGMAX_MAX_IDX_WORD    1u
@@ -152,6 +197,25 @@ typedef struct {
 #define FB_I8_I8_ARGMAX_FULL_MAX_WORD   17u
 #define FB_I8_I8_ARGMAX_HEADER_WORDS    18u
 
+/*
+ * Prequant activation buffer (x_ptr of MATMUL_I8_I8 and the fused i8 kernels):
+ *   int8_t  x[FB_ALIGN4(n)]  quantized activations, zero padded
+ *   int32_t x_scale_q16      real value of x[i] = x[i] * x_scale_q16 / 65536
+ * The kernels compute out[r] = (dot(w[r], x) * w_scale_q16 * x_scale_q16) >> 32,
+ * i.e. the real value when both scales are Q16 (Q16 when x_scale_q16 is Q32).
+ * FB_PREQUANT_T(n) declares a fixed-size buffer; for a runtime n allocate
+ * FB_PREQUANT_BYTES(n) and use fb_prequant_scale().
+ */
+#define FB_PREQUANT_BYTES(n) (FB_ALIGN4(n) + sizeof(int32_t))
+#define FB_PREQUANT_T(n)            \
+    struct {                        \
+        int8_t x[FB_ALIGN4(n)];     \
+        int32_t x_scale_q16;        \
+    }
+
+/* fb_quantize_i32_to_prequant flags */
+#define FB_PREQUANT_RELU 1u
+
 /* MATMUL_I8_I8_QKV config */
 typedef struct {
     uint64_t out_q;
@@ -199,42 +263,123 @@ typedef struct {
     uint64_t state_ptr;
 } fb_matmul_w1w3_silu_cfg_t;
 
+/* fb_matmul_i8_i8_bias_act config (guest-side, runs on MATMUL_I8_I8_PARTIAL) */
+typedef struct {
+    uint64_t out_ptr;   /* i32[d] */
+    uint64_t x_ptr;     /* prequant buffer */
+    uint64_t w_ptr;
+    uint64_t bias_ptr;  /* i32[d] in output units, 0 = none */
+    uint64_t out_q_ptr; /* FB_PREQUANT_BYTES(d) for the next layer, 0 = none */
+    uint32_t w_scale;
+    uint32_t n;
+    uint32_t d;
+    uint32_t act;       /* FB_ACT_RELU, FB_ACT_SIGMOID (Q16) or FB_ACT_NONE */
+    uint32_t out_scale; /* out_q step in output units (Q16), 0 = dynamic */
+    uint32_t _pad0;
+    uint64_t state_ptr; /* fb_row_state_t */
+} fb_matmul_bias_act_cfg_t;
+
+/* fb_conv1d_i8 config (guest-side, one MATMUL_I8_I8 per output position) */
+typedef struct {
+    uint64_t out_ptr;    /* i32[out_len][c_out], channels-last */
+    uint64_t x_ptr;      /* int8 [len][c_in], channels-last */
+    uint64_t w_ptr;      /* int8 [c_out][k][c_in] (fb_conv1d_pack_weights) */
+    uint64_t bias_ptr;   /* i32[c_out] in output units, 0 = none */
+    uint64_t window_ptr; /* FB_CONV1D_WINDOW_BYTES(k, c_in) scratch */
+    int32_t x_scale;     /* Q16 step of x */
+    uint32_t w_scale;
+    uint32_t len;        /* input positions */
+    uint32_t c_in;
+    uint32_t c_out;
+    uint32_t k;          /* taps */
+    uint32_t stride;
+    uint32_t dilation;
+    uint32_t pad;        /* zero positions on each side */
+    uint32_t act;        /* FB_ACT_RELU, FB_ACT_SIGMOID (Q16) or FB_ACT_NONE */
+    uint64_t state_ptr;  /* fb_row_state_t over output positions, 0 = all */
+} fb_conv1d_cfg_t;
+
 /* ============================================================================
  * Low-level syscall helpers
  * ============================================================================ */
 
-static inline long fb_syscall0(long id) {
+/*
+ * Call tracing. `fb-cc --trace` builds with -DFB_TRACE=1 -finstrument-functions
+ * and links lib/frostbite_trace.c, which keeps a call tree with fb_instret()
+ * totals per node. Syscalls are recorded as leaves FB_TRACE_SYSCALL_BIT | id.
+ * The tree is written as FB_BLOG records (tag FB_TRACE_TAG) at exit, and
+ * scripts/fb_flame.py folds them into flamegraph stacks.
+ */
+#ifndef FB_TRACE
+#define FB_TRACE 0
+#endif
+
+#define FB_TRACE_TAG         0xF1u
+#define FB_TRACE_SYSCALL_BIT (1ull << 63)
+
+#if FB_TRACE
+#define FB_NOTRACE __attribute__((no_instrument_function))
+void fb_trace_enter(uint64_t fn);
+void fb_trace_exit(void);
+void fb_trace_dump(void);
+#define FB_TRACE_SYSCALL_BEGIN(id) fb_trace_enter(FB_TRACE_SYSCALL_BIT | (uint64_t)(id))
+#define FB_TRACE_SYSCALL_END()     fb_trace_exit()
+#else
+#define FB_NOTRACE
+#define FB_TRACE_SYSCALL_BEGIN(id) ((void)0)
+#define FB_TRACE_SYSCALL_END()     ((void)0)
+#endif
+
+/*
+ * The wrappers copy a0 to a plain local before FB_TRACE_SYSCALL_END: with
+ * --trace it is a call, which clobbers the a0 register variable.
+ */
+
+static inline FB_NOTRACE long fb_syscall0(long id) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = 0;
     register long a7 asm("a7") = id;
     asm volatile("ecall" : "+r"(a0) : "r"(a7) : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
-static inline long fb_syscall1(long id, long arg0) {
+static inline FB_NOTRACE long fb_syscall1(long id, long arg0) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = arg0;
     register long a7 asm("a7") = id;
     asm volatile("ecall" : "+r"(a0) : "r"(a7) : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
-static inline long fb_syscall2(long id, long arg0, long arg1) {
+static inline FB_NOTRACE long fb_syscall2(long id, long arg0, long arg1) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = arg0;
     register long a1 asm("a1") = arg1;
     register long a7 asm("a7") = id;
     asm volatile("ecall" : "+r"(a0) : "r"(a1), "r"(a7) : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
-static inline long fb_syscall3(long id, long arg0, long arg1, long arg2) {
+static inline FB_NOTRACE long fb_syscall3(long id, long arg0, long arg1, long arg2) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = arg0;
     register long a1 asm("a1") = arg1;
     register long a2 asm("a2") = arg2;
     register long a7 asm("a7") = id;
     asm volatile("ecall" : "+r"(a0) : "r"(a1), "r"(a2), "r"(a7) : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
-static inline long fb_syscall4(long id, long arg0, long arg1, long arg2, long arg3) {
+static inline FB_NOTRACE long fb_syscall4(long id, long arg0, long arg1, long arg2, long arg3) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = arg0;
     register long a1 asm("a1") = arg1;
     register long a2 asm("a2") = arg2;
@@ -244,10 +389,13 @@ static inline long fb_syscall4(long id, long arg0, long arg1, long arg2, long ar
                  : "+r"(a0)
                  : "r"(a1), "r"(a2), "r"(a3), "r"(a7)
                  : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
-static inline long fb_syscall5(long id, long arg0, long arg1, long arg2, long arg3, long arg4) {
+static inline FB_NOTRACE long fb_syscall5(long id, long arg0, long arg1, long arg2, long arg3, long arg4) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = arg0;
     register long a1 asm("a1") = arg1;
     register long a2 asm("a2") = arg2;
@@ -258,11 +406,14 @@ static inline long fb_syscall5(long id, long arg0, long arg1, long arg2, long ar
                  : "+r"(a0)
                  : "r"(a1), "r"(a2), "r"(a3), "r"(a4), "r"(a7)
                  : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
-static inline long fb_syscall6(long id, long arg0, long arg1, long arg2, long arg3, long arg4,
+static inline FB_NOTRACE long fb_syscall6(long id, long arg0, long arg1, long arg2, long arg3, long arg4,
                                long arg5) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = arg0;
     register long a1 asm("a1") = arg1;
     register long a2 asm("a2") = arg2;
@@ -274,11 +425,14 @@ static inline long fb_syscall6(long id, long arg0, long arg1, long arg2, long ar
                  : "+r"(a0)
                  : "r"(a1), "r"(a2), "r"(a3), "r"(a4), "r"(a5), "r"(a7)
                  : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
-static inline long fb_syscall7(long id, long arg0, long arg1, long arg2, long arg3, long arg4,
+static inline FB_NOTRACE long fb_syscall7(long id, long arg0, long arg1, long arg2, long arg3, long arg4,
                                long arg5, long arg6) {
+    FB_TRACE_SYSCALL_BEGIN(id);
     register long a0 asm("a0") = arg0;
     register long a1 asm("a1") = arg1;
     register long a2 asm("a2") = arg2;
@@ -291,7 +445,9 @@ static inline long fb_syscall7(long id, long arg0, long arg1, long arg2, long ar
                  : "+r"(a0)
                  : "r"(a1), "r"(a2), "r"(a3), "r"(a4), "r"(a5), "r"(a6), "r"(a7)
                  : "memory");
-    return a0;
+    long ret = a0;
+    FB_TRACE_SYSCALL_END();
+    return ret;
 }
 
 /* ============================================================================
@@ -302,6 +458,9 @@ static inline long fb_syscall7(long id, long arg0, long arg1, long arg2, long ar
  * Exit the VM with the given code.
  */
 static inline __attribute__((noreturn)) void fb_exit(long code) {
+#if FB_TRACE
+    fb_trace_dump();
+#endif
     fb_syscall1(FB_SYS_EXIT, code);
     __builtin_unreachable();
 }
@@ -331,6 +490,130 @@ static inline void fb_yield(fb_yield_state_t *state) {
     fb_syscall1(FB_SYS_YIELD, (long)state);
 }
 
+/**
+ * Read the retired instruction counter (`rdinstret`).
+ *
+ * Encoded with .insn so it assembles without Zicsr/Zicntr in -march. VMs that
+ * do not implement the counter leave the destination untouched, so this
+ * returns 0 there (the current frostbite-run does this); compare against the
+ * `frostbite-run` instruction count before trusting deltas.
+ */
+static inline uint64_t fb_instret(void) {
+    uint64_t value = 0;
+    asm volatile(".insn i 0x73, 2, %0, x0, -1022" : "+r"(value));
+    return value;
+}
+
+/**
+ * Read the cycle counter (`rdcycle`). Returns 0 when unimplemented.
+ */
+static inline uint64_t fb_rdcycle(void) {
+    uint64_t value = 0;
+    asm volatile(".insn i 0x73, 2, %0, x0, -1024" : "+r"(value));
+    return value;
+}
+
+/**
+ * Scoped profiling. Build with -DFB_PROFILE=1 to enable; otherwise the macros
+ * expand to nothing.
+ *
+ *   FB_PROFILE_BEGIN(TAG);
+ *   ...hot section...
+ *   FB_PROFILE_END(TAG);
+ *
+ * END logs fb_debug_log(tag, FB_PROFILE_PHASE, delta, begin, end) with the
+ * fb_instret() delta. `tag` must be a single token (literal or macro name)
+ * and BEGIN/END must share a scope; distinct tags may nest.
+ */
+#ifndef FB_PROFILE
+#define FB_PROFILE 0
+#endif
+
+#define FB_PROFILE_PHASE 0xF0u
+
+#if FB_PROFILE
+#define FB_PROFILE_BEGIN(tag) \
+    const uint64_t fb_profile_start_##tag = fb_instret()
+#define FB_PROFILE_END(tag)                                               \
+    do {                                                                  \
+        uint64_t fb_profile_end_ = fb_instret();                          \
+        fb_debug_log((tag), FB_PROFILE_PHASE,                             \
+                     fb_profile_end_ - fb_profile_start_##tag,            \
+                     fb_profile_start_##tag, fb_profile_end_);            \
+    } while (0)
+#else
+#define FB_PROFILE_BEGIN(tag) ((void)0)
+#define FB_PROFILE_END(tag) ((void)0)
+#endif
+
+/*
+ * Per-transaction instruction budget. The VM has no budget query, so the
+ * guest tracks it: fb_instret() since the last transaction boundary against
+ * the client's instructions per transaction (FB_TX_BUDGET, see
+ * CLIENT_GUIDE.md). Mark each boundary the guest can see, i.e. after a yield:
+ *
+ *   fb_budget_t b;
+ *   fb_budget_init(&b, FB_TX_BUDGET, FB_TX_RESERVE);
+ *   while (st.cursor < d) {
+ *       st.max_rows = fb_budgeted_rows(&b, cost_per_row);
+ *       fb_matmul_i8_i8_partial(out, x, w, scale, n, d, &st);
+ *       if (st.cursor < d) fb_budget_mark_tx(&b);  // kernel yielded
+ *   }
+ *
+ * Where fb_instret() reads 0 every chunk gets the full budget.
+ */
+#ifndef FB_TX_BUDGET
+#define FB_TX_BUDGET 50000u
+#endif
+
+/* Instructions kept back for the code between chunks and the yield itself */
+#ifndef FB_TX_RESERVE
+#define FB_TX_RESERVE 2000u
+#endif
+
+typedef struct {
+    uint64_t tx_start; /* fb_instret() at the last boundary */
+    uint32_t tx_budget;
+    uint32_t reserve;
+} fb_budget_t;
+
+static inline void fb_budget_mark_tx(fb_budget_t *b) {
+    b->tx_start = fb_instret();
+}
+
+static inline void fb_budget_init(fb_budget_t *b, uint32_t tx_budget, uint32_t reserve) {
+    b->tx_budget = tx_budget;
+    b->reserve = reserve;
+    fb_budget_mark_tx(b);
+}
+
+/**
+ * Instructions left in this transaction after the reserve (0 when spent).
+ */
+static inline uint64_t fb_budget_remaining(const fb_budget_t *b) {
+    uint64_t used = fb_instret() - b->tx_start + b->reserve;
+    return used < b->tx_budget ? b->tx_budget - used : 0;
+}
+
+/**
+ * Rows of `cost_per_row` instructions that fit in the rest of the
+ * transaction, at least 1 so the cursor always advances. Use as
+ * fb_row_state_t.max_rows or fb_reduce_i32_state_t.max_per_call.
+ */
+static inline uint32_t fb_budgeted_rows(const fb_budget_t *b, uint32_t cost_per_row) {
+    uint64_t rows = fb_budget_remaining(b) / (cost_per_row ? cost_per_row : 1u);
+    return rows == 0 ? 1u : rows > UINT32_MAX ? UINT32_MAX : (uint32_t)rows;
+}
+
+/**
+ * Yield and start a new budget window.
+ */
+static inline void fb_budget_yield(fb_budget_t *b) {
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    fb_budget_mark_tx(b);
+}
+
 /**
  * Print a null-terminated string without format parsing.
  */
@@ -342,13 +625,57 @@ static inline void fb_print_str(const char *s) {
     fb_write(s, len);
 }
 
-static inline void fb_print_uint(uint64_t value, unsigned base, int uppercase) {
+/*
+ * Formatted output is staged in a FB_PRINTF_BUF-byte stack buffer and
+ * flushed with one WRITE, so a line that fits costs one syscall instead of
+ * one per chunk and character. Longer output flushes each time it fills.
+ */
+#ifndef FB_PRINTF_BUF
+#define FB_PRINTF_BUF 256
+#endif
+
+typedef struct {
+    size_t len;
+    char buf[FB_PRINTF_BUF];
+} fb_fmt_buf_t;
+
+static inline void fb_fmt_flush(fb_fmt_buf_t *f) {
+    if (f->len) {
+        fb_write(f->buf, f->len);
+        f->len = 0;
+    }
+}
+
+static inline void fb_fmt_putc(fb_fmt_buf_t *f, char c) {
+    if (f->len == sizeof(f->buf)) {
+        fb_fmt_flush(f);
+    }
+    f->buf[f->len++] = c;
+}
+
+static inline void fb_fmt_puts(fb_fmt_buf_t *f, const char *s, size_t len) {
+    while (len) {
+        if (f->len == sizeof(f->buf)) {
+            fb_fmt_flush(f);
+        }
+        size_t n = sizeof(f->buf) - f->len;
+        n = n < len ? n : len;
+        for (size_t i = 0; i < n; i++) {
+            f->buf[f->len + i] = s[i];
+        }
+        f->len += n;
+        s += n;
+        len -= n;
+    }
+}
+
+static inline void fb_fmt_uint(fb_fmt_buf_t *f, uint64_t value, unsigned base, int uppercase) {
     char buf[32];
     size_t i = 0;
     const char *digits = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
 
     if (value == 0) {
-        fb_putchar('0');
+        fb_fmt_putc(f, '0');
         return;
     }
 
@@ -358,24 +685,40 @@ static inline void fb_print_uint(uint64_t value, unsigned base, int uppercase) {
     }
 
     while (i > 0) {
-        fb_putchar(buf[--i]);
+        fb_fmt_putc(f, buf[--i]);
     }
 }
 
-static inline void fb_print_int(int64_t value) {
+static inline void fb_fmt_int(fb_fmt_buf_t *f, int64_t value) {
     uint64_t abs_value;
 
     if (value < 0) {
-        fb_putchar('-');
+        fb_fmt_putc(f, '-');
         abs_value = (uint64_t)(-(value + 1)) + 1;
     } else {
         abs_value = (uint64_t)value;
     }
 
-    fb_print_uint(abs_value, 10, 0);
+    fb_fmt_uint(f, abs_value, 10, 0);
+}
+
+static inline void fb_print_uint(uint64_t value, unsigned base, int uppercase) {
+    fb_fmt_buf_t f;
+    f.len = 0;
+    fb_fmt_uint(&f, value, base, uppercase);
+    fb_fmt_flush(&f);
+}
+
+static inline void fb_print_int(int64_t value) {
+    fb_fmt_buf_t f;
+    f.len = 0;
+    fb_fmt_int(&f, value);
+    fb_fmt_flush(&f);
 }
 
 static inline void fb_vprintf(const char *fmt, va_list ap) {
+    fb_fmt_buf_t f;
+    f.len = 0;
     const char *chunk = fmt;
 
     while (*fmt) {
@@ -385,16 +728,17 @@ static inline void fb_vprintf(const char *fmt, va_list ap) {
         }
 
         if (fmt > chunk) {
-            fb_write(chunk, (size_t)(fmt - chunk));
+            fb_fmt_puts(&f, chunk, (size_t)(fmt - chunk));
         }
 
         fmt++;
         if (*fmt == '\0') {
-            fb_putchar('%');
+            fb_fmt_putc(&f, '%');
+            fb_fmt_flush(&f);
             return;
         }
         if (*fmt == '%') {
-            fb_putchar('%');
+            fb_fmt_putc(&f, '%');
             fmt++;
             chunk = fmt;
             continue;
@@ -414,7 +758,8 @@ static inline void fb_vprintf(const char *fmt, va_list ap) {
         }
 
         if (*fmt == '\0') {
-            fb_putchar('%');
+            fb_fmt_putc(&f, '%');
+            fb_fmt_flush(&f);
             return;
         }
 
@@ -429,7 +774,7 @@ static inline void fb_vprintf(const char *fmt, va_list ap) {
                 } else {
                     v = (int64_t)va_arg(ap, int);
                 }
-                fb_print_int(v);
+                fb_fmt_int(&f, v);
                 break;
             }
             case 'u': {
@@ -441,7 +786,7 @@ static inline void fb_vprintf(const char *fmt, va_list ap) {
                 } else {
                     v = (uint64_t)va_arg(ap, unsigned int);
                 }
-                fb_print_uint(v, 10, 0);
+                fb_fmt_uint(&f, v, 10, 0);
                 break;
             }
             case 'x':
@@ -455,32 +800,33 @@ static inline void fb_vprintf(const char *fmt, va_list ap) {
                 } else {
                     v = (uint64_t)va_arg(ap, unsigned int);
                 }
-                fb_print_uint(v, 16, uppercase);
+                fb_fmt_uint(&f, v, 16, uppercase);
                 break;
             }
             case 'p': {
                 uintptr_t v = (uintptr_t)va_arg(ap, void *);
-                fb_print_str("0x");
-                fb_print_uint((uint64_t)v, 16, 0);
+                fb_fmt_puts(&f, "0x", 2);
+                fb_fmt_uint(&f, (uint64_t)v, 16, 0);
                 break;
             }
             case 'c': {
                 int v = va_arg(ap, int);
-                fb_putchar((char)v);
+                fb_fmt_putc(&f, (char)v);
                 break;
             }
             case 's': {
                 const char *s = va_arg(ap, const char *);
-                if (s) {
-                    fb_print_str(s);
-                } else {
-                    fb_print_str("(null)");
+                s = s ? s : "(null)";
+                size_t len = 0;
+                while (s[len]) {
+                    len++;
                 }
+                fb_fmt_puts(&f, s, len);
                 break;
             }
             default:
-                fb_putchar('%');
-                fb_putchar(*fmt);
+                fb_fmt_putc(&f, '%');
+                fb_fmt_putc(&f, *fmt);
                 break;
         }
 
@@ -489,12 +835,14 @@ static inline void fb_vprintf(const char *fmt, va_list ap) {
     }
 
     if (fmt > chunk) {
-        fb_write(chunk, (size_t)(fmt - chunk));
+        fb_fmt_puts(&f, chunk, (size_t)(fmt - chunk));
     }
+    fb_fmt_flush(&f);
 }
 
 /**
- * Print a format string (printf-style).
+ * Print a format string (printf-style) with one WRITE per FB_PRINTF_BUF
+ * bytes of output.
  *
  * Supported: %d %i %u %x %X %p %s %c %%
  * Length: l, ll, z
@@ -514,6 +862,42 @@ static inline void fb_printf(const char *fmt, ...) {
         fb_printf, fb_printf, fb_printf, fb_printf, fb_printf, fb_printf, fb_printf, fb_print_str) \
     (__VA_ARGS__)
 
+/*
+ * Leveled logging. Build with -DFB_LOG_LEVEL=FB_LOG_WARN (say) to compile out
+ * every call above that level; stripped calls do not evaluate their
+ * arguments. Default keeps all levels.
+ */
+#define FB_LOG_NONE  0
+#define FB_LOG_ERROR 1
+#define FB_LOG_WARN  2
+#define FB_LOG_INFO  3
+#define FB_LOG_DEBUG 4
+
+#ifndef FB_LOG_LEVEL
+#define FB_LOG_LEVEL FB_LOG_DEBUG
+#endif
+
+#if FB_LOG_LEVEL >= FB_LOG_ERROR
+#define fb_log_error(...) fb_print(__VA_ARGS__)
+#else
+#define fb_log_error(...) ((void)0)
+#endif
+#if FB_LOG_LEVEL >= FB_LOG_WARN
+#define fb_log_warn(...) fb_print(__VA_ARGS__)
+#else
+#define fb_log_warn(...) ((void)0)
+#endif
+#if FB_LOG_LEVEL >= FB_LOG_INFO
+#define fb_log_info(...) fb_print(__VA_ARGS__)
+#else
+#define fb_log_info(...) ((void)0)
+#endif
+#if FB_LOG_LEVEL >= FB_LOG_DEBUG
+#define fb_log_debug(...) fb_print(__VA_ARGS__)
+#else
+#define fb_log_debug(...) ((void)0)
+#endif
+
 /* ============================================================================
  * Heap + memory utilities
  * ============================================================================ */
@@ -522,9 +906,10 @@ static inline void fb_printf(const char *fmt, ...) {
  * Initialize heap bounds for fb_malloc (base/size). The heap must always be a
  * mapped RAM segment address (use FB_SEGMENT_ADDR). No local heap fallback.
  *
- * To default to a mapped RAM segment without calling fb_heap_init, compile with:
- * -DFB_HEAP_SEGMENT=<seg> [-DFB_HEAP_SEGMENT_COUNT=<n>]
- * [-DFB_HEAP_OFFSET=<bytes>] [-DFB_RAM_BYTES=<bytes>].
+ * To default to a mapped RAM segment without calling fb_heap_init, build the
+ * runtime with fb-cc -DFB_HEAP_SEGMENT=<seg> [-DFB_HEAP_SEGMENT_COUNT=<n>]
+ * [-DFB_HEAP_OFFSET=<bytes>] [-DFB_RAM_BYTES=<bytes>]; fb-cc forwards these
+ * to the runtime as well as the program.
  * The default heap segment is 1; multi-segment heaps consume contiguous segments.
  *
  * fb_malloc always allocates from a RAM segment. If no RAM accounts are mapped
@@ -552,19 +937,259 @@ static inline void fb_heap_init_segment(uint32_t segment, size_t size) {
 
 /**
  * Simple bump allocator (returns NULL on OOM).
+ *
+ * Compile the runtime with -DFB_ALLOC_FREELIST=1 to serve requests from
+ * power-of-two size classes (16 B .. 128 MB, 8-byte header) backed by the
+ * same RAM segments. Cost is bounded by the class search (at most 24 steps).
  */
 void *fb_malloc(size_t size);
 
 /**
- * Free is a no-op for the bump allocator.
+ * Free is a no-op for the bump allocator. With FB_ALLOC_FREELIST=1 the block
+ * is pushed onto its size-class free list in O(1); double frees exit.
  */
 void fb_free(void *ptr);
 
+/**
+ * Allocate `size` bytes aligned to `align` (a power of two, up to 1 << 28).
+ * Use 16/64 for matmul weights and activations, or a larger power of two to
+ * start a buffer on a segment page boundary. Release with fb_free.
+ *
+ * @return pointer, or NULL on invalid alignment or exhaustion
+ */
+void *fb_aligned_alloc(size_t align, size_t size);
+
+/**
+ * Global heap position: the bump pointer and the RAM segment it is in.
+ */
+typedef struct {
+    uint8_t *ptr;
+    uint8_t *end;
+    uint32_t segment_index;
+    uint32_t reserved;
+} fb_heap_mark_t;
+
+/**
+ * Record the global heap position (fb_checkpoint keeps one).
+ */
+void fb_heap_mark(fb_heap_mark_t *mark);
+
+/**
+ * Release every fb_malloc block taken since `mark`. With FB_ALLOC_FREELIST=1
+ * the free lists are emptied too, so blocks freed earlier are not reused.
+ */
+void fb_heap_rewind(const fb_heap_mark_t *mark);
+
+/**
+ * Scratch arena: a bump region that is released all at once.
+ *
+ * Intended for per-inference temporaries that would otherwise consume the
+ * global heap forever. Initialize once over a fixed RAM segment region (or a
+ * block carved from fb_malloc), then fb_arena_alloc per buffer and
+ * fb_arena_reset at the end of each call. The arena struct is plain data and
+ * may itself live in a RAM segment so it survives EXECUTE_V3 resumes.
+ */
+typedef struct {
+    uint8_t *base;
+    uint8_t *ptr;
+    uint8_t *end;
+} fb_arena_t;
+
+typedef uint8_t *fb_arena_mark_t;
+
+/**
+ * Initialize an arena over FB_SEGMENT_ADDR(segment, offset) .. +size.
+ * The base is rounded up to 8 bytes. Exits on an invalid configuration.
+ */
+void fb_arena_init(fb_arena_t *arena, uint32_t segment, size_t offset, size_t size);
+
+/**
+ * Initialize an arena over a block of `size` bytes taken from fb_malloc.
+ *
+ * @return 0 on success, -1 if the heap cannot satisfy the request
+ */
+int fb_arena_init_heap(fb_arena_t *arena, size_t size);
+
+/**
+ * Allocate `size` bytes (rounded to 8) from the arena.
+ *
+ * @return pointer, or NULL when the arena is exhausted
+ */
+static inline void *fb_arena_alloc(fb_arena_t *arena, size_t size) {
+    uint8_t *p = arena->ptr;
+    size = (size + 7u) & ~(size_t)7u;
+    if (size > (size_t)(arena->end - p)) {
+        return NULL;
+    }
+    arena->ptr = p + size;
+    return p;
+}
+
+/**
+ * Record the current arena position.
+ */
+static inline fb_arena_mark_t fb_arena_mark(const fb_arena_t *arena) {
+    return arena->ptr;
+}
+
+/**
+ * Release everything allocated since `mark`.
+ */
+static inline void fb_arena_reset(fb_arena_t *arena, fb_arena_mark_t mark) {
+    arena->ptr = mark;
+}
+
+/**
+ * Release every allocation in the arena.
+ */
+static inline void fb_arena_clear(fb_arena_t *arena) {
+    arena->ptr = arena->base;
+}
+
+/**
+ * Bytes still available in the arena.
+ */
+static inline size_t fb_arena_remaining(const fb_arena_t *arena) {
+    return (size_t)(arena->end - arena->ptr);
+}
+
+/*
+ * Warm image (lib/frostbite_warm.c, opt-in with fb-cc --warm-start or
+ * FROSTBITE_WARM_START): call fb_checkpoint once setup is done, and later
+ * fresh restarts of the same loaded program continue from it instead of
+ * re-running setup. This relies on unspecified behaviour: the guest contract
+ * does not promise that scratch survives a fresh restart, only that it is
+ * not all zeroed. The callee-saved registers, the stack from the caller's
+ * frame up and the heap position (fb_heap_mark) go to .noinit, and crt0
+ * restores them before it would clear .bss. A program (re)load resets the
+ * image's .data and so drops the checkpoint.
+ *   - The saved image is CRC-checked, and so are the `bind_len` bytes at
+ *     `bind`: pass the account state setup derived from (e.g. a model header
+ *     with a generation counter) and any change to it forces a cold start.
+ *   - Everything else written before the checkpoint (heap blocks, .bss,
+ *     .data) is reused unchecked as the last run left it, so treat setup
+ *     state as read-only afterwards and reinitialize per-call state yourself.
+ *   - fb_malloc blocks taken after the checkpoint are released on restore.
+ *   - Restarts must map the same RAM accounts, and `bind` must stay readable.
+ */
+#ifndef FB_WARM_START
+#define FB_WARM_START 0 /* fb-cc --warm-start sets 1 for the runtime and program */
+#endif
+#ifndef FB_WARM_STACK
+#define FB_WARM_STACK 2048 /* stack bytes fb_checkpoint can save */
+#endif
+
+/**
+ * Save a warm restart point bound to `bind_len` bytes at `bind` (NULL, 0 for
+ * none).
+ *
+ * @return 0 once saved, 1 when a fresh restart resumed here, -1 without
+ *         FB_WARM_START or if the stack above the caller exceeds
+ *         FB_WARM_STACK (no checkpoint is kept)
+ */
+int fb_checkpoint(const void *bind, size_t bind_len);
+
+/**
+ * Drop the checkpoint, so the next fresh restart runs from _entry.
+ */
+void fb_checkpoint_clear(void);
+
+/*
+ * Segment views: a validated window into a mapped account (segments 1-15),
+ * so kernels and loops can run on account memory with no copy. The range is
+ * checked arithmetically once at init against the segment's address span,
+ * not the mapped account length the guest cannot query, so size the view
+ * from the layout that created the account. Typed getters check a whole span
+ * once and return a plain pointer for the hot loop.
+ */
+#define FB_SEGMENT_SPAN 0x10000000u /* bytes addressable per segment */
+
+typedef struct {
+    uint8_t *base;
+    uint32_t len;
+    uint32_t segment;
+} fb_segment_view_t;
+
+/**
+ * View `len` bytes of `segment` starting at `offset`.
+ *
+ * @return 0 on success, -1 for segment 0/>15, an offset outside the segment
+ *         or a range past its end
+ */
+static inline int fb_segment_view_init(fb_segment_view_t *view, uint32_t segment,
+                                       uint32_t offset, uint32_t len) {
+    view->base = NULL;
+    view->len = 0;
+    view->segment = segment;
+    if (segment == 0 || segment > 15 || offset >= FB_SEGMENT_SPAN ||
+        len > FB_SEGMENT_SPAN - offset) {
+        return -1;
+    }
+    view->base = (uint8_t *)(uintptr_t)FB_SEGMENT_ADDR(segment, offset);
+    view->len = len;
+    return 0;
+}
+
+/**
+ * Sub-view of `len` bytes at `offset` (empty view with NULL base if out of
+ * range).
+ */
+static inline fb_segment_view_t fb_segment_view_slice(const fb_segment_view_t *view,
+                                                      uint32_t offset, uint32_t len) {
+    fb_segment_view_t sub = {NULL, 0, view->segment};
+    if (offset <= view->len && len <= view->len - offset) {
+        sub.base = view->base + offset;
+        sub.len = len;
+    }
+    return sub;
+}
+
+/**
+ * Pointer to `count` elements of `elem_size` bytes at byte `offset`, or NULL
+ * if the span leaves the view or `offset` is not a multiple of `align`.
+ */
+static inline void *fb_segment_view_span(const fb_segment_view_t *view, uint32_t offset,
+                                         uint32_t count, uint32_t elem_size,
+                                         uint32_t align) {
+    uint64_t bytes = (uint64_t)count * elem_size;
+    if (!view->base || offset > view->len || bytes > view->len - offset ||
+        (((uintptr_t)view->base + offset) & (align - 1u))) {
+        return NULL;
+    }
+    return view->base + offset;
+}
+
+/* VM address of byte `offset` (for kernels taking u64 addresses) */
+static inline uint64_t fb_segment_view_addr(const fb_segment_view_t *view, uint32_t offset) {
+    return (uint64_t)(uintptr_t)(view->base + offset);
+}
+
+#define FB_SEGMENT_VIEW_TYPED(name, T)                                                   \
+    static inline T *fb_segment_view_##name(const fb_segment_view_t *view,               \
+                                            uint32_t offset, uint32_t count) {           \
+        return (T *)fb_segment_view_span(view, offset, count, (uint32_t)sizeof(T),       \
+                                         (uint32_t)sizeof(T));                           \
+    }
+
+FB_SEGMENT_VIEW_TYPED(u8, uint8_t)
+FB_SEGMENT_VIEW_TYPED(i8, int8_t)
+FB_SEGMENT_VIEW_TYPED(i16, int16_t)
+FB_SEGMENT_VIEW_TYPED(i32, int32_t)
+FB_SEGMENT_VIEW_TYPED(u32, uint32_t)
+FB_SEGMENT_VIEW_TYPED(u64, uint64_t)
+FB_SEGMENT_VIEW_TYPED(f32, float)
+
+#undef FB_SEGMENT_VIEW_TYPED
+
 /* Optional libc-style aliases (weakly defined in the runtime). */
 void *malloc(size_t size);
 void free(void *ptr);
+void *aligned_alloc(size_t align, size_t size);
+int posix_memalign(void **out, size_t align, size_t size);
 void *memcpy(void *dst, const void *src, size_t n);
 void *memset(void *dst, int c, size_t n);
+void *memmove(void *dst, const void *src, size_t n);
+int memcmp(const void *a, const void *b, size_t n);
 
 /* ============================================================================
  * LLM syscalls (110-144)
@@ -767,6 +1392,82 @@ static inline void fb_rmsnorm_i32(int32_t *out, const int32_t *x, uint64_t weigh
     fb_syscall4(FB_SYS_RMSNORM_I32, (long)out, (long)x, (long)weight_addr, (long)dim);
 }
 
+/**
+ * Scale word of a prequant buffer holding `n` activations.
+ */
+static inline int32_t *fb_prequant_scale(void *prequant, size_t n) {
+    return (int32_t *)((uint8_t *)prequant + FB_ALIGN4(n));
+}
+
+/**
+ * Quantize one i32 value to int8 with step `scale_q16` (src units, Q16).
+ * Rounds half away from zero and clamps to +-127.
+ */
+static inline int8_t fb_quantize_i32_q8(int32_t v, uint32_t scale_q16) {
+    uint32_t sign = (uint32_t)(v >> 31);
+    uint64_t a = (uint64_t)(((uint32_t)v ^ sign) - sign);
+    uint64_t q = ((a << 16) + (scale_q16 >> 1)) / scale_q16;
+    q = q > 127u ? 127u : q;
+    return (int8_t)(((uint32_t)q ^ sign) - sign);
+}
+
+/**
+ * Dynamic quantization step for n i32 values: ceil(max|src| * 65536 / 127),
+ * saturating at INT32_MAX, at least 1. FB_PREQUANT_RELU ignores negatives.
+ */
+static inline int32_t fb_quantize_step_for_max(uint32_t max_abs) {
+    uint64_t step = (((uint64_t)max_abs << 16) + 126u) / 127u;
+    step = step > (uint64_t)INT32_MAX ? (uint64_t)INT32_MAX : step;
+    return step ? (int32_t)step : 1;
+}
+
+static inline uint32_t fb_abs_u32(int32_t v) {
+    uint32_t sign = (uint32_t)(v >> 31);
+    return ((uint32_t)v ^ sign) - sign;
+}
+
+static inline int32_t fb_quantize_i32_step(const int32_t *src, size_t n, uint32_t flags) {
+    int32_t lo = (flags & FB_PREQUANT_RELU) ? 0 : INT32_MIN;
+    uint32_t max_abs = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t a = fb_abs_u32(src[i] < lo ? lo : src[i]);
+        max_abs = a > max_abs ? a : max_abs;
+    }
+    return fb_quantize_step_for_max(max_abs);
+}
+
+/**
+ * Requantize i32 activations (e.g. MATMUL_I8_I8 output) into a prequant
+ * buffer for the next layer, in one pass (two when the scale is dynamic).
+ * The buffer decodes (x[i] * x_scale_q16 / 65536) to the units of src.
+ *
+ * With scale_q16 <= 0 the step is ceil(max|src| * 65536 / 127) so no value
+ * clips (saturating at INT32_MAX); otherwise the given calibration step is
+ * used and values clamp to +-127. FB_PREQUANT_RELU clamps negatives to 0
+ * first, replacing a separate ReLU pass. Padding bytes are zeroed.
+ *
+ * @param dst       FB_PREQUANT_BYTES(n) buffer (may not alias src)
+ * @return the x_scale_q16 written to dst
+ */
+static inline int32_t fb_quantize_i32_to_prequant(void *dst, const int32_t *src, size_t n,
+                                                  int32_t scale_q16, uint32_t flags) {
+    int8_t *x = (int8_t *)dst;
+    int32_t lo = (flags & FB_PREQUANT_RELU) ? 0 : INT32_MIN;
+
+    if (scale_q16 <= 0) {
+        scale_q16 = fb_quantize_i32_step(src, n, flags);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        x[i] = fb_quantize_i32_q8(src[i] < lo ? lo : src[i], (uint32_t)scale_q16);
+    }
+    for (size_t i = n; i < FB_ALIGN4(n); i++) {
+        x[i] = 0;
+    }
+    *fb_prequant_scale(dst, n) = scale_q16;
+    return scale_q16;
+}
+
 /**
  * MATMUL_I8_I8: int8 weights and prequant buffer.
  */
@@ -819,6 +1520,60 @@ static inline void fb_matmul_i8_i8_w1w3_silu(const fb_matmul_w1w3_silu_cfg_t *cf
     fb_syscall1(FB_SYS_MATMUL_I8_I8_W1W3_SILU, (long)cfg);
 }
 
+/**
+ * FB_ACT_RELU / FB_ACT_SIGMOID (Q16) / FB_ACT_NONE on one i32 value.
+ */
+static inline int32_t fb_act_i32(int32_t v, uint32_t act) {
+    if (act == FB_ACT_RELU) {
+        return v < 0 ? 0 : v;
+    }
+    if (act == FB_ACT_SIGMOID) {
+        return fb_q16_sigmoid(v);
+    }
+    return v;
+}
+
+/**
+ * Fused MATMUL_I8_I8 + bias + activation (+ requant into out_q_ptr) over the
+ * next `max_rows` rows of `state_ptr`. Each chunk yields like
+ * MATMUL_I8_I8_PARTIAL, so call until it returns 1; out_q_ptr's scale word
+ * (and a dynamic out_scale) is written with the last chunk.
+ *
+ * @return 1 once all d rows are done, else 0
+ */
+static inline int fb_matmul_i8_i8_bias_act(const fb_matmul_bias_act_cfg_t *cfg) {
+    fb_row_state_t *state = (fb_row_state_t *)(uintptr_t)cfg->state_ptr;
+    int32_t *out = (int32_t *)(uintptr_t)cfg->out_ptr;
+    const int32_t *bias = (const int32_t *)(uintptr_t)cfg->bias_ptr;
+    int8_t *out_q = (int8_t *)(uintptr_t)cfg->out_q_ptr;
+    uint32_t start = state->cursor;
+
+    fb_matmul_i8_i8_partial(out, (const void *)(uintptr_t)cfg->x_ptr,
+                            (const int8_t *)(uintptr_t)cfg->w_ptr, (int32_t)cfg->w_scale,
+                            cfg->n, cfg->d, state);
+
+    uint32_t end = state->cursor < cfg->d ? state->cursor : cfg->d;
+    for (uint32_t r = start; r < end; r++) {
+        int32_t v = fb_act_i32(bias ? out[r] + bias[r] : out[r], cfg->act);
+        out[r] = v;
+        if (out_q && cfg->out_scale) {
+            out_q[r] = fb_quantize_i32_q8(v, cfg->out_scale);
+        }
+    }
+    if (end < cfg->d) {
+        return 0;
+    }
+    if (out_q && !cfg->out_scale) {
+        (void)fb_quantize_i32_to_prequant(out_q, out, cfg->d, 0, 0);
+    } else if (out_q) {
+        for (uint32_t i = cfg->d; i < FB_ALIGN4(cfg->d); i++) {
+            out_q[i] = 0;
+        }
+        *fb_prequant_scale(out_q, cfg->d) = (int32_t)cfg->out_scale;
+    }
+    return 1;
+}
+
 /* ============================================================================
  * AI/ML accelerator syscalls (7000-7019)
  * ============================================================================ */
@@ -897,58 +1652,1659 @@ static inline uint32_t fb_aggregate(uint64_t graph_idx, void *table_ptr,
 }
 
 /* ============================================================================
- * Quantum syscall (9000)
+ * Resumable variants
  * ============================================================================ */
 
-/**
- * QUANTUM_OP: 7-qubit state ops (Q16.16 complex).
- *
- * @return measurement result for MEASURE, else 0
+/*
+ * Guest-side chunked versions of kernels that have no PARTIAL syscall. Each
+ * call does max_per_call elements of one pass, then yields like the partial
+ * kernels if work remains; call until it returns 1. Calls after that no-op.
+ * With max_per_call 0 each call runs a whole pass and never yields.
  */
-static inline int fb_quantum_op(int op, int target, int control, void *state_ptr) {
-    return (int)fb_syscall4(FB_SYS_QUANTUM_OP, (long)op, (long)target,
-                            (long)control, (long)state_ptr);
+
+static inline uint32_t fb_resume_chunk(const fb_reduce_i32_state_t *st, size_t len) {
+    uint32_t left = (uint32_t)len - st->cursor;
+    return st->max_per_call && st->max_per_call < left ? st->max_per_call : left;
 }
 
-/* ============================================================================
- * Utility functions
- * ============================================================================ */
+/* Advance past `step` elements; moves to the next pass at the end of one. */
+static inline int fb_resume_advance(fb_reduce_i32_state_t *st, uint32_t step, size_t len,
+                                    uint32_t passes) {
+    st->cursor += step;
+    if (st->cursor >= len) {
+        st->cursor = 0;
+        st->phase++;
+    }
+    if (st->phase >= passes) {
+        return 1;
+    }
+    if (st->max_per_call) {
+        fb_yield_state_t ys = {0};
+        fb_yield(&ys);
+    }
+    return 0;
+}
 
 /**
- * strlen for VM programs.
+ * Resumable DOT_I32. st->acc holds dot(a, b) >> shift once this returns 1
+ * (identical to fb_dot_i32; the shift is applied once at the end).
  */
-static inline size_t fb_strlen(const char *s) {
-    size_t len = 0;
-    while (s[len]) {
-        len++;
+static inline int fb_dot_i32_resumable(const int32_t *a, const int32_t *b, size_t len,
+                                       uint32_t shift, fb_reduce_i32_state_t *st) {
+    if (st->phase >= 1 || len == 0) {
+        return 1;
+    }
+    uint32_t c = st->cursor;
+    uint32_t step = fb_resume_chunk(st, len);
+    st->acc += fb_dot_i32(a + c, b + c, step, 0);
+    if (c + step >= len) {
+        st->acc >>= shift;
+    }
+    return fb_resume_advance(st, step, len, 1);
+}
+
+/**
+ * trunc(x / rms) as RMSNORM_I32 computes it: the largest k with
+ * k^2 * sumsq <= x^2 * dim, searched down from |x| / floor(rms), signed.
+ */
+static inline int64_t fb_rmsnorm_i32_k(int64_t v, uint64_t sumsq, int32_t rms, uint64_t kmax,
+                                       size_t dim) {
+    __extension__ typedef unsigned __int128 fb_u128;
+    uint64_t mag = (uint64_t)(v < 0 ? -v : v);
+    uint64_t k = 0;
+    if (sumsq) {
+        fb_u128 rhs = (fb_u128)(mag * mag) * dim;
+        k = rms && mag / (uint32_t)rms < kmax ? mag / (uint32_t)rms : kmax;
+        while (k && (fb_u128)(k * k) * sumsq > rhs) {
+            k--;
+        }
+    }
+    return v < 0 ? -(int64_t)k : (int64_t)k;
+}
+
+/**
+ * Resumable RMSNORM_I32 with the same weight layout and output: pass 0 sums
+ * x*x with DOT_I32, pass 1 writes out[i] = (trunc(x[i] / rms) * scale *
+ * weight[i]) >> 24 per chunk. out may alias x.
+ */
+static inline int fb_rmsnorm_i32_resumable(int32_t *out, const int32_t *x,
+                                           uint64_t weight_addr, size_t dim,
+                                           fb_reduce_i32_state_t *st) {
+    if (st->phase >= 2 || dim == 0) {
+        return 1;
+    }
+    uint32_t c = st->cursor;
+    uint32_t step = fb_resume_chunk(st, dim);
+    if (st->phase == 0) {
+        st->acc += fb_dot_i32(x + c, x + c, step, 0);
+        if (c + step >= dim) {
+            st->pivot = (int32_t)fb_isqrt64((uint64_t)st->acc / dim);
+        }
+        return fb_resume_advance(st, step, dim, 2);
+    }
+
+    const int16_t *w = (const int16_t *)(uintptr_t)weight_addr;
+    uint64_t sumsq = (uint64_t)st->acc;
+    uint64_t kmax = fb_isqrt64(dim); /* |x| / rms <= sqrt(dim) */
+    for (uint32_t i = c; i < c + step; i++) {
+        int64_t sk = fb_rmsnorm_i32_k(x[i], sumsq, st->pivot, kmax, dim);
+        out[i] = (int32_t)((sk * w[0] * w[1 + i]) >> 24);
+    }
+    return fb_resume_advance(st, step, dim, 2);
+}
+
+/* trunc(x / rms) fits int8 when sqrt(dim) <= 127 */
+#define FB_RMSNORM_PREQUANT_MAX_DIM 16129u
+
+/**
+ * Fused RMSNORM_I32 + requantize: writes the prequant buffer that
+ * fb_quantize_i32_to_prequant would make from fb_rmsnorm_i32's output
+ * (bit-exact, same scale_q16 and FB_PREQUANT_RELU handling), so the result
+ * goes straight into a QKV / W1W3 / W1W3_SILU config's x_ptr with no i32
+ * hidden vector in between. One DOT_I32 call plus one guest pass; with a
+ * dynamic scale, the trunc(x / rms) factors are parked in dst on the first
+ * pass and rescaled in a second one.
+ *
+ * @param dst  FB_PREQUANT_BYTES(dim) buffer
+ * @return the x_scale_q16 written to dst, or 0 if dim is 0 or above
+ *         FB_RMSNORM_PREQUANT_MAX_DIM
+ */
+static inline int32_t fb_rmsnorm_i32_to_prequant(void *dst, const int32_t *x,
+                                                 uint64_t weight_addr, size_t dim,
+                                                 int32_t scale_q16, uint32_t flags) {
+    if (dim == 0 || dim > FB_RMSNORM_PREQUANT_MAX_DIM) {
+        return 0;
+    }
+    int8_t *q = (int8_t *)dst;
+    const int16_t *w = (const int16_t *)(uintptr_t)weight_addr;
+    int32_t lo = (flags & FB_PREQUANT_RELU) ? 0 : INT32_MIN;
+    uint64_t sumsq = (uint64_t)fb_dot_i32(x, x, dim, 0);
+    int32_t rms = (int32_t)fb_isqrt64(sumsq / dim);
+    uint64_t kmax = fb_isqrt64(dim);
+    int64_t gain = w[0];
+
+    if (scale_q16 <= 0) {
+        uint32_t max_abs = 0;
+        for (size_t i = 0; i < dim; i++) {
+            int64_t sk = fb_rmsnorm_i32_k(x[i], sumsq, rms, kmax, dim);
+            int32_t v = (int32_t)((sk * gain * w[1 + i]) >> 24);
+            uint32_t a = fb_abs_u32(v < lo ? lo : v);
+            max_abs = a > max_abs ? a : max_abs;
+            q[i] = (int8_t)sk;
+        }
+        scale_q16 = fb_quantize_step_for_max(max_abs);
+        for (size_t i = 0; i < dim; i++) {
+            int32_t v = (int32_t)(((int64_t)q[i] * gain * w[1 + i]) >> 24);
+            q[i] = fb_quantize_i32_q8(v < lo ? lo : v, (uint32_t)scale_q16);
+        }
+    } else {
+        for (size_t i = 0; i < dim; i++) {
+            int64_t sk = fb_rmsnorm_i32_k(x[i], sumsq, rms, kmax, dim);
+            int32_t v = (int32_t)((sk * gain * w[1 + i]) >> 24);
+            q[i] = fb_quantize_i32_q8(v < lo ? lo : v, (uint32_t)scale_q16);
+        }
+    }
+    for (size_t i = dim; i < FB_ALIGN4(dim); i++) {
+        q[i] = 0;
+    }
+    *fb_prequant_scale(dst, dim) = scale_q16;
+    return scale_q16;
+}
+
+/**
+ * Resumable Q16 softmax in place: pass 0 finds the max with
+ * ARGMAX_I32_PARTIAL, pass 1 stores fb_q16_exp(x - max) and sums it, pass 2
+ * normalizes to 65536 * e / sum. Within a few LSB of SOFTMAX_I32.
+ */
+static inline int fb_softmax_i32_resumable(int32_t *data, size_t len,
+                                           fb_reduce_i32_state_t *st) {
+    if (st->phase >= 3 || len == 0) {
+        return 1;
+    }
+    uint32_t c = st->cursor;
+    uint32_t step = fb_resume_chunk(st, len);
+    int32_t *p = data + c;
+    if (st->phase == 0) {
+        fb_argmax_i32_state_t am = {0, 0, c ? st->pivot : INT32_MIN, 0};
+        (void)fb_argmax_i32_partial(p, step, &am);
+        st->pivot = am.max_val;
+    } else if (st->phase == 1) {
+        for (uint32_t i = 0; i < step; i++) {
+            p[i] = fb_q16_exp(fb_q16_sub_sat(p[i], st->pivot));
+            st->acc += p[i];
+        }
+    } else {
+        int64_t sum = st->acc;
+        for (uint32_t i = 0; i < step; i++) {
+            p[i] = (int32_t)(((int64_t)p[i] << 16) / sum);
+        }
+    }
+    return fb_resume_advance(st, step, len, 3);
+}
+
+/**
+ * Insert (i, x) into the best-first top-K arrays held by `st`. Equal values
+ * keep the earlier index first.
+ */
+static inline void fb_topk_i32_insert(uint32_t *idx, int32_t *val, uint32_t k,
+                                      fb_topk_i32_state_t *st, uint32_t i, int32_t x) {
+    uint32_t j = st->filled < k ? st->filled++ : k - 1u;
+    while (j > 0 && val[j - 1u] < x) {
+        val[j] = val[j - 1u];
+        idx[j] = idx[j - 1u];
+        j--;
+    }
+    val[j] = x;
+    idx[j] = i;
+    if (st->filled == k) {
+        st->min_val = val[k - 1u];
+    }
+}
+
+/**
+ * Resumable top-K over i32 logits: idx[k] / val[k] end up best-first, ties
+ * by lower index. Once K entries are held, an element that does not beat
+ * the K-th costs one compare. With FB_TOPK_SOFTMAX the final call runs
+ * SOFTMAX_I32 over the kept values only (renormalized over the K classes).
+ *
+ * @return 1 when done (st->filled = min(k, count) entries), 0 after a yield
+ */
+static inline int fb_topk_i32_partial(const int32_t *data, size_t count, uint32_t k,
+                                      uint32_t *idx, int32_t *val, uint32_t flags,
+                                      fb_topk_i32_state_t *st) {
+    uint32_t i = st->cursor;
+    if (k == 0 || i >= count) {
+        return 1;
+    }
+    uint32_t end = st->max_per_call && st->max_per_call < count - i ? i + st->max_per_call
+                                                                    : (uint32_t)count;
+    for (; i < end && st->filled < k; i++) {
+        fb_topk_i32_insert(idx, val, k, st, i, data[i]);
+    }
+    for (int32_t t = st->min_val; i < end; i++) {
+        if (data[i] > t) {
+            fb_topk_i32_insert(idx, val, k, st, i, data[i]);
+            t = st->min_val;
+        }
+    }
+    st->cursor = end;
+    if (end >= count) {
+        if (flags & FB_TOPK_SOFTMAX) {
+            fb_softmax_i32(val, st->filled);
+        }
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/**
+ * Top-K over i32 logits in one call (see fb_topk_i32_partial).
+ *
+ * @return entries written, min(k, count)
+ */
+static inline uint32_t fb_topk_i32(const int32_t *data, size_t count, uint32_t k, uint32_t *idx,
+                                   int32_t *val, uint32_t flags) {
+    fb_topk_i32_state_t st = {0, 0, 0, 0};
+    (void)fb_topk_i32_partial(data, count, k, idx, val, flags, &st);
+    return st.filled;
+}
+
+/**
+ * ARB_SEARCH over a batch of 32-byte input mints, max_rows mints per call on
+ * the row cursor. Mint r writes its matches at outputs + r * out_stride and
+ * its count to counts[r].
+ *
+ * @return 1 once all count mints are searched, else 0
+ */
+static inline int fb_arb_search_batch(const uint8_t *input_mints, size_t count,
+                                      uint64_t graph_idx, uint8_t *outputs,
+                                      size_t out_stride, uint32_t *counts,
+                                      uint64_t min_amount, const void *mask_ptr,
+                                      fb_row_state_t *state) {
+    uint32_t r = state->cursor;
+    uint32_t end = state->max_rows && state->max_rows < count - r ? r + state->max_rows
+                                                                  : (uint32_t)count;
+    for (; r < end; r++) {
+        counts[r] = fb_arb_search(input_mints + (size_t)r * 32u, graph_idx,
+                                  outputs + (size_t)r * out_stride, min_amount, mask_ptr);
+    }
+    state->cursor = end;
+    if (end >= count) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/* ============================================================================
+ * Quantum syscall (9000)
+ * ============================================================================ */
+
+/**
+ * QUANTUM_OP: 7-qubit state ops (Q16.16 complex).
+ *
+ * @return measurement result for MEASURE, else 0
+ */
+static inline int fb_quantum_op(int op, int target, int control, void *state_ptr) {
+    return (int)fb_syscall4(FB_SYS_QUANTUM_OP, (long)op, (long)target,
+                            (long)control, (long)state_ptr);
+}
+
+/*
+ * Quantum circuits: a flat array of gate records applied from one call site.
+ * `control` carries what QUANTUM_OP takes there: the control qubit for CNOT,
+ * the angle index for RX/RZ/PHASE, the RNG seed for MEASURE.
+ */
+typedef struct {
+    uint8_t op;       /* FB_QOP_* */
+    uint8_t target;
+    uint16_t control;
+} fb_qgate_t;
+
+#define FB_QGATE(op, target, control) { (uint8_t)(op), (uint8_t)(target), (uint16_t)(control) }
+
+/* 1 if gate `g` reads or writes qubit q (INIT and MEASURE touch every qubit) */
+static inline int fb_qgate_touches(const fb_qgate_t *g, uint32_t q) {
+    if (g->op == FB_QOP_INIT || g->op == FB_QOP_MEASURE) {
+        return 1;
+    }
+    return g->target == q || (g->op == FB_QOP_CNOT && g->control == q);
+}
+
+/**
+ * Check every record once: known op, target (and CNOT control) below
+ * FB_QUANTUM_NUM_QUBITS, CNOT control != target.
+ *
+ * @return 0, or -1 for the first bad record
+ */
+static inline int fb_quantum_circuit_check(const fb_qgate_t *gates, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const fb_qgate_t *g = &gates[i];
+        if (g->op > FB_QOP_PHASE || g->target >= FB_QUANTUM_NUM_QUBITS ||
+            (g->op == FB_QOP_CNOT &&
+             (g->control >= FB_QUANTUM_NUM_QUBITS || g->control == g->target))) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Drop gates that cancel, in place: an H or a CNOT whose previous gate on
+ * the same qubits is the identical gate removes both (H and CNOT are their
+ * own inverse), repeatedly, so mirrored uncompute blocks vanish. Gates
+ * (and INITs) before an INIT with no MEASURE between them are dead and
+ * dropped too.
+ * INIT and MEASURE are barriers; rotations are kept as written (their angle
+ * table belongs to the VM). Run once on a static circuit, then reuse it.
+ *
+ * @return the new gate count
+ */
+static inline size_t fb_quantum_circuit_simplify(fb_qgate_t *gates, size_t count) {
+    size_t kept = 0;
+    size_t barrier = 0; /* kept gates before this index are never revisited */
+    for (size_t i = 0; i < count; i++) {
+        fb_qgate_t g = gates[i];
+        if (g.op == FB_QOP_INIT) {
+            kept = barrier && gates[barrier - 1u].op == FB_QOP_INIT ? barrier - 1u : barrier;
+            barrier = kept;
+        }
+        if (g.op == FB_QOP_H || g.op == FB_QOP_CNOT) {
+            size_t j = kept;
+            while (j > barrier && !fb_qgate_touches(&gates[j - 1u], g.target) &&
+                   !(g.op == FB_QOP_CNOT && fb_qgate_touches(&gates[j - 1u], g.control))) {
+                j--;
+            }
+            if (j > barrier) {
+                fb_qgate_t *p = &gates[j - 1u];
+                if (p->op == g.op && p->target == g.target &&
+                    (g.op == FB_QOP_H || p->control == g.control)) {
+                    for (size_t k = j - 1u; k + 1u < kept; k++) {
+                        gates[k] = gates[k + 1u];
+                    }
+                    kept--;
+                    continue;
+                }
+            }
+        }
+        gates[kept++] = g;
+        if (g.op == FB_QOP_INIT || g.op == FB_QOP_MEASURE) {
+            barrier = kept;
+        }
+    }
+    return kept;
+}
+
+/**
+ * Apply `count` gates to `state` in order from one call site, after one
+ * up-front check, storing MEASURE outcomes in `results` (may be NULL).
+ *
+ * A guest-side convenience only: there is no batched trap, so each gate is
+ * still one QUANTUM_OP ecall with the same trap cost as calling
+ * fb_quantum_op directly. Only fb_quantum_circuit_simplify removes ecalls.
+ *
+ * @return MEASURE results written, or -1 if a record is invalid (nothing
+ *         applied)
+ */
+static inline int fb_quantum_run(const fb_qgate_t *gates, size_t count, void *state_ptr,
+                                 int *results) {
+    if (fb_quantum_circuit_check(gates, count) != 0) {
+        return -1;
+    }
+    int measured = 0;
+    for (size_t i = 0; i < count; i++) {
+        const fb_qgate_t *g = &gates[i];
+        int r = fb_quantum_op(g->op, g->target, g->control, state_ptr);
+        if (g->op == FB_QOP_MEASURE) {
+            if (results) {
+                results[measured] = r;
+            }
+            measured++;
+        }
+    }
+    return measured;
+}
+
+/* ============================================================================
+ * Command buffers
+ * ============================================================================ */
+
+/**
+ * One queued kernel call: syscall ID, argument count, up to seven arguments
+ * (a0..a6), and the a0 result written back by fb_cmd_run. Build entries with
+ * FB_CMD() or the FB_CMD_* helpers, which fill in argc; a command list can be
+ * static and re-run per inference.
+ */
+typedef struct {
+    uint32_t id;
+    uint32_t argc; /* registers fb_cmd_run loads, 1..7 */
+    uint64_t args[7];
+    int64_t result;
+} fb_cmd_t;
+
+#define FB_CMD_NARGS_(a0, a1, a2, a3, a4, a5, a6, n, ...) n
+#define FB_CMD_NARGS(...) FB_CMD_NARGS_(__VA_ARGS__, 7, 6, 5, 4, 3, 2, 1, 0)
+
+/* Brace initializer, so command lists may be static arrays. */
+#define FB_CMD(id, ...) \
+    { (uint32_t)(id), FB_CMD_NARGS(__VA_ARGS__), { __VA_ARGS__ }, 0 }
+#define FB_CMD_ARG(v) ((uint64_t)(uintptr_t)(v))
+
+#define FB_CMD_MATMUL_I8_I8(out, x, w, w_scale_q16, n, d)                     \
+    FB_CMD(FB_SYS_MATMUL_I8_I8, FB_CMD_ARG(out), FB_CMD_ARG(x), FB_CMD_ARG(w), \
+           (uint64_t)(int64_t)(w_scale_q16), (uint64_t)(n), (uint64_t)(d))
+#define FB_CMD_ARGMAX_I32_PARTIAL(data, count, state) \
+    FB_CMD(FB_SYS_ARGMAX_I32_PARTIAL, FB_CMD_ARG(data), (uint64_t)(count), FB_CMD_ARG(state))
+#define FB_CMD_DOT_I8(a, b, len) \
+    FB_CMD(FB_SYS_DOT_I8, FB_CMD_ARG(a), FB_CMD_ARG(b), (uint64_t)(len))
+#define FB_CMD_VEC_ADD_I8(dst, src, len) \
+    FB_CMD(FB_SYS_VEC_ADD_I8, FB_CMD_ARG(dst), FB_CMD_ARG(src), (uint64_t)(len))
+#define FB_CMD_ACTIVATION(data, len, type) \
+    FB_CMD(FB_SYS_ACTIVATION, FB_CMD_ARG(data), (uint64_t)(len), (uint64_t)(type))
+
+/**
+ * True for IDs fb_cmd_run accepts: LLM kernels (110-122, 130-144) and AI/ML
+ * kernels (7000-7019). Control syscalls (exit, yield, write) are rejected.
+ */
+static inline int fb_cmd_id_ok(uint64_t id) {
+    return (id >= FB_SYS_MATMUL && id <= FB_SYS_DEBUG_LOG) ||
+           (id >= FB_SYS_MATMUL_I8_I32 && id <= FB_SYS_MATMUL_I8_I8_W1W3_SILU) ||
+           (id >= 7000 && id <= 7019);
+}
+
+/**
+ * Execute `count` commands in order, storing each a0 in cmds[i].result.
+ *
+ * A guest-side convenience only: there is no batched trap, so each entry is
+ * still its own ecall with the same trap cost as a direct call. It runs a
+ * prebuilt list from one call site and loads only the command's argc
+ * registers. A rejected ID or argc stops the run with result -1.
+ *
+ * @return number of commands executed
+ */
+static inline size_t fb_cmd_run(fb_cmd_t *cmds, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        fb_cmd_t *c = &cmds[i];
+        const long *a = (const long *)c->args;
+        long id = (long)c->id;
+        if (!fb_cmd_id_ok(c->id)) {
+            c->result = -1;
+            return i;
+        }
+        switch (c->argc) {
+        case 1:
+            c->result = fb_syscall1(id, a[0]);
+            break;
+        case 2:
+            c->result = fb_syscall2(id, a[0], a[1]);
+            break;
+        case 3:
+            c->result = fb_syscall3(id, a[0], a[1], a[2]);
+            break;
+        case 4:
+            c->result = fb_syscall4(id, a[0], a[1], a[2], a[3]);
+            break;
+        case 5:
+            c->result = fb_syscall5(id, a[0], a[1], a[2], a[3], a[4]);
+            break;
+        case 6:
+            c->result = fb_syscall6(id, a[0], a[1], a[2], a[3], a[4], a[5]);
+            break;
+        case 7:
+            c->result = fb_syscall7(id, a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+            break;
+        default:
+            c->result = -1;
+            return i;
+        }
+    }
+    return count;
+}
+
+/* ============================================================================
+ * Utility functions
+ * ============================================================================ */
+
+/**
+ * strlen for VM programs.
+ */
+static inline size_t fb_strlen(const char *s) {
+    size_t len = 0;
+    while (s[len]) {
+        len++;
     }
     return len;
 }
 
-#ifndef FB_RUNTIME_IMPLEMENTATION
+/*
+ * f32 math helpers (lib/frostbite_softfloat.c). With the F extension (fb-cc)
+ * fb_fmaf / fb_sqrtf / fb_rsqrtf are fmadd.s / fsqrt.s; under rv64im they are
+ * integer fast paths that truncate like the soft-float builtins (<= 1 ulp).
+ * fb_expf is integer code on both (~1.6e-7 relative error; flushes below
+ * FLT_MIN).
+ */
+float fb_fmaf(float a, float b, float c);
+float fb_sqrtf(float x);
+float fb_rsqrtf(float x);
+float fb_expf(float x);
+
+/*
+ * Memory helpers.
+ *
+ * Bulk paths move 8 bytes per ld/sd once the destination is aligned, with the
+ * main loops unrolled 4x (32 bytes per iteration). Short lengths and the
+ * unaligned head/tail fall back to byte loops. When the source is misaligned
+ * relative to the destination, memcpy merges two aligned loads with shifts so
+ * every load and store stays naturally aligned.
+ *
+ * Guest code gets static inline copies; frostbite_alloc.c defines
+ * FB_RUNTIME_IMPLEMENTATION and receives the same bodies as out-of-line
+ * definitions for the libc-style aliases.
+ */
+#ifdef FB_RUNTIME_IMPLEMENTATION
+#define FB_MEM_FN
+#else
+#define FB_MEM_FN static inline
+#endif
+
+/* Below this length the byte loop is cheaper than the alignment prologue. */
+#define FB_MEM_WORD_MIN 16u
+
+typedef uint64_t __attribute__((may_alias)) fb_mem_word_t;
+
 /**
  * memset for VM programs.
  */
-static inline void *fb_memset(void *s, int c, size_t n) {
+FB_MEM_FN void *fb_memset(void *s, int c, size_t n) {
     unsigned char *p = (unsigned char *)s;
+    unsigned char v = (unsigned char)c;
+
+    if (n >= FB_MEM_WORD_MIN) {
+        while ((uintptr_t)p & 7u) {
+            *p++ = v;
+            n--;
+        }
+        uint64_t pattern = (uint64_t)v * 0x0101010101010101ULL;
+        fb_mem_word_t *w = (fb_mem_word_t *)p;
+        while (n >= 32) {
+            w[0] = pattern;
+            w[1] = pattern;
+            w[2] = pattern;
+            w[3] = pattern;
+            w += 4;
+            n -= 32;
+        }
+        while (n >= 8) {
+            *w++ = pattern;
+            n -= 8;
+        }
+        p = (unsigned char *)w;
+    }
+
     while (n--) {
-        *p++ = (unsigned char)c;
+        *p++ = v;
     }
     return s;
 }
 
 /**
- * memcpy for VM programs.
+ * memcpy for VM programs. Regions must not overlap (use fb_memmove).
  */
-static inline void *fb_memcpy(void *dest, const void *src, size_t n) {
+FB_MEM_FN void *fb_memcpy(void *dest, const void *src, size_t n) {
     unsigned char *d = (unsigned char *)dest;
     const unsigned char *s = (const unsigned char *)src;
+
+    if (n >= FB_MEM_WORD_MIN) {
+        while ((uintptr_t)d & 7u) {
+            *d++ = *s++;
+            n--;
+        }
+        fb_mem_word_t *dw = (fb_mem_word_t *)d;
+        unsigned misalign = (unsigned)((uintptr_t)s & 7u);
+        if (misalign == 0) {
+            const fb_mem_word_t *sw = (const fb_mem_word_t *)s;
+            while (n >= 32) {
+                uint64_t w0 = sw[0];
+                uint64_t w1 = sw[1];
+                uint64_t w2 = sw[2];
+                uint64_t w3 = sw[3];
+                dw[0] = w0;
+                dw[1] = w1;
+                dw[2] = w2;
+                dw[3] = w3;
+                sw += 4;
+                dw += 4;
+                n -= 32;
+            }
+            while (n >= 8) {
+                *dw++ = *sw++;
+                n -= 8;
+            }
+            s = (const unsigned char *)sw;
+        } else {
+            /* Only aligned words that contain source bytes are loaded. */
+            unsigned lo_shift = misalign * 8u;
+            unsigned hi_shift = 64u - lo_shift;
+            const fb_mem_word_t *sw = (const fb_mem_word_t *)(s - misalign);
+            uint64_t lo = *sw++;
+            size_t words = n >> 3;
+            while (words >= 2) {
+                uint64_t mid = sw[0];
+                uint64_t hi = sw[1];
+                dw[0] = (lo >> lo_shift) | (mid << hi_shift);
+                dw[1] = (mid >> lo_shift) | (hi << hi_shift);
+                lo = hi;
+                sw += 2;
+                dw += 2;
+                words -= 2;
+            }
+            if (words) {
+                uint64_t hi = *sw;
+                *dw++ = (lo >> lo_shift) | (hi << hi_shift);
+            }
+            s += n & ~(size_t)7u;
+            n &= 7u;
+        }
+        d = (unsigned char *)dw;
+    }
+
     while (n--) {
         *d++ = *s++;
     }
     return dest;
 }
-#endif
+
+/**
+ * memmove for VM programs (overlap-safe).
+ */
+FB_MEM_FN void *fb_memmove(void *dest, const void *src, size_t n) {
+    unsigned char *d = (unsigned char *)dest;
+    const unsigned char *s = (const unsigned char *)src;
+
+    /* Forward copy is safe unless dest starts inside [src, src + n). */
+    if ((uintptr_t)d - (uintptr_t)s >= n) {
+        return fb_memcpy(dest, src, n);
+    }
+
+    d += n;
+    s += n;
+    if (n >= FB_MEM_WORD_MIN && (((uintptr_t)d ^ (uintptr_t)s) & 7u) == 0) {
+        while ((uintptr_t)d & 7u) {
+            *--d = *--s;
+            n--;
+        }
+        fb_mem_word_t *dw = (fb_mem_word_t *)d;
+        const fb_mem_word_t *sw = (const fb_mem_word_t *)s;
+        while (n >= 32) {
+            uint64_t w3 = sw[-1];
+            uint64_t w2 = sw[-2];
+            uint64_t w1 = sw[-3];
+            uint64_t w0 = sw[-4];
+            dw[-1] = w3;
+            dw[-2] = w2;
+            dw[-3] = w1;
+            dw[-4] = w0;
+            sw -= 4;
+            dw -= 4;
+            n -= 32;
+        }
+        while (n >= 8) {
+            *--dw = *--sw;
+            n -= 8;
+        }
+        d = (unsigned char *)dw;
+        s = (const unsigned char *)sw;
+    }
+
+    while (n--) {
+        *--d = *--s;
+    }
+    return dest;
+}
+
+/**
+ * memcmp for VM programs.
+ *
+ * @return <0, 0, >0 comparing the first differing byte as unsigned
+ */
+FB_MEM_FN int fb_memcmp(const void *a, const void *b, size_t n) {
+    const unsigned char *pa = (const unsigned char *)a;
+    const unsigned char *pb = (const unsigned char *)b;
+
+    if (n >= FB_MEM_WORD_MIN && (((uintptr_t)pa ^ (uintptr_t)pb) & 7u) == 0) {
+        while ((uintptr_t)pa & 7u) {
+            if (*pa != *pb) {
+                return (int)*pa - (int)*pb;
+            }
+            pa++;
+            pb++;
+            n--;
+        }
+        const fb_mem_word_t *wa = (const fb_mem_word_t *)pa;
+        const fb_mem_word_t *wb = (const fb_mem_word_t *)pb;
+        while (n >= 32) {
+            if ((wa[0] ^ wb[0]) | (wa[1] ^ wb[1]) | (wa[2] ^ wb[2]) | (wa[3] ^ wb[3])) {
+                break;
+            }
+            wa += 4;
+            wb += 4;
+            n -= 32;
+        }
+        while (n >= 8 && *wa == *wb) {
+            wa++;
+            wb++;
+            n -= 8;
+        }
+        /* The differing byte (if any) is located by the byte loop below. */
+        pa = (const unsigned char *)wa;
+        pb = (const unsigned char *)wb;
+    }
+
+    while (n--) {
+        if (*pa != *pb) {
+            return (int)*pa - (int)*pb;
+        }
+        pa++;
+        pb++;
+    }
+    return 0;
+}
+
+/* ============================================================================
+ * Element-wise i32 helpers
+ * ============================================================================ */
+
+/*
+ * Element-wise i32 ops. There is no VM kernel for these: add/sub run on
+ * WEIGHTED_SUM_I32 (weight +-1), the rest are guest loops unrolled 4x. dst
+ * may alias a. fb_vec_op_i32 selects a helper by FB_VEC_OP_* code.
+ */
+#define FB_VEC_I32_EACH(len, BODY)                \
+    do {                                          \
+        size_t fb_i_ = 0;                         \
+        for (; fb_i_ + 4 <= (len); fb_i_ += 4) {  \
+            { size_t i = fb_i_; BODY; }           \
+            { size_t i = fb_i_ + 1; BODY; }       \
+            { size_t i = fb_i_ + 2; BODY; }       \
+            { size_t i = fb_i_ + 3; BODY; }       \
+        }                                         \
+        for (; fb_i_ < (len); fb_i_++) {          \
+            size_t i = fb_i_;                     \
+            BODY;                                 \
+        }                                         \
+    } while (0)
+
+static inline void fb_vec_add_i32(int32_t *dst, const int32_t *a, const int32_t *b,
+                                  size_t len) {
+    if (dst == b) {
+        fb_weighted_sum_i32(dst, a, 1, len, 0);
+        return;
+    }
+    if (dst != a) {
+        fb_memcpy(dst, a, len * sizeof(int32_t));
+    }
+    fb_weighted_sum_i32(dst, b, 1, len, 0);
+}
+
+static inline void fb_vec_sub_i32(int32_t *dst, const int32_t *a, const int32_t *b,
+                                  size_t len) {
+    if (dst == b && dst != a) {
+        FB_VEC_I32_EACH(len, dst[i] = (int32_t)((uint32_t)a[i] - (uint32_t)b[i]));
+        return;
+    }
+    if (dst != a) {
+        fb_memcpy(dst, a, len * sizeof(int32_t));
+    }
+    fb_weighted_sum_i32(dst, b, -1, len, 0);
+}
+
+/**
+ * dst = (a * b) >> shift with round-half-up (64-bit product, wraps to i32).
+ * Shifts above 63 are clamped to 63.
+ */
+static inline void fb_vec_mul_shift_i32(int32_t *dst, const int32_t *a, const int32_t *b,
+                                        size_t len, uint32_t shift) {
+    if (shift > 63u) {
+        shift = 63u;
+    }
+    /* (p + 2^(shift-1)) >> shift without the add, which overflows at shift 63 */
+    FB_VEC_I32_EACH(len, {
+        int64_t p = (int64_t)a[i] * b[i];
+        dst[i] = (int32_t)(shift ? (p >> shift) + ((p >> (shift - 1u)) & 1) : p);
+    });
+}
+
+static inline void fb_vec_max_i32(int32_t *dst, const int32_t *a, const int32_t *b,
+                                  size_t len) {
+    FB_VEC_I32_EACH(len, dst[i] = a[i] > b[i] ? a[i] : b[i]);
+}
+
+static inline void fb_vec_min_i32(int32_t *dst, const int32_t *a, const int32_t *b,
+                                  size_t len) {
+    FB_VEC_I32_EACH(len, dst[i] = a[i] < b[i] ? a[i] : b[i]);
+}
+
+static inline void fb_vec_clamp_i32(int32_t *dst, const int32_t *a, size_t len, int32_t lo,
+                                    int32_t hi) {
+    FB_VEC_I32_EACH(len, {
+        int32_t v = a[i] < lo ? lo : a[i];
+        dst[i] = v > hi ? hi : v;
+    });
+}
+
+/**
+ * dst[i] = round(a[i] / step) clamped to +-127, step in Q16 units of a (the
+ * fb_quantize_i32_q8 rule). No padding or scale word; see
+ * fb_quantize_i32_to_prequant for a full prequant buffer.
+ */
+static inline void fb_vec_requant_i32_i8(int8_t *dst, const int32_t *a, size_t len,
+                                         uint32_t step_q16) {
+    FB_VEC_I32_EACH(len, dst[i] = fb_quantize_i32_q8(a[i], step_q16));
+}
+
+/**
+ * Run one FB_VEC_OP_* over len elements. b is unused by CLAMP/REQUANT_I8;
+ * p0/p1 are the op parameters listed with the op codes.
+ *
+ * @return 0, or -1 for an unknown op or a MUL_SHIFT p0 outside 0..63
+ */
+static inline int fb_vec_op_i32(void *dst, const int32_t *a, const int32_t *b, size_t len,
+                                uint32_t op, int32_t p0, int32_t p1) {
+    int32_t *out = (int32_t *)dst;
+    switch (op) {
+    case FB_VEC_OP_ADD:
+        fb_vec_add_i32(out, a, b, len);
+        return 0;
+    case FB_VEC_OP_SUB:
+        fb_vec_sub_i32(out, a, b, len);
+        return 0;
+    case FB_VEC_OP_MUL_SHIFT:
+        if (p0 < 0 || p0 > 63) {
+            return -1;
+        }
+        fb_vec_mul_shift_i32(out, a, b, len, (uint32_t)p0);
+        return 0;
+    case FB_VEC_OP_MAX:
+        fb_vec_max_i32(out, a, b, len);
+        return 0;
+    case FB_VEC_OP_MIN:
+        fb_vec_min_i32(out, a, b, len);
+        return 0;
+    case FB_VEC_OP_CLAMP:
+        fb_vec_clamp_i32(out, a, len, p0, p1);
+        return 0;
+    case FB_VEC_OP_REQUANT_I8:
+        fb_vec_requant_i32_i8((int8_t *)dst, a, len, (uint32_t)p0);
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+/* ============================================================================
+ * Packed int4 weights
+ * ============================================================================ */
+
+/*
+ * d x n int4 weight matrices at half the bytes of int8. There is no VM
+ * kernel for int4: each row is unpacked to int8 into `row_buf` and scored with
+ * MATMUL_I8_I8, so results match the int8 kernels bit for bit:
+ *   out[r] = (dot(w[r], x) * scales[r] * x_scale_q16) >> 32
+ * with one Q16 scale per row. Rows are FB_I4_ROW_BYTES(n) apart; each group of
+ * 16 weights is 8 bytes, byte j holding w[16g + j] in its low nibble and
+ * w[16g + 8 + j] in its high nibble (two's complement, -8..7, tail zeroed).
+ * That order sign-extends 8 weights per 64-bit word with no byte shuffles.
+ * Pack with fb_i4_pack or scripts/fb_i4pack.py.
+ */
+#define FB_ALIGN16(n) (((n) + 15u) & ~15u)
+#define FB_I4_ROW_BYTES(n) (FB_ALIGN16(n) / 2u)
+#define FB_I4_BYTES(n, d) ((size_t)(d) * FB_I4_ROW_BYTES(n))
+/* row_buf size (8-byte aligned) */
+#define FB_I4_ROW_BUF_BYTES(n) FB_ALIGN16(n)
+
+/**
+ * Unpack one packed row into FB_ALIGN16(n) int8 weights. Word-at-a-time when
+ * both pointers are 8-byte aligned, else a byte loop.
+ */
+static inline void fb_i4_unpack_row(int8_t *dst, const uint8_t *src, size_t n) {
+    const uint64_t lo4 = 0x0F0F0F0F0F0F0F0FULL;
+    const uint64_t bias = 0x0808080808080808ULL;
+    const uint64_t lift = 0x7878787878787878ULL;
+    const uint64_t sign = 0x8080808080808080ULL;
+    size_t groups = FB_ALIGN16(n) / 16u;
+
+    if ((((uintptr_t)dst | (uintptr_t)src) & 7u) == 0) {
+        const fb_mem_word_t *s = (const fb_mem_word_t *)src;
+        fb_mem_word_t *o = (fb_mem_word_t *)dst;
+        for (size_t g = 0; g < groups; g++) {
+            uint64_t v = s[g];
+            /* per byte: ((nib ^ 8) + 0x78) ^ 0x80 == nib - 16 * (nib >> 3), no carries */
+            o[2 * g] = (((v & lo4) ^ bias) + lift) ^ sign;
+            o[2 * g + 1] = ((((v >> 4) & lo4) ^ bias) + lift) ^ sign;
+        }
+        return;
+    }
+    for (size_t g = 0; g < groups; g++) {
+        for (size_t j = 0; j < 8; j++) {
+            uint8_t b = src[8 * g + j];
+            dst[16 * g + j] = (int8_t)((b & 15u) ^ 8u) - 8;
+            dst[16 * g + 8 + j] = (int8_t)((b >> 4) ^ 8u) - 8;
+        }
+    }
+}
+
+/**
+ * Pack a row-major d x n int8 matrix into FB_I4_BYTES(n, d) bytes. Values
+ * clamp to -8..7 (requantize to that range first; fb_i4pack.py does it per
+ * row from int8 blobs).
+ */
+static inline void fb_i4_pack(uint8_t *dst, const int8_t *w, size_t n, size_t d) {
+    size_t row = FB_I4_ROW_BYTES(n);
+    for (size_t r = 0; r < d; r++) {
+        const int8_t *src = w + r * n;
+        uint8_t *out = dst + r * row;
+        for (size_t k = 0; k < row; k++) {
+            size_t i = (k / 8u) * 16u + (k % 8u);
+            int lo = i < n ? src[i] : 0;
+            int hi = i + 8 < n ? src[i + 8] : 0;
+            lo = lo < -8 ? -8 : (lo > 7 ? 7 : lo);
+            hi = hi < -8 ? -8 : (hi > 7 ? 7 : hi);
+            out[k] = (uint8_t)((lo & 15) | ((hi & 15) << 4));
+        }
+    }
+}
+
+/**
+ * Rows [start, end) of the int4 matmul.
+ */
+static inline void fb_matmul_i4_i8_rows(int32_t *out, const void *x_prequant,
+                                        const uint8_t *w_packed, const int32_t *scales_q16,
+                                        size_t n, size_t start, size_t end, int8_t *row_buf) {
+    for (size_t r = start; r < end; r++) {
+        fb_i4_unpack_row(row_buf, w_packed + r * FB_I4_ROW_BYTES(n), n);
+        fb_matmul_i8_i8(out + r, x_prequant, row_buf, scales_q16[r], n, 1);
+    }
+}
+
+/**
+ * int4 weights x prequant buffer, all d rows. Same output as fb_matmul_i8_i8
+ * with a per-row w_scale_q16.
+ */
+static inline void fb_matmul_i4_i8(int32_t *out, const void *x_prequant,
+                                   const uint8_t *w_packed, const int32_t *scales_q16,
+                                   size_t n, size_t d, int8_t *row_buf) {
+    fb_matmul_i4_i8_rows(out, x_prequant, w_packed, scales_q16, n, 0, d, row_buf);
+}
+
+/**
+ * Resumable fb_matmul_i4_i8: max_rows rows per call on the row cursor
+ * (0 = all), yielding like MATMUL_I8_I8_PARTIAL while rows remain.
+ *
+ * @return 1 once all d rows are done, else 0
+ */
+static inline int fb_matmul_i4_i8_partial(int32_t *out, const void *x_prequant,
+                                          const uint8_t *w_packed, const int32_t *scales_q16,
+                                          size_t n, size_t d, int8_t *row_buf,
+                                          fb_row_state_t *state) {
+    uint32_t r = state->cursor;
+    if (r >= d) {
+        return 1;
+    }
+    uint32_t end = state->max_rows && state->max_rows < d - r ? r + state->max_rows
+                                                              : (uint32_t)d;
+    fb_matmul_i4_i8_rows(out, x_prequant, w_packed, scales_q16, n, r, end, row_buf);
+    state->cursor = end;
+    if (end >= d) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/**
+ * Resumable argmax over the int4 matmul logits, max_per_call rows per call
+ * (0 = all), no logits buffer. Start from {0, 0, INT32_MIN, max_per_call};
+ * ties keep the lower row (strict >, as ARGMAX_I32_PARTIAL).
+ *
+ * @return 1 once all d rows are scored (winner in state->max_idx), else 0
+ */
+static inline int fb_matmul_i4_i8_argmax_partial(const void *x_prequant,
+                                                 const uint8_t *w_packed,
+                                                 const int32_t *scales_q16, size_t n, size_t d,
+                                                 int8_t *row_buf,
+                                                 fb_argmax_i32_state_t *state) {
+    uint32_t r = state->cursor;
+    if (r >= d) {
+        return 1;
+    }
+    uint32_t end = state->max_per_call && state->max_per_call < d - r
+                       ? r + state->max_per_call
+                       : (uint32_t)d;
+    for (; r < end; r++) {
+        int32_t logit;
+        fb_i4_unpack_row(row_buf, w_packed + (size_t)r * FB_I4_ROW_BYTES(n), n);
+        fb_matmul_i8_i8(&logit, x_prequant, row_buf, scales_q16[r], n, 1);
+        if (logit > state->max_val) {
+            state->max_val = logit;
+            state->max_idx = r;
+        }
+    }
+    state->cursor = end;
+    if (end >= d) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/* ============================================================================
+ * Batched matmul
+ * ============================================================================ */
+
+/*
+ * m inputs against one d x n weight matrix, out[i * d + r] for input i, row r.
+ * A batch block holds the m int8 inputs row-major (n bytes apart), then one
+ * Q16 scale per input at FB_BATCH_SCALES_OFFSET(n, m):
+ *   int8 x[m][n] | pad to 4 | int32 x_scale_q16[m]
+ * Results equal m fb_matmul_i8_i8 calls bit for bit. The VM has no batched
+ * kernel, so each pass is one MATMUL_I8_I8 over whichever side is longer:
+ * with m <= d a pass scores one input against all d rows; with m > d it
+ * scores one weight row against all m inputs (the block is the matrix), so
+ * each weight row is read once for the whole batch and a batch of m costs
+ * min(m, d) kernel calls instead of m.
+ */
+#define FB_BATCH_SCALES_OFFSET(n, m) FB_ALIGN4((size_t)(n) * (m))
+#define FB_BATCH_BYTES(n, m) (FB_BATCH_SCALES_OFFSET(n, m) + sizeof(int32_t) * (m))
+/* scratch for fb_matmul_i8_i8_batch (word-aligned) */
+#define FB_MATMUL_BATCH_SCRATCH_BYTES(n, m) (FB_PREQUANT_BYTES(n) + sizeof(int32_t) * (m))
+
+/**
+ * Per-input scales of a batch block.
+ */
+static inline int32_t *fb_batch_scales(void *batch, size_t n, size_t m) {
+    return (int32_t *)((uint8_t *)batch + FB_BATCH_SCALES_OFFSET(n, m));
+}
+
+/**
+ * Quantize m x n i32 activations into a batch block, each input with its own
+ * scale (scale_q16 <= 0: dynamic per input, as fb_quantize_i32_to_prequant).
+ */
+static inline void fb_quantize_i32_to_batch(void *dst, const int32_t *src, size_t n, size_t m,
+                                            int32_t scale_q16, uint32_t flags) {
+    int8_t *x = (int8_t *)dst;
+    int32_t *scales = fb_batch_scales(dst, n, m);
+    int32_t lo = (flags & FB_PREQUANT_RELU) ? 0 : INT32_MIN;
+    for (size_t i = 0; i < m; i++) {
+        const int32_t *row = src + i * n;
+        int32_t step = scale_q16 > 0 ? scale_q16 : fb_quantize_i32_step(row, n, flags);
+        for (size_t k = 0; k < n; k++) {
+            x[i * n + k] = fb_quantize_i32_q8(row[k] < lo ? lo : row[k], (uint32_t)step);
+        }
+        scales[i] = step;
+    }
+    for (size_t k = m * n; k < FB_BATCH_SCALES_OFFSET(n, m); k++) {
+        x[k] = 0;
+    }
+}
+
+/**
+ * Kernel calls a batch takes: min(m, d).
+ */
+static inline size_t fb_matmul_batch_passes(size_t d, size_t m) {
+    return m <= d ? m : d;
+}
+
+/**
+ * One pass of the batched matmul (input `pass` when m <= d, else weight row
+ * `pass`).
+ */
+static inline void fb_matmul_i8_i8_batch_pass(int32_t *out, const void *x_batch, const int8_t *w,
+                                              int32_t w_scale_q16, size_t n, size_t d, size_t m,
+                                              size_t pass, void *scratch) {
+    __extension__ typedef __int128 fb_i128;
+    const int8_t *xb = (const int8_t *)x_batch;
+    const int32_t *x_scales = (const int32_t *)(xb + FB_BATCH_SCALES_OFFSET(n, m));
+    int8_t *stage = (int8_t *)scratch;
+
+    for (size_t k = n; k < FB_ALIGN4(n); k++) {
+        stage[k] = 0;
+    }
+    if (m <= d) {
+        fb_memcpy(stage, xb + pass * n, n);
+        *fb_prequant_scale(stage, n) = x_scales[pass];
+        fb_matmul_i8_i8(out + pass * d, stage, w, w_scale_q16, n, d);
+        return;
+    }
+    /* weight row as the activation, inputs as the matrix: unit scales give raw dots */
+    int32_t *dots = (int32_t *)(stage + FB_PREQUANT_BYTES(n));
+    fb_memcpy(stage, w + pass * n, n);
+    *fb_prequant_scale(stage, n) = 1 << 16;
+    fb_matmul_i8_i8(dots, stage, xb, 1 << 16, n, m);
+    for (size_t i = 0; i < m; i++) {
+        out[i * d + pass] = (int32_t)(((fb_i128)dots[i] * w_scale_q16 * x_scales[i]) >> 32);
+    }
+}
+
+/**
+ * Batched MATMUL_I8_I8: m x d outputs for a batch block of m inputs.
+ *
+ * @param out       m * d outputs, input-major
+ * @param x_batch   FB_BATCH_BYTES(n, m) batch block (word-aligned)
+ * @param scratch   FB_MATMUL_BATCH_SCRATCH_BYTES(n, m) bytes
+ */
+static inline void fb_matmul_i8_i8_batch(int32_t *out, const void *x_batch, const int8_t *w,
+                                         int32_t w_scale_q16, size_t n, size_t d, size_t m,
+                                         void *scratch) {
+    size_t passes = fb_matmul_batch_passes(d, m);
+    for (size_t p = 0; p < passes; p++) {
+        fb_matmul_i8_i8_batch_pass(out, x_batch, w, w_scale_q16, n, d, m, p, scratch);
+    }
+}
+
+/**
+ * Resumable fb_matmul_i8_i8_batch: max_rows passes per call on the row
+ * cursor (0 = all), yielding while passes remain. The cursor runs to
+ * fb_matmul_batch_passes(d, m).
+ *
+ * @return 1 once the batch is done, else 0
+ */
+static inline int fb_matmul_i8_i8_batch_partial(int32_t *out, const void *x_batch,
+                                                const int8_t *w, int32_t w_scale_q16, size_t n,
+                                                size_t d, size_t m, void *scratch,
+                                                fb_row_state_t *state) {
+    uint32_t passes = (uint32_t)fb_matmul_batch_passes(d, m);
+    uint32_t p = state->cursor;
+    if (p >= passes) {
+        return 1;
+    }
+    uint32_t end = state->max_rows && state->max_rows < passes - p ? p + state->max_rows : passes;
+    for (; p < end; p++) {
+        fb_matmul_i8_i8_batch_pass(out, x_batch, w, w_scale_q16, n, d, m, p, scratch);
+    }
+    state->cursor = end;
+    if (end >= passes) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/**
+ * Batched MATMUL_I8_I32: m i32 inputs, n apart, one kernel call each (the
+ * operand types do not swap, so there is no weight-row pass here).
+ */
+static inline void fb_matmul_i8_i32_batch(int32_t *out, const int32_t *x, const int8_t *w,
+                                          int32_t scale_q16, size_t n, size_t d, size_t m) {
+    for (size_t i = 0; i < m; i++) {
+        fb_matmul_i8_i32(out + i * d, x + i * n, w, scale_q16, n, d);
+    }
+}
+
+/* ============================================================================
+ * 1D convolution
+ * ============================================================================ */
+
+/*
+ * int8 conv1d over channels-last activations, no im2col buffer:
+ *   dot       = sum_{j,c} w[o][j][c] * x[p * stride - pad + j * dilation][c]
+ *   out[p][o] = act(((dot * w_scale * x_scale) >> 32) + bias[o])
+ * with out-of-range positions reading zero. Each output position stages its
+ * k * c_in window (one contiguous copy when dilation is 1 and the window is
+ * inside the input) and runs all c_out filters through one MATMUL_I8_I8,
+ * so results equal fb_matmul_i8_i8 on the im2col row.
+ */
+#define FB_CONV1D_WINDOW_BYTES(k, c_in) FB_PREQUANT_BYTES((size_t)(k) * (c_in))
+
+/**
+ * Output positions of a conv1d config, or 0 if the shape is invalid.
+ */
+static inline uint32_t fb_conv1d_out_len(const fb_conv1d_cfg_t *cfg) {
+    if (cfg->k == 0 || cfg->c_in == 0 || cfg->c_out == 0 || cfg->stride == 0 ||
+        cfg->dilation == 0) {
+        return 0;
+    }
+    uint64_t span = (uint64_t)cfg->dilation * (cfg->k - 1u) + 1u;
+    uint64_t padded = (uint64_t)cfg->len + 2u * (uint64_t)cfg->pad;
+    return padded < span ? 0 : (uint32_t)((padded - span) / cfg->stride + 1u);
+}
+
+/**
+ * Reorder [c_out][c_in][k] weights (convert.py cnn1d, the loop order of the
+ * guest_cnn1d template) into the [c_out][k][c_in] rows fb_conv1d_i8 reads.
+ */
+static inline void fb_conv1d_pack_weights(int8_t *dst, const int8_t *w, uint32_t c_out,
+                                          uint32_t c_in, uint32_t k) {
+    for (uint32_t o = 0; o < c_out; o++) {
+        for (uint32_t c = 0; c < c_in; c++) {
+            for (uint32_t j = 0; j < k; j++) {
+                dst[((size_t)o * k + j) * c_in + c] = w[((size_t)o * c_in + c) * k + j];
+            }
+        }
+    }
+}
+
+/* Stage the window of output position p into a prequant buffer. */
+static inline void fb_conv1d_window(const fb_conv1d_cfg_t *cfg, uint32_t p, int8_t *win) {
+    const int8_t *x = (const int8_t *)(uintptr_t)cfg->x_ptr;
+    size_t n = (size_t)cfg->k * cfg->c_in;
+    int64_t t0 = (int64_t)p * cfg->stride - cfg->pad;
+    int64_t last = t0 + (int64_t)cfg->dilation * (cfg->k - 1u);
+
+    if (cfg->dilation == 1 && t0 >= 0 && last < (int64_t)cfg->len) {
+        fb_memcpy(win, x + (size_t)t0 * cfg->c_in, n);
+    } else {
+        for (uint32_t j = 0; j < cfg->k; j++) {
+            int64_t t = t0 + (int64_t)j * cfg->dilation;
+            int8_t *dst = win + (size_t)j * cfg->c_in;
+            if (t >= 0 && t < (int64_t)cfg->len) {
+                fb_memcpy(dst, x + (size_t)t * cfg->c_in, cfg->c_in);
+            } else {
+                fb_memset(dst, 0, cfg->c_in);
+            }
+        }
+    }
+    fb_memset(win + n, 0, FB_ALIGN4(n) - n);
+    *fb_prequant_scale(win, n) = cfg->x_scale;
+}
+
+/**
+ * Conv1d + bias + activation over the next `max_rows` output positions of
+ * `state_ptr` (all of them when state_ptr is 0), yielding between chunks.
+ *
+ * @return 1 once every position is done, 0 to call again, -1 for an invalid
+ *         shape
+ */
+static inline int fb_conv1d_i8(const fb_conv1d_cfg_t *cfg) {
+    uint32_t out_len = fb_conv1d_out_len(cfg);
+    if (out_len == 0) {
+        return -1;
+    }
+    fb_row_state_t *state = (fb_row_state_t *)(uintptr_t)cfg->state_ptr;
+    int32_t *out = (int32_t *)(uintptr_t)cfg->out_ptr;
+    const int8_t *w = (const int8_t *)(uintptr_t)cfg->w_ptr;
+    const int32_t *bias = (const int32_t *)(uintptr_t)cfg->bias_ptr;
+    int8_t *win = (int8_t *)(uintptr_t)cfg->window_ptr;
+    size_t n = (size_t)cfg->k * cfg->c_in;
+
+    uint32_t p = state ? state->cursor : 0;
+    if (p >= out_len) {
+        return 1;
+    }
+    uint32_t end = state && state->max_rows && state->max_rows < out_len - p
+                       ? p + state->max_rows
+                       : out_len;
+    for (; p < end; p++) {
+        int32_t *row = out + (size_t)p * cfg->c_out;
+        fb_conv1d_window(cfg, p, win);
+        fb_matmul_i8_i8(row, win, w, (int32_t)cfg->w_scale, n, cfg->c_out);
+        for (uint32_t o = 0; o < cfg->c_out; o++) {
+            row[o] = fb_act_i32(bias ? row[o] + bias[o] : row[o], cfg->act);
+        }
+    }
+    if (state) {
+        state->cursor = end;
+    }
+    if (end >= out_len) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/* ============================================================================
+ * Embedding bags
+ * ============================================================================ */
+
+/*
+ * Gather rows of an int8 embedding table (rows `dim` bytes apart, e.g. read
+ * in place from a weights or account segment) by ID and pool them into i32:
+ *   out[c] = sum_i table[ids[i] * dim + c]        (FB_EMBED_SUM)
+ * or that sum divided by count, rounded half away from zero (FB_EMBED_MEAN).
+ * When the table and dim are 8-byte aligned, rows are added eight bytes at a
+ * time into 16-bit lanes of `acc` (biased by +128 so lanes never borrow,
+ * flushed to out every 257 rows); otherwise a byte loop adds into out.
+ */
+#define FB_EMBED_SUM  0u
+#define FB_EMBED_MEAN 1u
+/* acc scratch (8-byte aligned) */
+#define FB_EMBED_ACC_BYTES(dim) ((((size_t)(dim) + 7u) & ~(size_t)7u) * 2u)
+
+/* Add rows[0..count) of the bag into out (ids already range-checked). */
+static inline void fb_embed_accumulate(int32_t *out, const int8_t *table, size_t dim,
+                                       const uint32_t *ids, size_t count, uint64_t *acc) {
+    const uint64_t lanes = 0x00FF00FF00FF00FFULL;
+    const uint64_t bias = 0x8080808080808080ULL;
+    size_t words = dim / 8u;
+
+    if (((uintptr_t)table & 7u) != 0 || (dim & 7u) != 0) {
+        for (size_t i = 0; i < count; i++) {
+            const int8_t *row = table + (size_t)ids[i] * dim;
+            for (size_t c = 0; c < dim; c++) {
+                out[c] += row[c];
+            }
+        }
+        return;
+    }
+    while (count > 0) {
+        size_t chunk = count < 257u ? count : 257u;
+        fb_memset(acc, 0, words * 2u * sizeof(uint64_t));
+        for (size_t i = 0; i < chunk; i++) {
+            const fb_mem_word_t *row = (const fb_mem_word_t *)(table + (size_t)ids[i] * dim);
+            for (size_t g = 0; g < words; g++) {
+                uint64_t v = row[g] ^ bias;
+                acc[2 * g] += v & lanes;
+                acc[2 * g + 1] += (v >> 8) & lanes;
+            }
+        }
+        int32_t unbias = (int32_t)(128u * chunk);
+        for (size_t g = 0; g < words; g++) {
+            for (uint32_t l = 0; l < 4; l++) {
+                out[8 * g + 2 * l] += (int32_t)((acc[2 * g] >> (16u * l)) & 0xFFFFu) - unbias;
+                out[8 * g + 2 * l + 1] += (int32_t)((acc[2 * g + 1] >> (16u * l)) & 0xFFFFu) - unbias;
+            }
+        }
+        ids += chunk;
+        count -= chunk;
+    }
+}
+
+static inline int fb_embed_ids_ok(const uint32_t *ids, size_t count, uint32_t num_rows) {
+    for (size_t i = 0; i < count; i++) {
+        if (ids[i] >= num_rows) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* out[c] / count for FB_EMBED_MEAN, rounded half away from zero. */
+static inline void fb_embed_mean(int32_t *out, size_t dim, size_t count) {
+    int64_t half = (int64_t)(count / 2u);
+    for (size_t c = 0; c < dim; c++) {
+        int64_t v = out[c];
+        out[c] = (int32_t)((v < 0 ? v - half : v + half) / (int64_t)count);
+    }
+}
+
+/**
+ * Embedding bag: pool the table rows named by `ids` into out[dim].
+ *
+ * @param acc  FB_EMBED_ACC_BYTES(dim) scratch
+ * @return 0, or -1 if an ID is >= num_rows, count is 0, or mode is unknown
+ */
+static inline int fb_embed_bag_i8(int32_t *out, const int8_t *table, size_t dim,
+                                  uint32_t num_rows, const uint32_t *ids, size_t count,
+                                  uint32_t mode, void *acc) {
+    if (count == 0 || mode > FB_EMBED_MEAN || !fb_embed_ids_ok(ids, count, num_rows)) {
+        return -1;
+    }
+    fb_memset(out, 0, dim * sizeof(int32_t));
+    fb_embed_accumulate(out, table, dim, ids, count, (uint64_t *)acc);
+    if (mode == FB_EMBED_MEAN) {
+        fb_embed_mean(out, dim, count);
+    }
+    return 0;
+}
+
+/**
+ * Resumable fb_embed_bag_i8: max_rows IDs per call on the row cursor
+ * (0 = all), yielding while IDs remain. out is zeroed on the first call and
+ * averaged on the last.
+ *
+ * @return 1 once the bag is pooled, 0 to call again, -1 as fb_embed_bag_i8
+ */
+static inline int fb_embed_bag_i8_partial(int32_t *out, const int8_t *table, size_t dim,
+                                          uint32_t num_rows, const uint32_t *ids, size_t count,
+                                          uint32_t mode, void *acc, fb_row_state_t *state) {
+    uint32_t i = state->cursor;
+    if (count == 0 || mode > FB_EMBED_MEAN) {
+        return -1;
+    }
+    if (i >= count) {
+        return 1;
+    }
+    uint32_t end = state->max_rows && state->max_rows < count - i ? i + state->max_rows
+                                                                  : (uint32_t)count;
+    if (!fb_embed_ids_ok(ids + i, end - i, num_rows)) {
+        return -1;
+    }
+    if (i == 0) {
+        fb_memset(out, 0, dim * sizeof(int32_t));
+    }
+    fb_embed_accumulate(out, table, dim, ids + i, end - i, (uint64_t *)acc);
+    state->cursor = end;
+    if (end >= count) {
+        if (mode == FB_EMBED_MEAN) {
+            fb_embed_mean(out, dim, count);
+        }
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/* ============================================================================
+ * Multi-segment weights
+ * ============================================================================ */
+
+/*
+ * One logical row-major tensor laid end to end over up to 15 segment views
+ * (e.g. a weight matrix too large for one account). Rows are read where
+ * they are: each run of whole rows inside one part goes to the kernel as
+ * is, and only a row that straddles two parts is gathered into a row_buf.
+ * Splitting the upload on row boundaries makes every access zero-copy.
+ */
+#define FB_SEG_TENSOR_MAX_PARTS 15u
+
+typedef struct {
+    fb_segment_view_t parts[FB_SEG_TENSOR_MAX_PARTS];
+    uint64_t starts[FB_SEG_TENSOR_MAX_PARTS + 1]; /* logical offset of each part; [num_parts] = total */
+    uint32_t num_parts;
+    uint32_t row_bytes;
+} fb_seg_tensor_t;
+
+/**
+ * Empty tensor of `row_bytes`-byte rows.
+ *
+ * @return 0, or -1 if row_bytes is 0
+ */
+static inline int fb_seg_tensor_init(fb_seg_tensor_t *t, uint32_t row_bytes) {
+    fb_memset(t, 0, sizeof(*t));
+    t->row_bytes = row_bytes;
+    return row_bytes ? 0 : -1;
+}
+
+/**
+ * Append an already validated view as the next part.
+ *
+ * @return 0, or -1 if the tensor has FB_SEG_TENSOR_MAX_PARTS parts or the
+ *         view is empty
+ */
+static inline int fb_seg_tensor_add_view(fb_seg_tensor_t *t, const fb_segment_view_t *view) {
+    if (t->num_parts >= FB_SEG_TENSOR_MAX_PARTS || !view->base || view->len == 0) {
+        return -1;
+    }
+    t->parts[t->num_parts] = *view;
+    t->starts[t->num_parts + 1u] = t->starts[t->num_parts] + view->len;
+    t->num_parts++;
+    return 0;
+}
+
+/**
+ * Append `len` bytes of `segment` at `offset` (checked by
+ * fb_segment_view_init) as the next part.
+ *
+ * @return 0 or -1
+ */
+static inline int fb_seg_tensor_add(fb_seg_tensor_t *t, uint32_t segment, uint32_t offset,
+                                    uint32_t len) {
+    fb_segment_view_t view;
+    if (fb_segment_view_init(&view, segment, offset, len) != 0) {
+        return -1;
+    }
+    return fb_seg_tensor_add_view(t, &view);
+}
+
+/**
+ * `total` bytes over `count` contiguous segments of `bytes_per_seg` each,
+ * starting at `offset` in the first (the fb_heap_init_segments layout).
+ *
+ * @return 0, or -1 if the segments cannot hold `total` bytes
+ */
+static inline int fb_seg_tensor_init_segments(fb_seg_tensor_t *t, uint32_t row_bytes,
+                                              uint32_t start_segment, uint32_t count,
+                                              uint32_t offset, uint32_t bytes_per_seg,
+                                              uint64_t total) {
+    if (fb_seg_tensor_init(t, row_bytes) != 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < count && total; i++) {
+        uint32_t off = i ? 0 : offset;
+        if (off >= bytes_per_seg) {
+            return -1;
+        }
+        uint32_t len = bytes_per_seg - off < total ? bytes_per_seg - off : (uint32_t)total;
+        if (fb_seg_tensor_add(t, start_segment + i, off, len) != 0) {
+            return -1;
+        }
+        total -= len;
+    }
+    return total ? -1 : 0;
+}
+
+/* Whole rows held by the tensor */
+static inline uint32_t fb_seg_tensor_rows(const fb_seg_tensor_t *t) {
+    return (uint32_t)(t->starts[t->num_parts] / t->row_bytes);
+}
+
+/* 1 if no part boundary falls inside one of the first `rows` rows */
+static inline int fb_seg_tensor_aligned(const fb_seg_tensor_t *t, uint32_t rows) {
+    uint64_t bytes = (uint64_t)rows * t->row_bytes;
+    for (uint32_t p = 1; p < t->num_parts && t->starts[p] < bytes; p++) {
+        if (t->starts[p] % t->row_bytes) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Part holding logical byte `pos` (< total) */
+static inline uint32_t fb_seg_tensor_part(const fb_seg_tensor_t *t, uint64_t pos) {
+    uint32_t p = 0;
+    while (p + 1u < t->num_parts && t->starts[p + 1u] <= pos) {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * Run of up to `max` whole rows from `row` that sit in one part, in place.
+ *
+ * @return rows in the run (*ptr set), or 0 if `row` straddles two parts or
+ *         is past the end
+ */
+static inline uint32_t fb_seg_tensor_run(const fb_seg_tensor_t *t, uint32_t row, uint32_t max,
+                                         const void **ptr) {
+    uint64_t pos = (uint64_t)row * t->row_bytes;
+    *ptr = NULL;
+    if (row >= fb_seg_tensor_rows(t)) {
+        return 0;
+    }
+    uint32_t p = fb_seg_tensor_part(t, pos);
+    uint64_t fit = (t->starts[p + 1u] - pos) / t->row_bytes;
+    if (fit == 0) {
+        return 0;
+    }
+    *ptr = t->parts[p].base + (pos - t->starts[p]);
+    return fit < max ? (uint32_t)fit : max;
+}
+
+/**
+ * Pointer to one row: in place, or gathered into `row_buf` (row_bytes) when
+ * it straddles parts.
+ *
+ * @return the row, or NULL if out of range (or straddling with no row_buf)
+ */
+static inline const void *fb_seg_tensor_row(const fb_seg_tensor_t *t, uint32_t row,
+                                            void *row_buf) {
+    const void *ptr;
+    if (fb_seg_tensor_run(t, row, 1, &ptr) || row >= fb_seg_tensor_rows(t) || !row_buf) {
+        return ptr;
+    }
+    uint64_t pos = (uint64_t)row * t->row_bytes;
+    uint8_t *dst = (uint8_t *)row_buf;
+    uint32_t left = t->row_bytes;
+    for (uint32_t p = fb_seg_tensor_part(t, pos); left; p++) {
+        uint64_t avail = t->starts[p + 1u] - pos;
+        uint32_t take = avail < left ? (uint32_t)avail : left;
+        fb_memcpy(dst, t->parts[p].base + (pos - t->starts[p]), take);
+        dst += take;
+        pos += take;
+        left -= take;
+    }
+    return row_buf;
+}
+
+/**
+ * MATMUL_I8_I8 over rows [r, end) of a multi-segment [d][n] weight tensor:
+ * one syscall per in-place run, one per straddling row.
+ */
+static inline void fb_matmul_i8_i8_seg_rows(int32_t *out, const void *x_prequant,
+                                            const fb_seg_tensor_t *w, int32_t w_scale_q16,
+                                            size_t n, uint32_t r, uint32_t end,
+                                            int8_t *row_buf) {
+    while (r < end) {
+        const void *rows;
+        uint32_t run = fb_seg_tensor_run(w, r, end - r, &rows);
+        if (run == 0) {
+            rows = fb_seg_tensor_row(w, r, row_buf);
+            run = 1;
+        }
+        fb_matmul_i8_i8(out + r, x_prequant, (const int8_t *)rows, w_scale_q16, n, run);
+        r += run;
+    }
+}
+
+/**
+ * Resumable MATMUL_I8_I8 with weights spread over segments: max_rows rows
+ * per call on the row cursor (0 = all), yielding while rows remain. row_buf
+ * (n bytes) is only used for rows that straddle parts.
+ *
+ * @return 1 once all d rows are done, 0 after a yield, -1 if the tensor
+ *         rows are not n bytes, hold fewer than d rows, or a row straddles
+ *         with no row_buf
+ */
+static inline int fb_matmul_i8_i8_seg_partial(int32_t *out, const void *x_prequant,
+                                              const fb_seg_tensor_t *w, int32_t w_scale_q16,
+                                              size_t n, size_t d, int8_t *row_buf,
+                                              fb_row_state_t *state) {
+    uint32_t r = state->cursor;
+    if (w->row_bytes != n || fb_seg_tensor_rows(w) < d ||
+        (!row_buf && !fb_seg_tensor_aligned(w, (uint32_t)d))) {
+        return -1;
+    }
+    if (r >= d) {
+        return 1;
+    }
+    uint32_t end = state->max_rows && state->max_rows < d - r ? r + state->max_rows
+                                                              : (uint32_t)d;
+    fb_matmul_i8_i8_seg_rows(out, x_prequant, w, w_scale_q16, n, r, end, row_buf);
+    state->cursor = end;
+    if (end >= d) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
 
 #ifdef __cplusplus
 }
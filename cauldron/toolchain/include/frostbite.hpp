@@ -0,0 +1,300 @@
+/**
+ * Frostbite VM - C++ shape-checked kernel wrappers
+ *
+ * Typed form of the frostbite.h kernels. Shapes are template parameters, so
+ * a weight matrix that does not match its input or output, an element type
+ * the kernel does not take, or a config struct that drifted from the VM ABI
+ * fails to compile, and n / d reach the ecall as immediates. Everything is
+ * inline over plain aggregates (no exceptions, RTTI, virtuals or
+ * allocation), so a call compiles to the same code as the C wrapper:
+ *
+ *   static fb::Matrix<int8_t, 64, 128> w1;      // d = 64 rows of n = 128
+ *   static fb::Tensor<int32_t, 128> in;
+ *   static fb::Prequant<128> x;
+ *   static fb::Tensor<int32_t, 64> h;
+ *
+ *   fb::quantize(x, in);                        // dynamic scale
+ *   fb::matmul_i8_i8(h, x, w1, w1_scale);       // N, D deduced and checked
+ *   fb::matmul_i8_i8<128, 64>(out, xq, w, s);   // raw pointers, explicit shape
+ *
+ * Weights in a RAM segment: auto &w = fb::at<fb::Matrix<int8_t, 64, 128>>(
+ * FB_SEGMENT_ADDR(2, 0)). Needs -std=c++14 or later.
+ */
+
+#ifndef FROSTBITE_HPP
+#define FROSTBITE_HPP
+
+#include "frostbite.h"
+
+#if !defined(__cplusplus) || __cplusplus < 201402L
+#error "frostbite.hpp needs C++14 or later"
+#endif
+
+namespace fb {
+
+/* The VM reads kernel configs by offset; keep the C structs in step. */
+static_assert(sizeof(fb_row_state_t) == 8, "fb_row_state_t layout");
+static_assert(sizeof(fb_matmul_qkv_cfg_t) == 96 && offsetof(fb_matmul_qkv_cfg_t, wq_scale) == 56 &&
+                  offsetof(fb_matmul_qkv_cfg_t, state_ptr) == 88,
+              "fb_matmul_qkv_cfg_t layout");
+static_assert(sizeof(fb_matmul_w1w3_cfg_t) == 64 && offsetof(fb_matmul_w1w3_cfg_t, w1_scale) == 40 &&
+                  offsetof(fb_matmul_w1w3_cfg_t, state_ptr) == 56,
+              "fb_matmul_w1w3_cfg_t layout");
+static_assert(sizeof(fb_matmul_w1w3_silu_cfg_t) == 56 &&
+                  offsetof(fb_matmul_w1w3_silu_cfg_t, w1_scale) == 32 &&
+                  offsetof(fb_matmul_w1w3_silu_cfg_t, state_ptr) == 48,
+              "fb_matmul_w1w3_silu_cfg_t layout");
+static_assert(sizeof(fb_matmul_bias_act_cfg_t) == 72 &&
+                  offsetof(fb_matmul_bias_act_cfg_t, w_scale) == 40 &&
+                  offsetof(fb_matmul_bias_act_cfg_t, state_ptr) == 64,
+              "fb_matmul_bias_act_cfg_t layout");
+
+/* Kernel length fields are u32. */
+template <size_t N>
+struct dim {
+    static_assert(N > 0, "fb: empty shape");
+    static_assert(N <= 0xFFFFFFFFu, "fb: shape does not fit the kernel's u32 fields");
+    static constexpr size_t value = N;
+};
+
+/* N elements of T. */
+template <class T, size_t N>
+struct Tensor {
+    static constexpr size_t size = N;
+    static_assert(dim<N>::value == N, "");
+    T data[N];
+
+    T *ptr() { return data; }
+    constexpr const T *ptr() const { return data; }
+    T &operator[](size_t i) { return data[i]; }
+    constexpr const T &operator[](size_t i) const { return data[i]; }
+};
+
+/* Row-major D x N matrix: the weight layout of the matmul kernels (d rows of n). */
+template <class T, size_t D, size_t N>
+struct Matrix {
+    static constexpr size_t rows = D;
+    static constexpr size_t cols = N;
+    static_assert(dim<D>::value == D && dim<N>::value == N && (N == 0 || D * N / N == D), "");
+    T data[D * N];
+
+    T *ptr() { return data; }
+    constexpr const T *ptr() const { return data; }
+    T *row(size_t r) { return data + r * N; }
+    constexpr const T *row(size_t r) const { return data + r * N; }
+};
+
+/* FB_PREQUANT_T(N): int8 activations padded to 4 bytes, then the Q16 scale. */
+template <size_t N>
+struct Prequant {
+    static constexpr size_t size = N;
+    static_assert(dim<N>::value == N, "");
+    int8_t x[FB_ALIGN4(N)];
+    int32_t x_scale_q16;
+
+    void *ptr() { return this; }
+    const void *ptr() const { return this; }
+};
+
+template <size_t N>
+constexpr bool prequant_layout_ok() {
+    return sizeof(Prequant<N>) == FB_PREQUANT_BYTES(N) &&
+           offsetof(Prequant<N>, x_scale_q16) == FB_ALIGN4(N) &&
+           alignof(Prequant<N>) == alignof(int32_t);
+}
+
+/**
+ * Typed reference to memory the guest does not own, e.g. a RAM segment.
+ * `addr` must be aligned for V.
+ */
+template <class V>
+inline V &at(uint64_t addr) {
+    return *reinterpret_cast<V *>(static_cast<uintptr_t>(addr));
+}
+
+inline uint64_t addr(const void *p) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p));
+}
+
+/* ============================================================================
+ * Quantization and glue
+ * ============================================================================ */
+
+/**
+ * fb_quantize_i32_to_prequant with a constant length.
+ *
+ * @return the x_scale_q16 written to dst
+ */
+template <size_t N>
+inline int32_t quantize(Prequant<N> &dst, const Tensor<int32_t, N> &src, int32_t scale_q16 = 0,
+                        uint32_t flags = 0) {
+    static_assert(prequant_layout_ok<N>(), "fb::Prequant layout");
+    return fb_quantize_i32_to_prequant(dst.ptr(), src.ptr(), N, scale_q16, flags);
+}
+
+template <size_t N>
+inline void relu(Tensor<int32_t, N> &t) {
+    for (size_t i = 0; i < N; i++) {
+        t.data[i] = t.data[i] < 0 ? 0 : t.data[i];
+    }
+}
+
+template <class T, size_t N>
+inline void copy(Tensor<T, N> &dst, const Tensor<T, N> &src) {
+    fb_memcpy(dst.data, src.data, sizeof(dst.data));
+}
+
+/* ============================================================================
+ * Kernels
+ * ============================================================================ */
+
+template <size_t N, size_t D>
+inline void matmul_i8_i8(int32_t *out, const void *x_prequant, const int8_t *w,
+                         int32_t w_scale_q16) {
+    fb_matmul_i8_i8(out, x_prequant, w, w_scale_q16, dim<N>::value, dim<D>::value);
+}
+
+/* Typed matmul shapes: w is D x N, x has N entries, out has D. */
+template <size_t N, size_t D, size_t WD, size_t WN>
+constexpr bool matmul_shape_ok() {
+    static_assert(WN == N, "fb: weight columns must equal the input length");
+    static_assert(WD == D, "fb: weight rows must equal the output length");
+    return true;
+}
+
+template <size_t N, size_t D, size_t WD, size_t WN>
+inline void matmul_i8_i8(Tensor<int32_t, D> &out, const Prequant<N> &x,
+                         const Matrix<int8_t, WD, WN> &w, int32_t w_scale_q16) {
+    static_assert(matmul_shape_ok<N, D, WD, WN>() && prequant_layout_ok<N>(), "fb::Prequant layout");
+    fb_matmul_i8_i8(out.ptr(), x.ptr(), w.ptr(), w_scale_q16, N, D);
+}
+
+/**
+ * MATMUL_I8_I8_PARTIAL over the next state.max_rows rows.
+ *
+ * @return true once all D rows are done
+ */
+template <size_t N, size_t D, size_t WD, size_t WN>
+inline bool matmul_i8_i8_partial(Tensor<int32_t, D> &out, const Prequant<N> &x,
+                                 const Matrix<int8_t, WD, WN> &w, int32_t w_scale_q16,
+                                 fb_row_state_t &state) {
+    static_assert(matmul_shape_ok<N, D, WD, WN>() && prequant_layout_ok<N>(), "fb::Prequant layout");
+    fb_matmul_i8_i8_partial(out.ptr(), x.ptr(), w.ptr(), w_scale_q16, N, D, &state);
+    return state.cursor >= D;
+}
+
+template <size_t N, size_t D, size_t WD, size_t WN>
+inline void matmul_i8_i32(Tensor<int32_t, D> &out, const Tensor<int32_t, N> &x,
+                          const Matrix<int8_t, WD, WN> &w, int32_t scale_q16) {
+    static_assert(matmul_shape_ok<N, D, WD, WN>(), "fb: matmul shape");
+    fb_matmul_i8_i32(out.ptr(), x.ptr(), w.ptr(), scale_q16, N, D);
+}
+
+template <size_t N>
+inline int32_t dot_i8(const Tensor<int8_t, N> &a, const Tensor<int8_t, N> &b) {
+    return fb_dot_i8(a.ptr(), b.ptr(), N);
+}
+
+template <size_t N>
+inline int64_t dot_i32(const Tensor<int32_t, N> &a, const Tensor<int32_t, N> &b,
+                       uint32_t shift) {
+    return fb_dot_i32(a.ptr(), b.ptr(), N, shift);
+}
+
+template <size_t N>
+inline void vec_add_i8(Tensor<int8_t, N> &dst, const Tensor<int8_t, N> &src) {
+    fb_vec_add_i8(dst.ptr(), src.ptr(), N);
+}
+
+template <size_t N>
+inline void softmax_i32(Tensor<int32_t, N> &t) {
+    fb_softmax_i32(t.ptr(), N);
+}
+
+template <size_t N>
+inline void silu_mul_i32(Tensor<int32_t, N> &hb, const Tensor<int32_t, N> &hb2) {
+    fb_silu_mul_i32(hb.ptr(), hb2.ptr(), N);
+}
+
+/* ============================================================================
+ * Fused kernel configs
+ * ============================================================================ */
+
+/**
+ * fb_matmul_i8_i8_bias_act config. out_q, when given, is the next layer's
+ * Prequant<D>, so chained layers are shape-checked too.
+ */
+template <size_t N, size_t D>
+inline fb_matmul_bias_act_cfg_t bias_act_cfg(Tensor<int32_t, D> &out, const Prequant<N> &x,
+                                             const Matrix<int8_t, D, N> &w, int32_t w_scale_q16,
+                                             uint32_t act, fb_row_state_t &state,
+                                             const Tensor<int32_t, D> *bias = nullptr,
+                                             Prequant<D> *out_q = nullptr,
+                                             uint32_t out_scale_q16 = 0) {
+    static_assert(prequant_layout_ok<N>() && prequant_layout_ok<D>(), "fb::Prequant layout");
+    fb_matmul_bias_act_cfg_t cfg = {};
+    cfg.out_ptr = addr(out.ptr());
+    cfg.x_ptr = addr(x.ptr());
+    cfg.w_ptr = addr(w.ptr());
+    cfg.bias_ptr = bias ? addr(bias->ptr()) : 0;
+    cfg.out_q_ptr = out_q ? addr(out_q->ptr()) : 0;
+    cfg.w_scale = static_cast<uint32_t>(w_scale_q16);
+    cfg.n = N;
+    cfg.d = D;
+    cfg.act = act;
+    cfg.out_scale = out_scale_q16;
+    cfg.state_ptr = addr(&state);
+    return cfg;
+}
+
+template <size_t N, size_t D>
+inline fb_matmul_w1w3_silu_cfg_t w1w3_silu_cfg(Tensor<int32_t, D> &out, const Prequant<N> &x,
+                                               const Matrix<int8_t, D, N> &w1,
+                                               const Matrix<int8_t, D, N> &w3,
+                                               int32_t w1_scale_q16, int32_t w3_scale_q16,
+                                               fb_row_state_t &state) {
+    static_assert(prequant_layout_ok<N>(), "fb::Prequant layout");
+    fb_matmul_w1w3_silu_cfg_t cfg = {};
+    cfg.out_ptr = addr(out.ptr());
+    cfg.x_ptr = addr(x.ptr());
+    cfg.w1_ptr = addr(w1.ptr());
+    cfg.w3_ptr = addr(w3.ptr());
+    cfg.w1_scale = static_cast<uint32_t>(w1_scale_q16);
+    cfg.w3_scale = static_cast<uint32_t>(w3_scale_q16);
+    cfg.n = N;
+    cfg.d = D;
+    cfg.state_ptr = addr(&state);
+    return cfg;
+}
+
+template <size_t N, size_t DQ, size_t DK, size_t DV>
+inline fb_matmul_qkv_cfg_t qkv_cfg(Tensor<int32_t, DQ> &q, Tensor<int32_t, DK> &k,
+                                   Tensor<int32_t, DV> &v, const Prequant<N> &x,
+                                   const Matrix<int8_t, DQ, N> &wq,
+                                   const Matrix<int8_t, DK, N> &wk,
+                                   const Matrix<int8_t, DV, N> &wv, int32_t wq_scale_q16,
+                                   int32_t wk_scale_q16, int32_t wv_scale_q16,
+                                   fb_row_state_t &state) {
+    static_assert(prequant_layout_ok<N>(), "fb::Prequant layout");
+    fb_matmul_qkv_cfg_t cfg = {};
+    cfg.out_q = addr(q.ptr());
+    cfg.out_k = addr(k.ptr());
+    cfg.out_v = addr(v.ptr());
+    cfg.x_ptr = addr(x.ptr());
+    cfg.wq_ptr = addr(wq.ptr());
+    cfg.wk_ptr = addr(wk.ptr());
+    cfg.wv_ptr = addr(wv.ptr());
+    cfg.wq_scale = static_cast<uint32_t>(wq_scale_q16);
+    cfg.wk_scale = static_cast<uint32_t>(wk_scale_q16);
+    cfg.wv_scale = static_cast<uint32_t>(wv_scale_q16);
+    cfg.n = N;
+    cfg.d_q = DQ;
+    cfg.d_k = DK;
+    cfg.d_v = DV;
+    cfg.state_ptr = addr(&state);
+    return cfg;
+}
+
+} // namespace fb
+
+#endif /* FROSTBITE_HPP */
@@ -0,0 +1,91 @@
+/**
+ * Frostbite VM - syscall cost model
+ *
+ * Each syscall's cost is modelled as a fixed part plus per-row and
+ * per-element parts:
+ *
+ *   instructions(n, rows) = fixed + rows * per_row + n * rows * per_elem
+ *
+ * Matmuls pass n = input length and rows = output rows. Vector kernels pass
+ * rows = 1 and n = length. per_row and per_elem are Q16, so fractional costs
+ * (a fraction of an instruction per int8 MAC) survive. scripts/fb_costmodel.py
+ * fits the coefficients from a bench_report.py sweep (on-chain CU, since
+ * the local runner charges a syscall as one instruction). It writes them as
+ * FB_COST_<SYSCALL> initializers into frostbite_cost_table.h, plus a JSON
+ * copy for host-side planners (`make costmodel` in
+ * examples/c_cpp/benchmarks writes both to its out/ directory; add it with
+ * -I). The table includes this header:
+ *
+ *   #include "frostbite_cost_table.h"
+ *   fb_cost_t mm = FB_COST_MATMUL_I8_I8_PARTIAL;
+ *   st.max_rows = fb_cost_max_rows(&mm, n, fb_budget_remaining(&b));
+ *
+ * The estimates are as good as the sweep that produced them. Kernels whose
+ * cost depends on the data (graph degree, early exits) are fitted at the
+ * bench's shapes only.
+ */
+
+#ifndef FROSTBITE_COST_H
+#define FROSTBITE_COST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t fixed;        /* instructions per call */
+    uint32_t per_row_q16;  /* Q16 instructions per output row */
+    uint32_t per_elem_q16; /* Q16 instructions per element (n per row) */
+} fb_cost_t;
+
+/* fb_cost_max_rows charges a row at least one instruction */
+#define FB_COST_MIN_ROW_Q16 (1u << 16)
+
+/* Q16 instructions one row of n elements adds */
+static inline uint64_t fb_cost_row_q16(const fb_cost_t *c, uint32_t n) {
+    return (uint64_t)c->per_row_q16 + (uint64_t)n * c->per_elem_q16;
+}
+
+/**
+ * Predicted instructions for one call over `rows` rows of `n` elements,
+ * rounded up.
+ */
+static inline uint64_t fb_cost_call(const fb_cost_t *c, uint32_t n, uint32_t rows) {
+    return c->fixed + ((fb_cost_row_q16(c, n) * rows + 0xFFFFu) >> 16);
+}
+
+/**
+ * Rows of `n` elements one call can cover within `budget` instructions, at
+ * least 1 so a row cursor always advances (the fb_budgeted_rows rule). A row
+ * costs at least FB_COST_MIN_ROW_Q16, so a zero or near-zero fit still
+ * bounds the chunk. Use as fb_row_state_t.max_rows.
+ */
+static inline uint32_t fb_cost_max_rows(const fb_cost_t *c, uint32_t n, uint64_t budget) {
+    uint64_t row = fb_cost_row_q16(c, n);
+    row = row < FB_COST_MIN_ROW_Q16 ? FB_COST_MIN_ROW_Q16 : row;
+    if (budget <= c->fixed) {
+        return 1u;
+    }
+    uint64_t rows = ((budget - c->fixed) << 16) / row;
+    return rows == 0 ? 1u : rows > UINT32_MAX ? UINT32_MAX : (uint32_t)rows;
+}
+
+/**
+ * Transactions a resumable kernel takes for `d` rows of `n` elements when
+ * each transaction runs one chunk of `tx_budget - reserve` instructions
+ * (FB_TX_BUDGET / FB_TX_RESERVE).
+ */
+static inline uint32_t fb_cost_transactions(const fb_cost_t *c, uint32_t n, uint32_t d,
+                                            uint32_t tx_budget, uint32_t reserve) {
+    uint64_t budget = tx_budget > reserve ? tx_budget - reserve : 0;
+    uint32_t per_tx = fb_cost_max_rows(c, n, budget);
+    return d ? (uint32_t)(((uint64_t)d + per_tx - 1u) / per_tx) : 0u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FROSTBITE_COST_H */
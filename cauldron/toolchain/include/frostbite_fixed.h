@@ -0,0 +1,250 @@
+/**
+ * Frostbite VM - Q16.16 fixed-point helpers
+ *
+ * Integer-only scalar math in the same Q16 format as SOFTMAX_I32,
+ * SILU_MUL_I32, RMSNORM_I32 and DOT_I32, so guest code does not need the
+ * soft-float builtins. Header-only with no syscalls; frostbite.h includes it.
+ * Functions are constexpr under C++14 and static inline in C.
+ */
+
+#ifndef FROSTBITE_FIXED_H
+#define FROSTBITE_FIXED_H
+
+#include <stdint.h>
+
+#if defined(__cplusplus) && __cplusplus >= 201402L
+#define FB_FIXED_FN static constexpr inline
+#define FB_FIXED_TABLE static constexpr
+#else
+#define FB_FIXED_FN static inline
+#define FB_FIXED_TABLE static const
+#endif
+
+typedef int32_t fb_q16_t;
+
+#define FB_Q16_ONE  65536
+#define FB_Q16_HALF 32768
+#define FB_Q16_MAX  INT32_MAX
+#define FB_Q16_MIN  INT32_MIN
+
+/* Q16 from a compile-time constant (rounds to nearest). */
+#define FB_Q16(x) ((fb_q16_t)((x) * 65536.0 + ((x) < 0 ? -0.5 : 0.5)))
+
+/* ============================================================================
+ * Conversion and arithmetic
+ * ============================================================================ */
+
+/**
+ * Clamp a wide intermediate to the Q16 range.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_sat(int64_t v) {
+    return v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : (fb_q16_t)v;
+}
+
+FB_FIXED_FN fb_q16_t fb_q16_from_int(int32_t i) {
+    return fb_q16_sat((int64_t)i * FB_Q16_ONE);
+}
+
+/**
+ * Integer part, rounded toward negative infinity.
+ */
+FB_FIXED_FN int32_t fb_q16_to_int(fb_q16_t q) {
+    return q >> 16;
+}
+
+/**
+ * Nearest integer (halves round up).
+ */
+FB_FIXED_FN int32_t fb_q16_round(fb_q16_t q) {
+    return (int32_t)(((int64_t)q + FB_Q16_HALF) >> 16);
+}
+
+FB_FIXED_FN fb_q16_t fb_q16_add_sat(fb_q16_t a, fb_q16_t b) {
+    return fb_q16_sat((int64_t)a + b);
+}
+
+FB_FIXED_FN fb_q16_t fb_q16_sub_sat(fb_q16_t a, fb_q16_t b) {
+    return fb_q16_sat((int64_t)a - b);
+}
+
+FB_FIXED_FN fb_q16_t fb_q16_abs(fb_q16_t a) {
+    return a == INT32_MIN ? INT32_MAX : a < 0 ? -a : a;
+}
+
+/**
+ * a * b, rounded to nearest. Wraps on overflow (see fb_q16_mul_sat).
+ */
+FB_FIXED_FN fb_q16_t fb_q16_mul(fb_q16_t a, fb_q16_t b) {
+    return (fb_q16_t)(((int64_t)a * b + FB_Q16_HALF) >> 16);
+}
+
+FB_FIXED_FN fb_q16_t fb_q16_mul_sat(fb_q16_t a, fb_q16_t b) {
+    return fb_q16_sat(((int64_t)a * b + FB_Q16_HALF) >> 16);
+}
+
+/**
+ * a / b, truncated toward zero and saturated. Division by zero returns
+ * FB_Q16_MAX or FB_Q16_MIN by the sign of a.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_div(fb_q16_t a, fb_q16_t b) {
+    return b == 0 ? (a < 0 ? INT32_MIN : INT32_MAX)
+                  : fb_q16_sat((int64_t)a * FB_Q16_ONE / b);
+}
+
+/* ============================================================================
+ * Square root
+ * ============================================================================ */
+
+/**
+ * Leading zero count of a non-zero u64 (no Zbb).
+ */
+FB_FIXED_FN int fb_fixed_clz64(uint64_t x) {
+    int n = 0;
+    if (!(x >> 32)) { n += 32; x <<= 32; }
+    if (!(x >> 48)) { n += 16; x <<= 16; }
+    if (!(x >> 56)) { n += 8; x <<= 8; }
+    if (!(x >> 60)) { n += 4; x <<= 4; }
+    if (!(x >> 62)) { n += 2; x <<= 2; }
+    if (!(x >> 63)) { n += 1; }
+    return n;
+}
+
+/**
+ * floor(sqrt(n)). Newton iteration from a power-of-two upper bound; each step
+ * is one divide, about five steps for 48-bit inputs.
+ */
+FB_FIXED_FN uint64_t fb_isqrt64(uint64_t n) {
+    if (n < 2) {
+        return n;
+    }
+    uint64_t r = 1ULL << ((64 - fb_fixed_clz64(n) + 1) >> 1);
+    for (;;) {
+        uint64_t t = (r + n / r) >> 1;
+        if (t >= r) {
+            return r;
+        }
+        r = t;
+    }
+}
+
+FB_FIXED_FN uint32_t fb_isqrt32(uint32_t n) {
+    return (uint32_t)fb_isqrt64(n);
+}
+
+/**
+ * Square root of a Q16 value (0 for x <= 0), truncated.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_sqrt(fb_q16_t x) {
+    return x <= 0 ? 0 : (fb_q16_t)fb_isqrt64((uint64_t)x << 16);
+}
+
+/* ============================================================================
+ * exp / log
+ * ============================================================================ */
+
+/* 2^f and log2(1 + t) on [0, 1): Chebyshev fits in Q30 */
+FB_FIXED_TABLE int64_t fb_q16_exp2_poly[5] = {
+    1073745574, 744074009, 259420703, 55560768, 14678383,
+};
+FB_FIXED_TABLE int64_t fb_q16_log2_poly[7] = {
+    2624, 1548822680, -770208733, 488024777, -292806781, 126286087, -26380263,
+};
+
+#define FB_Q30_LOG2E 1549082005LL /* log2(e) in Q30 */
+#define FB_Q28_LN2   186065280LL  /* ln(2) in Q28 */
+
+FB_FIXED_FN int64_t fb_q16_poly_q30(const int64_t *c, int degree, int64_t t) {
+    int64_t p = c[degree];
+    for (int i = degree - 1; i >= 0; i--) {
+        p = ((p * t) >> 30) + c[i];
+    }
+    return p;
+}
+
+/**
+ * 2^x for Q16 x, rounded. Saturates at FB_Q16_MAX; ~4e-6 relative error.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_exp2(fb_q16_t x) {
+    int32_t k = x >> 16;
+    if (k >= 15) {
+        return INT32_MAX;
+    }
+    if (k < -17) {
+        return 0;
+    }
+    int64_t p = fb_q16_poly_q30(fb_q16_exp2_poly, 4, (int64_t)(x & 0xFFFF) << 14);
+    if (k >= 14) {
+        return fb_q16_sat(p << (k - 14));
+    }
+    int shift = 14 - k;
+    return (fb_q16_t)((p + (1LL << (shift - 1))) >> shift);
+}
+
+/**
+ * e^x for Q16 x. Saturates at FB_Q16_MAX above x ~ 10.4.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_exp(fb_q16_t x) {
+    return fb_q16_exp2(fb_q16_sat(((int64_t)x * FB_Q30_LOG2E) >> 30));
+}
+
+/**
+ * log2(x) in Q30 for x > 0 (any fixed-point x is fine; scale by the format).
+ */
+FB_FIXED_FN int64_t fb_q16_log2_q30(fb_q16_t x) {
+    int msb = 63 - fb_fixed_clz64((uint64_t)x);
+    int64_t t = (int64_t)(((uint64_t)x << (30 - msb)) - (1ULL << 30));
+    return (int64_t)(msb - 16) * (1LL << 30) + fb_q16_poly_q30(fb_q16_log2_poly, 6, t);
+}
+
+/**
+ * log2(x) for Q16 x; FB_Q16_MIN for x <= 0.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_log2(fb_q16_t x) {
+    return x <= 0 ? INT32_MIN : (fb_q16_t)((fb_q16_log2_q30(x) + (1LL << 13)) >> 14);
+}
+
+/**
+ * Natural log of Q16 x (max ~1e-5 absolute error, about 0.6 LSB: the Q30
+ * log2 is within ~2.5e-6, the rest is the Q16 rounding); FB_Q16_MIN for x <= 0.
+ * log(p1) - log(p0) gives log-odds directly.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_log(fb_q16_t x) {
+    return x <= 0 ? INT32_MIN
+                  : (fb_q16_t)((fb_q16_log2_q30(x) * FB_Q28_LN2 + (1LL << 41)) >> 42);
+}
+
+/* ============================================================================
+ * Activations
+ * ============================================================================ */
+
+/* sigmoid(k / 4) in Q16 for k = 0..32 */
+FB_FIXED_TABLE uint16_t fb_q16_sigmoid_table[33] = {
+    32768, 36843, 40793, 44511, 47911, 50941, 53581, 55834, 57724, 59287, 60565,
+    61598, 62428, 63090, 63615, 64030, 64357, 64614, 64816, 64974, 65097, 65194,
+    65269, 65328, 65374, 65410, 65438, 65459, 65476, 65489, 65500, 65508, 65514,
+};
+
+/**
+ * Q16 sigmoid: table over [0, 8] with linear interpolation (max error
+ * ~50/65536), mirrored for negative inputs.
+ */
+FB_FIXED_FN fb_q16_t fb_q16_sigmoid(fb_q16_t x) {
+    uint32_t a = x < 0 ? 0u - (uint32_t)x : (uint32_t)x;
+    int32_t y = fb_q16_sigmoid_table[32];
+    if (a < (8u << 16)) {
+        uint32_t k = a >> 14;
+        int32_t f = (int32_t)(a & 0x3FFFu);
+        y = fb_q16_sigmoid_table[k] +
+            (((fb_q16_sigmoid_table[k + 1] - fb_q16_sigmoid_table[k]) * f) >> 14);
+    }
+    return x < 0 ? FB_Q16_ONE - y : y;
+}
+
+/**
+ * Q16 tanh as 2 * sigmoid(2x) - 1 (max error ~1e-3).
+ */
+FB_FIXED_FN fb_q16_t fb_q16_tanh(fb_q16_t x) {
+    return 2 * fb_q16_sigmoid(fb_q16_sat((int64_t)x * 2)) - FB_Q16_ONE;
+}
+
+#endif /* FROSTBITE_FIXED_H */
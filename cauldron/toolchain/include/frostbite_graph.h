@@ -0,0 +1,1072 @@
+/**
+ * Frostbite VM - CSR graph segments
+ *
+ * The flat GRPH segment read by GRAPH_SEARCH is one edge list, so every call
+ * scores every edge. A CSR segment groups edges by source node:
+ *
+ *   fb_csr_header_t (48 bytes)
+ *   u32 offsets[num_nodes + 1]   edges of node v are [offsets[v], offsets[v+1])
+ *   u32 targets[num_edges]       sorted ascending within each node
+ *   i8  weights[num_edges][dim]  same order as targets
+ *
+ * Each section starts 4-byte aligned. A node's weight rows are contiguous, so
+ * fb_csr_graph_search scores all of its neighbors with one MATMUL_I8_I8 call:
+ * O(deg) per lookup instead of O(E). fb_csr_build packs an unsorted edge list
+ * (in the guest, or on the client before upload).
+ *
+ * Updates go to a small delta log instead of rewriting the segment: the
+ * client appends upsert/delete records (fb_csr_delta_append), and the guest
+ * folds them into a fresh CSR with fb_csr_compact, which bumps the
+ * generation the log is tied to.
+ *
+ *   fb_csr_t g;
+ *   if (fb_csr_open(&g, (const void *)(uintptr_t)FB_SEGMENT_ADDR(2, 0), bytes) != 0) ...
+ *   uint32_t hits = fb_csr_graph_search(&g, node, x_prequant, out, 0, NULL);
+ */
+
+#ifndef FROSTBITE_GRAPH_H
+#define FROSTBITE_GRAPH_H
+
+#include "frostbite.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_CSR_MAGIC   0x52534347u /* "GCSR" */
+#define FB_CSR_VERSION 1u
+#define FB_CSR_NONE    0xFFFFFFFFu /* no such edge */
+
+typedef struct {
+    uint32_t magic;       /* FB_CSR_MAGIC */
+    uint16_t version;     /* FB_CSR_VERSION */
+    uint16_t flags;       /* reserved, 0 */
+    uint32_t num_nodes;
+    uint32_t num_edges;
+    uint32_t dim;         /* weight bytes per edge */
+    uint32_t offsets_off; /* byte offsets from the header */
+    uint32_t targets_off;
+    uint32_t weights_off;
+    uint32_t generation;  /* bumped by each fb_csr_compact */
+    uint32_t reserved[3]; /* 0 */
+} fb_csr_header_t;
+
+/* One GRAPH_SEARCH-style hit (same layout the kernel writes) */
+typedef struct {
+    uint32_t target;
+    int32_t score;
+} fb_graph_hit_t;
+
+/* Builder input: weights = dim bytes, or NULL for zeros */
+typedef struct {
+    uint32_t src;
+    uint32_t dst;
+    const int8_t *weights;
+} fb_csr_edge_t;
+
+/* Validated view of a CSR segment */
+typedef struct {
+    const fb_csr_header_t *hdr;
+    const uint32_t *offsets;
+    const uint32_t *targets;
+    const int8_t *weights;
+    uint32_t num_nodes;
+    uint32_t num_edges;
+    uint32_t dim;
+    uint32_t generation;
+} fb_csr_t;
+
+/* Section layout for a graph of the given shape (offsets in bytes). */
+static inline void fb_csr_layout(uint32_t num_nodes, uint32_t num_edges, uint32_t dim,
+                                 uint32_t *offsets_off, uint32_t *targets_off,
+                                 uint32_t *weights_off, size_t *total) {
+    size_t off = sizeof(fb_csr_header_t);
+    *offsets_off = (uint32_t)off;
+    off += ((size_t)num_nodes + 1u) * sizeof(uint32_t);
+    *targets_off = (uint32_t)off;
+    off += (size_t)num_edges * sizeof(uint32_t);
+    *weights_off = (uint32_t)off;
+    off += FB_ALIGN4((size_t)num_edges * dim);
+    *total = off;
+}
+
+/* Bytes fb_csr_build needs for a graph of the given shape. */
+static inline size_t fb_csr_bytes(uint32_t num_nodes, uint32_t num_edges, uint32_t dim) {
+    uint32_t o, t, w;
+    size_t total;
+    fb_csr_layout(num_nodes, num_edges, dim, &o, &t, &w, &total);
+    return total;
+}
+
+/**
+ * Pack `edges` (any order) into a CSR segment at `dst`: a counting sort by
+ * source, then an insertion sort of each adjacency by target.
+ *
+ * @return 0 on success, -1 if `cap` is too small, an endpoint is >= num_nodes
+ *         or an edge (src, dst) appears twice
+ */
+static inline int fb_csr_build(void *dst, size_t cap, uint32_t num_nodes, uint32_t dim,
+                               const fb_csr_edge_t *edges, uint32_t num_edges) {
+    uint32_t offsets_off, targets_off, weights_off;
+    size_t total;
+    fb_csr_layout(num_nodes, num_edges, dim, &offsets_off, &targets_off, &weights_off, &total);
+    if (total > cap) {
+        return -1;
+    }
+    uint8_t *base = (uint8_t *)dst;
+    uint32_t *offsets = (uint32_t *)(base + offsets_off);
+    uint32_t *targets = (uint32_t *)(base + targets_off);
+    int8_t *weights = (int8_t *)(base + weights_off);
+
+    fb_memset(offsets, 0, ((size_t)num_nodes + 1u) * sizeof(uint32_t));
+    for (uint32_t e = 0; e < num_edges; e++) {
+        if (edges[e].src >= num_nodes || edges[e].dst >= num_nodes) {
+            return -1;
+        }
+        offsets[edges[e].src]++;
+    }
+    /* offsets[v] = end of v; placing edges in reverse walks it back to start */
+    uint32_t sum = 0;
+    for (uint32_t v = 0; v < num_nodes; v++) {
+        sum += offsets[v];
+        offsets[v] = sum;
+    }
+    offsets[num_nodes] = num_edges;
+    for (uint32_t e = num_edges; e-- > 0;) {
+        uint32_t pos = --offsets[edges[e].src];
+        targets[pos] = edges[e].dst;
+        if (edges[e].weights) {
+            fb_memcpy(weights + (size_t)pos * dim, edges[e].weights, dim);
+        } else {
+            fb_memset(weights + (size_t)pos * dim, 0, dim);
+        }
+    }
+
+    for (uint32_t v = 0; v < num_nodes; v++) {
+        uint32_t lo = offsets[v];
+        uint32_t hi = offsets[v + 1u];
+        for (uint32_t i = lo + 1u; i < hi; i++) {
+            for (uint32_t j = i; j > lo && targets[j - 1u] >= targets[j]; j--) {
+                if (targets[j - 1u] == targets[j]) {
+                    return -1;
+                }
+                uint32_t t = targets[j];
+                targets[j] = targets[j - 1u];
+                targets[j - 1u] = t;
+                int8_t *a = weights + (size_t)(j - 1u) * dim;
+                int8_t *b = a + dim;
+                for (uint32_t k = 0; k < dim; k++) {
+                    int8_t w = a[k];
+                    a[k] = b[k];
+                    b[k] = w;
+                }
+            }
+        }
+    }
+    if (weights_off + (size_t)num_edges * dim < total) {
+        fb_memset(weights + (size_t)num_edges * dim, 0,
+                  total - weights_off - (size_t)num_edges * dim);
+    }
+
+    fb_csr_header_t *hdr = (fb_csr_header_t *)base;
+    fb_memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = FB_CSR_MAGIC;
+    hdr->version = FB_CSR_VERSION;
+    hdr->num_nodes = num_nodes;
+    hdr->num_edges = num_edges;
+    hdr->dim = dim;
+    hdr->offsets_off = offsets_off;
+    hdr->targets_off = targets_off;
+    hdr->weights_off = weights_off;
+    return 0;
+}
+
+/**
+ * Validate a CSR segment of `bytes` at `base` once, and bind `g` to it: the
+ * header, section bounds, monotonic offsets ending at num_edges, and every
+ * target below num_nodes and strictly ascending within its node. O(V + E);
+ * the accessors trust an opened graph from then on.
+ *
+ * @return 0 on success, -1 if malformed
+ */
+static inline int fb_csr_open(fb_csr_t *g, const void *base, size_t bytes) {
+    const fb_csr_header_t *hdr = (const fb_csr_header_t *)base;
+    fb_memset(g, 0, sizeof(*g));
+    if (bytes < sizeof(*hdr) || hdr->magic != FB_CSR_MAGIC || hdr->version != FB_CSR_VERSION) {
+        return -1;
+    }
+    uint32_t o, t, w;
+    size_t total;
+    fb_csr_layout(hdr->num_nodes, hdr->num_edges, hdr->dim, &o, &t, &w, &total);
+    if (hdr->offsets_off != o || hdr->targets_off != t || hdr->weights_off != w ||
+        total > bytes) {
+        return -1;
+    }
+    const uint8_t *b = (const uint8_t *)base;
+    const uint32_t *offsets = (const uint32_t *)(b + o);
+    if (offsets[0] != 0 || offsets[hdr->num_nodes] != hdr->num_edges) {
+        return -1;
+    }
+    const uint32_t *targets = (const uint32_t *)(b + t);
+    for (uint32_t v = 0; v < hdr->num_nodes; v++) {
+        uint32_t lo = offsets[v], hi = offsets[v + 1u];
+        if (lo > hi || hi > hdr->num_edges) {
+            return -1;
+        }
+        for (uint32_t e = lo; e < hi; e++) {
+            if (targets[e] >= hdr->num_nodes || (e > lo && targets[e] <= targets[e - 1u])) {
+                return -1;
+            }
+        }
+    }
+    g->hdr = hdr;
+    g->offsets = offsets;
+    g->targets = targets;
+    g->weights = (const int8_t *)(b + w);
+    g->num_nodes = hdr->num_nodes;
+    g->num_edges = hdr->num_edges;
+    g->dim = hdr->dim;
+    g->generation = hdr->generation;
+    return 0;
+}
+
+/**
+ * Sorted targets of `node`; *first_edge (optional) gets the edge index of
+ * the first one. NULL with *count = 0 for an unknown node.
+ */
+static inline const uint32_t *fb_csr_neighbors(const fb_csr_t *g, uint32_t node,
+                                               uint32_t *count, uint32_t *first_edge) {
+    if (node >= g->num_nodes) {
+        *count = 0;
+        return NULL;
+    }
+    uint32_t lo = g->offsets[node];
+    *count = g->offsets[node + 1u] - lo;
+    if (first_edge) {
+        *first_edge = lo;
+    }
+    return g->targets + lo;
+}
+
+/* Edge index of (src, dst) by binary search, or FB_CSR_NONE. */
+static inline uint32_t fb_csr_find_edge(const fb_csr_t *g, uint32_t src, uint32_t dst) {
+    if (src >= g->num_nodes) {
+        return FB_CSR_NONE;
+    }
+    uint32_t lo = g->offsets[src];
+    uint32_t hi = g->offsets[src + 1u];
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2u;
+        uint32_t t = g->targets[mid];
+        if (t == dst) {
+            return mid;
+        }
+        if (t < dst) {
+            lo = mid + 1u;
+        } else {
+            hi = mid;
+        }
+    }
+    return FB_CSR_NONE;
+}
+
+static inline const int8_t *fb_csr_edge_weights(const fb_csr_t *g, uint32_t edge) {
+    return g->weights + (size_t)edge * g->dim;
+}
+
+/**
+ * GRAPH_SEARCH over the neighbors of `node` only. Scores dot(x, weights) with
+ * one MATMUL_I8_I8 (score = dot * x_scale >> 16, so a prequant scale of
+ * FB_Q16_ONE gives the raw dot like GRAPH_SEARCH) and writes the edges with
+ * score >= min_score to `out` in target order. `edge_mask` (one byte per CSR
+ * edge, 0 = skip) may be NULL. `out` must hold
+ * deg(node) hits; the scores are staged in its upper half.
+ *
+ * @return number of hits
+ */
+static inline uint32_t fb_csr_graph_search(const fb_csr_t *g, uint32_t node,
+                                           const void *x_prequant, fb_graph_hit_t *out,
+                                           int32_t min_score, const uint8_t *edge_mask) {
+    uint32_t deg, first;
+    const uint32_t *targets = fb_csr_neighbors(g, node, &deg, &first);
+    if (deg == 0) {
+        return 0;
+    }
+    int32_t *scores = (int32_t *)out + deg;
+    fb_matmul_i8_i8(scores, x_prequant, fb_csr_edge_weights(g, first), FB_Q16_ONE, g->dim, deg);
+    /* hit k overwrites words 2k, 2k+1 < deg + j, so unread scores survive */
+    uint32_t hits = 0;
+    for (uint32_t j = 0; j < deg; j++) {
+        int32_t s = scores[j];
+        if (s >= min_score && (!edge_mask || edge_mask[first + j])) {
+            out[hits].target = targets[j];
+            out[hits].score = s;
+            hits++;
+        }
+    }
+    return hits;
+}
+
+/**
+ * Message passing over the CSR: out[k] = sum of features[u][k] over the
+ * neighbors u of `node` (features is num_nodes rows of `feat_dim` int8).
+ *
+ * @return deg(node)
+ */
+static inline uint32_t fb_csr_aggregate(const fb_csr_t *g, uint32_t node,
+                                        const int8_t *features, uint32_t feat_dim,
+                                        int32_t *out) {
+    uint32_t deg;
+    const uint32_t *targets = fb_csr_neighbors(g, node, &deg, NULL);
+    for (uint32_t k = 0; k < feat_dim; k++) {
+        out[k] = 0;
+    }
+    for (uint32_t j = 0; j < deg; j++) {
+        const int8_t *row = features + (size_t)targets[j] * feat_dim;
+        for (uint32_t k = 0; k < feat_dim; k++) {
+            out[k] += row[k];
+        }
+    }
+    return deg;
+}
+
+/* ============================================================================
+ * Multi-layer message passing
+ * ============================================================================ */
+
+#ifndef FB_CSR_GNN_MAX_LAYERS
+#define FB_CSR_GNN_MAX_LAYERS 4u
+#endif
+
+/* fb_csr_gnn_cfg_t.feat_type */
+#define FB_CSR_FEAT_I8  0u
+#define FB_CSR_FEAT_I32 1u
+
+/* fb_csr_gnn_layer_t.flags */
+#define FB_CSR_GNN_SELF 1u /* add the node's own row to its neighbors' */
+#define FB_CSR_GNN_MEAN 2u /* divide the sum by the rows summed */
+
+typedef struct {
+    uint64_t w_ptr;   /* int8 [out_dim][in_dim] for MATMUL_I8_I8, 0 = none */
+    uint32_t w_scale; /* Q16 */
+    uint32_t out_dim; /* must equal the input dim when w_ptr is 0 */
+    uint32_t act;     /* FB_ACT_RELU, FB_ACT_SIGMOID (Q16) or FB_ACT_NONE */
+    uint32_t flags;   /* FB_CSR_GNN_* */
+} fb_csr_gnn_layer_t;
+
+/*
+ * K-layer GNN over a CSR segment. Layer l sums (or averages) the rows of each
+ * node's neighbors, optionally requantizes the sum and multiplies it by w,
+ * then applies act. Layer 0 reads feat_ptr (num_nodes rows of in_dim, i8 or
+ * i32); layer l writes num_nodes rows of out_dim i32 to buf_ptr[l % 2], so
+ * both buffers need num_nodes * fb_csr_gnn_max_dim() words.
+ */
+typedef struct {
+    uint64_t graph_ptr;   /* const fb_csr_t * */
+    uint64_t feat_ptr;
+    uint64_t buf_ptr[2];
+    uint64_t scratch_ptr; /* fb_csr_gnn_scratch_bytes(cfg) */
+    uint64_t state_ptr;   /* fb_csr_gnn_state_t */
+    uint32_t feat_type;   /* FB_CSR_FEAT_I8 or FB_CSR_FEAT_I32 */
+    uint32_t in_dim;
+    uint32_t num_layers;  /* 1..FB_CSR_GNN_MAX_LAYERS */
+    uint32_t _pad0;
+    fb_csr_gnn_layer_t layers[FB_CSR_GNN_MAX_LAYERS];
+} fb_csr_gnn_cfg_t;
+
+/*
+ * Words 0-1 match fb_row_state_t: cursor is the next node of the current
+ * layer and max_rows the nodes per call. Start from {0, max_rows, 0}.
+ */
+typedef struct {
+    uint32_t cursor;
+    uint32_t max_rows; /* nodes per call, 0 = all */
+    uint32_t layer;
+} fb_csr_gnn_state_t;
+
+static inline uint32_t fb_csr_gnn_max_dim(const fb_csr_gnn_cfg_t *cfg) {
+    uint32_t dim = cfg->in_dim;
+    for (uint32_t l = 0; l < cfg->num_layers && l < FB_CSR_GNN_MAX_LAYERS; l++) {
+        dim = cfg->layers[l].out_dim > dim ? cfg->layers[l].out_dim : dim;
+    }
+    return dim;
+}
+
+/* One i32 sum row plus a prequant buffer for the matmul input. */
+static inline size_t fb_csr_gnn_scratch_bytes(const fb_csr_gnn_cfg_t *cfg) {
+    uint32_t dim = fb_csr_gnn_max_dim(cfg);
+    return (size_t)dim * sizeof(int32_t) + FB_PREQUANT_BYTES(dim);
+}
+
+/**
+ * Rows written by the last layer (num_nodes x layers[num_layers-1].out_dim).
+ */
+static inline int32_t *fb_csr_gnn_output(const fb_csr_gnn_cfg_t *cfg) {
+    return (int32_t *)(uintptr_t)cfg->buf_ptr[(cfg->num_layers - 1u) % 2u];
+}
+
+/* One chunk of the current layer. */
+static inline void fb_csr_gnn_chunk(const fb_csr_gnn_cfg_t *cfg, const fb_csr_t *g,
+                                   fb_csr_gnn_state_t *st) {
+    uint32_t l = st->layer;
+    const fb_csr_gnn_layer_t *layer = &cfg->layers[l];
+    uint32_t in_dim = l ? cfg->layers[l - 1u].out_dim : cfg->in_dim;
+    const void *in = l ? (const void *)(uintptr_t)cfg->buf_ptr[(l - 1u) % 2u]
+                       : (const void *)(uintptr_t)cfg->feat_ptr;
+    int in_i8 = l == 0 && cfg->feat_type == FB_CSR_FEAT_I8;
+    int32_t *out = (int32_t *)(uintptr_t)cfg->buf_ptr[l % 2u];
+    int32_t *sum = (int32_t *)(uintptr_t)cfg->scratch_ptr;
+    void *xq = sum + fb_csr_gnn_max_dim(cfg);
+
+    uint32_t v = st->cursor;
+    uint32_t end = st->max_rows && st->max_rows < g->num_nodes - v ? v + st->max_rows
+                                                                   : g->num_nodes;
+    for (; v < end; v++) {
+        uint32_t deg;
+        const uint32_t *nb = fb_csr_neighbors(g, v, &deg, NULL);
+        uint32_t rows = deg + ((layer->flags & FB_CSR_GNN_SELF) ? 1u : 0u);
+        for (uint32_t k = 0; k < in_dim; k++) {
+            sum[k] = 0;
+        }
+        for (uint32_t j = 0; j < rows; j++) {
+            size_t off = (size_t)(j < deg ? nb[j] : v) * in_dim;
+            if (in_i8) {
+                const int8_t *row = (const int8_t *)in + off;
+                for (uint32_t k = 0; k < in_dim; k++) {
+                    sum[k] += row[k];
+                }
+            } else {
+                const int32_t *row = (const int32_t *)in + off;
+                for (uint32_t k = 0; k < in_dim; k++) {
+                    sum[k] += row[k];
+                }
+            }
+        }
+        if ((layer->flags & FB_CSR_GNN_MEAN) && rows > 1u) {
+            for (uint32_t k = 0; k < in_dim; k++) {
+                sum[k] /= (int32_t)rows;
+            }
+        }
+
+        int32_t *dst = out + (size_t)v * layer->out_dim;
+        if (layer->w_ptr) {
+            (void)fb_quantize_i32_to_prequant(xq, sum, in_dim, 0, 0);
+            fb_matmul_i8_i8(dst, xq, (const int8_t *)(uintptr_t)layer->w_ptr,
+                            (int32_t)layer->w_scale, in_dim, layer->out_dim);
+        } else {
+            fb_memcpy(dst, sum, (size_t)in_dim * sizeof(int32_t));
+        }
+        for (uint32_t k = 0; k < layer->out_dim; k++) {
+            if (layer->act == FB_ACT_RELU) {
+                dst[k] = dst[k] < 0 ? 0 : dst[k];
+            } else if (layer->act == FB_ACT_SIGMOID) {
+                dst[k] = fb_q16_sigmoid(dst[k]);
+            }
+        }
+    }
+
+    st->cursor = end;
+    if (end >= g->num_nodes) {
+        st->cursor = 0;
+        st->layer++;
+    }
+}
+
+/**
+ * Run the next max_rows nodes of the current layer, moving to the next layer
+ * at the end of one. Yields like fb_matmul_i8_i8_bias_act while work
+ * remains, so call until it returns 1; calls after that no-op. With
+ * max_rows 0 one call runs every layer and never yields.
+ *
+ * @return 1 once every layer is done, 0 after a chunk, -1 on a bad config
+ */
+static inline int fb_csr_gnn(const fb_csr_gnn_cfg_t *cfg) {
+    const fb_csr_t *g = (const fb_csr_t *)(uintptr_t)cfg->graph_ptr;
+    fb_csr_gnn_state_t *st = (fb_csr_gnn_state_t *)(uintptr_t)cfg->state_ptr;
+    if (cfg->num_layers == 0 || cfg->num_layers > FB_CSR_GNN_MAX_LAYERS ||
+        cfg->feat_type > FB_CSR_FEAT_I32) {
+        return -1;
+    }
+    for (uint32_t l = 0, dim = cfg->in_dim; l < cfg->num_layers; l++) {
+        if (!cfg->layers[l].w_ptr && cfg->layers[l].out_dim != dim) {
+            return -1;
+        }
+        dim = cfg->layers[l].out_dim;
+    }
+    while (st->layer < cfg->num_layers) {
+        fb_csr_gnn_chunk(cfg, g, st);
+        if (st->max_rows) {
+            break;
+        }
+    }
+    if (st->layer >= cfg->num_layers) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+/* ============================================================================
+ * Cycle search
+ * ============================================================================ */
+
+#ifndef FB_CSR_CYCLE_MAX_DEPTH
+#define FB_CSR_CYCLE_MAX_DEPTH 4u /* longest cycle, in hops */
+#endif
+
+/*
+ * Resumable depth-first cycle search from one start node. Words 0-1 match
+ * fb_row_state_t, with max_steps counting edges examined per call. The
+ * visited bitset (one bit per node) follows the struct in the same buffer;
+ * size it with fb_csr_cycle_state_bytes.
+ */
+typedef struct {
+    uint32_t cursor;    /* edges examined so far */
+    uint32_t max_steps; /* edges per call, 0 = all */
+    uint32_t start;
+    uint32_t max_depth; /* 2..FB_CSR_CYCLE_MAX_DEPTH hops */
+    uint32_t depth;     /* current path length, 0 = finished */
+    uint32_t found;     /* cycles written to out */
+    uint32_t edge[FB_CSR_CYCLE_MAX_DEPTH]; /* next edge to try at each hop */
+    uint32_t end[FB_CSR_CYCLE_MAX_DEPTH];
+    int64_t sum[FB_CSR_CYCLE_MAX_DEPTH];   /* path score before each hop */
+} fb_csr_cycle_state_t;
+
+/* One cycle: CSR edge indices start -> ... -> start */
+typedef struct {
+    uint32_t hops;
+    uint32_t reserved;
+    int64_t score; /* sum of edge scores */
+    uint32_t edges[FB_CSR_CYCLE_MAX_DEPTH];
+} fb_csr_cycle_t;
+
+/**
+ * Score every edge with one MATMUL_I8_I8 and mark the ones at or above
+ * `threshold` in `mask` (one byte per CSR edge), like ARB_SCORE does for a
+ * GRPH segment. `scores` receives num_edges values.
+ *
+ * @return number of passing edges
+ */
+static inline uint32_t fb_csr_arb_score(const fb_csr_t *g, const void *x_prequant,
+                                        int32_t threshold, int32_t *scores, uint8_t *mask) {
+    if (g->num_edges == 0) {
+        return 0;
+    }
+    fb_matmul_i8_i8(scores, x_prequant, fb_csr_edge_weights(g, 0), FB_Q16_ONE, g->dim,
+                    g->num_edges);
+    uint32_t passing = 0;
+    for (uint32_t e = 0; e < g->num_edges; e++) {
+        mask[e] = scores[e] >= threshold;
+        passing += mask[e];
+    }
+    return passing;
+}
+
+static inline size_t fb_csr_cycle_state_bytes(uint32_t num_nodes) {
+    return sizeof(fb_csr_cycle_state_t) + (((size_t)num_nodes + 31u) / 32u) * 4u;
+}
+
+static inline uint32_t *fb_csr_cycle_visited(fb_csr_cycle_state_t *st) {
+    return (uint32_t *)(st + 1);
+}
+
+/**
+ * Start a search for cycles of 2..max_depth hops through `start`.
+ *
+ * @return 0 on success, -1 if the node, depth or buffer size is invalid
+ */
+static inline int fb_csr_cycle_init(fb_csr_cycle_state_t *st, size_t bytes, const fb_csr_t *g,
+                                    uint32_t start, uint32_t max_depth, uint32_t max_steps) {
+    if (start >= g->num_nodes || max_depth < 2u || max_depth > FB_CSR_CYCLE_MAX_DEPTH ||
+        bytes < fb_csr_cycle_state_bytes(g->num_nodes)) {
+        return -1;
+    }
+    fb_memset(st, 0, fb_csr_cycle_state_bytes(g->num_nodes));
+    st->max_steps = max_steps;
+    st->start = start;
+    st->max_depth = max_depth;
+    st->depth = 1;
+    uint32_t deg;
+    fb_csr_neighbors(g, start, &deg, &st->edge[0]);
+    st->end[0] = st->edge[0] + deg;
+    return 0;
+}
+
+/**
+ * Walk simple paths from st->start along edges whose `mask` byte is set
+ * (NULL = all) and write each one that returns to the start with a score of
+ * at least `min_score` to `out`. `scores` holds one value per edge, as from
+ * fb_csr_arb_score (NULL scores every cycle 0). The search stops once
+ * out_cap cycles are found. Yields after max_steps edges like the partial
+ * kernels; call again with the same state to continue.
+ *
+ * @return 1 once the search is finished, else 0
+ */
+static inline int fb_csr_cycle_search(const fb_csr_t *g, const int32_t *scores,
+                                      const uint8_t *mask, int64_t min_score,
+                                      fb_csr_cycle_t *out, uint32_t out_cap,
+                                      fb_csr_cycle_state_t *st) {
+    uint32_t *visited = fb_csr_cycle_visited(st);
+    uint32_t steps = 0;
+    while (st->depth > 0) {
+        uint32_t d = st->depth - 1u;
+        if (st->edge[d] >= st->end[d]) {
+            st->depth = d;
+            if (d > 0) {
+                uint32_t v = g->targets[st->edge[d - 1u]];
+                visited[v / 32u] &= ~(1u << (v % 32u));
+                st->edge[d - 1u]++;
+            }
+            continue;
+        }
+        if (st->max_steps && steps == st->max_steps) {
+            st->cursor += steps;
+            fb_yield_state_t ys = {0};
+            fb_yield(&ys);
+            return 0;
+        }
+        steps++;
+        uint32_t e = st->edge[d];
+        if (mask && !mask[e]) {
+            st->edge[d]++;
+            continue;
+        }
+        uint32_t v = g->targets[e];
+        int64_t sum = st->sum[d] + (scores ? scores[e] : 0);
+        if (v == st->start) {
+            if (d > 0 && sum >= min_score) {
+                if (st->found == out_cap) {
+                    st->depth = 0;
+                    break;
+                }
+                fb_csr_cycle_t *c = &out[st->found++];
+                c->hops = d + 1u;
+                c->reserved = 0;
+                c->score = sum;
+                for (uint32_t k = 0; k < FB_CSR_CYCLE_MAX_DEPTH; k++) {
+                    c->edges[k] = k <= d ? st->edge[k] : FB_CSR_NONE;
+                }
+            }
+            st->edge[d]++;
+            continue;
+        }
+        if (d + 1u >= st->max_depth || (visited[v / 32u] & (1u << (v % 32u)))) {
+            st->edge[d]++;
+            continue;
+        }
+        visited[v / 32u] |= 1u << (v % 32u);
+        uint32_t deg;
+        fb_csr_neighbors(g, v, &deg, &st->edge[d + 1u]);
+        st->end[d + 1u] = st->edge[d + 1u] + deg;
+        st->sum[d + 1u] = sum;
+        st->depth = d + 2u;
+    }
+    st->cursor += steps;
+    return 1;
+}
+
+/* ============================================================================
+ * Top-K hits
+ * ============================================================================ */
+
+/*
+ * Bounded shortlist of the K best hits, kept like the MATMUL_I8_I8_ARGMAX
+ * shortlists (topk, filled, min_val, min_pos): a hit below the current
+ * minimum costs one compare, a better one replaces the minimum and rescans
+ * K entries. Equal scores keep the lower target, so the result does not
+ * depend on edge order.
+ */
+typedef struct {
+    uint32_t topk;
+    uint32_t filled;
+    int32_t min_val;
+    uint32_t min_pos;
+    fb_graph_hit_t *hits; /* topk entries */
+} fb_topk_t;
+
+static inline void fb_topk_init(fb_topk_t *t, fb_graph_hit_t *hits, uint32_t k) {
+    t->topk = k;
+    t->filled = 0;
+    t->min_val = INT32_MIN;
+    t->min_pos = 0;
+    t->hits = hits;
+}
+
+static inline void fb_topk_rescan(fb_topk_t *t) {
+    t->min_pos = 0;
+    t->min_val = t->hits[0].score;
+    for (uint32_t i = 1; i < t->filled; i++) {
+        const fb_graph_hit_t *h = &t->hits[i];
+        if (h->score < t->min_val ||
+            (h->score == t->min_val && h->target > t->hits[t->min_pos].target)) {
+            t->min_val = h->score;
+            t->min_pos = i;
+        }
+    }
+}
+
+static inline void fb_topk_push(fb_topk_t *t, uint32_t target, int32_t score) {
+    if (t->filled < t->topk) {
+        t->hits[t->filled].target = target;
+        t->hits[t->filled].score = score;
+        t->filled++;
+        if (t->filled == t->topk) {
+            fb_topk_rescan(t);
+        }
+        return;
+    }
+    if (t->topk == 0 || score < t->min_val ||
+        (score == t->min_val && target >= t->hits[t->min_pos].target)) {
+        return;
+    }
+    t->hits[t->min_pos].target = target;
+    t->hits[t->min_pos].score = score;
+    fb_topk_rescan(t);
+}
+
+/**
+ * Sort the shortlist best-first (ties by lower target).
+ *
+ * @return number of hits kept (<= topk)
+ */
+static inline uint32_t fb_topk_finish(fb_topk_t *t) {
+    for (uint32_t i = 1; i < t->filled; i++) {
+        fb_graph_hit_t h = t->hits[i];
+        uint32_t j = i;
+        while (j > 0 && (t->hits[j - 1u].score < h.score ||
+                         (t->hits[j - 1u].score == h.score && t->hits[j - 1u].target > h.target))) {
+            t->hits[j] = t->hits[j - 1u];
+            j--;
+        }
+        t->hits[j] = h;
+    }
+    return t->filled;
+}
+
+/**
+ * GRAPH_SEARCH keeping only the `k` best hits, best-first, in `out`. The
+ * kernel still writes every hit, so `scratch` must hold num_edges hits; the
+ * output and any follow-up pass are O(k).
+ *
+ * @return number of hits in `out` (<= k)
+ */
+static inline uint32_t fb_graph_search_topk(const int8_t *input, uint64_t graph_idx,
+                                            fb_graph_hit_t *scratch, fb_graph_hit_t *out,
+                                            uint32_t k, int32_t min_score, int alt) {
+    uint32_t hits = fb_graph_search(input, graph_idx, scratch, min_score, alt);
+    fb_topk_t t;
+    fb_topk_init(&t, out, k);
+    for (uint32_t i = 0; i < hits; i++) {
+        fb_topk_push(&t, scratch[i].target, scratch[i].score);
+    }
+    return fb_topk_finish(&t);
+}
+
+#ifndef FB_CSR_TOPK_CHUNK
+#define FB_CSR_TOPK_CHUNK 64u /* rows scored per MATMUL_I8_I8 call */
+#endif
+
+/**
+ * fb_csr_graph_search keeping only the `k` best hits, best-first. Scores go
+ * through a FB_CSR_TOPK_CHUNK-row stack buffer, so `out` needs just k
+ * entries.
+ *
+ * @return number of hits in `out` (<= k)
+ */
+static inline uint32_t fb_csr_graph_search_topk(const fb_csr_t *g, uint32_t node,
+                                                const void *x_prequant, fb_graph_hit_t *out,
+                                                uint32_t k, int32_t min_score,
+                                                const uint8_t *edge_mask) {
+    uint32_t deg, first;
+    const uint32_t *targets = fb_csr_neighbors(g, node, &deg, &first);
+    int32_t scores[FB_CSR_TOPK_CHUNK];
+    fb_topk_t t;
+    fb_topk_init(&t, out, k);
+    for (uint32_t base = 0; base < deg; base += FB_CSR_TOPK_CHUNK) {
+        uint32_t rows = deg - base < FB_CSR_TOPK_CHUNK ? deg - base : FB_CSR_TOPK_CHUNK;
+        fb_matmul_i8_i8(scores, x_prequant, fb_csr_edge_weights(g, first + base), FB_Q16_ONE,
+                        g->dim, rows);
+        for (uint32_t j = 0; j < rows; j++) {
+            if (scores[j] >= min_score && (!edge_mask || edge_mask[first + base + j])) {
+                fb_topk_push(&t, targets[base + j], scores[j]);
+            }
+        }
+    }
+    return fb_topk_finish(&t);
+}
+
+/* ============================================================================
+ * Delta log
+ * ============================================================================ */
+
+#define FB_CSR_DELTA_MAGIC   0x544C4447u /* "GDLT" */
+#define FB_CSR_DELTA_VERSION 1u
+
+#define FB_CSR_DELTA_UPSERT 0u /* insert the edge or replace its weights */
+#define FB_CSR_DELTA_DELETE 1u /* remove the edge if present */
+
+typedef struct {
+    uint32_t magic;           /* FB_CSR_DELTA_MAGIC */
+    uint16_t version;         /* FB_CSR_DELTA_VERSION */
+    uint16_t flags;           /* reserved, 0 */
+    uint32_t base_generation; /* CSR generation the records apply to */
+    uint32_t count;           /* records after the header */
+    uint32_t dim;             /* must match the CSR */
+    uint32_t reserved[3];     /* 0 */
+} fb_csr_delta_header_t;
+
+/* Record: this header then FB_ALIGN4(dim) weight bytes (ignored on delete) */
+typedef struct {
+    uint32_t src;
+    uint32_t dst;
+    uint32_t op; /* FB_CSR_DELTA_* */
+} fb_csr_delta_rec_t;
+
+static inline size_t fb_csr_delta_stride(uint32_t dim) {
+    return sizeof(fb_csr_delta_rec_t) + FB_ALIGN4((size_t)dim);
+}
+
+/* Bytes a log of `count` records needs. */
+static inline size_t fb_csr_delta_bytes(uint32_t count, uint32_t dim) {
+    return sizeof(fb_csr_delta_header_t) + (size_t)count * fb_csr_delta_stride(dim);
+}
+
+static inline const fb_csr_delta_rec_t *fb_csr_delta_rec(const fb_csr_delta_header_t *log,
+                                                         uint32_t i) {
+    return (const fb_csr_delta_rec_t *)((const uint8_t *)(log + 1) +
+                                        (size_t)i * fb_csr_delta_stride(log->dim));
+}
+
+static inline const int8_t *fb_csr_delta_weights(const fb_csr_delta_rec_t *rec) {
+    return (const int8_t *)(rec + 1);
+}
+
+/* Empty the log at `log` and tie it to CSR `generation`. */
+static inline void fb_csr_delta_reset(fb_csr_delta_header_t *log, uint32_t generation,
+                                      uint32_t dim) {
+    fb_memset(log, 0, sizeof(*log));
+    log->magic = FB_CSR_DELTA_MAGIC;
+    log->version = FB_CSR_DELTA_VERSION;
+    log->base_generation = generation;
+    log->dim = dim;
+}
+
+/**
+ * Append one record; `weights` (dim bytes) may be NULL for zeros or a
+ * delete. Only the record and the header's count change, so a client update
+ * writes O(changed edges) bytes.
+ *
+ * @return 0 on success, -1 if the log (`cap` bytes) is full or malformed
+ */
+static inline int fb_csr_delta_append(fb_csr_delta_header_t *log, size_t cap, uint32_t src,
+                                      uint32_t dst, uint32_t op, const int8_t *weights) {
+    if (log->magic != FB_CSR_DELTA_MAGIC || op > FB_CSR_DELTA_DELETE ||
+        fb_csr_delta_bytes(log->count + 1u, log->dim) > cap) {
+        return -1;
+    }
+    fb_csr_delta_rec_t *rec = (fb_csr_delta_rec_t *)fb_csr_delta_rec(log, log->count);
+    int8_t *w = (int8_t *)(rec + 1);
+    rec->src = src;
+    rec->dst = dst;
+    rec->op = op;
+    if (weights && op == FB_CSR_DELTA_UPSERT) {
+        fb_memcpy(w, weights, log->dim);
+        fb_memset(w + log->dim, 0, FB_ALIGN4((size_t)log->dim) - log->dim);
+    } else {
+        fb_memset(w, 0, FB_ALIGN4((size_t)log->dim));
+    }
+    log->count++;
+    return 0;
+}
+
+/**
+ * Check a delta log of `bytes` against CSR `g`: magic, dim, generation,
+ * record bounds and endpoints < num_nodes.
+ *
+ * @return 0 if it can be compacted into `g`, -1 otherwise (a stale log has
+ *         base_generation != g->generation)
+ */
+static inline int fb_csr_delta_check(const fb_csr_t *g, const fb_csr_delta_header_t *log,
+                                     size_t bytes) {
+    if (bytes < sizeof(*log) || log->magic != FB_CSR_DELTA_MAGIC ||
+        log->version != FB_CSR_DELTA_VERSION || log->dim != g->dim ||
+        log->base_generation != g->generation ||
+        fb_csr_delta_bytes(log->count, log->dim) > bytes) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < log->count; i++) {
+        const fb_csr_delta_rec_t *rec = fb_csr_delta_rec(log, i);
+        if (rec->src >= g->num_nodes || rec->dst >= g->num_nodes ||
+            rec->op > FB_CSR_DELTA_DELETE) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Record order for compaction: (src, dst), later records last */
+static inline int fb_csr_delta_before(const fb_csr_delta_header_t *log, uint32_t a,
+                                      uint32_t b) {
+    const fb_csr_delta_rec_t *ra = fb_csr_delta_rec(log, a);
+    const fb_csr_delta_rec_t *rb = fb_csr_delta_rec(log, b);
+    if (ra->src != rb->src) {
+        return ra->src < rb->src;
+    }
+    if (ra->dst != rb->dst) {
+        return ra->dst < rb->dst;
+    }
+    return a < b;
+}
+
+static inline void fb_csr_delta_sift(const fb_csr_delta_header_t *log, uint32_t *order,
+                                     uint32_t root, uint32_t end) {
+    while (2u * root + 1u < end) {
+        uint32_t child = 2u * root + 1u;
+        if (child + 1u < end && fb_csr_delta_before(log, order[child], order[child + 1u])) {
+            child++;
+        }
+        if (!fb_csr_delta_before(log, order[root], order[child])) {
+            return;
+        }
+        uint32_t t = order[root];
+        order[root] = order[child];
+        order[child] = t;
+        root = child;
+    }
+}
+
+/* Heapsort record indices into `order` (O(k log k), no recursion). */
+static inline void fb_csr_delta_sort(const fb_csr_delta_header_t *log, uint32_t *order) {
+    uint32_t n = log->count;
+    for (uint32_t i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    for (uint32_t start = n / 2u; start-- > 0;) {
+        fb_csr_delta_sift(log, order, start, n);
+    }
+    for (uint32_t end = n; end > 1u;) {
+        end--;
+        uint32_t t = order[0];
+        order[0] = order[end];
+        order[end] = t;
+        fb_csr_delta_sift(log, order, 0, end);
+    }
+}
+
+/*
+ * Merge node v's adjacency with its sorted deltas order[*p..]. Counts the
+ * merged edges; writes them at targets/weights (edge index `out`) if non-NULL.
+ */
+static inline uint32_t fb_csr_merge_node(const fb_csr_t *g, const fb_csr_delta_header_t *log,
+                                         const uint32_t *order, uint32_t *p, uint32_t v,
+                                         uint32_t *targets, int8_t *weights, uint32_t out) {
+    uint32_t i = g->offsets[v];
+    uint32_t end = g->offsets[v + 1u];
+    uint32_t dim = g->dim;
+    uint32_t n = 0;
+    while (i < end || (*p < log->count && fb_csr_delta_rec(log, order[*p])->src == v)) {
+        const fb_csr_delta_rec_t *rec = NULL;
+        if (*p < log->count) {
+            rec = fb_csr_delta_rec(log, order[*p]);
+            if (rec->src != v) {
+                rec = NULL;
+            }
+        }
+        if (!rec || (i < end && g->targets[i] < rec->dst)) {
+            if (targets) {
+                targets[out + n] = g->targets[i];
+                fb_memcpy(weights + (size_t)(out + n) * dim, fb_csr_edge_weights(g, i), dim);
+            }
+            i++;
+            n++;
+            continue;
+        }
+        /* last record for (v, dst) wins; skip earlier ones */
+        while (*p + 1u < log->count) {
+            const fb_csr_delta_rec_t *next = fb_csr_delta_rec(log, order[*p + 1u]);
+            if (next->src != v || next->dst != rec->dst) {
+                break;
+            }
+            (*p)++;
+            rec = next;
+        }
+        (*p)++;
+        if (i < end && g->targets[i] == rec->dst) {
+            i++; /* replaced or deleted */
+        }
+        if (rec->op == FB_CSR_DELTA_UPSERT) {
+            if (targets) {
+                targets[out + n] = rec->dst;
+                fb_memcpy(weights + (size_t)(out + n) * dim, fb_csr_delta_weights(rec), dim);
+            }
+            n++;
+        }
+    }
+    return n;
+}
+
+/**
+ * Fold the delta log into `g` and write the result as a new CSR at `dst`
+ * (`cap` bytes, must not overlap `g`; ping-pong between two regions) with
+ * generation g->generation + 1. `order` is scratch for log->count u32. Cost
+ * is O(E + k log k) for k records; reset the log to the new generation
+ * afterwards (fb_csr_delta_reset).
+ *
+ * @return merged edge count, or -1 if the log fails fb_csr_delta_check or
+ *         the result does not fit
+ */
+static inline int64_t fb_csr_compact(void *dst, size_t cap, const fb_csr_t *g,
+                                     const fb_csr_delta_header_t *log, size_t log_bytes,
+                                     uint32_t *order) {
+    if (fb_csr_delta_check(g, log, log_bytes) != 0) {
+        return -1;
+    }
+    fb_csr_delta_sort(log, order);
+
+    uint32_t edges = 0;
+    uint32_t p = 0;
+    for (uint32_t v = 0; v < g->num_nodes; v++) {
+        edges += fb_csr_merge_node(g, log, order, &p, v, NULL, NULL, 0);
+    }
+    uint32_t offsets_off, targets_off, weights_off;
+    size_t total;
+    fb_csr_layout(g->num_nodes, edges, g->dim, &offsets_off, &targets_off, &weights_off, &total);
+    if (total > cap) {
+        return -1;
+    }
+
+    uint8_t *base = (uint8_t *)dst;
+    uint32_t *offsets = (uint32_t *)(base + offsets_off);
+    uint32_t *targets = (uint32_t *)(base + targets_off);
+    int8_t *weights = (int8_t *)(base + weights_off);
+    uint32_t out = 0;
+    p = 0;
+    for (uint32_t v = 0; v < g->num_nodes; v++) {
+        offsets[v] = out;
+        out += fb_csr_merge_node(g, log, order, &p, v, targets, weights, out);
+    }
+    offsets[g->num_nodes] = out;
+    if (weights_off + (size_t)out * g->dim < total) {
+        fb_memset(weights + (size_t)out * g->dim, 0, total - weights_off - (size_t)out * g->dim);
+    }
+
+    fb_csr_header_t *hdr = (fb_csr_header_t *)base;
+    fb_memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = FB_CSR_MAGIC;
+    hdr->version = FB_CSR_VERSION;
+    hdr->num_nodes = g->num_nodes;
+    hdr->num_edges = out;
+    hdr->dim = g->dim;
+    hdr->offsets_off = offsets_off;
+    hdr->targets_off = targets_off;
+    hdr->weights_off = weights_off;
+    hdr->generation = g->generation + 1u;
+    return out;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FROSTBITE_GRAPH_H */
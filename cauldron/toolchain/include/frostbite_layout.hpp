@@ -0,0 +1,102 @@
+/**
+ * Frostbite VM - constexpr weights segment layout
+ *
+ * Describes the blocks of a weights blob (matrices, bias vectors) as a list
+ * and resolves each block's segment address at compile time, so a guest
+ * indexes weights with constants instead of summing sizes at startup, and a
+ * block the int8 kernels would read misaligned fails to compile:
+ *
+ *   constexpr fb::WeightsLayout<4> kMlp = fb::weights_layout(1, 12, {
+ *       fb::i8_matrix(32, 64), fb::i32_vector(32),  // W1 (H x I), B1
+ *       fb::i8_matrix(1, 32), fb::i32_vector(1),    // W2 (O x H), B2
+ *   });
+ *   static_assert(kMlp.aligned(), "weights block misaligned");
+ *   static_assert(kMlp.end() - kMlp.base == 2212, "blob size_bytes drifted");
+ *
+ *   auto w1 = (const int8_t *)(uintptr_t)kMlp.addr(0);
+ *
+ * Blocks are packed densely in list order, as cauldron's convert.py writes
+ * them; `pad` rounds a block's start up for blobs written with padding.
+ * scripts/fb_layout.py generates the same constants as a C header straight
+ * from a model manifest. Needs -std=c++14 or later.
+ */
+
+#ifndef FROSTBITE_LAYOUT_HPP
+#define FROSTBITE_LAYOUT_HPP
+
+#include "frostbite.h"
+
+#if !defined(__cplusplus) || __cplusplus < 201402L
+#error "frostbite_layout.hpp needs C++14 or later"
+#endif
+
+namespace fb {
+
+/* One block of a weights blob. */
+struct Block {
+    size_t bytes; /* payload size */
+    size_t pad;   /* start is rounded up to a multiple of this (1 = dense) */
+    size_t need;  /* alignment the consuming kernel path expects */
+};
+
+/* Row-major D x N int8 matrix. Word-aligned so DOT_I8 and the guest word loops load whole words. */
+constexpr Block i8_matrix(size_t d, size_t n, size_t pad = 1) { return Block{d * n, pad, 4}; }
+
+/* N int32 values (bias, Q16 scales): read with lw. */
+constexpr Block i32_vector(size_t n, size_t pad = 1) { return Block{n * 4, pad, 4}; }
+
+/* Raw bytes with no alignment requirement (tree nodes, headers). */
+constexpr Block bytes(size_t n, size_t pad = 1) { return Block{n, pad, 1}; }
+
+constexpr size_t align_up(size_t v, size_t a) { return a > 1 ? (v + a - 1) / a * a : v; }
+
+/* K blocks placed from byte `base` of weights segment `segment`. */
+template <size_t K>
+struct WeightsLayout {
+    static_assert(K > 0, "fb: empty weights layout");
+    uint32_t segment;
+    size_t base; /* blob data_offset + build.weights_offset */
+    Block blocks[K];
+
+    static constexpr size_t count = K;
+
+    /* Byte offset of block i within the segment. */
+    constexpr size_t offset(size_t i) const {
+        size_t off = base;
+        for (size_t b = 0; b < i; b++) {
+            off = align_up(off, blocks[b].pad) + blocks[b].bytes;
+        }
+        return align_up(off, blocks[i].pad);
+    }
+
+    constexpr uint64_t addr(size_t i) const { return FB_SEGMENT_ADDR(segment, offset(i)); }
+
+    constexpr size_t size(size_t i) const { return blocks[i].bytes; }
+
+    /* First byte past the last block. */
+    constexpr size_t end() const { return offset(K - 1) + blocks[K - 1].bytes; }
+
+    /* Every block meets its kernel alignment and the blob fits the segment's 28-bit offset. */
+    constexpr bool aligned() const {
+        for (size_t i = 0; i < K; i++) {
+            size_t need = blocks[i].need ? blocks[i].need : 1;
+            if (offset(i) % need != 0) {
+                return false;
+            }
+        }
+        return end() <= 0x10000000u;
+    }
+};
+
+template <size_t K>
+constexpr WeightsLayout<K> weights_layout(uint32_t segment, size_t base, const Block (&blocks)[K]) {
+    WeightsLayout<K> layout{segment, base, {}};
+    for (size_t i = 0; i < K; i++) {
+        layout.blocks[i] = blocks[i];
+    }
+    return layout;
+}
+
+} // namespace fb
+
+#endif /* FROSTBITE_LAYOUT_HPP */
@@ -0,0 +1,155 @@
+/**
+ * Frostbite VM - binary log records
+ *
+ * A compact alternative to fb_printf for metrics: one record is a tag, an
+ * optional schema ID and a list of signed fields, varint-encoded and written
+ * as a single WRITE. scripts/fb_log.py decodes the records from runner or
+ * Solana program logs:
+ *
+ *   FB_BLOG(0xB100, MY_SCHEMA, rows, instret_delta, status);
+ *
+ * Wire format (before framing):
+ *   u8      version              FB_BLOG_VERSION
+ *   varint  tag
+ *   varint  schema_id            0 = none
+ *   varint  field[i]             zigzag-encoded int64, to the end of the record
+ *
+ * WRITE output must be UTF-8 (program logs drop anything else), so the record
+ * is framed as FB_BLOG_PREFIX + base64 + '\n'.
+ *
+ * A record that dropped fields is followed by a trailer record with the
+ * reserved tag FB_BLOG_TAG_DROPPED, schema 0 and fields {tag, dropped}, so a
+ * decoder can tell a truncated record from a complete one.
+ */
+
+#ifndef FROSTBITE_LOG_H
+#define FROSTBITE_LOG_H
+
+#include "frostbite.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_BLOG_VERSION 1u
+#define FB_BLOG_PREFIX  "fb1:"
+
+/* Reserved for the dropped-field trailer; do not log with tag 0 */
+#define FB_BLOG_TAG_DROPPED 0u
+
+/* Largest encoded record; fields past it are dropped and counted. */
+#ifndef FB_BLOG_MAX
+#define FB_BLOG_MAX 64
+#endif
+
+typedef struct {
+    uint64_t tag;
+    uint32_t len;
+    uint32_t dropped; /* fields that did not fit */
+    uint8_t buf[FB_BLOG_MAX];
+} fb_blog_t;
+
+static inline int fb_blog_put_varint(fb_blog_t *b, uint64_t v) {
+    uint8_t tmp[10];
+    uint32_t n = 0;
+    do {
+        tmp[n++] = (uint8_t)((v & 0x7Fu) | (v > 0x7Fu ? 0x80u : 0u));
+        v >>= 7;
+    } while (v);
+    if (b->len + n > sizeof(b->buf)) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        b->buf[b->len + i] = tmp[i];
+    }
+    b->len += n;
+    return 0;
+}
+
+/**
+ * Start a record.
+ */
+static inline void fb_blog_begin(fb_blog_t *b, uint64_t tag, uint64_t schema_id) {
+    b->tag = tag;
+    b->len = 0;
+    b->dropped = 0;
+    b->buf[b->len++] = (uint8_t)FB_BLOG_VERSION;
+    (void)fb_blog_put_varint(b, tag);
+    (void)fb_blog_put_varint(b, schema_id);
+}
+
+/**
+ * Append one signed field (zigzag varint: small magnitudes take one byte).
+ */
+static inline void fb_blog_i64(fb_blog_t *b, int64_t v) {
+    uint64_t z = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+    /* once one field is dropped, later ones are too, so positions hold */
+    if (b->dropped || fb_blog_put_varint(b, z) != 0) {
+        b->dropped++;
+    }
+}
+
+/* Frame one record and write it with one WRITE. */
+static inline long fb_blog_write(const fb_blog_t *b) {
+    static const char b64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    char line[sizeof(FB_BLOG_PREFIX) + ((FB_BLOG_MAX + 2) / 3) * 4 + 1];
+    size_t n = sizeof(FB_BLOG_PREFIX) - 1u;
+    fb_memcpy(line, FB_BLOG_PREFIX, n);
+    for (uint32_t i = 0; i < b->len; i += 3) {
+        uint32_t left = b->len - i;
+        uint32_t v = (uint32_t)b->buf[i] << 16;
+        v |= left > 1u ? (uint32_t)b->buf[i + 1u] << 8 : 0u;
+        v |= left > 2u ? (uint32_t)b->buf[i + 2u] : 0u;
+        line[n++] = b64[(v >> 18) & 63u];
+        line[n++] = b64[(v >> 12) & 63u];
+        line[n++] = left > 1u ? b64[(v >> 6) & 63u] : '=';
+        line[n++] = left > 2u ? b64[v & 63u] : '=';
+    }
+    line[n++] = '\n';
+    return fb_write(line, n);
+}
+
+/**
+ * Frame the record and write it with one WRITE, plus the FB_BLOG_TAG_DROPPED
+ * trailer when fields were dropped.
+ *
+ * @return bytes written
+ */
+static inline long fb_blog_emit(const fb_blog_t *b) {
+    long n = fb_blog_write(b);
+    if (b->dropped) {
+        fb_blog_t t;
+        fb_blog_begin(&t, FB_BLOG_TAG_DROPPED, 0);
+        fb_blog_i64(&t, (int64_t)b->tag);
+        fb_blog_i64(&t, (int64_t)b->dropped);
+        n += fb_blog_write(&t);
+    }
+    return n;
+}
+
+/**
+ * Encode and emit a record of `count` fields.
+ *
+ * @return bytes written
+ */
+static inline long fb_blog_log(uint64_t tag, uint64_t schema_id, const int64_t *fields,
+                               size_t count) {
+    fb_blog_t b;
+    fb_blog_begin(&b, tag, schema_id);
+    for (size_t i = 0; i < count; i++) {
+        fb_blog_i64(&b, fields[i]);
+    }
+    return fb_blog_emit(&b);
+}
+
+/* FB_BLOG(tag, schema_id, field, ...): fields convert to int64_t (C only) */
+#define FB_BLOG(tag, schema_id, ...)                                            \
+    fb_blog_log((tag), (schema_id), (const int64_t[]){__VA_ARGS__},             \
+                sizeof((int64_t[]){__VA_ARGS__}) / sizeof(int64_t))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FROSTBITE_LOG_H */
@@ -0,0 +1,281 @@
+/**
+ * Frostbite VM - model guest control block (FbModelControlV1)
+ *
+ * C side of docs/FROSTBITE_GUEST_CONTRACT.md: the control block struct, the
+ * optional FBH1 input header, and one validation pass that leaves the guest
+ * with plain pointers to its input payload and output region. Outputs are
+ * written in place at output_ptr, so no staging buffer or final copy:
+ *
+ *   fb_model_t m;
+ *   uint32_t rc = fb_model_open(&m, FB_SCRATCH_ADDR(CONTROL_OFFSET), OUTPUT_MAX,
+ *                               SCHEMA_ID, SCHEMA_HASH);
+ *   const int32_t *x = rc ? NULL : fb_model_input_i32(&m, 0, INPUT_DIM);
+ *   int32_t *y = x ? fb_model_output_i32(&m, 0, OUTPUT_DIM) : NULL;
+ *   if (!y) {
+ *       fb_model_exit(&m, rc ? rc : FB_MODEL_ERR_INPUT_BOUNDS);
+ *   }
+ *   fb_matmul_i8_i32(y, x, w, scale, INPUT_DIM, OUTPUT_DIM);
+ *   fb_model_exit(&m, FB_MODEL_OK);
+ */
+
+#ifndef FROSTBITE_MODEL_H
+#define FROSTBITE_MODEL_H
+
+#include "frostbite.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_MODEL_CTRL_MAGIC   0x314D4246u /* "FBM1" */
+#define FB_MODEL_ABI_VERSION  1u
+#define FB_INPUT_HEADER_MAGIC 0x31484246u /* "FBH1" */
+#define FB_INPUT_HEADER_LEN   32u
+
+#define FB_INPUT_FLAG_CRC32       (1u << 0)
+#define FB_INPUT_FLAG_SCHEMA_HASH (1u << 1)
+
+/* Pass as schema_id to accept any FBH1 schema */
+#define FB_MODEL_SCHEMA_ANY 0xFFFFFFFFu
+
+/* Status / exit codes (contract section 5) */
+#define FB_MODEL_OK                0u
+#define FB_MODEL_ERR_CTRL          1u
+#define FB_MODEL_ERR_INPUT_HEADER  2u
+#define FB_MODEL_ERR_SCHEMA        3u
+#define FB_MODEL_ERR_INPUT_BOUNDS  4u
+#define FB_MODEL_ERR_OUTPUT_BOUNDS 5u
+#define FB_MODEL_ERR_MISALIGNED    6u
+#define FB_MODEL_ERR_INTERNAL      7u
+
+typedef struct {
+    uint32_t magic;       /* FB_MODEL_CTRL_MAGIC */
+    uint32_t abi_version; /* FB_MODEL_ABI_VERSION */
+    uint32_t flags;       /* reserved */
+    uint32_t status;      /* mirrors the exit code */
+    uint32_t input_ptr;   /* vaddr */
+    uint32_t input_len;   /* bytes */
+    uint32_t output_ptr;  /* vaddr */
+    uint32_t output_len;  /* bytes written by the guest */
+    uint32_t scratch_ptr; /* optional temp region vaddr */
+    uint32_t scratch_len;
+    uint32_t user_ptr;    /* optional state/config vaddr */
+    uint32_t user_len;
+    uint64_t reserved0;
+} fb_model_control_v1_t;
+
+typedef struct {
+    uint32_t magic;       /* FB_INPUT_HEADER_MAGIC */
+    uint16_t version;     /* 1 */
+    uint16_t flags;       /* FB_INPUT_FLAG_* */
+    uint32_t header_len;  /* FB_INPUT_HEADER_LEN */
+    uint32_t schema_id;
+    uint32_t payload_len; /* input_len - header_len */
+    uint32_t crc32;
+    uint32_t schema_hash;
+    uint32_t reserved0;
+} fb_input_header_v1_t;
+
+#ifdef __cplusplus
+#define FB_MODEL_STATIC_ASSERT(cond, msg) static_assert(cond, msg)
+#else
+#define FB_MODEL_STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)
+#endif
+
+FB_MODEL_STATIC_ASSERT(sizeof(fb_model_control_v1_t) == 56, "FbModelControlV1 is 56 bytes");
+FB_MODEL_STATIC_ASSERT(offsetof(fb_model_control_v1_t, status) == 12, "status at 12");
+FB_MODEL_STATIC_ASSERT(offsetof(fb_model_control_v1_t, input_ptr) == 16, "input_ptr at 16");
+FB_MODEL_STATIC_ASSERT(offsetof(fb_model_control_v1_t, output_ptr) == 24, "output_ptr at 24");
+FB_MODEL_STATIC_ASSERT(offsetof(fb_model_control_v1_t, output_len) == 28, "output_len at 28");
+FB_MODEL_STATIC_ASSERT(offsetof(fb_model_control_v1_t, user_len) == 44, "user_len at 44");
+FB_MODEL_STATIC_ASSERT(offsetof(fb_model_control_v1_t, reserved0) == 48, "reserved0 at 48");
+FB_MODEL_STATIC_ASSERT(sizeof(fb_input_header_v1_t) == FB_INPUT_HEADER_LEN, "FBH1 is 32 bytes");
+FB_MODEL_STATIC_ASSERT(offsetof(fb_input_header_v1_t, payload_len) == 16, "payload_len at 16");
+
+#undef FB_MODEL_STATIC_ASSERT
+
+/* Validated view of one model call. */
+typedef struct {
+    fb_model_control_v1_t *ctrl;
+    const uint8_t *input;  /* payload (after FBH1 if present) */
+    uint32_t input_len;
+    uint8_t *output;       /* output_ptr */
+    uint32_t output_max;   /* writable bytes at output */
+    uint32_t output_len;   /* high-water mark of handed-out output spans */
+    uint32_t schema_id;    /* from FBH1, FB_MODEL_SCHEMA_ANY without a header */
+} fb_model_t;
+
+/**
+ * CRC-32 (IEEE, reflected) as used by FBH1; nibble table, 2 lookups per byte.
+ */
+static inline uint32_t fb_crc32(const void *data, size_t len) {
+    static const uint32_t table[16] = {
+        0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+        0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+        0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+        0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+    };
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ table[crc & 15u];
+        crc = (crc >> 4) ^ table[crc & 15u];
+    }
+    return ~crc;
+}
+
+/* 1 if [vaddr, vaddr + len) stays inside one segment */
+static inline int fb_model_range_ok(uint32_t vaddr, uint32_t len) {
+    return (uint64_t)(vaddr & 0x0FFFFFFFu) + len <= FB_SEGMENT_SPAN;
+}
+
+/**
+ * Validate the control block at `ctrl_addr` and the optional FBH1 header, and
+ * bind the input payload and `output_max` bytes of output. Both ranges are
+ * touched once (last byte), so a short account faults here, not mid-model.
+ * `schema_hash` 0 rejects any header that carries a hash.
+ *
+ * @return FB_MODEL_OK or an FB_MODEL_ERR_* code (m->ctrl is always set, so
+ *         fb_model_exit(m, code) reports it)
+ */
+static inline uint32_t fb_model_open(fb_model_t *m, uint64_t ctrl_addr, uint32_t output_max,
+                                     uint32_t schema_id, uint32_t schema_hash) {
+    fb_model_control_v1_t *c = (fb_model_control_v1_t *)(uintptr_t)ctrl_addr;
+    m->ctrl = c;
+    m->input = NULL;
+    m->input_len = 0;
+    m->output = NULL;
+    m->output_max = 0;
+    m->output_len = 0;
+    m->schema_id = FB_MODEL_SCHEMA_ANY;
+
+    if (ctrl_addr & 7u) {
+        return FB_MODEL_ERR_MISALIGNED;
+    }
+    if (c->magic != FB_MODEL_CTRL_MAGIC || c->abi_version != FB_MODEL_ABI_VERSION) {
+        return FB_MODEL_ERR_CTRL;
+    }
+
+    uint32_t in_ptr = c->input_ptr;
+    uint32_t in_len = c->input_len;
+    if (!fb_model_range_ok(in_ptr, in_len)) {
+        return FB_MODEL_ERR_INPUT_BOUNDS;
+    }
+    uint32_t out_ptr = c->output_ptr;
+    if (!fb_model_range_ok(out_ptr, output_max)) {
+        return FB_MODEL_ERR_OUTPUT_BOUNDS;
+    }
+
+    const uint8_t *in = (const uint8_t *)(uintptr_t)in_ptr;
+    if (in_len) {
+        (void)*(volatile const uint8_t *)(in + in_len - 1u);
+    }
+    if (in_len >= FB_INPUT_HEADER_LEN) {
+        fb_input_header_v1_t hdr;
+        fb_memcpy(&hdr, in, sizeof(hdr)); /* input_ptr may be unaligned */
+        if (hdr.magic == FB_INPUT_HEADER_MAGIC) {
+            if (hdr.version != 1 || hdr.header_len != FB_INPUT_HEADER_LEN ||
+                hdr.payload_len != in_len - FB_INPUT_HEADER_LEN) {
+                return FB_MODEL_ERR_INPUT_HEADER;
+            }
+            if (schema_id != FB_MODEL_SCHEMA_ANY && hdr.schema_id != schema_id) {
+                return FB_MODEL_ERR_SCHEMA;
+            }
+            if ((hdr.flags & FB_INPUT_FLAG_SCHEMA_HASH) &&
+                (schema_hash == 0 || hdr.schema_hash != schema_hash)) {
+                return FB_MODEL_ERR_SCHEMA;
+            }
+            if ((hdr.flags & FB_INPUT_FLAG_CRC32) &&
+                fb_crc32(in + FB_INPUT_HEADER_LEN, hdr.payload_len) != hdr.crc32) {
+                return FB_MODEL_ERR_INPUT_HEADER;
+            }
+            m->schema_id = hdr.schema_id;
+            in += FB_INPUT_HEADER_LEN;
+            in_len -= FB_INPUT_HEADER_LEN;
+        }
+    }
+
+    m->input = in;
+    m->input_len = in_len;
+    m->output = (uint8_t *)(uintptr_t)out_ptr;
+    m->output_max = output_max;
+    if (output_max) {
+        (void)*(volatile uint8_t *)(m->output + output_max - 1u);
+    }
+    return FB_MODEL_OK;
+}
+
+/**
+ * Pointer to `count` input elements of `elem_size` bytes at payload byte
+ * `offset`, or NULL if the payload is shorter or the span is misaligned.
+ */
+static inline const void *fb_model_input_span(const fb_model_t *m, uint32_t offset,
+                                              uint32_t count, uint32_t elem_size) {
+    uint64_t bytes = (uint64_t)count * elem_size;
+    if (!m->input || offset > m->input_len || bytes > m->input_len - offset ||
+        (((uintptr_t)m->input + offset) & (elem_size - 1u))) {
+        return NULL;
+    }
+    return m->input + offset;
+}
+
+/**
+ * Output span of `count` elements at byte `offset`, written in place at
+ * output_ptr. Raises the output_len reported by fb_model_exit to cover it.
+ *
+ * @return pointer, or NULL past output_max or misaligned
+ */
+static inline void *fb_model_output_span(fb_model_t *m, uint32_t offset, uint32_t count,
+                                         uint32_t elem_size) {
+    uint64_t bytes = (uint64_t)count * elem_size;
+    if (!m->output || offset > m->output_max || bytes > m->output_max - offset ||
+        (((uintptr_t)m->output + offset) & (elem_size - 1u))) {
+        return NULL;
+    }
+    if (offset + (uint32_t)bytes > m->output_len) {
+        m->output_len = offset + (uint32_t)bytes;
+    }
+    return m->output + offset;
+}
+
+#define FB_MODEL_SPAN_TYPED(name, T)                                                      \
+    static inline const T *fb_model_input_##name(const fb_model_t *m, uint32_t offset,    \
+                                                 uint32_t count) {                        \
+        return (const T *)fb_model_input_span(m, offset, count, (uint32_t)sizeof(T));     \
+    }                                                                                     \
+    static inline T *fb_model_output_##name(fb_model_t *m, uint32_t offset,               \
+                                            uint32_t count) {                             \
+        return (T *)fb_model_output_span(m, offset, count, (uint32_t)sizeof(T));          \
+    }
+
+FB_MODEL_SPAN_TYPED(u8, uint8_t)
+FB_MODEL_SPAN_TYPED(i8, int8_t)
+FB_MODEL_SPAN_TYPED(i16, int16_t)
+FB_MODEL_SPAN_TYPED(i32, int32_t)
+FB_MODEL_SPAN_TYPED(u32, uint32_t)
+FB_MODEL_SPAN_TYPED(f32, float)
+
+#undef FB_MODEL_SPAN_TYPED
+
+/* Set output_len explicitly (e.g. variable-length output). */
+static inline void fb_model_set_output_len(fb_model_t *m, uint32_t bytes) {
+    m->output_len = bytes <= m->output_max ? bytes : m->output_max;
+}
+
+/**
+ * Write output_len (0 on error) and status, then exit with the same code.
+ */
+static inline void fb_model_exit(const fb_model_t *m, uint32_t status) {
+    if (m->ctrl) {
+        m->ctrl->output_len = status == FB_MODEL_OK ? m->output_len : 0;
+        m->ctrl->status = status;
+    }
+    fb_exit((int)status);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FROSTBITE_MODEL_H */
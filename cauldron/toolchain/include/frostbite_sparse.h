@@ -0,0 +1,334 @@
+/**
+ * Frostbite VM - block-sparse int8 weight matrices
+ *
+ * A pruned d x n matrix stored as its nonzero br x bc blocks (block CSR):
+ *
+ *   fb_bsr_header_t (40 bytes)
+ *   u32 row_ptr[block_rows + 1]     blocks of block row R are [row_ptr[R], row_ptr[R+1])
+ *   u32 col_idx[num_blocks]         block column of each block, ascending per block row
+ *   i8  blocks[num_blocks][br * bc] row-major, zero padded past d / n
+ *
+ * block_rows = ceil(d / br) and each section starts 4-byte aligned. All-zero
+ * blocks are not stored, so the segment and the work shrink with the pruning.
+ *
+ * fb_bsr_matmul_i8_i8 computes the same out[r] as fb_matmul_i8_i8 on the
+ * dense matrix: (dot(w[r], x) * w_scale_q16 * x_scale_q16) >> 32. Each stored
+ * block is one MATMUL_I8_I8 call at unit scales, which returns its br raw
+ * partial dots exactly; they are summed per row and scaled once at the end.
+ * Skipped blocks cost nothing. The x slices each block reads are staged in
+ * `scratch` (fb_bsr_scratch_bytes) once per call.
+ *
+ *   fb_bsr_t m;
+ *   if (fb_bsr_open(&m, (const void *)(uintptr_t)FB_SEGMENT_ADDR(2, 0), bytes) != 0) ...
+ *   fb_bsr_matmul_i8_i8(out, x_prequant, &m, w_scale_q16, scratch);
+ *
+ * fb_bsr_build packs a dense matrix (in the guest, or on the client before
+ * upload).
+ */
+
+#ifndef FROSTBITE_SPARSE_H
+#define FROSTBITE_SPARSE_H
+
+#include "frostbite.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_BSR_MAGIC   0x31525342u /* "BSR1" */
+#define FB_BSR_VERSION 1u
+
+typedef struct {
+    uint32_t magic;       /* FB_BSR_MAGIC */
+    uint16_t version;     /* FB_BSR_VERSION */
+    uint16_t flags;       /* reserved, 0 */
+    uint32_t n;           /* columns (input dim) */
+    uint32_t d;           /* rows (output dim) */
+    uint16_t br;          /* rows per block */
+    uint16_t bc;          /* columns per block */
+    uint32_t num_blocks;  /* stored (nonzero) blocks */
+    uint32_t row_ptr_off; /* byte offsets from the header */
+    uint32_t col_idx_off;
+    uint32_t blocks_off;
+    uint32_t reserved;    /* 0 */
+} fb_bsr_header_t;
+
+/* Validated view of a block-sparse segment */
+typedef struct {
+    const fb_bsr_header_t *hdr;
+    const uint32_t *row_ptr;
+    const uint32_t *col_idx;
+    const int8_t *blocks;
+    uint32_t n;
+    uint32_t d;
+    uint32_t br;
+    uint32_t bc;
+    uint32_t block_rows;  /* ceil(d / br) */
+    uint32_t block_cols;  /* ceil(n / bc) */
+    uint32_t num_blocks;
+} fb_bsr_t;
+
+static inline uint32_t fb_bsr_div_up(uint32_t a, uint32_t b) {
+    return (a + b - 1u) / b;
+}
+
+/* Section layout for a matrix of the given shape (offsets in bytes). */
+static inline void fb_bsr_layout(uint32_t d, uint32_t br, uint32_t bc, uint32_t num_blocks,
+                                 uint32_t *row_ptr_off, uint32_t *col_idx_off,
+                                 uint32_t *blocks_off, size_t *total) {
+    size_t off = sizeof(fb_bsr_header_t);
+    *row_ptr_off = (uint32_t)off;
+    off += ((size_t)fb_bsr_div_up(d, br) + 1u) * sizeof(uint32_t);
+    *col_idx_off = (uint32_t)off;
+    off += (size_t)num_blocks * sizeof(uint32_t);
+    *blocks_off = (uint32_t)off;
+    off += FB_ALIGN4((size_t)num_blocks * br * bc);
+    *total = off;
+}
+
+static inline int fb_bsr_block_zero(const int8_t *w, uint32_t n, uint32_t d, uint32_t r0,
+                                    uint32_t c0, uint32_t br, uint32_t bc) {
+    for (uint32_t r = r0; r < r0 + br && r < d; r++) {
+        for (uint32_t c = c0; c < c0 + bc && c < n; c++) {
+            if (w[(size_t)r * n + c] != 0) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/* Nonzero br x bc blocks of a dense row-major d x n matrix. */
+static inline uint32_t fb_bsr_count_blocks(const int8_t *w, uint32_t n, uint32_t d,
+                                           uint32_t br, uint32_t bc) {
+    uint32_t count = 0;
+    for (uint32_t r0 = 0; r0 < d; r0 += br) {
+        for (uint32_t c0 = 0; c0 < n; c0 += bc) {
+            count += !fb_bsr_block_zero(w, n, d, r0, c0, br, bc);
+        }
+    }
+    return count;
+}
+
+/* Bytes fb_bsr_build needs for `w` (0 for a bad shape). */
+static inline size_t fb_bsr_bytes(const int8_t *w, uint32_t n, uint32_t d, uint32_t br,
+                                  uint32_t bc) {
+    if (n == 0 || d == 0 || br == 0 || bc == 0 || br > 0xFFFFu || bc > 0xFFFFu) {
+        return 0;
+    }
+    uint32_t rp, ci, bo;
+    size_t total;
+    fb_bsr_layout(d, br, bc, fb_bsr_count_blocks(w, n, d, br, bc), &rp, &ci, &bo, &total);
+    return total;
+}
+
+/**
+ * Pack a dense row-major d x n int8 matrix into a block-sparse segment at
+ * `dst`, keeping only blocks with a nonzero weight.
+ *
+ * @return bytes written, or -1 for a bad shape or if `cap` is too small
+ */
+static inline long fb_bsr_build(void *dst, size_t cap, const int8_t *w, uint32_t n, uint32_t d,
+                                uint32_t br, uint32_t bc) {
+    size_t total = fb_bsr_bytes(w, n, d, br, bc);
+    if (total == 0 || total > cap) {
+        return -1;
+    }
+    uint32_t num_blocks = fb_bsr_count_blocks(w, n, d, br, bc);
+    fb_bsr_header_t *hdr = (fb_bsr_header_t *)dst;
+    fb_memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = FB_BSR_MAGIC;
+    hdr->version = FB_BSR_VERSION;
+    hdr->n = n;
+    hdr->d = d;
+    hdr->br = (uint16_t)br;
+    hdr->bc = (uint16_t)bc;
+    hdr->num_blocks = num_blocks;
+    fb_bsr_layout(d, br, bc, num_blocks, &hdr->row_ptr_off, &hdr->col_idx_off,
+                  &hdr->blocks_off, &total);
+
+    uint8_t *base = (uint8_t *)dst;
+    uint32_t *row_ptr = (uint32_t *)(base + hdr->row_ptr_off);
+    uint32_t *col_idx = (uint32_t *)(base + hdr->col_idx_off);
+    int8_t *blocks = (int8_t *)(base + hdr->blocks_off);
+    uint32_t k = 0;
+    for (uint32_t R = 0; R < fb_bsr_div_up(d, br); R++) {
+        row_ptr[R] = k;
+        for (uint32_t C = 0; C < fb_bsr_div_up(n, bc); C++) {
+            uint32_t r0 = R * br, c0 = C * bc;
+            if (fb_bsr_block_zero(w, n, d, r0, c0, br, bc)) {
+                continue;
+            }
+            int8_t *blk = blocks + (size_t)k * br * bc;
+            for (uint32_t r = 0; r < br; r++) {
+                for (uint32_t c = 0; c < bc; c++) {
+                    int ok = r0 + r < d && c0 + c < n;
+                    blk[r * bc + c] = ok ? w[(size_t)(r0 + r) * n + c0 + c] : 0;
+                }
+            }
+            col_idx[k++] = C;
+        }
+    }
+    row_ptr[fb_bsr_div_up(d, br)] = k;
+    fb_memset(blocks + (size_t)k * br * bc, 0,
+              FB_ALIGN4((size_t)k * br * bc) - (size_t)k * br * bc);
+    return (long)total;
+}
+
+/**
+ * Validate a block-sparse segment of `bytes` at `base` (header, section
+ * bounds, monotonic row_ptr ending at num_blocks, col_idx in range and
+ * ascending) once, and bind `m` to it.
+ *
+ * @return 0 on success, -1 if malformed
+ */
+static inline int fb_bsr_open(fb_bsr_t *m, const void *base, size_t bytes) {
+    const fb_bsr_header_t *hdr = (const fb_bsr_header_t *)base;
+    fb_memset(m, 0, sizeof(*m));
+    if (bytes < sizeof(*hdr) || hdr->magic != FB_BSR_MAGIC || hdr->version != FB_BSR_VERSION ||
+        hdr->n == 0 || hdr->d == 0 || hdr->br == 0 || hdr->bc == 0) {
+        return -1;
+    }
+    uint32_t rp, ci, bo;
+    size_t total;
+    fb_bsr_layout(hdr->d, hdr->br, hdr->bc, hdr->num_blocks, &rp, &ci, &bo, &total);
+    if (hdr->row_ptr_off != rp || hdr->col_idx_off != ci || hdr->blocks_off != bo ||
+        total > bytes) {
+        return -1;
+    }
+    const uint8_t *b = (const uint8_t *)base;
+    const uint32_t *row_ptr = (const uint32_t *)(b + rp);
+    const uint32_t *col_idx = (const uint32_t *)(b + ci);
+    uint32_t block_rows = fb_bsr_div_up(hdr->d, hdr->br);
+    uint32_t block_cols = fb_bsr_div_up(hdr->n, hdr->bc);
+    if (row_ptr[0] != 0 || row_ptr[block_rows] != hdr->num_blocks) {
+        return -1;
+    }
+    for (uint32_t R = 0; R < block_rows; R++) {
+        if (row_ptr[R] > row_ptr[R + 1u]) {
+            return -1;
+        }
+        for (uint32_t k = row_ptr[R]; k < row_ptr[R + 1u]; k++) {
+            if (col_idx[k] >= block_cols || (k > row_ptr[R] && col_idx[k] <= col_idx[k - 1u])) {
+                return -1;
+            }
+        }
+    }
+    m->hdr = hdr;
+    m->row_ptr = row_ptr;
+    m->col_idx = col_idx;
+    m->blocks = (const int8_t *)(b + bo);
+    m->n = hdr->n;
+    m->d = hdr->d;
+    m->br = hdr->br;
+    m->bc = hdr->bc;
+    m->block_rows = block_rows;
+    m->block_cols = block_cols;
+    m->num_blocks = hdr->num_blocks;
+    return 0;
+}
+
+/* Stored blocks / all blocks, in Q16 (FB_Q16_ONE = dense). */
+static inline uint32_t fb_bsr_density_q16(const fb_bsr_t *m) {
+    uint64_t all = (uint64_t)m->block_rows * m->block_cols;
+    return all ? (uint32_t)(((uint64_t)m->num_blocks << 16) / all) : 0;
+}
+
+/* Scratch for the matmul: one prequant x slice per block column + br dots. */
+static inline size_t fb_bsr_scratch_bytes(const fb_bsr_t *m) {
+    return (size_t)m->block_cols * FB_PREQUANT_BYTES(m->bc) + (size_t)m->br * sizeof(int32_t);
+}
+
+/* Copy x into per-block-column prequant slices at unit scale, zero padded. */
+static inline void fb_bsr_stage_x(const fb_bsr_t *m, const void *x_prequant, uint8_t *scratch) {
+    const int8_t *x = (const int8_t *)x_prequant;
+    size_t stride = FB_PREQUANT_BYTES(m->bc);
+    for (uint32_t C = 0; C < m->block_cols; C++) {
+        uint8_t *slice = scratch + (size_t)C * stride;
+        uint32_t c0 = C * m->bc;
+        uint32_t len = m->n - c0 < m->bc ? m->n - c0 : m->bc;
+        fb_memcpy(slice, x + c0, len);
+        fb_memset(slice + len, 0, FB_ALIGN4(m->bc) - len);
+        *fb_prequant_scale(slice, m->bc) = FB_Q16_ONE;
+    }
+}
+
+/* Block rows [R0, R1): raw dots accumulated, then scaled into out. */
+static inline void fb_bsr_block_rows(int32_t *out, const void *x_prequant, const fb_bsr_t *m,
+                                     int32_t w_scale_q16, uint8_t *scratch, uint32_t R0,
+                                     uint32_t R1) {
+    __extension__ typedef __int128 fb_i128;
+    size_t stride = FB_PREQUANT_BYTES(m->bc);
+    int32_t *dots = (int32_t *)(scratch + (size_t)m->block_cols * stride);
+    int64_t x_scale = *fb_prequant_scale((void *)(uintptr_t)x_prequant, m->n);
+    size_t block_bytes = (size_t)m->br * m->bc;
+
+    for (uint32_t R = R0; R < R1; R++) {
+        uint32_t r0 = R * m->br;
+        uint32_t rows = m->d - r0 < m->br ? m->d - r0 : m->br;
+        int32_t *acc = out + r0; /* raw dots: |dot| <= 127 * 128 * n fits i32 */
+        for (uint32_t r = 0; r < rows; r++) {
+            acc[r] = 0;
+        }
+        for (uint32_t k = m->row_ptr[R]; k < m->row_ptr[R + 1u]; k++) {
+            /* unit scales: (dot * 65536 * 65536) >> 32 = dot exactly */
+            fb_matmul_i8_i8(dots, scratch + (size_t)m->col_idx[k] * stride,
+                            m->blocks + (size_t)k * block_bytes, FB_Q16_ONE, m->bc, rows);
+            for (uint32_t r = 0; r < rows; r++) {
+                acc[r] += dots[r];
+            }
+        }
+        for (uint32_t r = 0; r < rows; r++) {
+            acc[r] = (int32_t)(((fb_i128)acc[r] * w_scale_q16 * x_scale) >> 32);
+        }
+    }
+}
+
+/**
+ * Block-sparse MATMUL_I8_I8: out[d] from x_prequant (n activations) and
+ * the blocks of `m`, identical to fb_matmul_i8_i8 on the dense matrix.
+ * One MATMUL_I8_I8 per stored block.
+ */
+static inline void fb_bsr_matmul_i8_i8(int32_t *out, const void *x_prequant, const fb_bsr_t *m,
+                                       int32_t w_scale_q16, void *scratch) {
+    fb_bsr_stage_x(m, x_prequant, (uint8_t *)scratch);
+    fb_bsr_block_rows(out, x_prequant, m, w_scale_q16, (uint8_t *)scratch, 0, m->block_rows);
+}
+
+/**
+ * Resumable form on the row cursor: each call finishes the block rows
+ * covering the next max_rows output rows (0 = all; rounded up to whole
+ * blocks), then yields like MATMUL_I8_I8_PARTIAL while rows remain.
+ * The cursor counts output rows and stays at d when done.
+ *
+ * @return 1 once all d rows are done, else 0
+ */
+static inline int fb_bsr_matmul_i8_i8_partial(int32_t *out, const void *x_prequant,
+                                              const fb_bsr_t *m, int32_t w_scale_q16,
+                                              void *scratch, fb_row_state_t *state) {
+    if (state->cursor >= m->d) {
+        return 1;
+    }
+    uint32_t R0 = state->cursor / m->br;
+    uint32_t R1 = m->block_rows;
+    if (state->max_rows) {
+        uint32_t span = fb_bsr_div_up(state->max_rows, m->br);
+        R1 = span < m->block_rows - R0 ? R0 + span : m->block_rows;
+    }
+    fb_bsr_stage_x(m, x_prequant, (uint8_t *)scratch);
+    fb_bsr_block_rows(out, x_prequant, m, w_scale_q16, (uint8_t *)scratch, R0, R1);
+    uint32_t end = R1 * m->br;
+    state->cursor = end < m->d ? end : m->d;
+    if (state->cursor >= m->d) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FROSTBITE_SPARSE_H */
@@ -0,0 +1,283 @@
+/**
+ * Frostbite VM - streaming time-series windows
+ *
+ * A ring buffer of the last `window` samples (each `features` Q16 values)
+ * with running statistics, kept in a RAM segment between invocations so a
+ * model that gets one new sample per slot updates its features in O(features)
+ * instead of re-reading the whole window:
+ *
+ *   fb_ring_header_t (40 bytes)
+ *   q16 samples[window][features]   time-major ring, slot `head` is written next
+ *   i64 sum[features]               sum of the held samples (Q16)
+ *   i64 sum_sq[features]            sum of (x * x) >> 16 (Q16)
+ *   q16 ema[features]               ema += alpha * (x - ema), seeded by the first sample
+ *
+ * The sums are integers updated by adding the new sample and subtracting the
+ * evicted one (the same rounded square both ways), so they never drift.
+ *
+ *   fb_ring_t r;
+ *   void *seg = (void *)(uintptr_t)FB_SEGMENT_ADDR(2, 0);
+ *   if (fb_ring_open(&r, seg, FB_RING_BYTES(128, 16)) != 0) {
+ *       fb_ring_init(seg, FB_RING_BYTES(128, 16), 128, 16, FB_Q16(0.1));
+ *       fb_ring_open(&r, seg, FB_RING_BYTES(128, 16));
+ *   }
+ *   fb_ring_push(&r, sample);
+ *   fb_q16_t m = fb_ring_mean(&r, 0), v = fb_ring_var(&r, 0), e = fb_ring_ema(&r, 0);
+ */
+
+#ifndef FROSTBITE_STREAM_H
+#define FROSTBITE_STREAM_H
+
+#include "frostbite.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_RING_MAGIC   0x31474E52u /* "RNG1" */
+#define FB_RING_VERSION 1u
+
+typedef struct {
+    uint32_t magic;         /* FB_RING_MAGIC */
+    uint16_t version;       /* FB_RING_VERSION */
+    uint16_t flags;         /* reserved, 0 */
+    uint32_t window;        /* samples held at most */
+    uint32_t features;      /* Q16 values per sample */
+    uint32_t head;          /* slot the next sample goes to (the oldest when full) */
+    uint32_t count;         /* samples held, <= window */
+    uint64_t seq;           /* samples pushed since init */
+    int32_t ema_alpha;      /* Q16 smoothing factor, 0..FB_Q16_ONE */
+    uint32_t reserved;      /* 0 */
+} fb_ring_header_t;
+
+/* Validated view of a ring segment */
+typedef struct {
+    fb_ring_header_t *hdr;
+    fb_q16_t *samples;
+    int64_t *sum;
+    int64_t *sum_sq;
+    fb_q16_t *ema;
+    uint32_t window;
+    uint32_t features;
+} fb_ring_t;
+
+#define FB_RING_SUMS_OFFSET(window, features) \
+    ((sizeof(fb_ring_header_t) + (size_t)(window) * (features) * sizeof(fb_q16_t) + 7u) & ~(size_t)7u)
+#define FB_RING_BYTES(window, features) \
+    (FB_RING_SUMS_OFFSET(window, features) + (size_t)(features) * (2u * sizeof(int64_t) + sizeof(fb_q16_t)))
+
+static inline void fb_ring_bind(fb_ring_t *r, void *base) {
+    fb_ring_header_t *hdr = (fb_ring_header_t *)base;
+    uint8_t *b = (uint8_t *)base;
+    size_t sums = FB_RING_SUMS_OFFSET(hdr->window, hdr->features);
+    r->hdr = hdr;
+    r->samples = (fb_q16_t *)(b + sizeof(*hdr));
+    r->sum = (int64_t *)(b + sums);
+    r->sum_sq = r->sum + hdr->features;
+    r->ema = (fb_q16_t *)(r->sum_sq + hdr->features);
+    r->window = hdr->window;
+    r->features = hdr->features;
+}
+
+/**
+ * Lay out an empty ring in `mem` (8-byte aligned).
+ *
+ * @return 0, or -1 for a bad shape or alpha, or if `cap` is too small
+ */
+static inline int fb_ring_init(void *mem, size_t cap, uint32_t window, uint32_t features,
+                               int32_t ema_alpha_q16) {
+    if (window == 0 || features == 0 || ema_alpha_q16 < 0 || ema_alpha_q16 > FB_Q16_ONE ||
+        FB_RING_BYTES(window, features) > cap) {
+        return -1;
+    }
+    fb_memset(mem, 0, FB_RING_BYTES(window, features));
+    fb_ring_header_t *hdr = (fb_ring_header_t *)mem;
+    hdr->magic = FB_RING_MAGIC;
+    hdr->version = FB_RING_VERSION;
+    hdr->window = window;
+    hdr->features = features;
+    hdr->ema_alpha = ema_alpha_q16;
+    return 0;
+}
+
+/**
+ * Validate a ring segment of `bytes` at `base` (header, size, cursor) and
+ * bind `r` to it. The ring keeps living in the segment; `r` is a view.
+ *
+ * @return 0 on success, -1 if missing or malformed
+ */
+static inline int fb_ring_open(fb_ring_t *r, void *base, size_t bytes) {
+    const fb_ring_header_t *hdr = (const fb_ring_header_t *)base;
+    fb_memset(r, 0, sizeof(*r));
+    if (bytes < sizeof(*hdr) || hdr->magic != FB_RING_MAGIC || hdr->version != FB_RING_VERSION ||
+        hdr->window == 0 || hdr->features == 0 || hdr->head >= hdr->window ||
+        hdr->count > hdr->window || hdr->ema_alpha < 0 || hdr->ema_alpha > FB_Q16_ONE ||
+        (uint64_t)hdr->window * hdr->features > (uint64_t)bytes ||
+        FB_RING_BYTES(hdr->window, hdr->features) > bytes) {
+        return -1;
+    }
+    fb_ring_bind(r, base);
+    return 0;
+}
+
+static inline int64_t fb_ring_sq(fb_q16_t x) {
+    return ((int64_t)x * x) >> 16;
+}
+
+/**
+ * Append one sample of `features` Q16 values, evicting the oldest once the
+ * window is full. O(features).
+ */
+static inline void fb_ring_push(fb_ring_t *r, const fb_q16_t *sample) {
+    fb_ring_header_t *hdr = r->hdr;
+    fb_q16_t *slot = r->samples + (size_t)hdr->head * r->features;
+    int full = hdr->count == r->window;
+    int first = hdr->seq == 0;
+
+    for (uint32_t f = 0; f < r->features; f++) {
+        fb_q16_t x = sample[f];
+        if (full) {
+            r->sum[f] -= slot[f];
+            r->sum_sq[f] -= fb_ring_sq(slot[f]);
+        }
+        r->sum[f] += x;
+        r->sum_sq[f] += fb_ring_sq(x);
+        if (first) {
+            r->ema[f] = x;
+        } else {
+            int64_t e = r->ema[f];
+            r->ema[f] = (fb_q16_t)(e + (((int64_t)x - e) * hdr->ema_alpha >> 16));
+        }
+        slot[f] = x;
+    }
+    hdr->head = hdr->head + 1u == r->window ? 0 : hdr->head + 1u;
+    hdr->count += !full;
+    hdr->seq++;
+}
+
+/**
+ * Empty the window and the EMA, keeping the shape and alpha.
+ */
+static inline void fb_ring_reset(fb_ring_t *r) {
+    fb_memset(r->sum, 0, (size_t)r->features * (2u * sizeof(int64_t) + sizeof(fb_q16_t)));
+    r->hdr->head = 0;
+    r->hdr->count = 0;
+    r->hdr->seq = 0;
+}
+
+/* Signed division rounding half away from zero. */
+static inline int64_t fb_ring_div(int64_t num, uint32_t den) {
+    int64_t half = (int64_t)(den / 2u);
+    return (num < 0 ? num - half : num + half) / (int64_t)den;
+}
+
+/**
+ * Mean of feature f over the held samples (0 when empty).
+ */
+static inline fb_q16_t fb_ring_mean(const fb_ring_t *r, uint32_t f) {
+    uint32_t n = r->hdr->count;
+    return n ? fb_q16_sat(fb_ring_div(r->sum[f], n)) : 0;
+}
+
+/*
+ * Unsigned 128-bit by 32-bit division, one 32-bit limb at a time, so only
+ * 64-bit divides are emitted (a plain 128-bit `/` calls __divti3, which the
+ * -nostdlib link does not provide).
+ */
+__extension__ typedef unsigned __int128 fb_ring_u128;
+
+static inline fb_ring_u128 fb_ring_udiv128(fb_ring_u128 num, uint32_t den) {
+    fb_ring_u128 q = 0;
+    uint64_t rem = 0;
+    for (int shift = 96; shift >= 0; shift -= 32) {
+        uint64_t cur = rem << 32 | (uint32_t)(num >> shift);
+        q = q << 32 | (uint32_t)(cur / den);
+        rem = cur % den;
+    }
+    return q;
+}
+
+/**
+ * Population variance of feature f, E[x^2] - E[x]^2 in Q16, clamped at 0.
+ * Evaluated as (n * sum_sq - sum^2 / 65536) / n^2 in 128 bits, so only the
+ * per-sample rounding of the squares remains, not a rounded mean squared.
+ */
+static inline fb_q16_t fb_ring_var(const fb_ring_t *r, uint32_t f) {
+    __extension__ typedef __int128 fb_i128;
+    uint32_t n = r->hdr->count;
+    if (n == 0) {
+        return 0;
+    }
+    fb_i128 num = ((fb_i128)r->sum_sq[f] * n << 16) - (fb_i128)r->sum[f] * r->sum[f];
+    if (num <= 0) {
+        return 0;
+    }
+    /* floor(floor(num / n) / n) == floor(num / n^2) */
+    fb_ring_u128 v = fb_ring_udiv128(fb_ring_udiv128((fb_ring_u128)num, n), n) >> 16;
+    return v > INT32_MAX ? INT32_MAX : (fb_q16_t)v;
+}
+
+/**
+ * Standard deviation of feature f (Q16).
+ */
+static inline fb_q16_t fb_ring_std(const fb_ring_t *r, uint32_t f) {
+    return fb_q16_sqrt(fb_ring_var(r, f));
+}
+
+/**
+ * Exponential moving average of feature f over every sample pushed.
+ */
+static inline fb_q16_t fb_ring_ema(const fb_ring_t *r, uint32_t f) {
+    return r->ema[f];
+}
+
+/**
+ * Feature f of the sample pushed `age` samples ago (0 = newest). `age` must
+ * be below the held count.
+ */
+static inline fb_q16_t fb_ring_at(const fb_ring_t *r, uint32_t age, uint32_t f) {
+    uint32_t slot = r->hdr->head + r->window - 1u - age;
+    slot = slot >= r->window ? slot - r->window : slot;
+    return r->samples[(size_t)slot * r->features + f];
+}
+
+/**
+ * Mean, variance and EMA of every feature into three `features`-long
+ * arrays (any may be NULL). O(features).
+ */
+static inline void fb_ring_stats(const fb_ring_t *r, fb_q16_t *mean, fb_q16_t *var,
+                                 fb_q16_t *ema) {
+    for (uint32_t f = 0; f < r->features; f++) {
+        if (mean) {
+            mean[f] = fb_ring_mean(r, f);
+        }
+        if (var) {
+            var[f] = fb_ring_var(r, f);
+        }
+        if (ema) {
+            ema[f] = r->ema[f];
+        }
+    }
+}
+
+/**
+ * Copy the held samples oldest first into dst[count][features], the
+ * time-major payload order of the time_series schema, in at most two copies.
+ *
+ * @return samples copied
+ */
+static inline uint32_t fb_ring_copy_window(const fb_ring_t *r, fb_q16_t *dst) {
+    uint32_t n = r->hdr->count;
+    uint32_t start = n == r->window ? r->hdr->head : 0;
+    size_t row = (size_t)r->features * sizeof(fb_q16_t);
+    uint32_t first = r->window - start < n ? r->window - start : n;
+    fb_memcpy(dst, r->samples + (size_t)start * r->features, first * row);
+    fb_memcpy(dst + (size_t)first * r->features, r->samples, (n - first) * row);
+    return n;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FROSTBITE_STREAM_H */
@@ -0,0 +1,122 @@
+/**
+ * Frostbite VM - stackless guest tasks
+ *
+ * Resume points for guests that run across many transactions. A task is a
+ * function whose state lives in a struct (usually in a RAM segment) that
+ * starts with fb_task_t; the FB_TASK_* macros record where it stopped, so a
+ * fresh restart (EXECUTE_RESTART_V3) re-enters at the last await instead of
+ * the top. A plain resume (EXECUTE_V3) just continues at the PC, so the
+ * macros cost one store per step there.
+ *
+ *   typedef struct { fb_task_t task; uint32_t layer; } model_t;
+ *
+ *   static int model_run(model_t *m) {
+ *       FB_TASK_BEGIN(&m->task);
+ *       for (m->layer = 0; m->layer < N_LAYERS; m->layer++) {
+ *           FB_AWAIT_ROWS(&m->task, d, fb_matmul_i8_i8_partial(out, x, w[m->layer],
+ *                                                  scale, n, d, &m->task.rows));
+ *       }
+ *       FB_TASK_END(&m->task);
+ *   }
+ *
+ *   model_t *m = (model_t *)fb_task_attach(FB_SEGMENT_ADDR(2, 0), sizeof(*m), 16);
+ *   model_run(m);
+ *
+ * Rules (protothread-style): locals do not survive a restart, so keep loop
+ * counters in the state struct; use at most one FB_* await per line; do not
+ * await inside a nested switch.
+ */
+
+#ifndef FROSTBITE_TASK_H
+#define FROSTBITE_TASK_H
+
+#include "frostbite.h"
+
+#define FB_TASK_MAGIC 0x4B534154u /* "TASK" */
+#define FB_TASK_DONE  0xFFFFFFFFu
+
+typedef struct {
+    uint32_t magic;      /* FB_TASK_MAGIC once initialized */
+    uint32_t resume;     /* resume point (__LINE__), 0 = start, FB_TASK_DONE */
+    fb_row_state_t rows; /* cursor for FB_AWAIT_ROWS */
+} fb_task_t;
+
+/**
+ * Bind `bytes` of task state at `addr`. State from an earlier run (magic
+ * intact) is kept; otherwise it is zeroed and rows.max_rows set.
+ *
+ * @return addr, as the caller's state struct pointer
+ */
+static inline void *fb_task_attach(uint64_t addr, size_t bytes, uint32_t max_rows) {
+    fb_task_t *t = (fb_task_t *)(uintptr_t)addr;
+    if (t->magic != FB_TASK_MAGIC) {
+        fb_memset(t, 0, bytes);
+        t->magic = FB_TASK_MAGIC;
+        t->rows.max_rows = max_rows;
+    }
+    return t;
+}
+
+/**
+ * Start the task from the top on its next call (state fields are kept).
+ */
+static inline void fb_task_restart(fb_task_t *t) {
+    t->resume = 0;
+    t->rows.cursor = 0;
+}
+
+static inline int fb_task_done(const fb_task_t *t) {
+    return t->resume == FB_TASK_DONE;
+}
+
+#define FB_TASK_BEGIN(t)    \
+    switch ((t)->resume) {  \
+    case 0:
+
+/* End the task body; the function returns 1 now and on every later call. */
+#define FB_TASK_END(t)               \
+    (t)->resume = FB_TASK_DONE;      \
+    /* fallthrough */                \
+    case FB_TASK_DONE:;              \
+    }                                \
+    return 1
+
+/* End this transaction; a restart continues after it. */
+#define FB_TASK_YIELD(t)                  \
+    do {                                  \
+        fb_yield_state_t fb_ys_ = {0};    \
+        (t)->resume = __LINE__;           \
+        fb_yield(&fb_ys_);                \
+        /* fallthrough */                 \
+        case __LINE__:;                   \
+    } while (0)
+
+/*
+ * Run `call` (a partial kernel on &(t)->rows) until `total` rows are done.
+ * The kernel yields between chunks; a restart resumes at the saved cursor.
+ */
+#define FB_AWAIT_ROWS(t, total, call)                          \
+    do {                                                       \
+        (t)->rows.cursor = 0;                                  \
+        (t)->resume = __LINE__;                                \
+        /* fallthrough */                                      \
+        case __LINE__:                                         \
+        while ((t)->rows.cursor < (uint32_t)(total)) {         \
+            call;                                              \
+        }                                                      \
+    } while (0)
+
+/*
+ * Repeat `expr` until it returns non-zero, e.g. a *_resumable helper or
+ * fb_matmul_i8_i8_bias_act whose state lives in the task struct.
+ */
+#define FB_AWAIT(t, expr)               \
+    do {                                \
+        (t)->resume = __LINE__;         \
+        /* fallthrough */               \
+        case __LINE__:                  \
+        while (!(expr)) {               \
+        }                               \
+    } while (0)
+
+#endif /* FROSTBITE_TASK_H */
@@ -0,0 +1,248 @@
+/**
+ * Frostbite VM - C++20 coroutine tasks
+ *
+ * Coroutine form of frostbite_task.h, for one invocation only. Frames are
+ * carved from an arena that the guest may point at a RAM segment
+ * (fb::task_arena) to keep them out of scratch, but the arena cursor is a
+ * static and frames hold code and stack addresses, so a task survives plain
+ * resumes (EXECUTE_V3, fb_yield) but not a fresh restart (EXECUTE_RESTART_V3):
+ * that runs main again and builds new frames. Work that must continue across
+ * fresh restarts belongs in frostbite_task.h. fb::run drives one or more tasks
+ * round-robin, so each transaction does a chunk of every task:
+ *
+ *   fb::task layer(fb_row_state_t *st, ...) {
+ *       co_await fb::rows(st, d, [&] { fb_matmul_i8_i8_partial(..., st); });
+ *       co_await fb::next_tx();
+ *       ...
+ *   }
+ *
+ *   fb::task_arena(FB_SEGMENT_ADDR(2, 0), 4096);
+ *   fb::task t = layer(&st, ...);
+ *   fb::run(t);
+ *
+ * Needs -std=c++20. Uses <coroutine> when the headers are present and a
+ * minimal std::coroutine_handle shim otherwise (freestanding builds).
+ */
+
+#ifndef FROSTBITE_TASK_HPP
+#define FROSTBITE_TASK_HPP
+
+#include "frostbite_task.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#if __has_include(<coroutine>)
+#include <coroutine>
+#else
+namespace std {
+
+template <class R, class... Args>
+struct coroutine_traits {
+    using promise_type = typename R::promise_type;
+};
+
+template <class P = void>
+struct coroutine_handle;
+
+template <>
+struct coroutine_handle<void> {
+    void *frame_ = nullptr;
+    static coroutine_handle from_address(void *p) noexcept {
+        coroutine_handle h;
+        h.frame_ = p;
+        return h;
+    }
+    void *address() const noexcept { return frame_; }
+    explicit operator bool() const noexcept { return frame_ != nullptr; }
+    bool done() const noexcept { return __builtin_coro_done(frame_); }
+    void resume() const { __builtin_coro_resume(frame_); }
+    void destroy() const { __builtin_coro_destroy(frame_); }
+};
+
+template <class P>
+struct coroutine_handle : coroutine_handle<void> {
+    static coroutine_handle from_promise(P &p) noexcept {
+        coroutine_handle h;
+        h.frame_ = __builtin_coro_promise(&p, alignof(P), true);
+        return h;
+    }
+    static coroutine_handle from_address(void *p) noexcept {
+        coroutine_handle h;
+        h.frame_ = p;
+        return h;
+    }
+    P &promise() const {
+        return *static_cast<P *>(__builtin_coro_promise(frame_, alignof(P), false));
+    }
+};
+
+struct suspend_always {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(coroutine_handle<>) const noexcept {}
+    void await_resume() const noexcept {}
+};
+
+struct suspend_never {
+    bool await_ready() const noexcept { return true; }
+    void await_suspend(coroutine_handle<>) const noexcept {}
+    void await_resume() const noexcept {}
+};
+
+} // namespace std
+#endif
+
+namespace fb {
+
+/* Bump arena for coroutine frames; frames are never freed (restart the arena). */
+struct frame_arena_t {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+};
+
+inline frame_arena_t &frame_arena() {
+    static frame_arena_t arena = {nullptr, 0, 0};
+    return arena;
+}
+
+/**
+ * Place coroutine frames at `addr` (e.g. FB_SEGMENT_ADDR(seg, off)), from its
+ * start: earlier frames there are overwritten, not reattached. Without an
+ * arena frames come from fb_malloc.
+ */
+inline void task_arena(uint64_t addr, size_t bytes) {
+    frame_arena_t &a = frame_arena();
+    a.base = reinterpret_cast<uint8_t *>(static_cast<uintptr_t>(addr));
+    a.size = bytes;
+    a.used = 0;
+}
+
+inline void *frame_alloc(size_t bytes) {
+    frame_arena_t &a = frame_arena();
+    if (!a.base) {
+        return fb_malloc(bytes);
+    }
+    size_t off = (a.used + 15u) & ~static_cast<size_t>(15u);
+    if (off + bytes > a.size) {
+        fb_print_str("fb::task_arena: out of space for a coroutine frame.\n");
+        fb_exit(1);
+    }
+    a.used = off + bytes;
+    return a.base + off;
+}
+
+class task {
+public:
+    struct promise_type {
+        bool yield_tx = false;               /* set by next_tx */
+        bool (*chunk)(void *) = nullptr;     /* pending fb::rows chunk, 1 = done */
+        void *chunk_ctx = nullptr;
+
+        task get_return_object() noexcept {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        static task get_return_object_on_allocation_failure() noexcept { return task(); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+        static void *operator new(size_t bytes) noexcept { return frame_alloc(bytes); }
+        static void operator delete(void *) noexcept {}
+    };
+    using handle = std::coroutine_handle<promise_type>;
+
+    task() = default;
+    explicit task(handle h) : h_(h) {}
+    task(task &&o) noexcept : h_(o.h_) { o.h_ = handle(); }
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    bool done() const { return !h_ || h_.done(); }
+
+    /**
+     * Run one pending fb::rows chunk, or resume to the next suspension point.
+     *
+     * @return true if the task asked to end the transaction (next_tx)
+     */
+    bool step() {
+        if (done()) {
+            return false;
+        }
+        promise_type &p = h_.promise();
+        if (p.chunk) {
+            if (!p.chunk(p.chunk_ctx)) {
+                return false;
+            }
+            p.chunk = nullptr;
+        }
+        p.yield_tx = false;
+        h_.resume();
+        return !h_.done() && p.yield_tx;
+    }
+
+private:
+    handle h_;
+};
+
+/* co_await fb::next_tx(): end this transaction (like FB_TASK_YIELD). */
+struct next_tx {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(task::handle h) const noexcept { h.promise().yield_tx = true; }
+    void await_resume() const noexcept {}
+};
+
+/*
+ * co_await fb::rows(state, total, fn): fn (a partial kernel on state) runs one
+ * chunk per fb::run pass until state->cursor reaches total. The kernel yields
+ * the transaction itself, so the driver does not.
+ */
+template <class F>
+struct rows_awaiter {
+    fb_row_state_t *state;
+    uint32_t total;
+    F fn;
+
+    static bool run_chunk(void *self) {
+        rows_awaiter *a = static_cast<rows_awaiter *>(self);
+        a->fn();
+        return a->state->cursor >= a->total;
+    }
+    bool await_ready() const noexcept { return state->cursor >= total; }
+    void await_suspend(task::handle h) noexcept {
+        h.promise().chunk = &run_chunk;
+        h.promise().chunk_ctx = this;
+    }
+    void await_resume() const noexcept {}
+};
+
+template <class F>
+inline rows_awaiter<F> rows(fb_row_state_t *state, uint32_t total, F fn) {
+    state->cursor = 0;
+    return rows_awaiter<F>{state, total, fn};
+}
+
+/**
+ * Drive tasks round-robin until all finish. Each pass resumes every live task
+ * once; a next_tx request from any of them ends the transaction.
+ */
+template <class... Tasks>
+inline void run(Tasks &...tasks) {
+    for (;;) {
+        bool live = false;
+        bool yield_tx = false;
+        ((yield_tx |= tasks.step(), live |= !tasks.done()), ...);
+        if (!live) {
+            return;
+        }
+        if (yield_tx) {
+            fb_yield_state_t ys = {0};
+            fb_yield(&ys);
+        }
+    }
+}
+
+} // namespace fb
+
+#endif /* __cpp_impl_coroutine */
+
+#endif /* FROSTBITE_TASK_HPP */
@@ -0,0 +1,318 @@
+/**
+ * Frostbite VM - flattened decision-tree ensembles
+ *
+ * Trees are stored complete and breadth-first, so evaluation is a fixed
+ * number of steps with no pointer chasing and no data-dependent loop bound:
+ *
+ *   fb_tree_header_t (32 bytes)
+ *   per tree, tree_bytes = FB_TREE_BYTES(depth) apart:
+ *     fb_tree_node_t nodes[2^depth - 1]   {feature, threshold}, BFS order
+ *     i32            leaves[2^depth]      leaf values, left to right
+ *
+ * The children of node i are 2i + 1 (x[feature] <= threshold) and 2i + 2,
+ * as in the tree_q16_v1 walk of the guest_tree template. Each tree costs
+ * exactly `depth` compare-and-index steps, every ensemble call
+ * num_trees * depth, whatever the input.
+ *
+ * fb_tree_build converts cauldron's tree_q16_v1 blob (20-byte nodes with
+ * explicit left/right, see convert.py) in the guest or on the client;
+ * scripts/fb_treepack.py does the same offline. Leaves above the deepest
+ * level are padded with pass-through nodes (threshold INT32_MAX, always
+ * left) over copies of the leaf, so results match the pointer walk.
+ *
+ *   fb_tree_ensemble_t e;
+ *   if (fb_tree_open(&e, (const void *)(uintptr_t)FB_SEGMENT_ADDR(1, 12), bytes) != 0) ...
+ *   int64_t score = fb_tree_eval_i32(&e, features);
+ */
+
+#ifndef FROSTBITE_TREE_H
+#define FROSTBITE_TREE_H
+
+#include "frostbite.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_TREE_MAGIC     0x31455254u /* "TRE1" */
+#define FB_TREE_VERSION   1u
+#define FB_TREE_MAX_DEPTH 16u
+
+typedef struct {
+    uint32_t magic;        /* FB_TREE_MAGIC */
+    uint16_t version;      /* FB_TREE_VERSION */
+    uint16_t depth;        /* internal levels per tree, 0..FB_TREE_MAX_DEPTH */
+    uint32_t num_trees;
+    uint32_t num_features; /* feature vector length the nodes index */
+    uint32_t tree_bytes;   /* FB_TREE_BYTES(depth) */
+    int32_t base;          /* added to the leaf sum (e.g. GBDT base score, Q16) */
+    uint32_t reserved[2];  /* 0 */
+} fb_tree_header_t;
+
+typedef struct {
+    uint32_t feature;
+    int32_t threshold;     /* go right when x[feature] > threshold */
+} fb_tree_node_t;
+
+/* tree_q16_v1 node as convert.py writes it (feature < 0 marks a leaf) */
+typedef struct {
+    int32_t feature;
+    int32_t threshold;
+    int32_t left;
+    int32_t right;
+    int32_t value;
+} fb_tree_src_node_t;
+
+#define FB_TREE_NODES(depth) ((1u << (depth)) - 1u)
+#define FB_TREE_BYTES(depth) \
+    (FB_TREE_NODES(depth) * sizeof(fb_tree_node_t) + (1u << (depth)) * sizeof(int32_t))
+
+/* Validated view of an ensemble segment */
+typedef struct {
+    const fb_tree_header_t *hdr;
+    const uint8_t *trees;
+    uint32_t depth;
+    uint32_t num_trees;
+    uint32_t num_features;
+    uint32_t tree_bytes;
+    int32_t base;
+} fb_tree_ensemble_t;
+
+static inline const fb_tree_src_node_t *fb_tree_src(const void *src, size_t stride, size_t t) {
+    return (const fb_tree_src_node_t *)((const uint8_t *)src + t * stride);
+}
+
+/* Internal levels below source node idx, or -1 if malformed or too deep. */
+static inline int fb_tree_src_depth(const fb_tree_src_node_t *nodes, size_t node_count,
+                                    int32_t idx, uint32_t num_features, uint32_t level) {
+    if (idx < 0 || (size_t)idx >= node_count || level > FB_TREE_MAX_DEPTH) {
+        return -1;
+    }
+    const fb_tree_src_node_t *nd = &nodes[idx];
+    if (nd->feature < 0) {
+        return 0;
+    }
+    if ((uint32_t)nd->feature >= num_features) {
+        return -1;
+    }
+    int l = fb_tree_src_depth(nodes, node_count, nd->left, num_features, level + 1u);
+    int r = fb_tree_src_depth(nodes, node_count, nd->right, num_features, level + 1u);
+    if (l < 0 || r < 0) {
+        return -1;
+    }
+    return 1 + (l > r ? l : r);
+}
+
+/**
+ * Depth of the flattened ensemble: the deepest root-to-leaf path over
+ * `tree_count` trees of `node_count` nodes, `stride` bytes apart.
+ *
+ * @return depth, or -1 for a bad index or feature, a cycle, or a path deeper
+ *         than FB_TREE_MAX_DEPTH
+ */
+static inline int fb_tree_depth(const void *src, size_t node_count, size_t tree_count,
+                                size_t stride, uint32_t num_features) {
+    if (node_count == 0 || tree_count == 0 || stride < node_count * sizeof(fb_tree_src_node_t)) {
+        return -1;
+    }
+    int depth = 0;
+    for (size_t t = 0; t < tree_count; t++) {
+        int d = fb_tree_src_depth(fb_tree_src(src, stride, t), node_count, 0, num_features, 0);
+        if (d < 0) {
+            return -1;
+        }
+        depth = d > depth ? d : depth;
+    }
+    return depth;
+}
+
+/* Bytes fb_tree_build needs (0 if the source is malformed). */
+static inline size_t fb_tree_bytes(const void *src, size_t node_count, size_t tree_count,
+                                   size_t stride, uint32_t num_features) {
+    int depth = fb_tree_depth(src, node_count, tree_count, stride, num_features);
+    if (depth < 0) {
+        return 0;
+    }
+    return sizeof(fb_tree_header_t) + tree_count * FB_TREE_BYTES((uint32_t)depth);
+}
+
+/* Flatten the subtree at source node idx into BFS position pos. */
+static inline void fb_tree_put(fb_tree_node_t *nodes, int32_t *leaves, uint32_t depth,
+                               const fb_tree_src_node_t *src, int32_t idx, uint32_t pos,
+                               uint32_t level) {
+    const fb_tree_src_node_t *nd = &src[idx];
+    if (level == depth) {
+        leaves[pos - FB_TREE_NODES(depth)] = nd->value;
+        return;
+    }
+    if (nd->feature < 0) {
+        nodes[pos].feature = 0;
+        nodes[pos].threshold = INT32_MAX;
+        fb_tree_put(nodes, leaves, depth, src, idx, 2u * pos + 1u, level + 1u);
+        fb_tree_put(nodes, leaves, depth, src, idx, 2u * pos + 2u, level + 1u);
+        return;
+    }
+    nodes[pos].feature = (uint32_t)nd->feature;
+    nodes[pos].threshold = nd->threshold;
+    fb_tree_put(nodes, leaves, depth, src, nd->left, 2u * pos + 1u, level + 1u);
+    fb_tree_put(nodes, leaves, depth, src, nd->right, 2u * pos + 2u, level + 1u);
+}
+
+/**
+ * Flatten a tree_q16_v1 ensemble (`tree_count` trees of `node_count`
+ * fb_tree_src_node_t, `stride` bytes apart, root at node 0) into `dst`.
+ *
+ * @return bytes written, or -1 if the source is malformed or `cap` too small
+ */
+static inline long fb_tree_build(void *dst, size_t cap, const void *src, size_t node_count,
+                                 size_t tree_count, size_t stride, uint32_t num_features,
+                                 int32_t base) {
+    int depth = fb_tree_depth(src, node_count, tree_count, stride, num_features);
+    if (depth < 0 || tree_count > UINT32_MAX) {
+        return -1;
+    }
+    size_t tree_bytes = FB_TREE_BYTES((uint32_t)depth);
+    size_t total = sizeof(fb_tree_header_t) + tree_count * tree_bytes;
+    if (total > cap) {
+        return -1;
+    }
+    fb_tree_header_t *hdr = (fb_tree_header_t *)dst;
+    fb_memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = FB_TREE_MAGIC;
+    hdr->version = FB_TREE_VERSION;
+    hdr->depth = (uint16_t)depth;
+    hdr->num_trees = (uint32_t)tree_count;
+    hdr->num_features = num_features;
+    hdr->tree_bytes = (uint32_t)tree_bytes;
+    hdr->base = base;
+
+    uint8_t *tree = (uint8_t *)dst + sizeof(*hdr);
+    for (size_t t = 0; t < tree_count; t++, tree += tree_bytes) {
+        fb_tree_node_t *nodes = (fb_tree_node_t *)tree;
+        int32_t *leaves = (int32_t *)(tree + FB_TREE_NODES(depth) * sizeof(fb_tree_node_t));
+        fb_tree_put(nodes, leaves, (uint32_t)depth, fb_tree_src(src, stride, t), 0, 0, 0);
+    }
+    return (long)total;
+}
+
+/**
+ * Validate an ensemble segment of `bytes` at `base` (header, size, every
+ * node's feature below num_features) once, and bind `e` to it. Evaluation
+ * then needs no bounds checks.
+ *
+ * @return 0 on success, -1 if malformed
+ */
+static inline int fb_tree_open(fb_tree_ensemble_t *e, const void *base, size_t bytes) {
+    const fb_tree_header_t *hdr = (const fb_tree_header_t *)base;
+    fb_memset(e, 0, sizeof(*e));
+    if (bytes < sizeof(*hdr) || hdr->magic != FB_TREE_MAGIC || hdr->version != FB_TREE_VERSION ||
+        hdr->depth > FB_TREE_MAX_DEPTH || hdr->num_trees == 0 ||
+        hdr->tree_bytes != FB_TREE_BYTES(hdr->depth) ||
+        (uint64_t)hdr->num_trees * hdr->tree_bytes > bytes - sizeof(*hdr)) {
+        return -1;
+    }
+    if (hdr->depth > 0 && hdr->num_features == 0) {
+        return -1;
+    }
+    const uint8_t *trees = (const uint8_t *)base + sizeof(*hdr);
+    for (uint32_t t = 0; t < hdr->num_trees; t++) {
+        const fb_tree_node_t *nodes = (const fb_tree_node_t *)(trees + (size_t)t * hdr->tree_bytes);
+        for (uint32_t i = 0; i < FB_TREE_NODES(hdr->depth); i++) {
+            if (nodes[i].feature >= hdr->num_features) {
+                return -1;
+            }
+        }
+    }
+    e->hdr = hdr;
+    e->trees = trees;
+    e->depth = hdr->depth;
+    e->num_trees = hdr->num_trees;
+    e->num_features = hdr->num_features;
+    e->tree_bytes = hdr->tree_bytes;
+    e->base = hdr->base;
+    return 0;
+}
+
+/* Leaf value of tree t for i32 features. */
+static inline int32_t fb_tree_leaf_i32(const fb_tree_ensemble_t *e, uint32_t t, const int32_t *x) {
+    const uint8_t *tree = e->trees + (size_t)t * e->tree_bytes;
+    const fb_tree_node_t *nodes = (const fb_tree_node_t *)tree;
+    uint32_t i = 0;
+    for (uint32_t k = 0; k < e->depth; k++) {
+        const fb_tree_node_t *nd = &nodes[i];
+        i = 2u * i + 1u + (uint32_t)(x[nd->feature] > nd->threshold);
+    }
+    return ((const int32_t *)(tree + FB_TREE_NODES(e->depth) * sizeof(fb_tree_node_t)))
+        [i - FB_TREE_NODES(e->depth)];
+}
+
+/* Leaf value of tree t for int8 features (thresholds compare as i32). */
+static inline int32_t fb_tree_leaf_i8(const fb_tree_ensemble_t *e, uint32_t t, const int8_t *x) {
+    const uint8_t *tree = e->trees + (size_t)t * e->tree_bytes;
+    const fb_tree_node_t *nodes = (const fb_tree_node_t *)tree;
+    uint32_t i = 0;
+    for (uint32_t k = 0; k < e->depth; k++) {
+        const fb_tree_node_t *nd = &nodes[i];
+        i = 2u * i + 1u + (uint32_t)((int32_t)x[nd->feature] > nd->threshold);
+    }
+    return ((const int32_t *)(tree + FB_TREE_NODES(e->depth) * sizeof(fb_tree_node_t)))
+        [i - FB_TREE_NODES(e->depth)];
+}
+
+/**
+ * base + the leaf values of every tree for num_features i32 features.
+ */
+static inline int64_t fb_tree_eval_i32(const fb_tree_ensemble_t *e, const int32_t *x) {
+    int64_t sum = e->base;
+    for (uint32_t t = 0; t < e->num_trees; t++) {
+        sum += fb_tree_leaf_i32(e, t, x);
+    }
+    return sum;
+}
+
+/**
+ * base + the leaf values of every tree for num_features int8 features.
+ */
+static inline int64_t fb_tree_eval_i8(const fb_tree_ensemble_t *e, const int8_t *x) {
+    int64_t sum = e->base;
+    for (uint32_t t = 0; t < e->num_trees; t++) {
+        sum += fb_tree_leaf_i8(e, t, x);
+    }
+    return sum;
+}
+
+/**
+ * Resumable fb_tree_eval_i32: max_rows trees per call on the row cursor
+ * (0 = all), accumulating into *sum (start it at 0; base is added with the
+ * first tree), yielding while trees remain.
+ *
+ * @return 1 once every tree is summed, else 0
+ */
+static inline int fb_tree_eval_i32_partial(const fb_tree_ensemble_t *e, const int32_t *x,
+                                           int64_t *sum, fb_row_state_t *state) {
+    uint32_t t = state->cursor;
+    if (t >= e->num_trees) {
+        return 1;
+    }
+    if (t == 0) {
+        *sum += e->base;
+    }
+    uint32_t end = state->max_rows && state->max_rows < e->num_trees - t ? t + state->max_rows
+                                                                         : e->num_trees;
+    for (; t < end; t++) {
+        *sum += fb_tree_leaf_i32(e, t, x);
+    }
+    state->cursor = end;
+    if (end >= e->num_trees) {
+        return 1;
+    }
+    fb_yield_state_t ys = {0};
+    fb_yield(&ys);
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FROSTBITE_TREE_H */
@@ -3,9 +3,10 @@
  *
  * This file provides the entry point and initialization for C programs
  * running on the Frostbite VM. It:
- *   1. Sets up the stack pointer
+ *   1. Sets up the stack pointer (__stack_top from frostbite.ld)
  *   2. Initializes the global pointer (for relaxation)
- *   3. Zeros the BSS section
+ *   3. Resumes an fb_checkpoint warm image (fb-cc --warm-start), or zeros
+ *      the BSS section (not .noinit)
  *   4. Calls main() or _start()
  *   5. Exits with the return value
  *
@@ -16,6 +17,17 @@
 void _start(void) __attribute__((weak));
 int main(void) __attribute__((weak));
 
+/* fb-cc --trace: write the call tree (lib/frostbite_trace.c) before exiting */
+#if defined(FB_TRACE) && FB_TRACE
+void fb_trace_dump(void);
+#endif
+
+/* lib/frostbite_warm.c (--warm-start), linked only if fb_checkpoint is called */
+void fb_warm_resume(void) __attribute__((weak));
+
+/* Startup code runs before .bss is clear, so it is never instrumented */
+#define FB_CRT_NOTRACE __attribute__((no_instrument_function))
+
 /* BSS section boundaries (from linker script) */
 extern char __bss_start[];
 extern char __bss_end[];
@@ -28,22 +40,46 @@ static inline __attribute__((noreturn)) void _exit(long code) {
     __builtin_unreachable();
 }
 
-/* Zero BSS section */
-static inline void _init_bss(void) {
-    for (char *p = __bss_start; p < __bss_end; p++) {
-        *p = 0;
+/*
+ * Zero BSS section. The linker script aligns both ends to 8 bytes, so this
+ * is 8 doublewords per loop iteration plus a short tail, instead of one byte
+ * store (and branch) per byte. Build with fb-cc --rt-define
+ * FB_CRT_CLEAR_BSS=0 to skip it on fresh restarts when no static relies on
+ * zero-init; FB_NOINIT data (.noinit) is never cleared either way.
+ */
+#ifndef FB_CRT_CLEAR_BSS
+#define FB_CRT_CLEAR_BSS 1
+#endif
+
+static inline FB_CRT_NOTRACE void _init_bss(void) {
+#if FB_CRT_CLEAR_BSS
+    unsigned long *p = (unsigned long *)__bss_start;
+    unsigned long *end = (unsigned long *)__bss_end;
+    while (end - p >= 8) {
+        p[0] = 0;
+        p[1] = 0;
+        p[2] = 0;
+        p[3] = 0;
+        p[4] = 0;
+        p[5] = 0;
+        p[6] = 0;
+        p[7] = 0;
+        p += 8;
+    }
+    while (p < end) {
+        *p++ = 0;
     }
+#endif
 }
 
 /* True entry point - called by hardware at address 0 */
-void __attribute__((naked, section(".init"))) _entry(void) {
+void __attribute__((naked, section(".init"))) FB_CRT_NOTRACE _entry(void) {
     asm volatile(
-        /* Initialize stack pointer to top of memory (256KB - 16, aligned) */
-        "lui sp, 0x40\n"
-        "addi sp, sp, -16\n"
-        /* Initialize global pointer (for relaxation) */
+        /* Stack pointer from the linker script memory map (16-byte aligned) */
         ".option push\n"
         ".option norelax\n"
+        "la sp, __stack_top\n"
+        /* Initialize global pointer (for relaxation) */
         "la gp, __global_pointer$\n"
         ".option pop\n"
         /* Jump to C init */
@@ -52,7 +88,11 @@ void __attribute__((naked, section(".init"))) _entry(void) {
 }
 
 /* C initialization and main call */
-void __attribute__((noreturn)) _crt_init(void) {
+void __attribute__((noreturn)) FB_CRT_NOTRACE _crt_init(void) {
+    /* Returns only on a cold start; a warm one continues in fb_checkpoint */
+    if (fb_warm_resume) {
+        fb_warm_resume();
+    }
     _init_bss();
 
     int ret = 0;
@@ -61,9 +101,36 @@ void __attribute__((noreturn)) _crt_init(void) {
     } else if (_start) {
         _start();
     }
+#if defined(FB_TRACE) && FB_TRACE
+    fb_trace_dump();
+#endif
     _exit(ret);
 }
 
+/*
+ * Immutable code (fb-cc --immutable-code, FROSTBITE_IMMUTABLE_CODE): an ELF
+ * note, "Frostbite" type 1, in its own PT_NOTE segment, telling the loader
+ * that [__fb_code_start, __fb_code_end) - .init and .text - is never written
+ * while the program runs. A VM that honours it may keep decoded instructions
+ * for that range across fresh restarts (EXECUTE_RESTART_V3) of the same
+ * program; a VM that does not simply ignores the note. Descriptor:
+ *   u32 version (1), u32 flags (bit 0: immutable), u64 code_start, u64 code_end
+ */
+#if defined(FB_IMMUTABLE_CODE) && FB_IMMUTABLE_CODE
+asm(".pushsection .note.frostbite.code, \"a\", @note\n"
+    ".p2align 3\n"
+    ".word 10\n"        /* namesz, "Frostbite\0" */
+    ".word 24\n"        /* descsz */
+    ".word 1\n"         /* type: code descriptor */
+    ".asciz \"Frostbite\"\n"
+    ".p2align 3\n"
+    ".word 1\n"         /* version */
+    ".word 1\n"         /* flags: immutable */
+    ".quad __fb_code_start\n"
+    ".quad __fb_code_end\n"
+    ".popsection\n");
+#endif
+
 /* Provide __global_pointer$ symbol */
 asm(".global __global_pointer$\n"
     ".hidden __global_pointer$\n"
@@ -1,8 +1,27 @@
 // Frostbite minimal allocator + memory helpers.
 //
-// Provides a simple bump allocator and byte-wise memcpy/memset for
-// freestanding C programs. The allocator always uses a mapped RAM
-// account segment; it never falls back to local heap memory.
+// Provides a simple bump allocator plus the out-of-line memcpy/memset/
+// memmove/memcmp definitions (bodies live in frostbite.h) for freestanding
+// C programs. The allocator always uses a mapped RAM account segment; it
+// never falls back to local heap memory.
+//
+// Compile with -DFB_ALLOC_FREELIST=1 to layer segregated size classes over
+// the bump allocator so fb_free reclaims memory:
+//   - Blocks are powers of two from 16 bytes (class 0) up to 128 MB
+//     (class FB_ALLOC_NUM_CLASSES - 1), each with an 8-byte header holding
+//     the class index. Requests round up to the smallest class that fits
+//     size + 8, so internal fragmentation is below 50%.
+//   - fb_malloc pops the class free list, or bump-allocates a fresh block
+//     when it is empty. Cost: up to FB_ALLOC_NUM_CLASSES iterations of the
+//     class search (one per doubling above 16 bytes) plus O(1) list work.
+//   - fb_free pushes the block onto its class list: O(1), no coalescing.
+//     Freed blocks are only reused by requests of the same class.
+//   - fb_aligned_alloc over-allocates by `align + 8` and stores an 8-byte tag
+//     (FB_ALLOC_ALIGNED_BIT | offset to the real payload) just below the
+//     aligned pointer so fb_free can find the block header.
+//   - Free list heads live in .bss, heap blocks live in the RAM segment, so
+//     both persist across EXECUTE_V3 resumes and reset together on a fresh
+//     restart.
 
 #include <stddef.h>
 #include <stdint.h>
@@ -26,6 +45,10 @@
 #define FB_HEAP_SEGMENT_COUNT 1
 #endif
 
+#ifndef FB_ALLOC_FREELIST
+#define FB_ALLOC_FREELIST 0
+#endif
+
 #ifndef FB_SEGMENT_ADDR
 #define FB_SEGMENT_ADDR(seg, offset) \
     ((((uint64_t)(seg)) << 28) | ((uint64_t)(offset) & 0x0FFFFFFFULL))
@@ -40,6 +63,30 @@ static size_t fb_heap_segment_bytes = FB_RAM_BYTES;
 static size_t fb_heap_segment_offset = FB_HEAP_OFFSET;
 static int fb_heap_use_segments = 1;
 
+#if FB_ALLOC_FREELIST
+#define FB_ALLOC_MIN_SHIFT 4u
+#define FB_ALLOC_NUM_CLASSES 24u
+#define FB_ALLOC_HEADER 8u
+#define FB_ALLOC_FREE_BIT (1ULL << 63)
+#define FB_ALLOC_ALIGNED_BIT (1ULL << 62)
+
+typedef struct fb_free_block {
+    uint64_t header;
+    struct fb_free_block *next;
+} fb_free_block_t;
+
+static fb_free_block_t *fb_free_lists[FB_ALLOC_NUM_CLASSES];
+
+static void fb_freelist_reset(void) {
+    for (uint32_t i = 0; i < FB_ALLOC_NUM_CLASSES; i++) {
+        fb_free_lists[i] = NULL;
+    }
+}
+#else
+static void fb_freelist_reset(void) {
+}
+#endif
+
 __attribute__((weak)) void fb_alloc_panic(const char *msg) {
     fb_print_str(msg);
     fb_exit(1);
@@ -107,6 +154,7 @@ void fb_heap_init(void *base, size_t size) {
         fb_heap_ptr = NULL;
         fb_heap_end = NULL;
     }
+    fb_freelist_reset();
 }
 
 void fb_heap_init_segments(uint32_t start_segment, uint32_t count,
@@ -123,21 +171,15 @@ void fb_heap_init_segments(uint32_t start_segment, uint32_t count,
     fb_heap_segment_bytes = bytes_per_segment;
     fb_heap_segment_offset = offset;
     fb_heap_set_segment(0);
+    fb_freelist_reset();
 }
 
-void *fb_malloc(size_t size) {
-    if (size == 0) {
-        return NULL;
-    }
-
-    fb_heap_init_default();
-
-    size = fb_align_up(size, 8u);
+static void *fb_heap_bump(size_t size, size_t align) {
 retry:
-    uintptr_t ptr = (uintptr_t)fb_heap_ptr;
+    uintptr_t ptr = fb_align_up((uintptr_t)fb_heap_ptr, align);
     uintptr_t end = (uintptr_t)fb_heap_end;
 
-    if (ptr + size > end) {
+    if (ptr > end || size > end - ptr) {
         if (fb_heap_use_segments &&
             (fb_heap_segment_index + 1) < fb_heap_segment_count) {
             fb_heap_segment_index++;
@@ -151,30 +193,160 @@ retry:
     return (void *)ptr;
 }
 
-void fb_free(void *ptr) {
-    (void)ptr;
+#if FB_ALLOC_FREELIST
+static void *fb_freelist_alloc(size_t size) {
+    size_t need = size + FB_ALLOC_HEADER;
+    if (need < size) {
+        return NULL;
+    }
+
+    uint32_t cls = 0;
+    size_t block = (size_t)1 << FB_ALLOC_MIN_SHIFT;
+    while (block < need) {
+        if (++cls >= FB_ALLOC_NUM_CLASSES) {
+            return NULL;
+        }
+        block <<= 1;
+    }
+
+    fb_free_block_t *b = fb_free_lists[cls];
+    if (b != NULL) {
+        fb_free_lists[cls] = b->next;
+    } else {
+        b = (fb_free_block_t *)fb_heap_bump(block, 8u);
+        if (b == NULL) {
+            return NULL;
+        }
+    }
+    b->header = cls;
+    return (uint8_t *)b + FB_ALLOC_HEADER;
+}
+
+static void *fb_freelist_alloc_aligned(size_t align, size_t size) {
+    if (align <= FB_ALLOC_HEADER) {
+        return fb_freelist_alloc(size);
+    }
+    size_t padded = size + align + FB_ALLOC_HEADER;
+    if (padded < size) {
+        return NULL;
+    }
+    uint8_t *raw = (uint8_t *)fb_freelist_alloc(padded);
+    if (raw == NULL) {
+        return NULL;
+    }
+    uint8_t *p = (uint8_t *)fb_align_up((uintptr_t)raw, align);
+    if (p - raw == FB_ALLOC_HEADER) {
+        /* Keep the tag clear of the free-list link stored at raw. */
+        p += align;
+    }
+    if (p != raw) {
+        *(uint64_t *)(p - FB_ALLOC_HEADER) =
+            FB_ALLOC_ALIGNED_BIT | (uint64_t)(p - raw);
+    }
+    return p;
+}
+#endif
+
+void *fb_malloc(size_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+
+    fb_heap_init_default();
+
+#if FB_ALLOC_FREELIST
+    return fb_freelist_alloc(size);
+#else
+    return fb_heap_bump(fb_align_up(size, 8u), 8u);
+#endif
 }
 
-void *fb_memcpy(void *dst, const void *src, size_t n) {
-    uint8_t *d = (uint8_t *)dst;
-    const uint8_t *s = (const uint8_t *)src;
+void *fb_aligned_alloc(size_t align, size_t size) {
+    if (size == 0 || align == 0 || (align & (align - 1u)) != 0 ||
+        align > 0x10000000u) {
+        return NULL;
+    }
+    if (align < 8u) {
+        align = 8u;
+    }
 
-    for (size_t i = 0; i < n; i++) {
-        d[i] = s[i];
+    fb_heap_init_default();
+
+#if FB_ALLOC_FREELIST
+    return fb_freelist_alloc_aligned(align, size);
+#else
+    return fb_heap_bump(fb_align_up(size, 8u), align);
+#endif
+}
+
+void fb_free(void *ptr) {
+#if FB_ALLOC_FREELIST
+    if (ptr == NULL) {
+        return;
     }
+    uint64_t tag = *(uint64_t *)((uint8_t *)ptr - FB_ALLOC_HEADER);
+    if ((tag & (FB_ALLOC_FREE_BIT | FB_ALLOC_ALIGNED_BIT)) == FB_ALLOC_ALIGNED_BIT) {
+        uint64_t offset = tag & ~FB_ALLOC_ALIGNED_BIT;
+        if (offset >= 0x10000000u || (offset & 7u) != 0) {
+            fb_alloc_panic("fb_free: pointer was not returned by fb_malloc.\n");
+        }
+        ptr = (uint8_t *)ptr - offset;
+    }
+    fb_free_block_t *b = (fb_free_block_t *)((uint8_t *)ptr - FB_ALLOC_HEADER);
+    uint64_t cls = b->header;
+    if (cls >= FB_ALLOC_NUM_CLASSES) {
+        fb_alloc_panic(
+            (cls & FB_ALLOC_FREE_BIT)
+                ? "fb_free: double free.\n"
+                : "fb_free: pointer was not returned by fb_malloc.\n"
+        );
+    }
+    b->header = cls | FB_ALLOC_FREE_BIT;
+    b->next = fb_free_lists[cls];
+    fb_free_lists[cls] = b;
+#else
+    (void)ptr;
+#endif
+}
 
-    return dst;
+void fb_heap_mark(fb_heap_mark_t *mark) {
+    mark->ptr = fb_heap_ptr;
+    mark->end = fb_heap_end;
+    mark->segment_index = fb_heap_segment_index;
+    mark->reserved = 0;
 }
 
-void *fb_memset(void *dst, int c, size_t n) {
-    uint8_t *d = (uint8_t *)dst;
-    uint8_t value = (uint8_t)c;
+void fb_heap_rewind(const fb_heap_mark_t *mark) {
+    fb_heap_ptr = mark->ptr;
+    fb_heap_end = mark->end;
+    fb_heap_segment_index = mark->segment_index;
+    fb_freelist_reset();
+}
 
-    for (size_t i = 0; i < n; i++) {
-        d[i] = value;
+void fb_arena_init(fb_arena_t *arena, uint32_t segment, size_t offset, size_t size) {
+    size_t skip = fb_align_up(offset, 8u) - offset;
+    if (segment == 0 || segment > 15 || size <= skip ||
+        offset >= 0x10000000u || size > 0x10000000u - offset) {
+        fb_alloc_panic(
+            "fb_arena_init: invalid RAM segment region. Use segment 1-15 and "
+            "keep offset + size within the segment.\n"
+        );
     }
+    uint8_t *base = (uint8_t *)(uintptr_t)FB_SEGMENT_ADDR(segment, offset + skip);
+    arena->base = base;
+    arena->ptr = base;
+    arena->end = base + (size - skip);
+}
 
-    return dst;
+int fb_arena_init_heap(fb_arena_t *arena, size_t size) {
+    uint8_t *base = (uint8_t *)fb_malloc(size);
+    if (base == NULL) {
+        return -1;
+    }
+    arena->base = base;
+    arena->ptr = base;
+    arena->end = base + size;
+    return 0;
 }
 
 __attribute__((weak)) void *malloc(size_t size) {
@@ -185,6 +357,22 @@ __attribute__((weak)) void free(void *ptr) {
     fb_free(ptr);
 }
 
+__attribute__((weak)) void *aligned_alloc(size_t align, size_t size) {
+    return fb_aligned_alloc(align, size);
+}
+
+__attribute__((weak)) int posix_memalign(void **out, size_t align, size_t size) {
+    if (align < sizeof(void *) || (align & (align - 1u)) != 0) {
+        return 22; /* EINVAL */
+    }
+    void *p = fb_aligned_alloc(align, size);
+    if (p == NULL && size != 0) {
+        return 12; /* ENOMEM */
+    }
+    *out = p;
+    return 0;
+}
+
 __attribute__((weak)) void *memcpy(void *dst, const void *src, size_t n) {
     return fb_memcpy(dst, src, n);
 }
@@ -192,3 +380,11 @@ __attribute__((weak)) void *memcpy(void *dst, const void *src, size_t n) {
 __attribute__((weak)) void *memset(void *dst, int c, size_t n) {
     return fb_memset(dst, c, n);
 }
+
+__attribute__((weak)) void *memmove(void *dst, const void *src, size_t n) {
+    return fb_memmove(dst, src, n);
+}
+
+__attribute__((weak)) int memcmp(const void *a, const void *b, size_t n) {
+    return fb_memcmp(a, b, n);
+}
@@ -1,6 +1,11 @@
 /**
  * Soft-float implementation for RV64IM bare-metal.
- * Provides float and double compiler builtins.
+ * Provides float and double compiler builtins, plus the fb_fmaf / fb_sqrtf /
+ * fb_rsqrtf / fb_expf helpers declared in frostbite.h.
+ *
+ * f32 add/mul/div take a short path when both operands are normal and finite
+ * and fall back to the generic code otherwise; both truncate and flush
+ * subnormals, so results are bit-identical.
  */
 
 typedef unsigned int u32;
@@ -29,6 +34,18 @@ static inline int f32_exp(u32 a) { return (a >> 23) & 0xFF; }
 static inline u32 f32_frac(u32 a) { return a & 0x7FFFFF; }
 static inline int f32_is_nan(u32 a) { return (f32_exp(a) == 0xFF && f32_frac(a)); }
 
+/* Leading zero count of a non-zero u64 (no Zbb). */
+static inline int u64_clz(u64 x) {
+    int n = 0;
+    if (!(x >> 32)) { n += 32; x <<= 32; }
+    if (!(x >> 48)) { n += 16; x <<= 16; }
+    if (!(x >> 56)) { n += 8; x <<= 8; }
+    if (!(x >> 60)) { n += 4; x <<= 4; }
+    if (!(x >> 62)) { n += 2; x <<= 2; }
+    if (!(x >> 63)) { n += 1; }
+    return n;
+}
+
 static int f32_cmp(float a, float b, int *unordered) {
     u32 ua = f32_to_bits(a);
     u32 ub = f32_to_bits(b);
@@ -85,7 +102,7 @@ FB_WEAK int __unordsf2(float a, float b) {
             (f32_exp(ub) == 0xFF && f32_frac(ub))) ? 1 : 0;
 }
 
-FB_WEAK float __addsf3(float a, float b) {
+static float f32_add_generic(float a, float b) {
     u32 ua = f32_to_bits(a);
     u32 ub = f32_to_bits(b);
     if ((ua & 0x7FFFFFFF) == 0) return b;
@@ -130,12 +147,45 @@ FB_WEAK float __addsf3(float a, float b) {
     return bits_to_f32(((u32)sr << 31) | ((u32)er << 23) | ((u32)fr & 0x7FFFFF));
 }
 
+FB_WEAK float __addsf3(float a, float b) {
+    u32 ua = f32_to_bits(a);
+    u32 ub = f32_to_bits(b);
+    if ((ua & 0x7FFFFFFF) < (ub & 0x7FFFFFFF)) {
+        u32 t = ua;
+        ua = ub;
+        ub = t;
+    }
+    int ea = f32_exp(ua), eb = f32_exp(ub);
+    if ((u32)(eb - 1) >= 254u || ea == 255) return f32_add_generic(a, b);
+    int diff = ea - eb;
+    if (diff > 24) return bits_to_f32(ua);
+    u32 fa = f32_frac(ua) | 0x800000;
+    u32 fb = (f32_frac(ub) | 0x800000) >> diff;
+    u32 sr = ua & 0x80000000;
+    u32 fr;
+    if ((ua ^ ub) >> 31) {
+        fr = fa - fb;
+        if (fr == 0) return bits_to_f32(0);
+        int shift = u64_clz(fr) - 40;
+        if (shift >= ea) return bits_to_f32(sr);
+        fr <<= shift;
+        ea -= shift;
+    } else {
+        fr = fa + fb;
+        u32 carry = fr >> 24;
+        fr >>= carry;
+        ea += (int)carry;
+        if (ea >= 255) return bits_to_f32(sr | 0x7F800000);
+    }
+    return bits_to_f32(sr | ((u32)ea << 23) | (fr & 0x7FFFFF));
+}
+
 FB_WEAK float __subsf3(float a, float b) {
     u32 ub = f32_to_bits(b);
     return __addsf3(a, bits_to_f32(ub ^ 0x80000000));
 }
 
-FB_WEAK float __mulsf3(float a, float b) {
+static float f32_mul_generic(float a, float b) {
     u32 ua = f32_to_bits(a);
     u32 ub = f32_to_bits(b);
     int sa = f32_sign(ua), sb = f32_sign(ub);
@@ -157,7 +207,22 @@ FB_WEAK float __mulsf3(float a, float b) {
     return bits_to_f32(((u32)sr << 31) | ((u32)er << 23) | ((u32)fr & 0x7FFFFF));
 }
 
-FB_WEAK float __divsf3(float a, float b) {
+FB_WEAK float __mulsf3(float a, float b) {
+    u32 ua = f32_to_bits(a);
+    u32 ub = f32_to_bits(b);
+    int ea = f32_exp(ua), eb = f32_exp(ub);
+    if ((u32)(ea - 1) >= 254u || (u32)(eb - 1) >= 254u) return f32_mul_generic(a, b);
+    u32 sr = (ua ^ ub) & 0x80000000;
+    u64 fr = ((u64)(f32_frac(ua) | 0x800000) * (f32_frac(ub) | 0x800000)) >> 23;
+    u32 carry = (u32)(fr >> 24);
+    fr >>= carry;
+    int er = ea + eb - 127 + (int)carry;
+    if (er >= 255) return bits_to_f32(sr | 0x7F800000);
+    if (er <= 0) return bits_to_f32(sr);
+    return bits_to_f32(sr | ((u32)er << 23) | ((u32)fr & 0x7FFFFF));
+}
+
+static float f32_div_generic(float a, float b) {
     u32 ua = f32_to_bits(a);
     u32 ub = f32_to_bits(b);
     int sa = f32_sign(ua), sb = f32_sign(ub);
@@ -179,6 +244,21 @@ FB_WEAK float __divsf3(float a, float b) {
     return bits_to_f32(((u32)sr << 31) | ((u32)er << 23) | ((u32)fr & 0x7FFFFF));
 }
 
+FB_WEAK float __divsf3(float a, float b) {
+    u32 ua = f32_to_bits(a);
+    u32 ub = f32_to_bits(b);
+    int ea = f32_exp(ua), eb = f32_exp(ub);
+    if ((u32)(ea - 1) >= 254u || (u32)(eb - 1) >= 254u) return f32_div_generic(a, b);
+    u32 sr = (ua ^ ub) & 0x80000000;
+    u64 fr = ((u64)(f32_frac(ua) | 0x800000) << 24) / (f32_frac(ub) | 0x800000);
+    u32 carry = (u32)(fr >> 24);
+    fr >>= carry;
+    int er = ea - eb + 127 + (int)carry;
+    if (er >= 255) return bits_to_f32(sr | 0x7F800000);
+    if (er <= 0) return bits_to_f32(sr);
+    return bits_to_f32(sr | ((u32)er << 23) | ((u32)fr & 0x7FFFFF));
+}
+
 FB_WEAK int __fixsfsi(float a) {
     u32 ua = f32_to_bits(a);
     int s = f32_sign(ua);
@@ -197,16 +277,17 @@ FB_WEAK float __floatsisf(int a) {
     u32 ua;
     if (a < 0) { s = 1; ua = (u32)(-(long long)a); }
     else { ua = (u32)a; }
-    int e = 127 + 31;
-    while ((ua & 0x80000000) == 0) { ua <<= 1; e--; }
+    int z = u64_clz(ua) - 32;
+    ua <<= z;
+    int e = 127 + 31 - z;
     return bits_to_f32(((u32)s << 31) | ((u32)e << 23) | ((ua >> 8) & 0x7FFFFF));
 }
 
 FB_WEAK float __floatunsisf(unsigned int a) {
     if (a == 0) return bits_to_f32(0);
-    int e = 127 + 31;
-    u32 ua = a;
-    while ((ua & 0x80000000) == 0) { ua <<= 1; e--; }
+    int z = u64_clz(a) - 32;
+    u32 ua = a << z;
+    int e = 127 + 31 - z;
     return bits_to_f32(((u32)e << 23) | ((ua >> 8) & 0x7FFFFF));
 }
 
@@ -225,6 +306,131 @@ FB_WEAK float __negsf2(float a) {
     return bits_to_f32(f32_to_bits(a) ^ 0x80000000);
 }
 
+/* ---- f32 math helpers ---- */
+
+/* floor(sqrt(m << 23)) for m in [2^23, 2^25); Newton from the AM-GM bound. */
+static u32 f32_isqrt(u64 m) {
+    u64 n = m << 23;
+    u64 r = (m + 0x800000) >> 1;
+    for (;;) {
+        u64 t = (r + n / r) >> 1;
+        if (t >= r) break;
+        r = t;
+    }
+    return (u32)r;
+}
+
+#if defined(__riscv_flen)
+
+float fb_fmaf(float a, float b, float c) {
+    float r;
+    __asm__("fmadd.s %0, %1, %2, %3" : "=f"(r) : "f"(a), "f"(b), "f"(c));
+    return r;
+}
+
+float fb_sqrtf(float x) {
+    float r;
+    __asm__("fsqrt.s %0, %1" : "=f"(r) : "f"(x));
+    return r;
+}
+
+float fb_rsqrtf(float x) {
+    return 1.0f / fb_sqrtf(x);
+}
+
+#else
+
+float fb_fmaf(float a, float b, float c) {
+    u32 ua = f32_to_bits(a), ub = f32_to_bits(b), uc = f32_to_bits(c);
+    int ea = f32_exp(ua), eb = f32_exp(ub), ec = f32_exp(uc);
+    if ((u32)(ea - 1) >= 254u || (u32)(eb - 1) >= 254u || (u32)(ec - 1) >= 254u)
+        return __addsf3(__mulsf3(a, b), c);
+    /* Both terms as mantissas in [2^60, 2^61), scaled by 2^-60 (the shift is exact) */
+    u64 p = ((u64)(f32_frac(ua) | 0x800000) * (f32_frac(ub) | 0x800000)) << 14;
+    u64 q = (u64)(f32_frac(uc) | 0x800000) << 37;
+    u32 carry = (u32)(p >> 61);
+    p >>= carry;
+    int ep = ea + eb - 127 + (int)carry;
+    u32 sp = (ua ^ ub) & 0x80000000, sq = uc & 0x80000000;
+    if (ec > ep || (ec == ep && q > p)) {
+        u64 t = p; p = q; q = t;
+        int te = ep; ep = ec; ec = te;
+        u32 ts = sp; sp = sq; sq = ts;
+    }
+    int diff = ep - ec;
+    q = diff > 63 ? 0 : q >> diff;
+    u64 r = (sp == sq) ? p + q : p - q;
+    if (r == 0) return bits_to_f32(0);
+    int z = u64_clz(r);
+    int er = ep + 3 - z;
+    if (er >= 255) return bits_to_f32(sp | 0x7F800000);
+    if (er <= 0) return bits_to_f32(sp);
+    return bits_to_f32(sp | ((u32)er << 23) | ((u32)((r << z) >> 40) & 0x7FFFFF));
+}
+
+float fb_sqrtf(float x) {
+    u32 ux = f32_to_bits(x);
+    int e = f32_exp(ux);
+    if ((ux << 1) == 0) return x;
+    if (ux >> 31) return bits_to_f32(0x7FC00000);
+    if (e == 255) return x;
+    if (e == 0) return bits_to_f32(0);
+    u64 m = f32_frac(ux) | 0x800000;
+    int k = e - 127;
+    if (k & 1) { m <<= 1; k--; }
+    return bits_to_f32(((u32)(k / 2 + 127) << 23) | (f32_isqrt(m) & 0x7FFFFF));
+}
+
+float fb_rsqrtf(float x) {
+    u32 ux = f32_to_bits(x);
+    int e = f32_exp(ux);
+    if ((ux << 1) == 0 || e == 0) return bits_to_f32((ux & 0x80000000) | 0x7F800000);
+    if (f32_is_nan(ux) || (ux >> 31)) return bits_to_f32(0x7FC00000);
+    if (e == 255) return bits_to_f32(0);
+    u64 m = f32_frac(ux) | 0x800000;
+    int k = e - 127;
+    if (k & 1) { m <<= 1; k--; }
+    /* 2^47 / sqrt(m << 23) lies in (2^23, 2^24] */
+    u64 q = (1ULL << 47) / f32_isqrt(m);
+    u32 carry = (u32)(q >> 24);
+    q >>= carry;
+    int er = 126 - k / 2 + (int)carry;
+    return bits_to_f32(((u32)er << 23) | ((u32)q & 0x7FFFFF));
+}
+
+#endif
+
+/* 2^f on [0, 1): Chebyshev fit in Q30, max relative error ~3.5e-9 */
+static const i64 f32_exp2_poly[7] = {
+    1073741827, 744260852, 257945486, 59571873, 10398316, 1330509, 234782,
+};
+
+float fb_expf(float x) {
+    u32 ux = f32_to_bits(x);
+    int e = f32_exp(ux);
+    u32 neg = ux >> 31;
+    if (f32_is_nan(ux)) return x;
+    if (e < 127 - 27) return 1.0f;
+    if (e >= 127 + 7) return bits_to_f32(neg ? 0 : 0x7F800000);
+    /* x in Q26 (|x| < 128), then y = x * log2(e) in Q32 */
+    i64 xq = (i64)(f32_frac(ux) | 0x800000);
+    int shift = e - 127 + 3;
+    xq = shift >= 0 ? xq << shift : xq >> -shift;
+    if (neg) xq = -xq;
+    i64 y = (xq * 774541002LL) >> 23;
+    i64 k = y >> 32;
+    if (k > 127) return bits_to_f32(0x7F800000);
+    if (k < -126) return bits_to_f32(0);
+    i64 f = (y & 0xFFFFFFFFLL) >> 2;
+    i64 p = f32_exp2_poly[6];
+    for (int i = 5; i >= 0; i--) {
+        p = ((p * f) >> 30) + f32_exp2_poly[i];
+    }
+    u32 m = (u32)(p >> 7);
+    if (m > 0xFFFFFF) m = 0xFFFFFF;
+    return bits_to_f32(((u32)(k + 127) << 23) | (m & 0x7FFFFF));
+}
+
 /* ---- double (f64) ---- */
 
 static inline u64 f64_to_bits(double f) {
@@ -336,8 +542,9 @@ static u64 div_u128_u64(u64 hi, u64 lo, u64 d) {
 
 static u64 u64_to_f64_bits(u64 a, int sign) {
     if (a == 0) return (u64)sign << 63;
-    int e = 1023 + 63;
-    while ((a & (1ULL << 63)) == 0) { a <<= 1; e--; }
+    int z = u64_clz(a);
+    a <<= z;
+    int e = 1023 + 63 - z;
     u64 frac = (a >> 11) & 0xFFFFFFFFFFFFFULL;
     return ((u64)sign << 63) | ((u64)e << 52) | frac;
 }
@@ -0,0 +1,161 @@
+// Frostbite call tracer (fb-cc --trace).
+//
+// The program and runtime are built with -finstrument-functions, so every
+// function entry and exit calls the hooks below; fb_syscallN adds one
+// enter/exit pair per syscall (FB_TRACE_SYSCALL_BIT | id). The hooks keep a
+// call tree in .bss: one node per distinct (parent, function) path with its
+// call count, total fb_instret() instructions and the part spent in
+// children, so self time is total - child.
+//   - Instructions between a hook's two counter reads are subtracted
+//     (`skew`), so the profile shows the program's cost, not the tracer's;
+//     only the call into each hook remains. Where the counter reads 0 (as in
+//     frostbite-run) only the call counts are real.
+//   - Paths past FB_TRACE_NODES nodes or FB_TRACE_DEPTH frames are not
+//     recorded; their time stays in the caller's self time and they are
+//     counted as dropped.
+//   - fb_exit (and crt0 after main returns) calls fb_trace_dump, which writes
+//     one FB_BLOG record per node, schema 1 {node, parent, fn, calls, total,
+//     child}, then schema 2 {nodes, dropped, instructions}. The tree lives in
+//     .bss, so it spans yields and transactions like the rest of the program.
+//   - scripts/fb_flame.py symbolizes fn against the ELF and prints folded
+//     stacks for flamegraph.pl / speedscope / inferno.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frostbite.h"
+#include "frostbite_log.h"
+
+#ifndef FB_TRACE_NODES
+#define FB_TRACE_NODES 1024
+#endif
+
+#ifndef FB_TRACE_DEPTH
+#define FB_TRACE_DEPTH 128
+#endif
+
+#define FB_TRACE_SLOTS (2u * FB_TRACE_NODES) /* open-addressing table, half full at most */
+#define FB_TRACE_NODE_SCHEMA 1u
+#define FB_TRACE_SUMMARY_SCHEMA 2u
+
+typedef struct {
+    uint64_t fn;     /* function address, or FB_TRACE_SYSCALL_BIT | syscall id */
+    uint32_t parent; /* node index; node 0 is the root */
+    uint32_t calls;
+    uint64_t total;  /* instructions between entry and exit */
+    uint64_t child;  /* part of total spent in child nodes */
+} fb_trace_node_t;
+
+static fb_trace_node_t fb_trace_nodes[FB_TRACE_NODES];
+static uint32_t fb_trace_slots[FB_TRACE_SLOTS]; /* node index + 1, 0 = empty */
+static uint32_t fb_trace_stack[FB_TRACE_DEPTH];
+static uint64_t fb_trace_start[FB_TRACE_DEPTH];
+static uint32_t fb_trace_count = 1;
+static uint32_t fb_trace_depth;
+static uint32_t fb_trace_lost;    /* open frames that were not recorded */
+static uint64_t fb_trace_dropped; /* calls that were not recorded */
+static uint64_t fb_trace_skew;    /* instructions spent in the hooks */
+static int fb_trace_off;
+
+static inline __attribute__((always_inline, no_instrument_function)) uint64_t
+fb_trace_clock(void) {
+    uint64_t value = 0;
+    asm volatile(".insn i 0x73, 2, %0, x0, -1022" : "+r"(value));
+    return value;
+}
+
+static FB_NOTRACE uint32_t fb_trace_child(uint32_t parent, uint64_t fn) {
+    uint64_t h = (fn ^ ((uint64_t)parent * 0x9E3779B97F4A7C15ull)) * 0xFF51AFD7ED558CCDull;
+    uint32_t slot = (uint32_t)(h >> 40) % FB_TRACE_SLOTS;
+    for (;;) {
+        uint32_t idx = fb_trace_slots[slot];
+        if (idx == 0) {
+            break;
+        }
+        if (fb_trace_nodes[idx - 1u].fn == fn && fb_trace_nodes[idx - 1u].parent == parent) {
+            return idx - 1u;
+        }
+        slot = slot + 1u == FB_TRACE_SLOTS ? 0 : slot + 1u;
+    }
+    if (fb_trace_count == FB_TRACE_NODES) {
+        return 0;
+    }
+    uint32_t idx = fb_trace_count++;
+    fb_trace_nodes[idx].fn = fn;
+    fb_trace_nodes[idx].parent = parent;
+    fb_trace_slots[slot] = idx + 1u;
+    return idx;
+}
+
+FB_NOTRACE void fb_trace_enter(uint64_t fn) {
+    uint64_t t0 = fb_trace_clock();
+    if (fb_trace_off) {
+        return;
+    }
+    uint32_t parent = fb_trace_depth ? fb_trace_stack[fb_trace_depth - 1u] : 0;
+    uint32_t idx = 0;
+    if (fb_trace_lost == 0 && fb_trace_depth < FB_TRACE_DEPTH) {
+        idx = fb_trace_child(parent, fn);
+    }
+    if (idx == 0) {
+        fb_trace_lost++;
+        fb_trace_dropped++;
+    } else {
+        fb_trace_nodes[idx].calls++;
+        fb_trace_stack[fb_trace_depth] = idx;
+        fb_trace_start[fb_trace_depth++] = t0 - fb_trace_skew;
+    }
+    fb_trace_skew += fb_trace_clock() - t0;
+}
+
+FB_NOTRACE void fb_trace_exit(void) {
+    uint64_t t0 = fb_trace_clock();
+    if (fb_trace_off) {
+        return;
+    }
+    if (fb_trace_lost) {
+        fb_trace_lost--;
+    } else if (fb_trace_depth) {
+        uint32_t idx = fb_trace_stack[--fb_trace_depth];
+        uint64_t delta = t0 - fb_trace_skew - fb_trace_start[fb_trace_depth];
+        fb_trace_nodes[idx].total += delta;
+        fb_trace_nodes[fb_trace_nodes[idx].parent].child += delta;
+    }
+    fb_trace_skew += fb_trace_clock() - t0;
+}
+
+FB_NOTRACE void __cyg_profile_func_enter(void *fn, void *call_site) {
+    (void)call_site;
+    fb_trace_enter((uint64_t)(uintptr_t)fn);
+}
+
+FB_NOTRACE void __cyg_profile_func_exit(void *fn, void *call_site) {
+    (void)fn;
+    (void)call_site;
+    fb_trace_exit();
+}
+
+/**
+ * Close the open frames at the current instruction count and write the tree.
+ * Tracing stays off afterwards, so a second call writes nothing.
+ */
+FB_NOTRACE void fb_trace_dump(void) {
+    if (fb_trace_off) {
+        return;
+    }
+    uint64_t now = fb_trace_clock() - fb_trace_skew;
+    fb_trace_off = 1;
+    while (fb_trace_depth) {
+        uint32_t idx = fb_trace_stack[--fb_trace_depth];
+        uint64_t delta = now - fb_trace_start[fb_trace_depth];
+        fb_trace_nodes[idx].total += delta;
+        fb_trace_nodes[fb_trace_nodes[idx].parent].child += delta;
+    }
+    for (uint32_t i = 1; i < fb_trace_count; i++) {
+        const fb_trace_node_t *n = &fb_trace_nodes[i];
+        FB_BLOG(FB_TRACE_TAG, FB_TRACE_NODE_SCHEMA, i, n->parent, (int64_t)n->fn, n->calls,
+                (int64_t)n->total, (int64_t)n->child);
+    }
+    FB_BLOG(FB_TRACE_TAG, FB_TRACE_SUMMARY_SCHEMA, fb_trace_count - 1u,
+            (int64_t)fb_trace_dropped, (int64_t)now);
+}
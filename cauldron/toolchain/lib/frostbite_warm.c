@@ -0,0 +1,185 @@
+// Frostbite warm image (fb_checkpoint), opt-in with fb-cc --warm-start.
+//
+// This relies on unspecified VM behaviour: the guest contract only says a
+// fresh restart (EXECUTE_RESTART_V3) resets registers and pc and "does not
+// zero all scratch bytes". Where scratch and the RAM segments do survive, a
+// program can skip its setup on later runs by restoring the point where
+// setup finished:
+//   - fb_checkpoint saves ra, sp and s0-s11 (the lp64 callee-saved set; no
+//     FP register is callee-saved under lp64), the stack from its caller's
+//     frame up to __stack_top and the fb_heap_mark position, all in .noinit,
+//     then marks fb_warm_state ready.
+//   - The image carries a CRC-32 of itself and of the account bytes the
+//     caller bound it to (e.g. a model header with a generation counter).
+//     fb_warm_resume checks both, so a scribbled image or changed account
+//     state means a cold start, never a jump into stale state.
+//   - crt0 calls fb_warm_resume (a weak reference, so programs that never
+//     call fb_checkpoint do not link this file) before it clears .bss. With
+//     a valid checkpoint, it rewinds the heap, copies the stack back and
+//     returns 1 from fb_checkpoint in the restored frame; .bss and .data are
+//     kept, unchecked.
+//   - fb_warm_state lives in .data with a nonzero initializer, so loading
+//     the program writes FB_WARM_COLD over it and a checkpoint never outlives
+//     the image that took it.
+//   - A --trace build profiles the cold run only: the tracer is off once it
+//     has dumped, and .bss is not cleared on a warm start.
+//   - Without FB_WARM_START, fb_checkpoint keeps nothing and returns -1.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "frostbite.h"
+#include "frostbite_model.h"
+
+#if defined(FB_WARM_START) && FB_WARM_START
+
+#define FB_WARM_COLD 0x434F4C44u  /* "COLD" */
+#define FB_WARM_READY 0x5741524Du /* "WARM" */
+
+/* Offsets used by the asm below */
+typedef struct {
+    uint64_t ra;          /* 0 */
+    uint64_t sp;          /* 8 */
+    uint64_t s[12];       /* 16 */
+    uint64_t stack_bytes; /* 112 */
+    fb_heap_mark_t heap;
+    const void *bind;     /* account bytes the image depends on */
+    uint64_t bind_len;
+    uint32_t bind_crc;
+    uint32_t stack_crc;
+    uint32_t ctx_crc;     /* of everything above */
+} fb_warm_ctx_t;
+
+_Static_assert(offsetof(fb_warm_ctx_t, s) == 16, "fb_warm_ctx_t layout");
+_Static_assert(offsetof(fb_warm_ctx_t, stack_bytes) == 112, "fb_warm_ctx_t layout");
+
+extern char __stack_top[];
+
+/* Absent with --alloc none; the checkpoint then keeps no heap position */
+#pragma weak fb_heap_mark
+#pragma weak fb_heap_rewind
+
+static volatile uint32_t fb_warm_state = FB_WARM_COLD;
+FB_NOINIT __attribute__((used)) static fb_warm_ctx_t fb_warm_ctx;
+FB_NOINIT __attribute__((used)) static uint64_t fb_warm_stack[FB_WARM_STACK / 8];
+
+/* Called from fb_checkpoint with its arguments and its caller's sp. */
+static __attribute__((used)) FB_NOTRACE int fb_warm_save(const void *bind, size_t bind_len,
+                                                         uintptr_t sp) {
+    uintptr_t top = (uintptr_t)__stack_top;
+    fb_warm_state = FB_WARM_COLD;
+    if (sp > top || top - sp > sizeof(fb_warm_stack) || (!bind && bind_len)) {
+        return -1;
+    }
+    const uint64_t *src = (const uint64_t *)sp;
+    for (size_t i = 0; i < (top - sp) / 8u; i++) {
+        fb_warm_stack[i] = src[i];
+    }
+    fb_warm_ctx.stack_bytes = top - sp;
+    if (fb_heap_mark) {
+        fb_heap_mark(&fb_warm_ctx.heap);
+    }
+    fb_warm_ctx.bind = bind;
+    fb_warm_ctx.bind_len = bind_len;
+    fb_warm_ctx.bind_crc = fb_crc32(bind, bind_len);
+    fb_warm_ctx.stack_crc = fb_crc32(fb_warm_stack, fb_warm_ctx.stack_bytes);
+    fb_warm_ctx.ctx_crc = fb_crc32(&fb_warm_ctx, offsetof(fb_warm_ctx_t, ctx_crc));
+    fb_warm_state = FB_WARM_READY;
+    return 0;
+}
+
+/* bind and bind_len stay in a0/a1 for fb_warm_save */
+__attribute__((naked)) FB_NOTRACE int fb_checkpoint(const void *bind, size_t bind_len) {
+    asm volatile(
+        "la t0, fb_warm_ctx\n"
+        "sd ra, 0(t0)\n"
+        "sd sp, 8(t0)\n"
+        "sd s0, 16(t0)\n"
+        "sd s1, 24(t0)\n"
+        "sd s2, 32(t0)\n"
+        "sd s3, 40(t0)\n"
+        "sd s4, 48(t0)\n"
+        "sd s5, 56(t0)\n"
+        "sd s6, 64(t0)\n"
+        "sd s7, 72(t0)\n"
+        "sd s8, 80(t0)\n"
+        "sd s9, 88(t0)\n"
+        "sd s10, 96(t0)\n"
+        "sd s11, 104(t0)\n"
+        "mv a2, sp\n"
+        "tail fb_warm_save\n"
+    );
+}
+
+/*
+ * Copy the saved stack back over [sp, __stack_top) - including the frames of
+ * the C code that jumped here, which are dead - without touching memory
+ * through sp, then return 1 from fb_checkpoint.
+ */
+static __attribute__((naked, used)) FB_NOTRACE void fb_warm_jump(void) {
+    asm volatile(
+        "la t0, fb_warm_ctx\n"
+        "ld t1, 8(t0)\n"
+        "ld t2, 112(t0)\n"
+        "la t3, fb_warm_stack\n"
+        "add t2, t1, t2\n"
+        "mv t4, t1\n"
+        "1:\n"
+        "bgeu t4, t2, 2f\n"
+        "ld t5, 0(t3)\n"
+        "sd t5, 0(t4)\n"
+        "addi t3, t3, 8\n"
+        "addi t4, t4, 8\n"
+        "j 1b\n"
+        "2:\n"
+        "mv sp, t1\n"
+        "ld ra, 0(t0)\n"
+        "ld s0, 16(t0)\n"
+        "ld s1, 24(t0)\n"
+        "ld s2, 32(t0)\n"
+        "ld s3, 40(t0)\n"
+        "ld s4, 48(t0)\n"
+        "ld s5, 56(t0)\n"
+        "ld s6, 64(t0)\n"
+        "ld s7, 72(t0)\n"
+        "ld s8, 80(t0)\n"
+        "ld s9, 88(t0)\n"
+        "ld s10, 96(t0)\n"
+        "ld s11, 104(t0)\n"
+        "li a0, 1\n"
+        "ret\n"
+    );
+}
+
+/* crt0: returns only when there is no checkpoint to resume. */
+FB_NOTRACE void fb_warm_resume(void) {
+    if (fb_warm_state != FB_WARM_READY || fb_warm_ctx.stack_bytes > sizeof(fb_warm_stack) ||
+        fb_warm_ctx.sp + fb_warm_ctx.stack_bytes != (uintptr_t)__stack_top ||
+        fb_crc32(&fb_warm_ctx, offsetof(fb_warm_ctx_t, ctx_crc)) != fb_warm_ctx.ctx_crc ||
+        fb_crc32(fb_warm_stack, fb_warm_ctx.stack_bytes) != fb_warm_ctx.stack_crc ||
+        fb_crc32(fb_warm_ctx.bind, fb_warm_ctx.bind_len) != fb_warm_ctx.bind_crc) {
+        fb_warm_state = FB_WARM_COLD;
+        return;
+    }
+    if (fb_heap_rewind) {
+        fb_heap_rewind(&fb_warm_ctx.heap);
+    }
+    fb_warm_jump();
+    __builtin_unreachable();
+}
+
+FB_NOTRACE void fb_checkpoint_clear(void) {
+    fb_warm_state = FB_WARM_COLD;
+}
+
+#else /* !FB_WARM_START */
+
+FB_NOTRACE int fb_checkpoint(const void *bind, size_t bind_len) {
+    (void)bind;
+    (void)bind_len;
+    return -1;
+}
+
+FB_NOTRACE void fb_checkpoint_clear(void) {}
+
+#endif
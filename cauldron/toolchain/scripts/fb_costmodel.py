@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""Fit and query the syscall cost model of frostbite_cost.h.
+
+`fit` reads a bench_report.py report (CSV or JSON) and derives a linear cost
+model for every syscall that has its own bench (bench_<name> times
+FB_SYS_<NAME>):
+
+  cost(n, rows) = fixed + rows * per_row + n * rows * per_elem
+
+Shapes come from the report's sweep. (n, d) benches fit all three terms,
+flat-length benches fit fixed + per_elem with rows = 1, and the rest fit
+only fixed. The fit is least squares over per_call (and over cu_per_call
+when the report ran on-chain). Any negative term is dropped and the rest
+refitted. The result is written as JSON, and optionally as
+frostbite_cost_table.h with one FB_COST_<NAME> initializer per syscall.
+The header rounds every term up, so guest-side sizing stays conservative.
+
+Fit CU from an on-chain report (bench_report.py --onchain, the `make
+costmodel` default). The local runner charges each syscall as one
+instruction, so its per_row and per_elem come out ~0. A syscall whose
+bench scales with rows or elements but whose slopes are below FLAT_SLOPE
+is left out of the header, with a warning, rather than written as a
+near-free row that would defeat fb_cost_max_rows.
+
+`plan` answers the planner question from a fitted model: how many rows fit
+in one transaction, and how many transactions a resumable kernel takes.
+
+Usage:
+  fb_costmodel.py fit report.json -o cost_model.json [--header frostbite_cost_table.h]
+  fb_costmodel.py plan cost_model.json MATMUL_I8_I8_PARTIAL --n 256 --d 1024
+                  [--tx-budget 50000] [--reserve 2000] [--metric instructions]
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import re
+import sys
+from pathlib import Path
+from typing import Any
+
+HERE = Path(__file__).resolve().parent
+HEADER = HERE.parent / "include" / "frostbite.h"
+sys.path.insert(0, str(HERE.parent / "examples" / "c_cpp" / "benchmarks"))
+
+import bench_report  # noqa: E402  (examples/c_cpp/benchmarks/bench_report.py)
+
+VERSION = 1
+MODEL = "fixed + rows * per_row + n * rows * per_elem"
+TERMS = ("fixed", "per_row", "per_elem")
+METRICS = {"instructions": "per_call", "cu": "cu_per_call"}
+SYS_RE = re.compile(r"#define\s+FB_SYS_(\w+)\s+(\d+)")
+TX_BUDGET = 50000  # FB_TX_BUDGET
+TX_RESERVE = 2000  # FB_TX_RESERVE
+FLAT_SLOPE = 1e-3  # per_row / per_elem below this count as not measured
+MIN_ROW_Q16 = 1 << 16  # FB_COST_MIN_ROW_Q16
+
+
+def syscall_ids(header: Path = HEADER) -> dict[str, int]:
+    return {name: int(num) for name, num in SYS_RE.findall(header.read_text())}
+
+
+def bench_syscall(bench: str, ids: dict[str, int]) -> str | None:
+    if bench in bench_report.OP_POINTS or not bench.startswith("bench_"):
+        return None
+    name = bench[len("bench_"):].upper()
+    return name if name in ids else None
+
+
+def features(bench: str, row: dict[str, Any]) -> list[float] | None:
+    """(fixed, per_row, per_elem) multipliers of one sweep point."""
+    try:
+        if bench in bench_report.ND_BENCHES:
+            n, d = int(row["n"]), int(row["d"])
+            return [1.0, float(d), float(n * d)]
+        if bench in bench_report.N_BENCHES:
+            return [1.0, 0.0, float(int(row["n"]))]
+    except (KeyError, TypeError, ValueError):
+        return None
+    return [1.0, 0.0, 0.0]
+
+
+def solve(a: list[list[float]], b: list[float]) -> list[float] | None:
+    """Gaussian elimination with partial pivoting; None if singular."""
+    k = len(b)
+    m = [row[:] + [b[i]] for i, row in enumerate(a)]
+    for col in range(k):
+        piv = max(range(col, k), key=lambda r: abs(m[r][col]))
+        if abs(m[piv][col]) < 1e-12:
+            return None
+        m[col], m[piv] = m[piv], m[col]
+        for r in range(k):
+            if r != col:
+                f = m[r][col] / m[col][col]
+                for c in range(col, k + 1):
+                    m[r][c] -= f * m[col][c]
+    return [m[i][k] / m[i][i] for i in range(k)]
+
+
+def least_squares(xs: list[list[float]], ys: list[float]) -> list[float]:
+    """Non-negative fit: drop a term that comes out negative, refit."""
+    active = [t for t in range(len(TERMS)) if any(x[t] for x in xs)]
+    while active:
+        ata = [[sum(x[i] * x[j] for x in xs) for j in active] for i in active]
+        aty = [sum(x[i] * y for x, y in zip(xs, ys)) for i in active]
+        coef = solve(ata, aty)
+        if coef is None:
+            active.pop()  # shapes do not separate the last term; fold it in
+            continue
+        worst = min(range(len(active)), key=lambda i: coef[i])
+        if coef[worst] < 0 and len(active) > 1:
+            active.pop(worst)
+            continue
+        out = [0.0] * len(TERMS)
+        for t, v in zip(active, coef):
+            out[t] = max(v, 0.0)
+        return out
+    return [0.0] * len(TERMS)
+
+
+def fit(rows: list[dict[str, Any]], ids: dict[str, int]) -> dict[str, Any]:
+    points: dict[str, list[dict[str, Any]]] = {}
+    for row in rows:
+        if row.get("op", "") not in ("", None):
+            continue
+        name = bench_syscall(row["bench"], ids)
+        if name is not None:
+            points.setdefault(name, []).append(row)
+
+    syscalls: dict[str, Any] = {}
+    for name, pts in sorted(points.items()):
+        bench = pts[0]["bench"]
+        entry: dict[str, Any] = {"id": ids[name], "bench": bench, "points": len(pts)}
+        for metric, field in METRICS.items():
+            xs, ys = [], []
+            for row in pts:
+                x = features(bench, row)
+                if x is None or row.get(field) in ("", None):
+                    continue
+                xs.append(x)
+                ys.append(float(row[field]))
+            if not xs:
+                continue
+            coef = least_squares(xs, ys)
+            worst = max(
+                abs(sum(c * v for c, v in zip(coef, x)) - y) / y * 100.0 if y else 0.0
+                for x, y in zip(xs, ys)
+            )
+            entry[metric] = {t: round(c, 4) for t, c in zip(TERMS, coef)}
+            entry[metric]["max_error_pct"] = round(worst, 2)
+        if any(m in entry for m in METRICS):
+            syscalls[name] = entry
+    return {"version": VERSION, "model": MODEL, "syscalls": syscalls}
+
+
+def flat(entry: dict[str, Any], metric: str) -> bool:
+    """True if a row-scaled bench fitted no per-row or per-element cost."""
+    bench = entry["bench"]
+    if bench not in bench_report.ND_BENCHES and bench not in bench_report.N_BENCHES:
+        return False
+    cost = entry[metric]
+    return cost["per_row"] < FLAT_SLOPE and cost["per_elem"] < FLAT_SLOPE
+
+
+def q16(value: float) -> int:
+    return min(math.ceil(value * 65536.0), 0xFFFFFFFF)
+
+
+def header_text(model: dict[str, Any], metric: str, source: str) -> str:
+    lines = [
+        f"/* Generated by scripts/fb_costmodel.py from {source} ({metric}); do not edit. */",
+        "",
+        "#ifndef FROSTBITE_COST_TABLE_H",
+        "#define FROSTBITE_COST_TABLE_H",
+        "",
+        '#include "frostbite_cost.h"',
+        "",
+        f'#define FB_COST_TABLE_METRIC "{metric}"',
+        "",
+    ]
+    for name, entry in model["syscalls"].items():
+        cost = entry.get(metric)
+        if cost is None:
+            continue
+        if flat(entry, metric):
+            print(f"fb_costmodel: {name}: {metric} per_row and per_elem are ~0 "
+                  f"({entry['bench']}); left out of the header, refit from "
+                  f"bench_report.py --onchain", file=sys.stderr)
+            lines += [f"/* FB_COST_{name}: no per-row cost measured ({metric}) */", ""]
+            continue
+        fixed = min(math.ceil(cost["fixed"]), 0xFFFFFFFF)
+        lines += [
+            f"/* {entry['bench']}, sweep points: {entry['points']}, "
+            f"max error {cost['max_error_pct']}% */",
+            f"#define FB_COST_{name}_FIXED {fixed}u",
+            f"#define FB_COST_{name}_PER_ROW_Q16 {q16(cost['per_row'])}u",
+            f"#define FB_COST_{name}_PER_ELEM_Q16 {q16(cost['per_elem'])}u",
+            f"#define FB_COST_{name} \\",
+            f"    {{ FB_COST_{name}_FIXED, FB_COST_{name}_PER_ROW_Q16, FB_COST_{name}_PER_ELEM_Q16 }}",
+            "",
+        ]
+    lines += ["#endif /* FROSTBITE_COST_TABLE_H */", ""]
+    return "\n".join(lines)
+
+# ── Planning (same integer math as frostbite_cost.h) ──────────────
+
+
+def coefficients(cost: dict[str, float]) -> tuple[int, int, int]:
+    return (min(math.ceil(cost["fixed"]), 0xFFFFFFFF), q16(cost["per_row"]),
+            q16(cost["per_elem"]))
+
+
+def cost_call(c: tuple[int, int, int], n: int, rows: int) -> int:
+    return c[0] + (((c[1] + n * c[2]) * rows + 0xFFFF) >> 16)
+
+
+def max_rows(c: tuple[int, int, int], n: int, budget: int) -> int:
+    row = max(c[1] + n * c[2], MIN_ROW_Q16)
+    if budget <= c[0]:
+        return 1
+    return min(max(((budget - c[0]) << 16) // row, 1), 0xFFFFFFFF)
+
+
+def transactions(c: tuple[int, int, int], n: int, d: int, tx_budget: int,
+                 reserve: int) -> int:
+    per_tx = max_rows(c, n, max(tx_budget - reserve, 0))
+    return -(-d // per_tx) if d else 0
+
+
+def lookup(model: dict[str, Any], syscall: str, metric: str) -> tuple[int, int, int]:
+    name = syscall.upper().removeprefix("FB_SYS_")
+    entry = model["syscalls"].get(name)
+    if entry is None or metric not in entry:
+        raise KeyError(f"no {metric} cost for {name}")
+    return coefficients(entry[metric])
+
+# ── Main ───────────────────────────────────────────────────────────
+
+
+def main(argv: list[str] | None = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    f = sub.add_parser("fit", help="fit a model from a bench_report.py report")
+    f.add_argument("report", type=Path)
+    f.add_argument("-o", "--output", type=Path, required=True, help="cost model JSON")
+    f.add_argument("--header", type=Path, help="also write frostbite_cost_table.h here")
+    f.add_argument("--metric", choices=tuple(METRICS), default=None,
+                   help="header metric (default cu when present, else instructions)")
+    p = sub.add_parser("plan", help="rows per transaction and transactions for one kernel")
+    p.add_argument("model", type=Path)
+    p.add_argument("syscall", help="e.g. MATMUL_I8_I8_PARTIAL")
+    p.add_argument("--n", type=int, required=True, help="elements per row (vector length)")
+    p.add_argument("--d", type=int, default=1, help="rows")
+    p.add_argument("--tx-budget", type=int, default=TX_BUDGET)
+    p.add_argument("--reserve", type=int, default=TX_RESERVE)
+    p.add_argument("--metric", choices=tuple(METRICS), default="instructions")
+    args = ap.parse_args(argv)
+
+    try:
+        if args.cmd == "fit":
+            model = fit(bench_report.load_rows(args.report), syscall_ids())
+            args.output.write_text(json.dumps(model, indent=2) + "\n")
+            if args.header:
+                metric = args.metric or (
+                    "cu" if any("cu" in e for e in model["syscalls"].values()) else "instructions")
+                args.header.write_text(header_text(model, metric, args.report.name))
+            print(f"{len(model['syscalls'])} syscalls fitted -> {args.output}")
+            return 0
+        model = json.loads(args.model.read_text())
+        c = lookup(model, args.syscall, args.metric)
+    except (OSError, ValueError, KeyError) as e:
+        print(f"fb_costmodel: {e}", file=sys.stderr)
+        return 1
+    rows = max_rows(c, args.n, max(args.tx_budget - args.reserve, 0))
+    print(f"one call over {args.d} rows: {cost_call(c, args.n, args.d)} {args.metric}")
+    print(f"max_rows per transaction: {min(rows, args.d)}")
+    print(f"transactions: {transactions(c, args.n, args.d, args.tx_budget, args.reserve)}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,408 @@
+#!/usr/bin/env python3
+"""Estimate the instruction budget and transaction count of a guest ELF.
+
+Combines the fb-cc ELF, a cost model from fb_costmodel.py, and optionally a
+frostbite-run / frostbite-run-onchain log:
+
+  functions  every function symbol with its static instruction count and the
+             predicted cost of the syscalls it makes
+  sites      every ecall, the syscall ID found in a7 (constant-propagated
+             through the function), and its predicted cost from the model
+  trace      "Total instructions:" / "Transactions:" from the runner and the
+             FB_PROFILE_END phase records (-DFB_PROFILE=1) found in the log
+
+Arguments are not visible in the ELF, so shapes come from --call:
+NAME=n[,rows[,count]] prices every site of FB_SYS_NAME at n elements x rows
+rows, `count` times per run. A site address (0x...) instead of a name prices
+one site. Sites without --call are priced at their fixed cost, once.
+
+The prediction at --instructions-per-tx uses the measured total when a trace
+is given. Without one it uses the syscall costs plus one pass over every
+function. Each YIELD ends a transaction, so the count is at least one more
+than the yields. A site whose single call exceeds the budget is flagged: no
+instructions-per-tx value can split it.
+
+Usage:
+  fb_estimate.py prog.elf --model cost_model.json [--trace run.log]
+                 [--call MATMUL_I8_I8_PARTIAL=256,64,16] [--call YIELD=0,1,16]
+                 [--instructions-per-tx 50000] [--tag 0x10=attention]
+                 [--format text|json]
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import struct
+import sys
+from pathlib import Path
+from typing import Any
+
+import fb_costmodel  # scripts/fb_costmodel.py
+
+bench_report = fb_costmodel.bench_report
+
+EM_RISCV = 243
+SHT_SYMTAB = 2
+SHF_EXECINSTR = 0x4
+STT_FUNC = 2
+ECALL = 0x00000073
+A0, A7 = 10, 17
+# x1, x5-x7, x10-x17, x28-x31: clobbered by a call
+CALLER_SAVED = {1, 5, 6, 7, *range(10, 18), *range(28, 32)}
+PROFILE_PHASE = 0xF0  # FB_PROFILE_PHASE
+
+
+def sext(value: int, bits: int) -> int:
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+# ── ELF ────────────────────────────────────────────────────────────
+
+
+def read_elf(data: bytes) -> tuple[list[tuple[int, bytes]], list[tuple[int, int, str]]]:
+    """Executable sections [(addr, bytes)] and function symbols [(addr, size, name)]."""
+    if data[:4] != b"\x7fELF" or data[4] != 2 or data[5] != 1:
+        raise ValueError("not a little-endian ELF64 file")
+    machine = struct.unpack_from("<H", data, 18)[0]
+    if machine != EM_RISCV:
+        raise ValueError(f"e_machine {machine} is not RISC-V")
+    shoff, = struct.unpack_from("<Q", data, 40)
+    shentsize, shnum = struct.unpack_from("<HH", data, 58)
+    sections = [struct.unpack_from("<IIQQQQIIQQ", data, shoff + i * shentsize)
+                for i in range(shnum)]
+
+    code = [(sh[3], data[sh[4]:sh[4] + sh[5]]) for sh in sections
+            if sh[2] & SHF_EXECINSTR and sh[5]]
+    funcs = []
+    for sh in sections:
+        if sh[1] != SHT_SYMTAB:
+            continue
+        strtab = sections[sh[6]]
+        names = data[strtab[4]:strtab[4] + strtab[5]]
+        for off in range(sh[4], sh[4] + sh[5], 24):
+            name, info, _, _, value, size = struct.unpack_from("<IBBHQQ", data, off)
+            if info & 0xF == STT_FUNC and size:
+                funcs.append((value, size, names[name:names.index(b"\0", name)].decode()))
+    return code, sorted(set(funcs))
+
+
+def fetch(code: list[tuple[int, bytes]], addr: int, size: int) -> bytes:
+    for base, blob in code:
+        if base <= addr and addr + size <= base + len(blob):
+            return blob[addr - base:addr - base + size]
+    raise ValueError(f"function at 0x{addr:x} is outside the executable sections")
+
+
+# ── Decode (RV64I + C, only what constant propagation needs) ──────
+
+
+def decode(blob: bytes, base: int) -> list[dict[str, Any]]:
+    """One dict per instruction: pc, len, succ, and an effect on the registers."""
+    out, off = [], 0
+    while off + 2 <= len(blob):
+        half, = struct.unpack_from("<H", blob, off)
+        pc = base + off
+        if half & 3 == 3:
+            if off + 4 > len(blob):
+                break
+            ins = decode32(struct.unpack_from("<I", blob, off)[0], pc)
+        else:
+            ins = decode16(half, pc)
+        out.append(ins)
+        off += ins["len"]
+    return out
+
+
+def decode32(w: int, pc: int) -> dict[str, Any]:
+    op, rd, f3, rs1 = w & 0x7F, (w >> 7) & 31, (w >> 12) & 7, (w >> 15) & 31
+    ins: dict[str, Any] = {"pc": pc, "len": 4, "next": True, "jump": None, "ecall": w == ECALL}
+    if op == 0x37:  # lui
+        ins["set"] = (rd, ("imm", sext(w & 0xFFFFF000, 32)))
+    elif op in (0x13, 0x1B) and f3 == 0:  # addi / addiw
+        ins["set"] = (rd, ("add", rs1, sext(w >> 20, 12), op == 0x1B))
+    elif op == 0x63:  # branch
+        imm = ((w >> 31) << 12 | ((w >> 7) & 1) << 11 | ((w >> 25) & 0x3F) << 5
+               | ((w >> 8) & 0xF) << 1)
+        ins["jump"] = pc + sext(imm, 13)
+    elif op == 0x6F:  # jal
+        imm = ((w >> 31) << 20 | ((w >> 12) & 0xFF) << 12 | ((w >> 20) & 1) << 11
+               | ((w >> 21) & 0x3FF) << 1)
+        if rd:
+            ins["call"] = True
+        else:
+            ins["jump"], ins["next"] = pc + sext(imm, 21), False
+    elif op == 0x67:  # jalr
+        if rd:
+            ins["call"] = True
+        else:
+            ins["next"] = False
+    elif op not in (0x23, 0x27, 0x0F) and not (op == 0x73 and f3 == 0):
+        ins["set"] = (rd, None)  # any other write to rd
+    return ins
+
+
+def decode16(h: int, pc: int) -> dict[str, Any]:
+    q, f3 = h & 3, h >> 13
+    rd, rs2 = (h >> 7) & 31, (h >> 2) & 31
+    imm6 = sext(((h >> 12) & 1) << 5 | rs2, 6)
+    ins: dict[str, Any] = {"pc": pc, "len": 2, "next": True, "jump": None, "ecall": False}
+    if q == 0:
+        if f3 in (0, 2, 3):  # c.addi4spn, c.lw, c.ld
+            ins["set"] = (8 + ((h >> 2) & 7), None)
+    elif q == 1:
+        if f3 in (0, 1):  # c.addi / c.addiw
+            ins["set"] = (rd, ("add", rd, imm6, f3 == 1))
+        elif f3 == 2:  # c.li
+            ins["set"] = (rd, ("imm", imm6))
+        elif f3 == 3:  # c.addi16sp / c.lui
+            ins["set"] = (rd, None if rd == 2 else ("imm", sext(imm6 << 12, 32)))
+        elif f3 == 4:
+            ins["set"] = (8 + ((h >> 7) & 7), None)
+        elif f3 == 5:  # c.j
+            imm = (((h >> 12) & 1) << 11 | ((h >> 11) & 1) << 4 | ((h >> 9) & 3) << 8
+                   | ((h >> 8) & 1) << 10 | ((h >> 7) & 1) << 6 | ((h >> 6) & 1) << 7
+                   | ((h >> 3) & 7) << 1 | ((h >> 2) & 1) << 5)
+            ins["jump"], ins["next"] = pc + sext(imm, 12), False
+        else:  # c.beqz / c.bnez
+            imm = (((h >> 12) & 1) << 8 | ((h >> 10) & 3) << 3 | ((h >> 5) & 3) << 6
+                   | ((h >> 3) & 3) << 1 | ((h >> 2) & 1) << 5)
+            ins["jump"] = pc + sext(imm, 9)
+    else:
+        if f3 == 4 and rs2 == 0 and rd:  # c.jr / c.jalr
+            if (h >> 12) & 1:
+                ins["call"] = True
+            else:
+                ins["next"] = False
+        elif f3 == 4 and rs2 and not (h >> 12) & 1:  # c.mv
+            ins["set"] = (rd, ("add", rs2, 0, False))
+        elif f3 == 4 and (h >> 12) & 1 and h != 0x9002:  # c.add
+            ins["set"] = (rd, None)
+        elif f3 in (0, 2, 3):  # c.slli, c.lwsp, c.ldsp
+            ins["set"] = (rd, None)
+    return ins
+
+
+def step(ins: dict[str, Any], regs: dict[int, int]) -> dict[int, int]:
+    regs = dict(regs)
+    if ins.get("call"):
+        for r in CALLER_SAVED:
+            regs.pop(r, None)
+    elif ins["ecall"]:
+        regs.pop(A0, None)
+    elif "set" in ins and ins["set"][0]:
+        rd, effect = ins["set"]
+        value = None
+        if effect and effect[0] == "imm":
+            value = effect[1]
+        elif effect:
+            _, rs, imm, word = effect
+            base = 0 if rs == 0 else regs.get(rs)
+            if base is not None:
+                value = sext(base + imm, 32) if word else sext(base + imm, 64)
+        if value is None:
+            regs.pop(rd, None)
+        else:
+            regs[rd] = value
+    return regs
+
+
+def ecall_ids(insns: list[dict[str, Any]]) -> dict[int, int | None]:
+    """a7 at every ecall: a forward dataflow over the function's CFG that keeps
+    the constants all incoming paths agree on."""
+    index = {ins["pc"]: i for i, ins in enumerate(insns)}
+    state: dict[int, dict[int, int]] = {0: {}} if insns else {}
+    work = [0] if insns else []
+    while work:
+        i = work.pop()
+        regs = step(insns[i], state[i])
+        succ = []
+        if insns[i]["next"] and i + 1 < len(insns):
+            succ.append(i + 1)
+        if insns[i]["jump"] in index:
+            succ.append(index[insns[i]["jump"]])
+        for s in succ:
+            if s not in state:
+                state[s] = regs
+            else:
+                merged = {r: v for r, v in state[s].items() if regs.get(r) == v}
+                if merged == state[s]:
+                    continue
+                state[s] = merged
+            work.append(s)
+    return {ins["pc"]: state.get(i, {}).get(A7) for i, ins in enumerate(insns) if ins["ecall"]}
+
+
+def scan(data: bytes) -> list[dict[str, Any]]:
+    code, funcs = read_elf(data)
+    out = []
+    for addr, size, name in funcs:
+        insns = decode(fetch(code, addr, size), addr)
+        out.append({"name": name, "addr": addr, "instructions": len(insns),
+                    "sites": [{"addr": pc, "id": sid} for pc, sid in ecall_ids(insns).items()]})
+    return out
+
+
+# ── Trace ──────────────────────────────────────────────────────────
+
+
+def parse_trace(text: str) -> dict[str, Any]:
+    result: dict[str, Any] = {"phases": {}}
+    for regex, key in ((bench_report.TOTAL_INSTR_RE, "instructions"),
+                       (bench_report.TRANSACTIONS_RE, "transactions")):
+        found = regex.findall(text)
+        if found:
+            result[key] = int(found[-1])
+    for match in bench_report.DEBUG_LOG_RE.finditer(text):
+        tag, phase, delta = (int(g, 16) for g in match.groups()[:3])
+        if phase == PROFILE_PHASE:
+            calls, total = result["phases"].get(tag, (0, 0))
+            result["phases"][tag] = (calls + 1, total + delta)
+    return result
+
+
+# ── Estimate ───────────────────────────────────────────────────────
+
+
+def parse_call(spec: str, ids: dict[str, int]) -> tuple[str | int, tuple[int, int, int]]:
+    key, _, shape = spec.partition("=")
+    parts = [int(p, 0) for p in shape.split(",") if p] if shape else []
+    if len(parts) > 3 or any(p < 0 for p in parts):
+        raise ValueError(f"--call {spec}: expected NAME=n[,rows[,count]]")
+    n, rows, count = (parts + [0, 1, 1][len(parts):])
+    if key.lower().startswith("0x"):
+        return int(key, 16), (n, rows, count)
+    name = key.upper().removeprefix("FB_SYS_")
+    if name not in ids:
+        raise ValueError(f"--call {spec}: no FB_SYS_{name} in frostbite.h")
+    return name, (n, rows, count)
+
+
+def estimate(funcs: list[dict[str, Any]], model: dict[str, Any] | None,
+             calls: dict[str | int, tuple[int, int, int]], ids: dict[str, int],
+             trace: dict[str, Any] | None, per_tx: int) -> dict[str, Any]:
+    names = {v: k for k, v in ids.items()}
+    sites, yields = [], 0
+    for fn in funcs:
+        fn["syscall_cost"] = 0
+        for site in fn["sites"]:
+            name = names.get(site["id"]) if site["id"] is not None else None
+            n, rows, count = calls.get(site["addr"]) or calls.get(name or "") or (0, 1, 1)
+            cost = None
+            if model is not None and name is not None:
+                try:
+                    cost = fb_costmodel.cost_call(fb_costmodel.lookup(model, name, "instructions"),
+                                                  n, rows)
+                except KeyError:
+                    cost = None
+            yields += count if name == "YIELD" else 0
+            entry = {"function": fn["name"], "addr": site["addr"],
+                     "offset": site["addr"] - fn["addr"], "id": site["id"], "syscall": name,
+                     "n": n, "rows": rows, "count": count, "cost": cost,
+                     "total": cost * count if cost is not None else None,
+                     "over_budget": cost is not None and cost > per_tx}
+            fn["syscall_cost"] += entry["total"] or 0
+            sites.append(entry)
+
+    if "YIELD" in calls and not any(s["syscall"] == "YIELD" for s in sites):
+        yields = calls["YIELD"][2]  # fb_yield's site not resolved; trust the given count
+    static = sum(fn["instructions"] for fn in funcs)
+    predicted = static + sum(s["total"] or 0 for s in sites)
+    total = trace.get("instructions") if trace else None
+    basis = "trace" if total is not None else "static"
+    total = total if total is not None else predicted
+    tx = max(-(-total // per_tx), yields + 1) if total else yields + 1
+    return {
+        "instructions_per_tx": per_tx,
+        "functions": funcs,
+        "sites": sites,
+        "unpriced_sites": sum(s["cost"] is None for s in sites),
+        "predicted_instructions": predicted,
+        "total_instructions": total,
+        "basis": basis,
+        "yields": yields,
+        "transactions": tx,
+        "measured_transactions": trace.get("transactions") if trace else None,
+        "phases": [{"tag": tag, "calls": c, "instructions": d}
+                   for tag, (c, d) in sorted((trace or {}).get("phases", {}).items())],
+    }
+
+
+def render(est: dict[str, Any], tags: dict[int, str]) -> str:
+    lines = [f"{'function':<32} {'addr':>10} {'static':>8} {'sites':>5} {'syscall cost':>14}"]
+    for fn in sorted(est["functions"], key=lambda f: (-f["syscall_cost"], f["addr"])):
+        lines.append(f"{fn['name'][:32]:<32} {fn['addr']:>#10x} {fn['instructions']:>8} "
+                     f"{len(fn['sites']):>5} {fn['syscall_cost']:>14}")
+    lines += ["", f"{'site':<40} {'syscall':<26} {'n':>6} {'rows':>6} {'count':>6} "
+                  f"{'cost':>10} {'total':>12}"]
+    for s in est["sites"]:
+        where = f"{s['function'][:28]}+0x{s['offset']:x}"
+        name = s["syscall"] or (f"id {s['id']}" if s["id"] is not None else "? (a7 unknown)")
+        cost = "-" if s["cost"] is None else str(s["cost"])
+        total = "-" if s["total"] is None else str(s["total"])
+        flag = "  exceeds one transaction" if s["over_budget"] else ""
+        lines.append(f"{where:<40} {name[:26]:<26} {s['n']:>6} {s['rows']:>6} {s['count']:>6} "
+                     f"{cost:>10} {total:>12}{flag}")
+    if est["phases"]:
+        lines += ["", f"{'profile tag':<24} {'calls':>6} {'instructions':>14}"]
+        for p in est["phases"]:
+            label = tags.get(p["tag"], f"0x{p['tag']:x}")
+            lines.append(f"{label[:24]:<24} {p['calls']:>6} {p['instructions']:>14}")
+    lines += [
+        "",
+        "predicted instructions (syscalls + one pass over code): "
+        f"{est['predicted_instructions']}",
+    ]
+    if est["basis"] == "trace":
+        lines.append(f"measured instructions (trace): {est['total_instructions']}")
+    if est["unpriced_sites"]:
+        lines.append(f"unpriced sites: {est['unpriced_sites']}")
+    measured = est["measured_transactions"]
+    lines.append(f"transactions at {est['instructions_per_tx']} per tx: {est['transactions']}"
+                 f" ({est['yields']} yields, from the {est['basis']} total)"
+                 + (f"; measured {measured}" if measured is not None else ""))
+    return "\n".join(lines) + "\n"
+
+
+# ── Main ───────────────────────────────────────────────────────────
+
+
+def main(argv: list[str] | None = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("elf", type=Path, help="guest ELF from fb-cc")
+    ap.add_argument("--model", type=Path, help="cost model JSON from fb_costmodel.py fit")
+    ap.add_argument("--trace", type=Path, help="frostbite-run / frostbite-run-onchain output")
+    ap.add_argument("--call", action="append", default=[], metavar="NAME=n[,rows[,count]]",
+                    help="shape and per-run count of a syscall's sites (or of one 0x site)")
+    ap.add_argument("--instructions-per-tx", type=int, default=fb_costmodel.TX_BUDGET)
+    ap.add_argument("--tag", action="append", default=[], metavar="TAG=NAME",
+                    help="label an FB_PROFILE tag in the report")
+    ap.add_argument("--format", choices=("text", "json"), default="text")
+    args = ap.parse_args(argv)
+    if args.instructions_per_tx <= 0:
+        ap.error("--instructions-per-tx must be positive")
+
+    try:
+        ids = fb_costmodel.syscall_ids()
+        calls = dict(parse_call(spec, ids) for spec in args.call)
+        tags = {}
+        for spec in args.tag:
+            tag, _, label = spec.partition("=")
+            tags[int(tag, 0)] = label
+        funcs = scan(args.elf.read_bytes())
+        model = json.loads(args.model.read_text()) if args.model else None
+        trace = parse_trace(args.trace.read_text(errors="replace")) if args.trace else None
+    except (OSError, ValueError, struct.error) as e:
+        print(f"fb_estimate: {e}", file=sys.stderr)
+        return 1
+    est = estimate(funcs, model, calls, ids, trace, args.instructions_per_tx)
+    if args.format == "json":
+        print(json.dumps(est, indent=2))
+    else:
+        sys.stdout.write(render(est, tags))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Fold an `fb-cc --trace` call tree into flamegraph stacks.
+
+A traced guest (lib/frostbite_trace.c) logs its call tree at exit as FB_BLOG
+records (tag FB_TRACE_TAG): one per (parent, function) path, with the call
+count, the total instructions and the part spent in children, then a
+summary. This script reads them from runner output or Solana program logs,
+names every frame from the ELF's symbol table (syscalls as sys:<NAME> from
+frostbite.h), and prints one folded stack per path:
+
+  main;llm_forward;fb_matmul_i8_i8_partial;sys:MATMUL_I8_I8_PARTIAL 48210
+
+The weights are self instructions: a path's total minus its children. Feed
+them to flamegraph.pl, inferno-flamegraph or speedscope. `--top N` prints a
+flat per-function table instead, the function-level histogram of where
+instructions went (soft-float helpers, memcpy, kernels). Where the runner's
+instruction counter reads 0, as in frostbite-run, count totals are all zero,
+so the weights fall back to call counts (`--weight calls`).
+
+Usage:
+  fb_flame.py prog.elf run.log [-o prog.folded] [--weight self|calls] [--top 20]
+  frostbite-run-onchain prog.elf | fb_flame.py prog.elf - | flamegraph.pl > prog.svg
+"""
+
+from __future__ import annotations
+
+import argparse
+import bisect
+import sys
+from pathlib import Path
+from typing import Any
+
+import fb_costmodel  # scripts/fb_costmodel.py
+import fb_estimate  # scripts/fb_estimate.py
+import fb_log  # scripts/fb_log.py
+
+TRACE_TAG = 0xF1  # FB_TRACE_TAG
+NODE_SCHEMA = 1
+SUMMARY_SCHEMA = 2
+SYSCALL_BIT = 1 << 63  # FB_TRACE_SYSCALL_BIT
+
+
+def load(text: str) -> tuple[dict[int, dict[str, int]], dict[str, int] | None]:
+    """Trace nodes by index, and the summary record (None if the run did not exit)."""
+    nodes: dict[int, dict[str, int]] = {}
+    summary = None
+    for rec in fb_log.scan(text):
+        if rec["tag"] != TRACE_TAG:
+            continue
+        f = rec["fields"]
+        if rec["schema"] == NODE_SCHEMA and len(f) >= 6:
+            nodes[f[0]] = {"parent": f[1], "fn": f[2] & ((1 << 64) - 1), "calls": f[3],
+                           "total": f[4], "child": f[5]}
+        elif rec["schema"] == SUMMARY_SCHEMA and len(f) >= 3:
+            summary = {"nodes": f[0], "dropped": f[1], "instructions": f[2]}
+    return nodes, summary
+
+
+class Symbols:
+    def __init__(self, elf: bytes) -> None:
+        _, funcs = fb_estimate.read_elf(elf)
+        self.funcs = sorted(funcs)
+        self.addrs = [f[0] for f in self.funcs]
+        self.syscalls = {v: k for k, v in fb_costmodel.syscall_ids().items()}
+
+    def name(self, fn: int) -> str:
+        if fn & SYSCALL_BIT:
+            sid = fn & ~SYSCALL_BIT
+            return f"sys:{self.syscalls.get(sid, sid)}"
+        i = bisect.bisect_right(self.addrs, fn) - 1
+        if i >= 0:
+            addr, size, name = self.funcs[i]
+            if addr <= fn < addr + size:
+                return name
+        return f"0x{fn:x}"
+
+
+def folded(nodes: dict[int, dict[str, int]], syms: Symbols, weight: str) -> dict[str, int]:
+    paths: dict[int, str] = {}
+
+    def path(idx: int) -> str:
+        if idx not in paths:
+            node = nodes[idx]
+            parent = node["parent"]
+            frame = syms.name(node["fn"])
+            paths[idx] = f"{path(parent)};{frame}" if parent in nodes else frame
+        return paths[idx]
+
+    stacks: dict[str, int] = {}
+    for idx, node in nodes.items():
+        value = node["calls"] if weight == "calls" else max(node["total"] - node["child"], 0)
+        if value:
+            key = path(idx)
+            stacks[key] = stacks.get(key, 0) + value
+    return stacks
+
+
+def flat(nodes: dict[int, dict[str, int]], syms: Symbols) -> list[dict[str, Any]]:
+    """Per-function self, inclusive total (outermost frames only, so recursion
+    counts once) and calls."""
+    rows: dict[str, dict[str, Any]] = {}
+    for idx, node in nodes.items():
+        name = syms.name(node["fn"])
+        row = rows.setdefault(name, {"function": name, "self": 0, "total": 0, "calls": 0})
+        row["self"] += max(node["total"] - node["child"], 0)
+        row["calls"] += node["calls"]
+        up = node["parent"]
+        while up in nodes and syms.name(nodes[up]["fn"]) != name:
+            up = nodes[up]["parent"]
+        if up not in nodes:
+            row["total"] += node["total"]
+    return sorted(rows.values(), key=lambda r: (-r["self"], -r["calls"], r["function"]))
+
+
+def main(argv: list[str] | None = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("elf", type=Path, help="the traced ELF (fb-cc --trace)")
+    ap.add_argument("log", help="runner output or program log ('-' for stdin)")
+    ap.add_argument("-o", "--output", type=Path, help="write here instead of stdout")
+    ap.add_argument("--weight", choices=("self", "calls"), default="self",
+                    help="folded-stack weight: self instructions or call counts")
+    ap.add_argument("--top", type=int, metavar="N", help="print the N heaviest functions instead")
+    args = ap.parse_args(argv)
+
+    try:
+        text = sys.stdin.read() if args.log == "-" else Path(args.log).read_text(errors="replace")
+        syms = Symbols(args.elf.read_bytes())
+    except (OSError, ValueError) as e:
+        print(f"fb_flame: {e}", file=sys.stderr)
+        return 1
+    nodes, summary = load(text)
+    if not nodes:
+        print("fb_flame: no trace records (build with fb-cc --trace)", file=sys.stderr)
+        return 1
+    if summary is None:
+        print("fb_flame: no trace summary; the log may be cut short", file=sys.stderr)
+    elif summary["dropped"]:
+        print(f"fb_flame: {summary['dropped']} calls not recorded "
+              "(raise --rt-define FB_TRACE_NODES=N / FB_TRACE_DEPTH=N)", file=sys.stderr)
+    weight = args.weight
+    if weight == "self" and not any(n["total"] for n in nodes.values()):
+        print("fb_flame: the trace has no instruction counts; weighting by calls",
+              file=sys.stderr)
+        weight = "calls"
+
+    if args.top is not None:
+        rows = flat(nodes, syms)[:args.top]
+        grand = sum(max(n["total"] - n["child"], 0) for n in nodes.values()) or 1
+        lines = [f"{'self':>12} {'%':>6} {'total':>12} {'calls':>10}  function"]
+        lines += [f"{r['self']:>12} {100.0 * r['self'] / grand:>6.2f} {r['total']:>12} "
+                  f"{r['calls']:>10}  {r['function']}" for r in rows]
+    else:
+        lines = [f"{k} {v}" for k, v in sorted(folded(nodes, syms, weight).items())]
+    out = "\n".join(lines) + "\n"
+    if args.output:
+        args.output.write_text(out)
+    else:
+        sys.stdout.write(out)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
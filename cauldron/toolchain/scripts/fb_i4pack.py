@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Pack int8 weight matrices into the int4 layout of fb_matmul_i4_i8.
+
+Reads a row-major d x n int8 matrix (raw bytes, e.g. one W block of a
+convert.py weights blob) and writes the packed rows followed by d per-row
+Q16 scales (i32 little-endian), the two arrays fb_matmul_i4_i8 takes:
+
+  packed  d * FB_I4_ROW_BYTES(n) bytes   (FB_I4_ROW_BYTES(n) = align16(n) / 2)
+  scales  d * 4 bytes
+
+Each row is requantized to -8..7 on its own: q = round(w * 7 / max|row|)
+and scale = round(w_scale * max|row| / 7), so real weights stay
+w * w_scale / 65536 within half an int4 step. Rows already in -8..7 keep
+their values and w_scale.
+
+Usage:
+  fb_i4pack.py w1.i8 --n 64 --d 32 [--w-scale 65536] [--offset 0] -o w1.i4
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+
+
+def row_bytes(n: int) -> int:
+    return (n + 15) // 16 * 8
+
+
+def _round_half_away(num: int, den: int) -> int:
+    q, r = divmod(abs(num), den)
+    q += 2 * r >= den
+    return q if num >= 0 else -q
+
+
+def requant_row(row: list[int], w_scale_q16: int) -> tuple[list[int], int]:
+    if all(-8 <= v <= 7 for v in row):
+        return list(row), w_scale_q16
+    peak = max(abs(v) for v in row)
+    q = [max(-8, min(7, _round_half_away(v * 7, peak))) for v in row]
+    return q, max(1, _round_half_away(w_scale_q16 * peak, 7))
+
+
+def pack_row(q: list[int]) -> bytes:
+    n = len(q)
+    out = bytearray(row_bytes(n))
+    for k in range(len(out)):
+        i = (k // 8) * 16 + k % 8
+        lo = q[i] if i < n else 0
+        hi = q[i + 8] if i + 8 < n else 0
+        out[k] = (lo & 15) | ((hi & 15) << 4)
+    return bytes(out)
+
+
+def pack(data: bytes, n: int, d: int, w_scale_q16: int = 1 << 16) -> tuple[bytes, list[int]]:
+    """Return (packed rows, per-row Q16 scales) for a d x n int8 matrix."""
+    if len(data) < n * d:
+        raise ValueError(f"need {n * d} bytes for a {d} x {n} matrix, got {len(data)}")
+    packed = bytearray()
+    scales = []
+    for r in range(d):
+        row = [b - 256 if b > 127 else b for b in data[r * n:(r + 1) * n]]
+        q, scale = requant_row(row, w_scale_q16)
+        if scale > 0x7FFFFFFF:
+            raise ValueError(f"row {r}: scale {scale} overflows i32")
+        packed += pack_row(q)
+        scales.append(scale)
+    return bytes(packed), scales
+
+
+def main(argv: list[str] | None = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", type=Path, help="raw int8 matrix")
+    ap.add_argument("--n", type=int, required=True, help="columns (input dim)")
+    ap.add_argument("--d", type=int, required=True, help="rows (output dim)")
+    ap.add_argument("--w-scale", type=int, default=1 << 16, help="Q16 scale of the int8 matrix")
+    ap.add_argument("--offset", type=int, default=0, help="byte offset of the matrix in INPUT")
+    ap.add_argument("-o", "--output", type=Path, required=True)
+    args = ap.parse_args(argv)
+    if args.n <= 0 or args.d <= 0 or args.w_scale <= 0:
+        ap.error("--n, --d and --w-scale must be positive")
+    try:
+        data = args.input.read_bytes()[args.offset:]
+        packed, scales = pack(data, args.n, args.d, args.w_scale)
+        args.output.write_bytes(packed + struct.pack(f"<{len(scales)}i", *scales))
+    except (OSError, ValueError) as e:
+        print(f"fb_i4pack: {e}", file=sys.stderr)
+        return 1
+    total = len(packed) + 4 * len(scales)
+    print(f"{args.d} x {args.n}: {args.n * args.d} -> {total} bytes "
+          f"(packed {len(packed)} at 0, scales {4 * len(scales)} at {len(packed)})")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""Generate a C header of weights segment addresses from a model manifest.
+
+Resolves the block list of the manifest's weights blob (W1, B1, W2, ...) and
+writes one set of constants per block, so a guest reads weights at
+compile-time addresses instead of summing sizes at startup:
+
+  #define MLP2_RISK_SCORE_W1_OFFSET 12u             /* segment byte offset */
+  #define MLP2_RISK_SCORE_W1_BYTES  2048u
+  #define MLP2_RISK_SCORE_W1_ADDR   FB_SEGMENT_ADDR(1, 12u)
+
+The header also asserts (_Static_assert / static_assert) that every block the
+int8 kernels read is word-aligned, and the generator refuses to write one
+whose block sizes do not add up to the blob's size_bytes.
+
+Blocks come from the layout convert.py writes for weights.layout
+(linear_*, softmax_*, naive_bayes_*, mlp_*, mlp2_*, mlp3_*), or from an
+explicit list in the manifest, which takes precedence:
+
+  [[build.weights_layout]]
+  name = "w1"
+  dtype = "i8"        # i8 | i32 | u8 (raw bytes, no alignment check)
+  shape = [32, 64]
+  pad = 4             # optional: round the block start up, as the blob does
+
+Usage:
+  fb_layout.py model.frostbite-model.toml [-o weights_layout.h] [--prefix NAME]
+"""
+
+from __future__ import annotations
+
+import argparse
+import math
+import re
+import sys
+from pathlib import Path
+from typing import Any
+
+try:
+    import tomllib  # type: ignore[attr-defined]
+except ModuleNotFoundError:  # pragma: no cover
+    import tomli as tomllib  # type: ignore
+
+SEGMENT_LIMIT = 0x1000_0000
+# dtype -> (element bytes, alignment the consuming kernel path expects)
+DTYPES = {"i8": (1, 4), "i32": (4, 4), "u8": (1, 1)}
+
+
+class Block:
+    def __init__(self, name: str, dtype: str, shape: list[int], pad: int = 1) -> None:
+        if dtype not in DTYPES:
+            raise ValueError(f"block {name}: dtype must be one of {sorted(DTYPES)}")
+        if not shape or any(not isinstance(d, int) or d <= 0 for d in shape):
+            raise ValueError(f"block {name}: shape must be a non-empty list of positive ints")
+        if not isinstance(pad, int) or pad < 1 or pad & (pad - 1):
+            raise ValueError(f"block {name}: pad must be a power of two")
+        self.name = name
+        self.dtype = dtype
+        self.shape = shape
+        self.pad = pad
+        self.bytes = math.prod(shape) * DTYPES[dtype][0]
+        self.need = DTYPES[dtype][1]
+        self.offset = 0
+
+
+def _mlp_blocks(dims: list[int], bias: bool) -> list[Block]:
+    """dims = [input, hidden..., output]; W_k is (dims[k] x dims[k-1])."""
+    blocks = []
+    for k in range(1, len(dims)):
+        blocks.append(Block(f"w{k}", "i8", [dims[k], dims[k - 1]]))
+        if bias:
+            blocks.append(Block(f"b{k}", "i32", [dims[k]]))
+    if len(dims) == 2:
+        for b in blocks:
+            b.name = b.name[0]
+    return blocks
+
+
+def _dims(manifest: dict[str, Any]) -> tuple[int, int]:
+    vector = manifest.get("schema", {}).get("vector")
+    if not isinstance(vector, dict):
+        raise ValueError("built-in layouts need [schema.vector]; list [[build.weights_layout]] instead")
+    return math.prod(vector["input_shape"]), math.prod(vector["output_shape"])
+
+
+def _build_int(build: dict[str, Any], key: str) -> int:
+    value = build.get(key)
+    if not isinstance(value, int) or value <= 0:
+        raise ValueError(f"build.{key} must be a positive integer for this layout")
+    return value
+
+
+def resolve_blocks(manifest: dict[str, Any]) -> list[Block]:
+    build = manifest.get("build", {})
+    explicit = build.get("weights_layout")
+    if explicit is not None:
+        if not isinstance(explicit, list) or not explicit:
+            raise ValueError("build.weights_layout must be a non-empty array of tables")
+        blocks = []
+        for i, entry in enumerate(explicit):
+            if not isinstance(entry, dict) or not isinstance(entry.get("name"), str):
+                raise ValueError(f"build.weights_layout[{i}] needs a name")
+            blocks.append(Block(entry["name"], entry.get("dtype", "i8"), entry.get("shape", []),
+                                entry.get("pad", 1)))
+        return blocks
+
+    layout = manifest.get("weights", {}).get("layout", "")
+    family = re.sub(r"_(i8|q16|v\d+).*$", "", layout)
+    bias = build.get("has_bias", True)
+    if family in ("linear", "softmax", "naive_bayes"):
+        i, o = _dims(manifest)
+        return _mlp_blocks([i, o], bias)
+    if family == "mlp":
+        i, o = _dims(manifest)
+        return _mlp_blocks([i, _build_int(build, "hidden_dim"), o], True)
+    if family in ("mlp2", "mlp3"):
+        i, o = _dims(manifest)
+        hidden = [_build_int(build, f"hidden_dim{k}") for k in range(1, int(family[3]) + 1)]
+        return _mlp_blocks([i, *hidden, o], bias)
+    raise ValueError(f"no built-in block list for weights.layout {layout!r}; "
+                     "list the blocks under [[build.weights_layout]]")
+
+
+def resolve_base(manifest: dict[str, Any]) -> tuple[int, int, dict[str, Any]]:
+    """Return (segment, base offset, blob) for the first weights blob."""
+    weights = manifest.get("weights", {})
+    blobs = weights.get("blobs")
+    if not isinstance(blobs, list) or not blobs or not isinstance(blobs[0], dict):
+        raise ValueError("manifest has no [[weights.blobs]]")
+    blob = blobs[0]
+    data_offset = blob.get("data_offset")
+    if data_offset is None:
+        data_offset = 12 if weights.get("header_format") == "rvcd-v1" else 0
+    segment = blob.get("segment_index")
+    if segment is None:
+        for seg in manifest.get("segments", []):
+            if isinstance(seg, dict) and seg.get("kind") == "weights":
+                segment = seg.get("index")
+                break
+    if not isinstance(segment, int) or not 1 <= segment <= 15:
+        raise ValueError("weights segment index not found (blob segment_index or [[segments]])")
+    weights_offset = manifest.get("build", {}).get("weights_offset", 0)
+    if not isinstance(weights_offset, int):
+        raise ValueError("build.weights_offset must be an integer when provided")
+    return segment, data_offset + weights_offset, blob
+
+
+def place(blocks: list[Block], base: int) -> int:
+    """Assign offsets; returns the first byte past the last block."""
+    off = base
+    for b in blocks:
+        off = (off + b.pad - 1) // b.pad * b.pad
+        b.offset = off
+        off += b.bytes
+    return off
+
+
+def check(blocks: list[Block], base: int, end: int, blob: dict[str, Any]) -> None:
+    for b in blocks:
+        if b.offset % b.need:
+            raise ValueError(f"block {b.name} at offset {b.offset} is not {b.need}-byte aligned; "
+                             "pad the blob and set pad in [[build.weights_layout]]")
+    size = blob.get("size_bytes")
+    if isinstance(size, int) and end - base != size:
+        raise ValueError(f"blocks cover {end - base} bytes but blob size_bytes is {size}")
+    if end > SEGMENT_LIMIT:
+        raise ValueError("weights do not fit the 28-bit segment offset")
+
+
+def render(manifest_name: str, prefix: str, segment: int, base: int, end: int,
+           blocks: list[Block]) -> str:
+    guard = f"{prefix}_WEIGHTS_LAYOUT_H"
+    width = max(len(f"{prefix}_{b.name.upper()}_OFFSET") for b in blocks)
+    width = max(width, len(f"{prefix}_WEIGHTS_BASE"))
+    lines = [
+        f"/* Generated by fb_layout.py from {manifest_name}. Do not edit. */",
+        "",
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        '#include "frostbite.h"',
+        "",
+        f"#define {prefix + '_WEIGHTS_SEG':<{width}} {segment}u",
+        f"#define {prefix + '_WEIGHTS_BASE':<{width}} {base}u",
+        f"#define {prefix + '_WEIGHTS_END':<{width}} {end}u",
+        "",
+    ]
+    for b in blocks:
+        name = f"{prefix}_{b.name.upper()}"
+        shape = " x ".join(str(d) for d in b.shape)
+        lines.append(f"/* {b.name}: {b.dtype} {shape} */")
+        lines.append(f"#define {name + '_OFFSET':<{width}} {b.offset}u")
+        lines.append(f"#define {name + '_BYTES':<{width}} {b.bytes}u")
+        lines.append(f"#define {name + '_ADDR':<{width}} FB_SEGMENT_ADDR({segment}, {b.offset}u)")
+    lines += [
+        "",
+        "#ifdef __cplusplus",
+        "#define FB_LAYOUT_ASSERT static_assert",
+        "#else",
+        "#define FB_LAYOUT_ASSERT _Static_assert",
+        "#endif",
+    ]
+    for b in blocks:
+        if b.need > 1:
+            name = f"{prefix}_{b.name.upper()}"
+            lines.append(f'FB_LAYOUT_ASSERT({name}_OFFSET % {b.need}u == 0, '
+                         f'"{b.name} misaligned for the int8 kernels");')
+    lines += [
+        f'FB_LAYOUT_ASSERT({prefix}_WEIGHTS_END <= 0x10000000u, "weights overflow the segment");',
+        "#undef FB_LAYOUT_ASSERT",
+        "",
+        f"#endif /* {guard} */",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def generate(manifest_path: Path, prefix: str | None = None) -> str:
+    with manifest_path.open("rb") as f:
+        manifest = tomllib.load(f)
+    blocks = resolve_blocks(manifest)
+    names = [b.name.upper() for b in blocks]
+    if len(set(names)) != len(names):
+        raise ValueError("weights_layout block names must be unique")
+    segment, base, blob = resolve_base(manifest)
+    end = place(blocks, base)
+    check(blocks, base, end, blob)
+    if prefix is None:
+        prefix = manifest.get("model", {}).get("id", manifest_path.stem.split(".")[0])
+    prefix = re.sub(r"[^A-Za-z0-9]+", "_", prefix).strip("_").upper()
+    if not prefix or prefix[0].isdigit():
+        prefix = "FB_" + prefix
+    return render(manifest_path.name, prefix, segment, base, end, blocks)
+
+
+def main(argv: list[str] | None = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("manifest", type=Path)
+    ap.add_argument("-o", "--output", type=Path, help="header path (default: stdout)")
+    ap.add_argument("--prefix", help="macro prefix (default: model.id)")
+    args = ap.parse_args(argv)
+    try:
+        header = generate(args.manifest, args.prefix)
+    except (OSError, ValueError, KeyError, tomllib.TOMLDecodeError) as e:
+        print(f"fb_layout: {args.manifest}: {e}", file=sys.stderr)
+        return 1
+    if args.output:
+        args.output.write_text(header)
+    else:
+        sys.stdout.write(header)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
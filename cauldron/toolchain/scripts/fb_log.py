@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""Decode Frostbite binary log records (include/frostbite_log.h).
+
+Scans runner output or Solana program logs for FB_BLOG_PREFIX-framed
+records ("fb1:<base64>", anywhere on a line, e.g. after "Program log: ")
+and prints one decoded record per line. Other text is ignored.
+
+A schema file maps schema IDs to field names, so records print as named
+fields instead of a positional list:
+
+  {"7": {"name": "matmul", "fields": ["rows", "instret", "status"]}}
+
+A record that overflowed FB_BLOG_MAX is followed by a trailer record (tag
+DROPPED_TAG, fields {tag, dropped}); it is reported on stderr instead of
+printed, since the record before it is missing its last fields.
+
+Usage:
+  fb_log.py [--schema schemas.json] [--format jsonl|csv] [log.txt ...]
+  frostbite-run prog.elf | fb_log.py
+
+Also importable: decode_record(bytes) and scan(text) return plain dicts.
+"""
+
+from __future__ import annotations
+
+import argparse
+import base64
+import binascii
+import csv
+import json
+import re
+import sys
+from typing import Any, Iterable, Iterator
+
+VERSION = 1
+PREFIX = "fb1:"
+DROPPED_TAG = 0  # FB_BLOG_TAG_DROPPED
+RECORD_RE = re.compile(re.escape(PREFIX) + r"([A-Za-z0-9+/]+={0,2})")
+
+
+def read_varint(data: bytes, pos: int) -> tuple[int, int]:
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(data) or shift > 63:
+            raise ValueError("truncated varint")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def unzigzag(z: int) -> int:
+    return (z >> 1) ^ -(z & 1)
+
+
+def decode_record(data: bytes) -> dict[str, Any]:
+    """Decode one unframed record into {"tag", "schema", "fields"}."""
+    if not data or data[0] != VERSION:
+        raise ValueError(f"unknown record version {data[0] if data else None}")
+    tag, pos = read_varint(data, 1)
+    schema, pos = read_varint(data, pos)
+    fields = []
+    while pos < len(data):
+        z, pos = read_varint(data, pos)
+        fields.append(unzigzag(z))
+    return {"tag": tag, "schema": schema, "fields": fields}
+
+
+def scan(text: str) -> Iterator[dict[str, Any]]:
+    """Yield every decodable record in `text`, in order."""
+    for match in RECORD_RE.finditer(text):
+        try:
+            yield decode_record(base64.b64decode(match.group(1), validate=True))
+        except (ValueError, binascii.Error):
+            continue
+
+
+def name_fields(record: dict[str, Any], schemas: dict[str, Any]) -> dict[str, Any]:
+    schema = schemas.get(str(record["schema"]))
+    if not schema:
+        return record
+    names = schema.get("fields", [])
+    named = {n: v for n, v in zip(names, record["fields"])}
+    extra = record["fields"][len(names):]
+    out = {"tag": record["tag"], "schema": schema.get("name", record["schema"]), **named}
+    if extra:
+        out["extra"] = extra
+    return out
+
+
+def read_inputs(paths: list[str]) -> Iterable[str]:
+    if not paths:
+        yield sys.stdin.read()
+        return
+    for path in paths:
+        with open(path, encoding="utf-8", errors="replace") as f:
+            yield f.read()
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("logs", nargs="*", help="Log files (default stdin)")
+    parser.add_argument("--schema", help="JSON file of schema ID -> {name, fields}")
+    parser.add_argument("--format", choices=("jsonl", "csv"), default="jsonl")
+    parser.add_argument("--tag", type=lambda v: int(v, 0), action="append", default=[],
+                        help="Only print these tags (repeatable)")
+    args = parser.parse_args()
+
+    schemas: dict[str, Any] = {}
+    if args.schema:
+        with open(args.schema, encoding="utf-8") as f:
+            schemas = json.load(f)
+
+    writer = csv.writer(sys.stdout) if args.format == "csv" else None
+    for text in read_inputs(args.logs):
+        for record in scan(text):
+            if record["tag"] == DROPPED_TAG and len(record["fields"]) >= 2:
+                tag, dropped = record["fields"][:2]
+                if dropped:
+                    print(f"fb_log: record {hex(tag)} dropped {dropped} fields; "
+                          f"raise FB_BLOG_MAX or log fewer fields", file=sys.stderr)
+                continue
+            if args.tag and record["tag"] not in args.tag:
+                continue
+            if writer:
+                writer.writerow([hex(record["tag"]), record["schema"], *record["fields"]])
+            else:
+                print(json.dumps(name_fields(record, schemas)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Flatten a tree_q16_v1 ensemble into the breadth-first layout of frostbite_tree.h.
+
+Reads the blob convert.py writes for tree models (per tree, node_count
+20-byte nodes <feature, threshold_q16, left, right, value_q16>, tree_stride
+bytes apart, root at node 0, feature < 0 for leaves) and writes a "TRE1"
+segment that fb_tree_open / fb_tree_eval_i32 read:
+
+  header  32 bytes  magic, version, depth, num_trees, num_features, tree_bytes, base
+  trees   num_trees * ((2^depth - 1) * 8 + 2^depth * 4) bytes
+
+Every tree is padded to the deepest one: a leaf above the last level becomes
+pass-through nodes (threshold INT32_MAX) over copies of its value, so each
+evaluation takes exactly depth steps per tree and returns what the pointer
+walk returns.
+
+Usage:
+  fb_treepack.py weights.bin --nodes 15 --trees 1 --features 64 [--stride 300]
+                 [--offset 12] [--base 0] -o trees.bin
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = 0x31455254  # "TRE1"
+VERSION = 1
+MAX_DEPTH = 16
+INT32_MAX = 0x7FFFFFFF
+NODE = struct.Struct("<iiiii")
+
+
+def read_trees(data: bytes, nodes: int, trees: int, stride: int) -> list[list[tuple[int, ...]]]:
+    if stride < nodes * NODE.size:
+        raise ValueError(f"stride {stride} is below {nodes} nodes x {NODE.size} bytes")
+    need = (trees - 1) * stride + nodes * NODE.size
+    if len(data) < need:
+        raise ValueError(f"need {need} bytes for {trees} trees, got {len(data)}")
+    return [[NODE.unpack_from(data, t * stride + i * NODE.size) for i in range(nodes)]
+            for t in range(trees)]
+
+
+def tree_depth(tree: list[tuple[int, ...]], features: int, idx: int = 0, level: int = 0) -> int:
+    if not 0 <= idx < len(tree):
+        raise ValueError(f"node index {idx} out of range")
+    if level > MAX_DEPTH:
+        raise ValueError(f"tree deeper than {MAX_DEPTH} levels (or cyclic)")
+    feature, _, left, right, _ = tree[idx]
+    if feature < 0:
+        return 0
+    if feature >= features:
+        raise ValueError(f"feature {feature} out of range for {features} features")
+    return 1 + max(tree_depth(tree, features, left, level + 1),
+                   tree_depth(tree, features, right, level + 1))
+
+
+def flatten(tree: list[tuple[int, ...]], depth: int) -> bytes:
+    internal = (1 << depth) - 1
+    nodes = [(0, INT32_MAX)] * internal
+    leaves = [0] * (1 << depth)
+
+    def put(idx: int, pos: int, level: int) -> None:
+        feature, threshold, left, right, value = tree[idx]
+        if level == depth:
+            leaves[pos - internal] = value
+            return
+        if feature < 0:
+            put(idx, 2 * pos + 1, level + 1)
+            put(idx, 2 * pos + 2, level + 1)
+            return
+        nodes[pos] = (feature, threshold)
+        put(left, 2 * pos + 1, level + 1)
+        put(right, 2 * pos + 2, level + 1)
+
+    put(0, 0, 0)
+    out = bytearray()
+    for feature, threshold in nodes:
+        out += struct.pack("<Ii", feature, threshold)
+    out += struct.pack(f"<{len(leaves)}i", *leaves)
+    return bytes(out)
+
+
+def pack(data: bytes, nodes: int, trees: int, stride: int, features: int, base: int = 0) -> bytes:
+    ensemble = read_trees(data, nodes, trees, stride)
+    depth = max(tree_depth(t, features) for t in ensemble)
+    tree_bytes = ((1 << depth) - 1) * 8 + (1 << depth) * 4
+    out = bytearray(struct.pack("<IHHIIIiII", MAGIC, VERSION, depth, trees, features,
+                                tree_bytes, base, 0, 0))
+    for tree in ensemble:
+        out += flatten(tree, depth)
+    return bytes(out)
+
+
+def main(argv: list[str] | None = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("input", type=Path, help="tree_q16_v1 weights blob")
+    ap.add_argument("--nodes", type=int, required=True, help="build.tree_node_count")
+    ap.add_argument("--trees", type=int, required=True, help="build.tree_count")
+    ap.add_argument("--features", type=int, required=True, help="feature vector length")
+    ap.add_argument("--stride", type=int, help="build.tree_stride (default: nodes * 20)")
+    ap.add_argument("--offset", type=int, default=0, help="byte offset of the nodes in INPUT")
+    ap.add_argument("--base", type=int, default=0, help="value added to the leaf sum (Q16)")
+    ap.add_argument("-o", "--output", type=Path, required=True)
+    args = ap.parse_args(argv)
+    if args.nodes <= 0 or args.trees <= 0 or args.features <= 0:
+        ap.error("--nodes, --trees and --features must be positive")
+    stride = args.stride if args.stride is not None else args.nodes * NODE.size
+    try:
+        data = args.input.read_bytes()[args.offset:]
+        out = pack(data, args.nodes, args.trees, stride, args.features, args.base)
+        args.output.write_bytes(out)
+    except (OSError, ValueError, struct.error) as e:
+        print(f"fb_treepack: {e}", file=sys.stderr)
+        return 1
+    depth = struct.unpack_from("<H", out, 6)[0]
+    print(f"{args.trees} trees, depth {depth}: {len(out)} bytes "
+          f"({args.trees * depth} node steps per evaluation)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
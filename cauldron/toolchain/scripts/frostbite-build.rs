@@ -68,7 +68,7 @@ fn main() {
         .args([
             "-target",
             "riscv64",
-            "-march=rv64im",
+            "-march=rv64imc",
             "-mabi=lp64",
             "-ffreestanding",
             "-fno-builtin",
@@ -95,7 +95,7 @@ fn main() {
             .args([
                 "-target",
                 "riscv64",
-                "-march=rv64im",
+                "-march=rv64imc",
                 "-mabi=lp64",
                 "-ffreestanding",
                 "-fno-builtin",
@@ -123,7 +123,7 @@ fn main() {
             .args([
                 "-target",
                 "riscv64",
-                "-march=rv64im",
+                "-march=rv64imc",
                 "-mabi=lp64",
                 "-ffreestanding",
                 "-fno-builtin",
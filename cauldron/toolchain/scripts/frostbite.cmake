@@ -6,6 +6,44 @@
 #
 # Optional environment:
 #   FROSTBITE_TOOLCHAIN=/path/to/frostbite/toolchain
+#
+# Memory map (same as fb-cc --scratch-size etc.): set any of
+#   FROSTBITE_SCRATCH_SIZE   abi.scratch_min (default 0x40000)
+#   FROSTBITE_RESERVED_TAIL  bytes at the end of scratch left untouched (0)
+#   FROSTBITE_STACK_GUARD    gap between the stack top and the tail (0x10)
+#   FROSTBITE_STACK_SIZE     stack reserved below sp (0x4000)
+# before frostbite_add_executable and the target links with a generated copy
+# of lib/frostbite.ld (sp = scratch_size - reserved_tail - stack_guard).
+#
+# Size (same as fb-cc --profile etc.):
+#   FROSTBITE_PROFILE        "release-size" = -Os + GC_SECTIONS + LTO
+#   FROSTBITE_OPT_LEVEL      replaces -O2 (e.g. -Oz)
+#   FROSTBITE_GC_SECTIONS    per-function/data sections, --gc-sections
+#   FROSTBITE_LTO            ThinLTO for user sources and the allocator
+#   FROSTBITE_SIZE_REPORT    print section sizes and the largest symbols
+#
+# Profiling: FROSTBITE_TRACE=ON is fb-cc --trace (instrumented program and
+# runtime, call tree logged at exit for scripts/fb_flame.py).
+#
+# Target: FROSTBITE_MARCH (default rv64imfd_zca, else rv64imfd, as fb-cc
+# picks it; FROSTBITE_RVC=OFF for rv64imfd).
+# FROSTBITE_IMMUTABLE_CODE=ON is fb-cc --immutable-code (crt0 notes .init and
+# .text as never written, so the VM may keep decodes across fresh restarts).
+# FROSTBITE_WARM_START=ON is fb-cc --warm-start (fb_checkpoint warm images,
+# which rely on scratch surviving a fresh restart; see frostbite.h).
+#
+# Runtime: executables link frostbite::rt, a static libfrostbite_rt.a (crt0,
+# fb_checkpoint, bump allocator, soft-float) built once per build tree. It is
+# created by the first frostbite_add_executable and keeps the FROSTBITE_*
+# values in effect there: set them before that call, since a later change
+# reaches later executables but not frostbite::rt. For another allocator or
+# no soft-float, make one and pass it as RUNTIME:
+#   frostbite_add_runtime(rt_freelist ALLOC freelist)
+#   frostbite_add_executable(myprog RUNTIME rt_freelist src/main.c)
+# frostbite_import_runtime() wraps a prebuilt `fb-cc --build-rt` directory.
+#
+# Weights: frostbite_weights_layout(myprog model.frostbite-model.toml)
+# generates <model>_layout.h with a compile-time address per weights block.
 
 if(NOT DEFINED FROSTBITE_TOOLCHAIN)
   if(DEFINED ENV{FROSTBITE_TOOLCHAIN})
@@ -21,10 +59,38 @@ set(FROSTBITE_LINKER_SCRIPT "${FROSTBITE_TOOLCHAIN}/lib/frostbite.ld")
 set(FROSTBITE_CRT0 "${FROSTBITE_TOOLCHAIN}/lib/crt0.c")
 set(FROSTBITE_ALLOC "${FROSTBITE_TOOLCHAIN}/lib/frostbite_alloc.c")
 set(FROSTBITE_SOFTFLOAT "${FROSTBITE_TOOLCHAIN}/lib/frostbite_softfloat.c")
+set(FROSTBITE_TRACE_SOURCE "${FROSTBITE_TOOLCHAIN}/lib/frostbite_trace.c")
+set(FROSTBITE_WARM_SOURCE "${FROSTBITE_TOOLCHAIN}/lib/frostbite_warm.c")
+set(FROSTBITE_RT_VERSION 1) # matches fb-cc RT_VERSION
+
+# Same default as fb-cc, so both build a source the same way: native
+# float/double plus Zca, the integer half of the C extension (the program,
+# crt0, allocator and soft-float shrink by about a quarter). Full 'c' would
+# add c.fld/c.fsd, which the VM rejects. A clang without Zca builds
+# uncompressed.
+option(FROSTBITE_RVC "Emit RISC-V compressed instructions" ON)
+if(NOT FROSTBITE_MARCH)
+  set(FROSTBITE_MARCH rv64imfd)
+  if(FROSTBITE_RVC)
+    if(CMAKE_C_COMPILER)
+      set(_fb_cc "${CMAKE_C_COMPILER}")
+    else()
+      set(_fb_cc clang)
+    endif()
+    execute_process(
+      COMMAND ${_fb_cc} -target riscv64 -march=rv64imfd_zca -c -x c /dev/null -o /dev/null
+      RESULT_VARIABLE _fb_zca OUTPUT_QUIET ERROR_QUIET)
+    if(_fb_zca EQUAL 0)
+      set(FROSTBITE_MARCH rv64imfd_zca)
+    else()
+      message(STATUS "frostbite: clang has no Zca support; building uncompressed rv64imfd")
+    endif()
+  endif()
+endif()
 
 set(FROSTBITE_COMPILE_OPTIONS
   -target riscv64
-  -march=rv64im
+  -march=${FROSTBITE_MARCH}
   -mabi=lp64
   -ffreestanding
   -fno-builtin
@@ -32,7 +98,7 @@ set(FROSTBITE_COMPILE_OPTIONS
   -fno-exceptions
   -fno-unwind-tables
   -fno-asynchronous-unwind-tables
-  -O2
+  $<$<COMPILE_LANGUAGE:CXX>:-fno-rtti>
 )
 
 set(FROSTBITE_LINK_OPTIONS
@@ -40,16 +106,216 @@ set(FROSTBITE_LINK_OPTIONS
   -Wl,-T,${FROSTBITE_LINKER_SCRIPT}
 )
 
-function(frostbite_add_executable target)
-  set(_fb_runtime ${FROSTBITE_CRT0})
-  if(EXISTS "${FROSTBITE_ALLOC}")
-    list(APPEND _fb_runtime ${FROSTBITE_ALLOC})
+# Write <binary dir>/<target>.ld from FROSTBITE_LINKER_SCRIPT with the
+# FROSTBITE_* memory map values; sets out_var to the script to link with.
+function(_frostbite_memory_map target out_var)
+  set(_fb_script "${FROSTBITE_LINKER_SCRIPT}")
+  set(_fb_any OFF)
+  set(_fb_scratch 0x40000)
+  set(_fb_tail 0)
+  foreach(_fb_name SCRATCH_SIZE RESERVED_TAIL STACK_GUARD STACK_SIZE)
+    if(DEFINED FROSTBITE_${_fb_name})
+      set(_fb_any ON)
+    endif()
+  endforeach()
+  if(NOT _fb_any)
+    set(${out_var} "${_fb_script}" PARENT_SCOPE)
+    return()
+  endif()
+  if(DEFINED FROSTBITE_SCRATCH_SIZE)
+    set(_fb_scratch ${FROSTBITE_SCRATCH_SIZE})
+  endif()
+  if(DEFINED FROSTBITE_RESERVED_TAIL)
+    set(_fb_tail ${FROSTBITE_RESERVED_TAIL})
+  endif()
+  math(EXPR _fb_length "${_fb_scratch} - ${_fb_tail}")
+  if(_fb_length LESS_EQUAL 0)
+    message(FATAL_ERROR "FROSTBITE_RESERVED_TAIL must be smaller than FROSTBITE_SCRATCH_SIZE")
+  endif()
+
+  file(READ "${_fb_script}" _fb_ld)
+  string(REGEX REPLACE "LENGTH = [0-9A-Fa-fxX]+" "LENGTH = ${_fb_length}" _fb_ld "${_fb_ld}")
+  foreach(_fb_name SCRATCH_SIZE RESERVED_TAIL STACK_GUARD STACK_SIZE)
+    if(DEFINED FROSTBITE_${_fb_name})
+      string(TOLOWER "${_fb_name}" _fb_sym)
+      math(EXPR _fb_value "${FROSTBITE_${_fb_name}}")
+      string(REGEX REPLACE "__fb_${_fb_sym} = [^;)]*" "__fb_${_fb_sym} = ${_fb_value}"
+             _fb_ld "${_fb_ld}")
+    endif()
+  endforeach()
+  set(_fb_out "${CMAKE_CURRENT_BINARY_DIR}/${target}.ld")
+  file(WRITE "${_fb_out}" "${_fb_ld}")
+  set(${out_var} "${_fb_out}" PARENT_SCOPE)
+endfunction()
+
+# Optimization, section GC and LTO options for `target`. crt0, fb_checkpoint
+# and soft-float stay native: LTO would drop the asm-only callees and the
+# helpers that only codegen calls.
+function(_frostbite_size_options target)
+  set(_fb_opt -O2)
+  set(_fb_gc ${FROSTBITE_GC_SECTIONS})
+  set(_fb_lto ${FROSTBITE_LTO})
+  if(DEFINED FROSTBITE_PROFILE AND NOT FROSTBITE_PROFILE STREQUAL "default")
+    if(NOT FROSTBITE_PROFILE STREQUAL "release-size")
+      message(FATAL_ERROR "FROSTBITE_PROFILE must be default or release-size")
+    endif()
+    set(_fb_opt -Os)
+    set(_fb_gc ON)
+    set(_fb_lto ON)
+  endif()
+  if(DEFINED FROSTBITE_OPT_LEVEL)
+    set(_fb_opt ${FROSTBITE_OPT_LEVEL})
+  endif()
+  target_compile_options(${target} PRIVATE ${_fb_opt})
+  if(_fb_gc)
+    target_compile_options(${target} PRIVATE -ffunction-sections -fdata-sections)
+    target_link_options(${target} PRIVATE -Wl,--gc-sections)
+  endif()
+  if(_fb_lto)
+    target_compile_options(${target} PRIVATE -flto=thin)
+    target_link_options(${target} PRIVATE -flto=thin)
+    set_source_files_properties(${FROSTBITE_CRT0} ${FROSTBITE_WARM_SOURCE}
+                                ${FROSTBITE_SOFTFLOAT} PROPERTIES COMPILE_OPTIONS -fno-lto)
+  endif()
+  get_target_property(_fb_type ${target} TYPE)
+  if(FROSTBITE_SIZE_REPORT AND _fb_type STREQUAL "EXECUTABLE")
+    add_custom_command(TARGET ${target} POST_BUILD
+      COMMAND llvm-size -A $<TARGET_FILE:${target}>
+      COMMAND llvm-nm --print-size --size-sort --radix=d $<TARGET_FILE:${target}>
+      VERBATIM)
+  endif()
+endfunction()
+
+# FROSTBITE_TRACE: instrument `target` like fb-cc --trace.
+function(_frostbite_trace_options target)
+  if(FROSTBITE_TRACE)
+    target_compile_definitions(${target} PRIVATE FB_TRACE=1)
+    target_compile_options(${target} PRIVATE -finstrument-functions)
+  endif()
+endfunction()
+
+# frostbite_add_runtime(<name> [ALLOC bump|freelist|none] [NO_SOFTFLOAT]
+#                       [COMPILE_DEFINITIONS def...])
+# Static runtime library: crt0 (pulled in with -u _entry), the allocator
+# variant (none = the program defines fb_malloc, memcpy, ...) and soft-float,
+# compiled with the FROSTBITE_* options. COMPILE_DEFINITIONS reach the
+# runtime sources only, e.g. FB_HEAP_SEGMENT=2.
+function(frostbite_add_runtime name)
+  cmake_parse_arguments(_fb "NO_SOFTFLOAT" "ALLOC" "COMPILE_DEFINITIONS" ${ARGN})
+  if(NOT _fb_ALLOC)
+    set(_fb_ALLOC bump)
+  endif()
+  if(NOT _fb_ALLOC MATCHES "^(bump|freelist|none)$")
+    message(FATAL_ERROR "frostbite_add_runtime: ALLOC must be bump, freelist or none")
+  endif()
+  set(_fb_sources ${FROSTBITE_CRT0} ${FROSTBITE_WARM_SOURCE})
+  if(NOT _fb_ALLOC STREQUAL "none" AND EXISTS "${FROSTBITE_ALLOC}")
+    list(APPEND _fb_sources ${FROSTBITE_ALLOC})
+  endif()
+  if(NOT _fb_NO_SOFTFLOAT AND EXISTS "${FROSTBITE_SOFTFLOAT}")
+    list(APPEND _fb_sources ${FROSTBITE_SOFTFLOAT})
+  endif()
+  if(FROSTBITE_TRACE)
+    list(APPEND _fb_sources ${FROSTBITE_TRACE_SOURCE})
+  endif()
+  add_library(${name} STATIC ${_fb_sources})
+  target_include_directories(${name} PRIVATE ${FROSTBITE_INCLUDE_DIR})
+  target_compile_options(${name} PRIVATE ${FROSTBITE_COMPILE_OPTIONS})
+  _frostbite_size_options(${name})
+  _frostbite_trace_options(${name})
+  if(_fb_ALLOC STREQUAL "freelist")
+    target_compile_definitions(${name} PRIVATE FB_ALLOC_FREELIST=1)
+  endif()
+  if(FROSTBITE_IMMUTABLE_CODE)
+    target_compile_definitions(${name} PRIVATE FB_IMMUTABLE_CODE=1)
+  endif()
+  if(FROSTBITE_WARM_START)
+    target_compile_definitions(${name} PRIVATE FB_WARM_START=1)
+  endif()
+  if(_fb_COMPILE_DEFINITIONS)
+    target_compile_definitions(${name} PRIVATE ${_fb_COMPILE_DEFINITIONS})
+  endif()
+  target_link_options(${name} INTERFACE -Wl,-u,_entry)
+  # Per-version directory, like fb-cc's rt-cache/v<RT_VERSION>-*, so a bump
+  # never links a stale archive
+  set_target_properties(${name} PROPERTIES ARCHIVE_OUTPUT_DIRECTORY
+    "${CMAKE_CURRENT_BINARY_DIR}/frostbite-rt/v${FROSTBITE_RT_VERSION}")
+endfunction()
+
+# frostbite_import_runtime(<name> <dir> [ALLOC bump|freelist|none])
+# IMPORTED target for the libraries `fb-cc --build-rt` printed as <dir>.
+function(frostbite_import_runtime name dir)
+  cmake_parse_arguments(_fb "" "ALLOC" "" ${ARGN})
+  set(_fb_lib "${dir}/libfrostbite_rt.a")
+  if(_fb_ALLOC AND NOT _fb_ALLOC STREQUAL "bump")
+    set(_fb_lib "${dir}/libfrostbite_rt_${_fb_ALLOC}.a")
   endif()
-  if(EXISTS "${FROSTBITE_SOFTFLOAT}")
-    list(APPEND _fb_runtime ${FROSTBITE_SOFTFLOAT})
+  if(NOT EXISTS "${_fb_lib}")
+    message(FATAL_ERROR "frostbite_import_runtime: ${_fb_lib} not found (run fb-cc --build-rt)")
   endif()
-  add_executable(${target} ${ARGN} ${_fb_runtime})
+  add_library(${name} STATIC IMPORTED)
+  set_target_properties(${name} PROPERTIES IMPORTED_LOCATION "${_fb_lib}")
+  target_link_options(${name} INTERFACE -Wl,-u,_entry)
+  if(EXISTS "${dir}/libfrostbite_builtins.a")
+    target_link_libraries(${name} INTERFACE "${dir}/libfrostbite_builtins.a")
+  endif()
+endfunction()
+
+# frostbite_add_executable(<target> [RUNTIME <runtime target>] sources...)
+function(frostbite_add_executable target)
+  cmake_parse_arguments(_fb "" "RUNTIME" "" ${ARGN})
+  if(NOT _fb_RUNTIME)
+    if(NOT TARGET frostbite_rt)
+      frostbite_add_runtime(frostbite_rt)
+      add_library(frostbite::rt ALIAS frostbite_rt)
+    endif()
+    set(_fb_RUNTIME frostbite::rt)
+  endif()
+  add_executable(${target} ${_fb_UNPARSED_ARGUMENTS})
+  target_link_libraries(${target} PRIVATE ${_fb_RUNTIME})
   target_include_directories(${target} PRIVATE ${FROSTBITE_INCLUDE_DIR})
   target_compile_options(${target} PRIVATE ${FROSTBITE_COMPILE_OPTIONS})
-  target_link_options(${target} PRIVATE ${FROSTBITE_LINK_OPTIONS})
+  _frostbite_size_options(${target})
+  _frostbite_trace_options(${target})
+  if(FROSTBITE_WARM_START)
+    target_compile_definitions(${target} PRIVATE FB_WARM_START=1)
+  endif()
+  _frostbite_memory_map(${target} _fb_ld)
+  if(_fb_ld STREQUAL FROSTBITE_LINKER_SCRIPT)
+    target_link_options(${target} PRIVATE ${FROSTBITE_LINK_OPTIONS})
+  else()
+    list(REMOVE_ITEM FROSTBITE_LINK_OPTIONS -Wl,-T,${FROSTBITE_LINKER_SCRIPT})
+    target_link_options(${target} PRIVATE ${FROSTBITE_LINK_OPTIONS} -Wl,-T,${_fb_ld})
+    set_property(TARGET ${target} APPEND PROPERTY LINK_DEPENDS ${_fb_ld})
+  endif()
+endfunction()
+
+# frostbite_weights_layout(<target> <manifest> [PREFIX <name>] [HEADER <file>])
+# Generate <HEADER> (default <model id>_layout.h in the binary dir) with the
+# weights segment address of every block (scripts/fb_layout.py) and add its
+# directory to <target>'s include path. Regenerated when the manifest changes.
+function(frostbite_weights_layout target manifest)
+  cmake_parse_arguments(_fb "" "PREFIX;HEADER" "" ${ARGN})
+  find_package(Python3 REQUIRED COMPONENTS Interpreter)
+  get_filename_component(_fb_manifest "${manifest}" ABSOLUTE)
+  if(NOT _fb_HEADER)
+    get_filename_component(_fb_stem "${_fb_manifest}" NAME)
+    string(REGEX REPLACE "\\..*$" "" _fb_stem "${_fb_stem}")
+    string(MAKE_C_IDENTIFIER "${_fb_stem}" _fb_stem)
+    set(_fb_HEADER "${_fb_stem}_layout.h")
+  endif()
+  set(_fb_out "${CMAKE_CURRENT_BINARY_DIR}/${target}_layout/${_fb_HEADER}")
+  set(_fb_args "${_fb_manifest}" -o "${_fb_out}")
+  if(_fb_PREFIX)
+    list(APPEND _fb_args --prefix "${_fb_PREFIX}")
+  endif()
+  add_custom_command(
+    OUTPUT "${_fb_out}"
+    COMMAND ${CMAKE_COMMAND} -E make_directory "${CMAKE_CURRENT_BINARY_DIR}/${target}_layout"
+    COMMAND Python3::Interpreter "${FROSTBITE_TOOLCHAIN}/scripts/fb_layout.py" ${_fb_args}
+    DEPENDS "${_fb_manifest}" "${FROSTBITE_TOOLCHAIN}/scripts/fb_layout.py"
+    COMMENT "fb_layout ${_fb_HEADER}"
+    VERBATIM)
+  target_sources(${target} PRIVATE "${_fb_out}")
+  target_include_directories(${target} PRIVATE "${CMAKE_CURRENT_BINARY_DIR}/${target}_layout")
 endfunction()
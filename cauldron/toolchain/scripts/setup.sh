@@ -178,6 +178,9 @@ echo ""
 if command -v clang &>/dev/null; then
     if clang --target=riscv64 -march=rv64imac -c -x c /dev/null -o /dev/null 2>/dev/null; then
         echo "[OK] Clang has RISC-V 64-bit support"
+        if ! clang --target=riscv64 -march=rv64imfd_zca -c -x c /dev/null -o /dev/null 2>/dev/null; then
+            echo "[WARN] Clang has no Zca; fb-cc will emit uncompressed (larger) code"
+        fi
     else
         echo "[WARN] Clang may not have full RISC-V support"
         echo "  Try: sudo apt install clang llvm"